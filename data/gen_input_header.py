@@ -41,6 +41,8 @@ from header_file import HeaderFile, HeaderConstant, HeaderScalar, HeaderArray, H
 from header_file import align_array
 import convert_torch_format as convert
 import functional as F
+import preprocessing
+from gen_net_header import DEFAULT_ADC_BITS, DEFAULT_ADC_LSB
 
 DEFAULT_HEADER_NAME = "../src/cl/input.h"
 DEFAULT_CONFIG_JSON = "config.json"
@@ -48,21 +50,34 @@ DEFAULT_NET_NPZ = "net.npz"
 DEFAULT_INPUT_NPZ = "input.npz"
 
 
-def gen_input_header_from_file(net_file, config_file, input_file, output_file):
+def adc_codes(x, adc_bits=DEFAULT_ADC_BITS, adc_lsb=DEFAULT_ADC_LSB):
+    """ Converts the input into raw ADC codes (rounded and saturated to the ADC range) """
+    code_max = 2 ** (adc_bits - 1) - 1
+    return np.clip(np.round(x / adc_lsb), -code_max - 1, code_max).astype(np.int)
+
+
+def gen_input_header_from_file(net_file, config_file, input_file, output_file,
+                               adc_bits=DEFAULT_ADC_BITS, adc_lsb=DEFAULT_ADC_LSB,
+                               preprocessing_spec=None):
     # load network
     net = np.load(net_file)
     data = np.load(input_file)
 
+    # the preprocessing may change the input scale
+    if preprocessing_spec is not None:
+        net, _ = preprocessing.fold(net, preprocessing_spec)
+
     # load configuration file
     with open(config_file, "r") as _f:
         config = json.load(_f)
     # we only need the network parameters
     net_params = config["indiv"]["net"]["params"]
 
-    gen_input_header(net, net_params, data["input"], output_file)
+    gen_input_header(net, net_params, data["input"], output_file, adc_bits, adc_lsb)
 
 
-def gen_input_header(net, net_params, data, output_file):
+def gen_input_header(net, net_params, data, output_file, adc_bits=DEFAULT_ADC_BITS,
+                     adc_lsb=DEFAULT_ADC_LSB):
 
     # only allow nets with 255 levels
     assert net_params["weightInqNumLevels"] == 255
@@ -84,6 +99,14 @@ def gen_input_header(net, net_params, data, output_file):
     header = HeaderFile(output_file, "__INPUT_H__", with_c=True)
     header.add(HeaderArray("input_data", "int8_t", input_quant_align.ravel()))
     header.add(HeaderArray("input_data_pad", "int8_t", input_pad.ravel()))
+    # samples of all channels interleaved, not padded (INTERLEAVED_INPUT)
+    header.add(HeaderArray("input_data_interleaved", "int8_t", input_quant[0].T.ravel()))
+    # raw ADC samples of the first trial, quantized on the device (ADC_INPUT)
+    adc_dtype = "int16_t" if adc_bits <= 16 else "int32_t"
+    input_adc = adc_codes(data[0], adc_bits, adc_lsb)
+    header.add(HeaderArray("input_adc", adc_dtype, input_adc.ravel()))
+    # raw ADC samples of all channels interleaved (ADC_INPUT and INTERLEAVED_INPUT)
+    header.add(HeaderArray("input_adc_interleaved", adc_dtype, input_adc.T.ravel()))
     header.write()
 
 
@@ -94,6 +117,14 @@ if __name__ == "__main__":
     parser.add_argument("-n", "--net",    help="numpy file containing the network", default=DEFAULT_NET_NPZ)
     parser.add_argument("-c", "--config", help="configuration file name", default=DEFAULT_CONFIG_JSON)
     parser.add_argument("-i", "--input", help="numpy file containing the input", default=DEFAULT_INPUT_NPZ)
+    parser.add_argument("--adc-bits", help="Resolution of the ADC samples (16 or 24)", type=int,
+                        default=DEFAULT_ADC_BITS)
+    parser.add_argument("--adc-lsb", help="Value of a single ADC code, in the unit of the input",
+                        type=float, default=DEFAULT_ADC_LSB)
+    parser.add_argument("-p", "--preprocessing", help="json file with the linear preprocessing, "
+                        "which is folded into layer 1 and 2 (see python_utils/preprocessing.py)",
+                        default=None)
     args = parser.parse_args()
 
-    gen_input_header_from_file(args.net, args.config, args.input, args.output)
+    gen_input_header_from_file(args.net, args.config, args.input, args.output, args.adc_bits,
+                               args.adc_lsb, args.preprocessing)
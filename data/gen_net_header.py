@@ -35,33 +35,97 @@ import argparse
 import json
 import numpy as np
 
-from header_file import HeaderFile, HeaderConstant, HeaderScalar, HeaderArray, HeaderComment
+from header_file import HeaderFile, HeaderConstant, HeaderScalar, HeaderArray, HeaderComment, HeaderIfdef
 from header_file import align_array, align_array_size
 import convert_torch_format as convert
+import net_blob
+import ntt
+import preprocessing
+import sparsity
+import value_range
 
 DEFAULT_HEADER_NAME = "../src/cl/net/net.h"
 DEFAULT_CONFIG_JSON = "config.json"
 DEFAULT_NET_NPZ = "net.npz"
+DEFAULT_BLOB_NAME = "net.bin"
+
+# format of the raw ADC samples, which are quantized on the device (src/cl/net/input_stage.c)
+DEFAULT_ADC_BITS = 16
+DEFAULT_ADC_LSB = 2 ** -12
+ADC_SHIFT = 23
 
 WEIGHT_L1_PAD = 4 * 0
 
 
-def gen_net_header(net_file, config_file, output_file):
+def pack_params(*parts):
+    """
+    Packs the parameters of a layer into one contiguous block of 32bit words (little endian), such
+    that the layer can load all of them with a single DMA transfer. Every part starts at a word.
+
+    Parameters:
+    - parts: tuples (data, dtype), with dtype either np.int32 or np.int8
+
+    Returns: (block, offsets): block is a np.array of int32, and offsets contains the position
+             (in words) of every part inside the block
+    """
+    raw = b""
+    offsets = []
+    for data, dtype in parts:
+        offsets.append(len(raw) // 4)
+        raw += np.asarray(data).ravel().astype(np.dtype(dtype).newbyteorder("<")).tobytes()
+        raw += b"\0" * (-len(raw) % 4)
+    return np.frombuffer(raw, dtype="<i4"), offsets
+
+
+def add_params(header, layer, names, parts):
+    """
+    Adds the packed parameter block of the layer and the offsets of all its parts
+
+    Returns: dict {name: (byte offset, number of elements)} of every part
+    """
+    block, offsets = pack_params(*parts)
+    prefix = "NET_L{}_PARAMS".format(layer)
+    for name, offset in zip(names, offsets):
+        header.add(HeaderConstant("{}_{}".format(prefix, name), offset, blank_line=False))
+    header.add(HeaderConstant("{}_LEN".format(prefix), len(block)))
+    header.add(HeaderArray("net_l{}_params".format(layer), "int32_t", block))
+    return {name: (4 * offset, np.asarray(data).size)
+            for name, offset, (data, _) in zip(names, offsets, parts)}
+
+
+def gen_net_header(net_file, config_file, output_file, blob_file=None,
+                   adc_bits=DEFAULT_ADC_BITS, adc_lsb=DEFAULT_ADC_LSB, preprocessing_spec=None, sparsity_report=False,
+                   compress=False, range_report=False):
 
     # load network
     net = np.load(net_file)
 
+    # fold the linear preprocessing into layer 1 and layer 2
+    if preprocessing_spec is not None:
+        net, dropped = preprocessing.fold(net, preprocessing_spec)
+        print("Preprocessing folded into layer 1 and 2 ({:.2f}% of the filter energy truncated)".format(
+            100 * dropped))
+
     # load configuration file
     with open(config_file, "r") as _f:
         config = json.load(_f)
     # we only need the network parameters
     net_params = config["indiv"]["net"]["params"]
 
+    if sparsity_report:
+        sparsity.print_report(sparsity.analyze(net, net_params))
+
+    # bounds of all intermediate values, to select the 16bit kernels and the ReLU cap of layer 2
+    value_ranges = value_range.analyze(net, net_params)
+    if range_report:
+        value_range.print_report(value_ranges)
+    # refuse nets, for which an accumulator on the device might overflow
+    value_range.check(value_ranges)
+
     # only allow nets with 255 levels
     assert net_params["weightInqNumLevels"] == 255
     assert net_params["actSTENumLevels"] == 255
     assert net_params["F2"] % 4 == 0
-    assert net_params["N"] == 4
 
     # prepare params
     if net_params["F2"] is None:
@@ -88,11 +152,23 @@ def gen_net_header(net_file, config_file, output_file):
     header.add(HeaderConstant("NET_T64_ALIGN", align_array_size((net_params["T"] // 8) // 8), blank_line=False))
     header.add(HeaderConstant("NET_N", net_params["N"], blank_line=True))
 
-    # Layer 1
+    # Input stage
     input_scale = convert.ste_quant(net, "quant1")
-    weight, weight_scale = convert.inq_conv2d(net, "conv1")
-    weight = weight.reshape(net_params["F1"], 64)
-    weight_reverse, _ = convert.inq_conv2d(net, "conv1", store_reversed=True)
+    input_factor = convert.adc_factor(input_scale, adc_lsb, ADC_SHIFT)
+    assert adc_bits in [16, 24]
+
+    header.add(HeaderComment("Input Stage\n"
+                             "===========\n"
+                             "Quantization of the raw ADC samples\n\n"
+                             "Input:  [C, T] (ADC codes)\n"
+                             "Output: [C, T] (padded like the input of layer 1)",
+                             mode="/*"))
+    header.add(HeaderConstant("NET_INPUT_ADC_BITS", adc_bits))
+    header.add(HeaderConstant("NET_INPUT_SHIFT", ADC_SHIFT))
+    header.add(HeaderConstant("NET_INPUT_FACTOR", input_factor))
+
+    # Layer 1
+    weight_reverse, weight_scale = convert.inq_conv2d(net, "conv1", store_reversed=True)
     weight_reverse = weight_reverse.reshape(net_params["F1"], 64)
     bn_scale, bn_offset = convert.batch_norm(net, "batch_norm1")
     output_scale = convert.ste_quant(net, "quant2")
@@ -109,20 +185,42 @@ def gen_net_header(net_file, config_file, output_file):
                              "=======\n"
                              "Convolution + BN\n\n"
                              "Input:  [C, T]\n"
-                             "Weight: [F1, 64]\n"
+                             "Weight: [F1, 64] (reversed, aligned to [F1, NET_L1_WEIGHT_LEN_ALIGN])\n"
                              "Output: [F1, C, T]",
                              mode="/*"))
     header.add(HeaderConstant("NET_L1_PAD_START", 31))
     header.add(HeaderConstant("NET_L1_PAD_END", 32))
     header.add(HeaderConstant("NET_L1_PAD_INPUT_LEN", net_params["T"] + 31 + 32))
     header.add(HeaderConstant("NET_L1_PAD_INPUT_LEN_ALIGN", align_array_size(net_params["T"] + 31 + 32)))
-    header.add(HeaderArray("net_l1_factor", "int32_t", factor.ravel()))
-    header.add(HeaderArray("net_l1_offset", "int32_t", offset.ravel()))
-    header.add(HeaderConstant("NET_L1_WEIGHT_LEN", weight.shape[-1]))
+    header.add(HeaderConstant("NET_L1_WEIGHT_LEN", weight_reverse.shape[-1]))
     header.add(HeaderConstant("NET_L1_WEIGHT_LEN_ALIGN", weight_reverse_pad.shape[-1]))
-    header.add(HeaderArray("net_l1_weight", "int8_t", weight.ravel()))
-    header.add(HeaderArray("net_l1_weight_reverse", "int8_t", weight_reverse.ravel()))
-    header.add(HeaderArray("net_l1_weight_reverse_pad", "int8_t", weight_reverse_pad.ravel()))
+    # bits of the unscaled results (NO_INTERMEDIATE_SCALE), at most 16 selects the 16bit SIMD kernel of layer 2
+    header.add(HeaderConstant("NET_L1_RESULT_BITS", value_range.l1_result_bits(value_ranges)))
+    # unsigned bits of the pool sums of layer 2 plus the offset (NO_INTERMEDIATE_SCALE), more than 32
+    # caps the ReLU outputs (L2_RELU_CAP)
+    header.add(HeaderConstant("NET_L2_POOL_BITS", value_range.l2_pool_bits(value_ranges)))
+    # position of the weights in every section of the model blob (to compress them)
+    weight_layout = {}
+
+    weight_layout["net_l1_params"] = add_params(
+        header, 1, ["FACTOR", "OFFSET", "WEIGHT"],
+        [(factor, np.int32), (offset, np.int32), (weight_reverse_pad, np.int8)])
+
+    # filter spectra for the convolution with the number theoretic transform (NTT_CONV)
+    ntt_len = ntt.ntt_len(weight_reverse.shape[-1])
+    ntt_step = ntt_len - weight_reverse.shape[-1] + 1
+    ntt_twiddle = np.concatenate([ntt.twiddles(ntt_len), ntt.twiddles(ntt_len, inverse=True)])
+    ntt_spectrum = np.stack([ntt.filter_spectrum(w, ntt_len) for w in weight_reverse])
+    header.add(HeaderConstant("NET_L1_NTT_LEN", ntt_len, blank_line=False))
+    header.add(HeaderConstant("NET_L1_NTT_STEP", ntt_step, blank_line=False))
+    header.add(HeaderConstant("NET_L1_NTT_STEP_ALIGN", align_array_size(ntt_step), blank_line=False))
+    header.add(HeaderConstant("NET_L1_NTT_BLOCKS", (net_params["T"] + ntt_step - 1) // ntt_step,
+                              blank_line=False))
+    header.add(HeaderConstant("NET_L1_NTT_SCALE", ntt.scale_constant(ntt_len)))
+    # the arrays take 10kB of L2, and are only needed with NTT_CONV
+    header.add(HeaderIfdef("NTT_CONV", [
+        HeaderArray("net_l1_ntt_twiddle", "uint32_t", ntt_twiddle, blank_line=False),
+        HeaderArray("net_l1_ntt_spectrum", "uint32_t", ntt_spectrum.ravel(), blank_line=False)]))
 
     # layer2
     input_scale = convert.ste_quant(net, "quant2")
@@ -140,17 +238,17 @@ def gen_net_header(net_file, config_file, output_file):
                              "Weight: [F2, C] (aligned to [F2, 24]\n"
                              "Output: [F2, T // 8]",
                              mode="/*"))
-    header.add(HeaderArray("net_l2_factor", "int32_t", factor.ravel()))
-    header.add(HeaderArray("net_l2_offset", "int32_t", offset.ravel()))
     header.add(HeaderConstant("NET_L2_WEIGHT_LEN", weight.shape[-1]))
-    header.add(HeaderArray("net_l2_weight", "int8_t", weight.ravel()))
-    header.add(HeaderArray("net_l2_weight_32", "int32_t", weight.ravel()))
+    weight_layout["net_l2_params"] = add_params(
+        header, 2, ["FACTOR", "OFFSET", "WEIGHT"],
+        [(factor, np.int32), (offset, np.int32), (weight, np.int8)])
 
     # layer3
     input_scale = convert.ste_quant(net, "quant3")
     weight, weight_scale = convert.inq_conv2d(net, "sep_conv1")
     output_scale = convert.ste_quant(net, "quant4")
     factor = convert.div_factor(input_scale, weight_scale, output_scale)
+    l3_factor = factor
     weight = weight.reshape(net_params["F2"], 16)
 
     header.add(HeaderComment("Layer 3\n"
@@ -167,6 +265,7 @@ def gen_net_header(net_file, config_file, output_file):
     header.add(HeaderConstant("NET_L3_FACTOR", factor))
     header.add(HeaderConstant("NET_L3_WEIGHT_LEN", weight.shape[-1]))
     header.add(HeaderArray("net_l3_weight", "int8_t", weight.ravel()))
+    weight_layout["net_l3_weight"] = {"WEIGHT": (0, weight.size)}
 
     # layer4
     input_scale = convert.ste_quant(net, "quant4")
@@ -183,10 +282,10 @@ def gen_net_header(net_file, config_file, output_file):
                              "Weight: [F2, F2]\n"
                              "Output: [F2, T // 64]",
                              mode="/*"))
-    header.add(HeaderArray("net_l4_factor", "int32_t", factor.ravel()))
-    header.add(HeaderArray("net_l4_offset", "int32_t", offset.ravel()))
     header.add(HeaderConstant("NET_L4_WEIGHT_LEN", weight.shape[-1]))
-    header.add(HeaderArray("net_l4_weight", "int8_t", weight.ravel()))
+    weight_layout["net_l4_params"] = add_params(
+        header, 4, ["FACTOR", "OFFSET", "WEIGHT"],
+        [(factor, np.int32), (offset, np.int32), (weight, np.int8)])
 
     # layer5
     input_scale = convert.ste_quant(net, "quant5")
@@ -211,13 +310,31 @@ def gen_net_header(net_file, config_file, output_file):
                              "Output: [N]",
                              mode="/*"))
     header.add(HeaderConstant("NET_L5_FACTOR", factor))
-    header.add(HeaderArray("net_l5_bias", "int8_t", bias.ravel()))
     header.add(HeaderConstant("NET_L5_WEIGHT_LEN", weight_align.shape[-1]))
-    header.add(HeaderArray("net_l5_weight", "int8_t", weight_align.ravel()))
+    weight_layout["net_l5_params"] = add_params(
+        header, 5, ["BIAS", "WEIGHT"], [(bias, np.int8), (weight_align, np.int8)])
 
     # store the header file
     header.write()
 
+    # store the same parameters as model blob, which can be loaded at runtime
+    if blob_file is not None:
+        dims = {key: net_params[key] for key in net_blob.DIMS}
+        scalars = {"input_factor": input_factor, "l3_factor": l3_factor, "l5_factor": factor,
+                   "l1_result_bits": value_range.l1_result_bits(value_ranges),
+                   "l2_pool_bits": value_range.l2_pool_bits(value_ranges)}
+        sections = {e.name: e.data for e in header.elements if isinstance(e, HeaderArray)}
+        if compress:
+            weights = {name: layout["WEIGHT"] for name, layout in weight_layout.items()}
+            blob = net_blob.encode(dims, scalars, sections, weights)
+            size = len(net_blob.encode(dims, scalars, sections))
+            print("Compressed model blob: {} bytes instead of {} bytes ({:.1f}% saved on L2)".format(
+                len(blob), size, 100 * (1 - len(blob) / size)))
+            with open(blob_file, "wb") as _f:
+                _f.write(blob)
+        else:
+            net_blob.write(blob_file, dims, scalars, sections)
+
 
 if __name__ == "__main__":
 
@@ -225,6 +342,22 @@ if __name__ == "__main__":
     parser.add_argument("-o", "--output", help="Export header file name", default=DEFAULT_HEADER_NAME)
     parser.add_argument("-n", "--net",    help="numpy file containing the network", default=DEFAULT_NET_NPZ)
     parser.add_argument("-c", "--config", help="configuration file name", default=DEFAULT_CONFIG_JSON)
+    parser.add_argument("-b", "--blob", help="Export model blob file name (see src/cl/net/blob.h)",
+                        default=DEFAULT_BLOB_NAME)
+    parser.add_argument("--adc-bits", help="Resolution of the ADC samples (16 or 24)", type=int,
+                        default=DEFAULT_ADC_BITS)
+    parser.add_argument("--adc-lsb", help="Value of a single ADC code, in the unit of the input",
+                        type=float, default=DEFAULT_ADC_LSB)
+    parser.add_argument("-p", "--preprocessing", help="json file with the linear preprocessing, "
+                        "which is folded into layer 1 and 2 (see python_utils/preprocessing.py)",
+                        default=None)
+    parser.add_argument("-s", "--sparsity", action="store_true",
+                        help="report the zero weights (see python_utils/sparsity.py)")
+    parser.add_argument("-z", "--compress", action="store_true",
+                        help="store the weights in the model blob as 4bit INQ codes")
+    parser.add_argument("-r", "--range", action="store_true",
+                        help="report the value range of all intermediate values (see python_utils/value_range.py)")
     args = parser.parse_args()
 
-    gen_net_header(args.net, args.config, args.output)
+    gen_net_header(args.net, args.config, args.output, args.blob, args.adc_bits, args.adc_lsb,
+                   args.preprocessing, args.sparsity, args.compress, args.range)
@@ -0,0 +1,191 @@
+"""
+Evaluates the golden model on an entire dataset (e.g. all trials of verification.npz), using the
+batched implementation of the golden model. The trials are split into batches, which can be
+distributed over multiple processes. The throughput in trials per second is reported, and if the
+labels are available, also the accuracy.
+
+Usage (from this directory):
+    python3 batch_eval.py                                  # ../data/verification.npz
+    python3 batch_eval.py -i input.npz -b 32 -j 4          # 4 processes, 32 trials per batch
+    python3 batch_eval.py -l labels --check -o out.npz     # accuracy, compare with single trials
+    python3 batch_eval.py -l labels -p spec.json           # folded preprocessing vs. unfolded
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/26"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import os
+import time
+import multiprocessing
+import numpy as np
+
+from golden_model import GoldenModel
+import functional as F
+import preprocessing
+
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "../data")
+
+# model of the worker processes, set by _init_worker
+_worker_model = None
+
+
+def _init_worker(model):
+    global _worker_model
+    _worker_model = model
+
+
+def _run_batch(x):
+    return _worker_model(x)
+
+
+def run(model, x, batch_size=16, num_workers=1):
+    """
+    Executes the model on all trials
+
+    Parameters:
+    - model: GoldenModel
+    - x: np.array(shape: [N, C, T], dtype=int), quantized input
+    - batch_size: number of trials which are computed at once
+    - num_workers: number of processes (1: run in this process)
+
+    Returns: (np.array(shape: [N, *model.output_shape]), throughput in trials / s)
+    """
+    assert x.shape[1:] == tuple(model.input_shape), "shape was {}".format(x.shape)
+    batches = [x[i:i + batch_size] for i in range(0, x.shape[0], batch_size)]
+
+    start = time.perf_counter()
+    if num_workers > 1:
+        with multiprocessing.Pool(num_workers, initializer=_init_worker, initargs=(model, )) as pool:
+            outputs = pool.map(_run_batch, batches)
+    else:
+        outputs = [model(batch) for batch in batches]
+    duration = time.perf_counter() - start
+
+    y = np.concatenate(outputs, axis=0)
+    return y, x.shape[0] / duration
+
+
+def compare_preprocessing(model, reference, trials, y, batch_size=16, num_workers=1):
+    """
+    Compares the model with the folded preprocessing to the unfolded pipeline, where the
+    preprocessing is applied on the floating point input, before quantizing it.
+
+    Parameters:
+    - model: GoldenModel, with preprocessing_spec
+    - reference: GoldenModel, without preprocessing
+    - trials: np.array(shape: [N, C, T], dtype=float), raw input
+    - y: np.array, output of model (on the raw input)
+
+    Returns: (y_ref, dict with the keys agreement, max_error and mean_error)
+    """
+    x_ref = F.quantize_to_int(preprocessing.apply(model.preprocessing_spec, trials),
+                              reference.input_scale)
+    y_ref, _ = run(reference, x_ref, batch_size, num_workers)
+    error = np.abs(y.astype(int) - y_ref.astype(int))
+    return y_ref, {"agreement": np.mean(np.argmax(y, axis=-1) == np.argmax(y_ref, axis=-1)),
+                   "max_error": int(error.max()), "mean_error": float(error.mean())}
+
+
+def check(model, x, y):
+    """
+    Compares the batched output y with the model executed on every trial separately
+
+    Returns: list of indices of all trials which do not match
+    """
+    return [i for i in range(x.shape[0]) if not np.array_equal(model(x[i]), y[i])]
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Evaluates the golden model on an entire dataset")
+    parser.add_argument("-i", "--input", default=os.path.join(DATA_DIR, "verification.npz"),
+                        help="npz file with the trials [N, C, T] (float or already quantized)")
+    parser.add_argument("-k", "--key", default="input", help="name of the trials in the npz file")
+    parser.add_argument("-l", "--labels", default=None,
+                        help="name of the labels in the npz file, to compute the accuracy")
+    parser.add_argument("-c", "--config", default=os.path.join(DATA_DIR, "config.json"))
+    parser.add_argument("-n", "--net", default=os.path.join(DATA_DIR, "net.npz"))
+    parser.add_argument("-b", "--batch-size", type=int, default=16)
+    parser.add_argument("-j", "--workers", type=int, default=os.cpu_count(),
+                        help="number of processes (default: number of CPUs)")
+    parser.add_argument("--no-scale-between-l1-l2", action="store_true",
+                        help="use the fused layer 1 and 2 (NO_INTERMEDIATE_SCALE)")
+    parser.add_argument("--no-reorder-bn", action="store_true",
+                        help="apply the batch norm before the pooling (without REORDER_BN)")
+    parser.add_argument("--clip-unbalanced", action="store_true",
+                        help="clip to [-128, 127] instead of [-127, 127], like on the device")
+    parser.add_argument("--check", action="store_true",
+                        help="compare the result with the model executed on every trial separately")
+    parser.add_argument("-p", "--preprocessing", default=None,
+                        help="json file with a linear preprocessing, which is folded into layer 1 "
+                             "and 2, and compared to the unfolded pipeline (float input required)")
+    parser.add_argument("-o", "--output", default=None, help="store the output in this npz file")
+    args = parser.parse_args()
+
+    model_args = {"clip_balanced": not args.clip_unbalanced,
+                  "no_scale_between_l1_l2": args.no_scale_between_l1_l2,
+                  "reorder_bn": not args.no_reorder_bn}
+    golden = GoldenModel(args.config, args.net, preprocessing_spec=args.preprocessing, **model_args)
+
+    data = np.load(args.input)
+    raw_trials = data[args.key]
+    raw_trials = np.reshape(raw_trials, (raw_trials.shape[0], ) + tuple(golden.input_shape))
+    trials = raw_trials
+    if not np.issubdtype(trials.dtype, np.integer):
+        trials = F.quantize_to_int(trials, golden.input_scale)
+    else:
+        assert args.preprocessing is None, "The preprocessing requires the input in floating point"
+
+    result, throughput = run(golden, trials, args.batch_size, args.workers)
+    print("{} trials: {:.1f} trials/s (batch size: {}, processes: {})".format(
+        trials.shape[0], throughput, args.batch_size, args.workers))
+
+    if args.labels is not None:
+        labels = data[args.labels].ravel()
+        accuracy = np.mean(np.argmax(result, axis=-1) == labels)
+        print("Accuracy: {:.2f}%".format(100 * accuracy))
+
+    if args.preprocessing is not None:
+        unfolded = GoldenModel(args.config, args.net, **model_args)
+        result_ref, stats = compare_preprocessing(golden, unfolded, raw_trials, result,
+                                                  args.batch_size, args.workers)
+        print("Folded vs. unfolded preprocessing: {:.2f}% same class, output error: max {}, "
+              "mean {:.2f}".format(100 * stats["agreement"], stats["max_error"],
+                                   stats["mean_error"]))
+        if args.labels is not None:
+            accuracy = np.mean(np.argmax(result_ref, axis=-1) == labels)
+            print("Accuracy (unfolded): {:.2f}%".format(100 * accuracy))
+
+    if args.check:
+        mismatch = check(golden, trials, result)
+        if mismatch:
+            print("Mismatch in {} trials: {}".format(len(mismatch), mismatch))
+        else:
+            print("All trials match the single trial model")
+
+    if args.output is not None:
+        np.savez(args.output, output=result)
@@ -60,6 +60,46 @@ def inq_conv2d(net, layer_name, num_levels=255, store_reversed=False):
     return weights, scale_factor
 
 
+def inq_compress(weights):
+    """
+    Compresses INQ weights into 4bit codes (sign + exponent), two codes per byte (the first weight in
+    the lower nibble). A code c represents the value (2^(c & 7) - 1), negated if bit 3 is set. Thus,
+    0, +-1, +-3, ..., +-127 can be represented, which are all levels of a INQ layer with 255 levels.
+
+    Parameters
+    - weights: np.array(dtype=int), any shape
+
+    Returns: np.array(dtype=np.uint8) of size ceil(weights.size / 2)
+
+    Raises: ValueError if a weight is not a INQ level (e.g. if the weights were requantized)
+    """
+    weights = np.asarray(weights).ravel().astype(int)
+    magnitude = np.abs(weights) + 1
+    exponent = np.round(np.log2(magnitude)).astype(int)
+    if np.any(2 ** exponent != magnitude) or np.any(exponent > 7):
+        raise ValueError("The weights are not INQ levels and cannot be compressed")
+    codes = exponent | np.where(weights < 0, 8, 0)
+    if codes.size % 2 != 0:
+        codes = np.append(codes, 0)
+    return (codes[0::2] | (codes[1::2] << 4)).astype(np.uint8)
+
+
+def inq_decompress(packed, num_weights):
+    """
+    Expands the 4bit codes (see inq_compress) to the weights
+
+    Parameters
+    - packed: np.array(dtype=np.uint8), two codes per byte
+    - num_weights: int, number of weights
+
+    Returns: np.array(dtype=int) of size num_weights
+    """
+    packed = np.asarray(packed).astype(int)
+    codes = np.stack([packed & 0xf, packed >> 4], axis=-1).ravel()[:num_weights]
+    values = (1 << (codes & 7)) - 1
+    return np.where(codes & 8, -values, values)
+
+
 def inq_linear(net, layer_name, num_levels=255):
     """
     Converts a INQLinear layer into a quantized array
@@ -203,3 +243,29 @@ def div_factor_batch_norm(input_scale, weight_scale, output_scale, bn_scale, bn_
     factor = factor.round().astype(np.int)
     bias = bias.round().astype(np.int)
     return factor, bias
+
+
+def adc_factor(input_scale, adc_lsb, shift, num_levels=255):
+    """
+    Returns the fixed-point factor to quantize the raw ADC codes on the device (see
+    functional.quantize_adc). Notation: x: real value, c: ADC code, x': quantized integer value
+
+        x = c * lsb; x' = x/s_x * R_x
+
+                 (|c| * factor) >> shift                  lsb * R_x * 2^shift
+        |x'| = ---------------------------, factor = -----------------------
+                                                                s_x
+
+    Parameters:
+    - input_scale: float, scale of the input quantization (quant1)
+    - adc_lsb: float, value of a single ADC code in the same unit as the input
+    - shift: int, number of fractional bits of the factor
+    - num_levels: int, number of quantization levels
+
+    Returns: factor: int
+    """
+    val_range = (num_levels - 1) / 2
+    factor = int(round(adc_lsb * val_range * 2 ** shift / input_scale))
+    # the product (after clipping the ADC code) must fit into 32 bits
+    assert 1 <= factor < 2 ** 30
+    return factor
@@ -0,0 +1,191 @@
+"""
+Parameterized energy model of the Mr. Wolf cluster, used to estimate the energy per inference at
+different operating points (voltage, frequency), based on the cycles and activity counters measured
+in GVSOC (which does not model power).
+
+The cluster power consists of a dynamic part, which scales with V^2 * f and with the activity of
+the cores, and a leakage part, which only depends on the voltage:
+
+    P_dyn  = (C_base + n_active * C_core + n_idle * C_core_idle) * V^2 * f
+    P_leak = P_leak_nom * exp((V - V_nom) / V_leak)
+    E      = (P_dyn + P_leak) * cycles / f + (E_ext * n_ext + E_dma * n_dma) * (V / V_nom)^2
+
+where n_active is the average number of active cores (the sum of the active cycles of all cores,
+divided by the cycles), n_ext is the number of accesses of the cores to L2, and n_dma is the number
+of bytes transferred by the DMA between L2 and L1. Most of the L2 traffic of the network goes
+through the DMA. The performance counters of the cores do not see it, the host runtime counts it
+(rt_host_dma_bytes in src/host/rt/rt_api.h).
+
+The default coefficients are fitted to the numbers published for Mr. Wolf (Pullini et al., JSSC
+2019: cluster with 8 cores, 0.8V to 1.1V, up to 450MHz). They are only a rough estimate, and
+should be calibrated with a power measurement (see src/fc/main.c, POWER mode) before drawing
+quantitative conclusions. All coefficients can be overwritten with a json file.
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/20"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import json
+import math
+
+# Operating points (voltage in mV, cluster frequency in MHz), the same as in src/fc/main.c (POWER)
+OPERATING_POINTS = [
+    (800, 50),
+    (850, 50), (850, 100), (850, 150),
+    (900, 50), (900, 100), (900, 150),
+    (950, 50), (950, 100), (950, 150),
+    (1000, 50), (1000, 100), (1000, 150), (1000, 200),
+    (1050, 50), (1050, 100), (1050, 150), (1050, 200),
+    (1100, 50), (1100, 100), (1100, 150), (1100, 200), (1100, 250)
+]
+
+DEFAULT_PARAMS = {
+    # number of cores in the cluster
+    "num_cores": 8,
+    # nominal voltage [V], at which the leakage power and the L2 access energy are specified
+    "v_nom": 0.8,
+    # effective switched capacitance of the cluster without the cores (TCDM, icache, DMA) [F]
+    "c_base": 40e-12,
+    # effective switched capacitance of an active core [F]
+    "c_core": 18e-12,
+    # effective switched capacitance of an idle (clock gated) core [F]
+    "c_core_idle": 2e-12,
+    # leakage power of the cluster at the nominal voltage [W]
+    "p_leak_nom": 0.6e-3,
+    # leakage increases by a factor of e every v_leak volts [V]
+    "v_leak": 0.15,
+    # energy of a single access to L2 (from the cluster) at the nominal voltage [J]
+    "e_ext": 15e-12,
+    # energy per byte transferred by the DMA between L2 and L1 (64bit bursts) at the nominal
+    # voltage [J]
+    "e_dma": 4e-12,
+}
+
+
+class EnergyModel:
+    """
+    Energy model of the cluster. Use EnergyModel.from_file to load the coefficients from a json file
+    (all missing coefficients are set to the default).
+    """
+    def __init__(self, **params):
+        self.params = dict(DEFAULT_PARAMS)
+        for key in params:
+            assert key in DEFAULT_PARAMS, "Unknown parameter: {}".format(key)
+        self.params.update(params)
+
+    @classmethod
+    def from_file(cls, filename):
+        """ Load the coefficients from a json file """
+        with open(filename, "r") as _f:
+            return cls(**json.load(_f))
+
+    def dynamic_power(self, voltage, freq, activity=1.0):
+        """
+        Returns the dynamic power in W
+
+        Parameters:
+        - voltage: float, voltage in V
+        - freq: float, frequency in Hz
+        - activity: float in [0, 1], ratio of active core cycles over all core cycles
+        """
+        p = self.params
+        n_active = p["num_cores"] * activity
+        n_idle = p["num_cores"] - n_active
+        c_eff = p["c_base"] + n_active * p["c_core"] + n_idle * p["c_core_idle"]
+        return c_eff * voltage * voltage * freq
+
+    def leakage_power(self, voltage):
+        """ Returns the leakage power in W """
+        p = self.params
+        return p["p_leak_nom"] * math.exp((voltage - p["v_nom"]) / p["v_leak"])
+
+    def energy(self, voltage, freq, cycles, activity=1.0, ext_accesses=0, dma_bytes=0):
+        """
+        Returns the energy of a single inference in J, (dynamic energy, leakage energy)
+
+        Parameters:
+        - voltage: float, voltage in V
+        - freq: float, frequency in Hz
+        - cycles: int, number of cluster cycles for one inference
+        - activity: float in [0, 1], ratio of active core cycles over all core cycles
+        - ext_accesses: int, number of accesses of the cores to L2 (loads and stores)
+        - dma_bytes: int, number of bytes transferred by the DMA between L2 and L1
+        """
+        p = self.params
+        t = cycles / freq
+        e_dyn = self.dynamic_power(voltage, freq, activity) * t
+        e_dyn += (p["e_ext"] * ext_accesses + p["e_dma"] * dma_bytes) * (voltage / p["v_nom"]) ** 2
+        e_leak = self.leakage_power(voltage) * t
+        return e_dyn, e_leak
+
+    def evaluate(self, points, cycles, activity=1.0, ext_accesses=0, dma_bytes=0):
+        """
+        Evaluates the model at all operating points
+
+        Parameters:
+        - points: list of tuples (voltage [mV], frequency [MHz])
+        - cycles: int, or dict {frequency [MHz]: cycles}, if the cycles depend on the frequency
+        - activity: float, or dict {frequency [MHz]: activity}
+        - ext_accesses: int, or dict {frequency [MHz]: ext_accesses}
+        - dma_bytes: int, or dict {frequency [MHz]: dma_bytes}
+
+        Returns: list of dict with the keys: voltage, freq, cycles, latency [s], power [W],
+                 energy [J], energy_dyn [J], energy_leak [J]
+        """
+        def _get(val, freq):
+            return val[freq] if isinstance(val, dict) else val
+
+        result = []
+        for voltage_mv, freq_mhz in points:
+            n_cycles = _get(cycles, freq_mhz)
+            act = _get(activity, freq_mhz)
+            n_ext = _get(ext_accesses, freq_mhz)
+            n_dma = _get(dma_bytes, freq_mhz)
+            voltage = voltage_mv / 1000
+            freq = freq_mhz * 1e6
+            e_dyn, e_leak = self.energy(voltage, freq, n_cycles, act, n_ext, n_dma)
+            latency = n_cycles / freq
+            result.append({"voltage": voltage_mv, "freq": freq_mhz, "cycles": n_cycles,
+                           "latency": latency, "power": (e_dyn + e_leak) / latency,
+                           "energy": e_dyn + e_leak, "energy_dyn": e_dyn,
+                           "energy_leak": e_leak})
+        return result
+
+
+def min_energy_point(evaluated, deadline=None):
+    """
+    Returns the point with the lowest energy per inference, which meets the deadline.
+
+    Parameters:
+    - evaluated: list of dict, as returned by EnergyModel.evaluate
+    - deadline: float, maximal latency in s, or None if there is no deadline
+
+    Returns: dict of the selected point, or None if no point meets the deadline
+    """
+    feasible = [p for p in evaluated if deadline is None or p["latency"] <= deadline]
+    if not feasible:
+        return None
+    return min(feasible, key=lambda p: p["energy"])
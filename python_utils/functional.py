@@ -29,8 +29,29 @@ __copyright__ = """
 
 
 import numpy as np
+from numpy.lib.stride_tricks import sliding_window_view
 
-def batch_norm(x, scale, bias):
+# All functions accept an optional leading batch dimension (or multiple leading dimensions), e.g.
+# conv_time can be called with x of shape [CH, T] or [B, CH, T]. For the functions, which are applied
+# per channel (batch_norm, apply_factor_offset and relu), the position of the channel dimension must
+# be given with the parameter axis (axis=1 if x has a leading batch dimension).
+
+
+def _expand(v, x, axis):
+    """ reshapes the vector v such that it broadcasts along dimension axis of x """
+    shape = [1] * len(x.shape)
+    shape[axis] = -1
+    return np.reshape(v, shape)
+
+
+def _same_padding(length):
+    """ returns the padding (left, right) for a convolution with mode=same """
+    if length % 2 == 0: # even
+        return (length // 2 - 1, length // 2)
+    return ((length - 1) // 2, (length - 1) // 2)
+
+
+def batch_norm(x, scale, bias, axis=0):
     """
     Applies BatchNorm with scale and bias obtained from convert.batch_norm
     
@@ -38,21 +59,19 @@ def batch_norm(x, scale, bias):
     - x: np.array(shape: [D, ...])
     - scale: np.array(shape: [D])
     - bias: np.array(shape: [D])
+    - axis: dimension of x with size D
 
     Returns: np.array, same shape as x, same dtype as x
     """
     assert scale.shape == bias.shape
     assert len(scale.shape) == 1
-    assert scale.shape[0] == x.shape[0]
-
-    y = np.zeros(x.shape, dtype=x.dtype)
-    for k in range(x.shape[0]):
-        y[k, :] = x[k, :] * scale[k] + bias[k]
+    assert scale.shape[0] == x.shape[axis]
 
-    return y
+    y = x * _expand(scale, x, axis) + _expand(bias, x, axis)
+    return y.astype(x.dtype)
 
 
-def apply_factor_offset(x, factor, offset=None, clip_balanced=True):
+def apply_factor_offset(x, factor, offset=None, clip_balanced=True, axis=0):
     """
     Scales x according to the factor and offset.
     Factor and Offset should be obtained from convert.div_factor or convert.div_factor_batch_norm
@@ -62,6 +81,7 @@ def apply_factor_offset(x, factor, offset=None, clip_balanced=True):
     - x: np.array(dtype=int)
     - factor: int
     - clip_balanced: if False, clip from -128 to 127, if True, clip from -127 to 127
+    - axis: dimension of x to which the factor and offset are applied (if they are arrays)
 
     - y: np.array(dtype=int)
     """
@@ -76,58 +96,54 @@ def apply_factor_offset(x, factor, offset=None, clip_balanced=True):
     assert offset.shape == factor.shape
     assert len(factor.shape) == 1
 
-    y = np.zeros(x.shape, dtype=x.dtype)
-
     if factor.shape[0] == 1:
         y = (x + offset) / factor
     else:
-        for k in range(factor.shape[0]):
-            y[k] = (x[k] + offset[k]) / factor[k]
+        assert factor.shape[0] == x.shape[axis]
+        y = (x + _expand(offset, x, axis)) / _expand(factor, x, axis)
+        y = y.astype(x.dtype)
 
-    y = y.astype(np.int)
+    y = y.astype(int)
 
     if clip_balanced:
         return np.clip(y, -127, 127)
     return np.clip(y, -128, 127)
 
 
-def relu(x, threshold=0):
+def relu(x, threshold=0, axis=0):
     """
     Applies ReLU operation: max(x, threshold)
 
     Parameters:
     x: np.array(size=[D, ...])
-    threshold: either float or np.array(size=[D])
+    threshold: either a scalar or np.array(size=[D])
+    axis: dimension of x with size D
     """
     # convert threshold to an np.ndarray of shape (1, )
-    if isinstance(threshold, float):
-        threshold = np.array(threshold)
+    if not isinstance(threshold, np.ndarray):
+        threshold = np.array([threshold])
     assert len(threshold.shape) == 1
     # if the shape of the threshold is (1, ), then convert it to shape(D, )
     if threshold.shape[0] == 1:
-        threshold = (np.ones((x.shape[0], )) * threshold).astype(x.dtype)
-    assert threshold.shape[0] == x.shape[0]
+        threshold = (np.ones((x.shape[axis], )) * threshold).astype(x.dtype)
+    assert threshold.shape[0] == x.shape[axis]
 
-    y = np.zeros(x.shape, dtype=x.dtype)
-    for k in range(x.shape[0]):
-        y[k] = np.maximum(x[k], threshold[k])
-
-    return y
+    return np.maximum(x, _expand(threshold, x, axis)).astype(x.dtype)
 
 
 def pool(x, shape, reduction="sum"):
     """
-    Applies pooling
+    Applies pooling over the last len(shape) dimensions of x. Remaining values at the end of each
+    dimension (which do not fill an entire window) are dropped.
 
     Parameters:
-    - x: np.array(size=[K, T])
-    - shape: tuple of same dimensionality as x
+    - x: np.array(size=[..., K, T])
+    - shape: tuple, window size of the last dimensions of x
     - reduction: str, either "sum", "mean" or "max"
 
     Returns: np.array
     """
-    assert len(x.shape) == len(shape)
-    assert len(x.shape) == 2
+    assert len(x.shape) >= len(shape)
     do_round = False
     if reduction == "sum":
         func = np.sum
@@ -140,15 +156,19 @@ def pool(x, shape, reduction="sum"):
     else:
         raise TypeError("Parameter \"reduction\" must be either \"sum\", \"mean\" or \"max\"!")
 
-    out_shape = tuple(d // s for d, s in zip(x.shape, shape))
-    y = np.zeros(out_shape, dtype=x.dtype)
-
-    for k in range(y.shape[0]):
-        for t in range(y.shape[1]):
-            y[k, t] = func(x[k * shape[0]:(k + 1) * shape[0], t * shape[1]:(t + 1) * shape[1]])
+    # reshape [..., K, T] into [..., K / s0, s0, T / s1, s1] and reduce the window dimensions
+    num_batch = len(x.shape) - len(shape)
+    crop = tuple(slice(0, (d // s) * s) for d, s in zip(x.shape[num_batch:], shape))
+    windows = x[(Ellipsis, ) + crop]
+    windowed_shape = x.shape[:num_batch]
+    for d, s in zip(x.shape[num_batch:], shape):
+        windowed_shape += (d // s, s)
+    windows = np.reshape(windows, windowed_shape)
+    y = func(windows, axis=tuple(num_batch + 2 * i + 1 for i in range(len(shape))))
+    y = y.astype(x.dtype)
 
     if do_round:
-        y = y.astype(np.int)
+        y = y.astype(int)
 
     return y
 
@@ -159,27 +179,19 @@ def conv_time(x, w):
     Used in Layer 1
 
     Parameters:
-    - x: np.array(shape: [CH, T])
+    - x: np.array(shape: [..., CH, T])
     - w: np.array(shape: [K, T'])
 
-    Returns: np.array(shape: [K, CH, T]), same dtype as x
+    Returns: np.array(shape: [..., K, CH, T]), same dtype as x
     """
-    assert len(x.shape) == 2
+    assert len(x.shape) >= 2
     assert len(w.shape) == 2
 
-    # determine padding
-    if w.shape[1] % 2 == 0: # even
-        padding = (w.shape[1] // 2 - 1, w.shape[1] // 2)
-    else: #odd
-        padding = ((w.shape[1] - 1) // 2, (w.shape[1] - 1) // 2)
-
-    y = np.zeros((w.shape[0], x.shape[0], x.shape[1]), dtype=x.dtype)
-    x = np.pad(x, ((0, 0), padding))
-    for k in range(w.shape[0]):
-        for ch in range(x.shape[0]):
-            y[k, ch, :] = np.convolve(x[ch, :], w[k, :], mode="valid")
-
-    return y
+    padding = [(0, 0)] * (len(x.shape) - 1) + [_same_padding(w.shape[1])]
+    # windows: [..., CH, T, T'], the filter is flipped, because it is a convolution
+    windows = sliding_window_view(np.pad(x, padding), w.shape[1], axis=-1)
+    y = np.einsum("...ctl,kl->...kct", windows, w[:, ::-1])
+    return y.astype(x.dtype)
 
 
 def depthwise_conv_space(x, w):
@@ -188,25 +200,21 @@ def depthwise_conv_space(x, w):
     Used in Layer 2
 
     Parameters:
-    - x: np.array(shape: [K1, CH, T])
+    - x: np.array(shape: [..., K1, CH, T])
     - w: np.array(shape: [K2, CH])
 
-    Returns: np.array(shape: [K2, T]), same dtype as x
+    Returns: np.array(shape: [..., K2, T]), same dtype as x
     """
     assert len(w.shape) == 2
-    assert len(x.shape) == 3
-    assert x.shape[1] == w.shape[1]
-    assert w.shape[0] % x.shape[0] == 0 # K2 must be divisible by K1
+    assert len(x.shape) >= 3
+    assert x.shape[-2] == w.shape[1]
+    assert w.shape[0] % x.shape[-3] == 0 # K2 must be divisible by K1
 
-    D = w.shape[0] // x.shape[0]
+    D = w.shape[0] // x.shape[-3]
 
-    y = np.zeros((w.shape[0], x.shape[2]), dtype=x.dtype)
-
-    for k in range(w.shape[0]):
-        for t in range(x.shape[2]):
-            y[k, t] = np.convolve(x[k // D, :, t], w[k], mode="valid")
-
-    return y
+    # filter k is applied to the input channel k // D, the filter is flipped (convolution)
+    y = np.einsum("...kct,kc->...kt", np.repeat(x, D, axis=-3), w[:, ::-1])
+    return y.astype(x.dtype)
 
 
 def depthwise_conv_time(x, w):
@@ -215,27 +223,20 @@ def depthwise_conv_time(x, w):
     Used in Layer 3
 
     Parameters:
-    - x: np.array(shape: [K, T])
+    - x: np.array(shape: [..., K, T])
     - w: np.array(shape: [K, T'])
 
-    Returns: np.array(shape: [K, T]), same dtype as x
+    Returns: np.array(shape: [..., K, T]), same dtype as x
     """
-    assert len(x.shape) == 2
+    assert len(x.shape) >= 2
     assert len(w.shape) == 2
-    assert x.shape[0] == w.shape[0]
+    assert x.shape[-2] == w.shape[0]
 
-    # determine padding
-    if w.shape[1] % 2 == 0: # even
-        padding = (w.shape[1] // 2 - 1, w.shape[1] // 2)
-    else: #odd
-        padding = ((w.shape[1] - 1) // 2, (w.shape[1] - 1) // 2)
-
-    y = np.zeros(x.shape, dtype=x.dtype)
-    x = np.pad(x, ((0, 0), padding))
-    for k in range(x.shape[0]):
-        y[k] = np.convolve(x[k], w[k], mode="valid")
-
-    return y
+    padding = [(0, 0)] * (len(x.shape) - 1) + [_same_padding(w.shape[1])]
+    # windows: [..., K, T, T'], the filter is flipped, because it is a convolution
+    windows = sliding_window_view(np.pad(x, padding), w.shape[1], axis=-1)
+    y = np.einsum("...ktl,kl->...kt", windows, w[:, ::-1])
+    return y.astype(x.dtype)
 
 
 def pointwise_conv(x, w):
@@ -244,24 +245,19 @@ def pointwise_conv(x, w):
     Used in Layer4
 
     Parameters:
-    - x: np.array(shape: [K, T])
+    - x: np.array(shape: [..., K, T])
     - w: np.array(shape: [K, K])
 
-    Returns: np.array(shape: [K, T]), same dtype as x
+    Returns: np.array(shape: [..., K, T]), same dtype as x
     """
 
-    assert len(x.shape) == 2
+    assert len(x.shape) >= 2
     assert len(w.shape) == 2
-    assert x.shape[0] == w.shape[0]
-    assert x.shape[0] == w.shape[1]
-
-    y = np.zeros(x.shape, dtype=x.dtype)
+    assert x.shape[-2] == w.shape[0]
+    assert x.shape[-2] == w.shape[1]
 
-    for k_outer in range(w.shape[0]):
-        for k_inner in range(w.shape[1]):
-            y[k_outer] += x[k_inner] * w[k_outer, k_inner]
-
-    return y
+    y = np.einsum("...it,oi->...ot", x, w)
+    return y.astype(x.dtype)
 
 def linear(x, w, b):
     """
@@ -269,25 +265,21 @@ def linear(x, w, b):
     Used in layer 5
 
     Parameters:
-    - x: np.array(shape: [K])
+    - x: np.array(shape: [..., K])
     - w: np.array(shape: [N, K])
     - b: np.array(shape: [N])
     
-    Returns: np.array(shape: [N]), same dtype as x
+    Returns: np.array(shape: [..., N]), same dtype as x
     """
 
     assert len(w.shape) == 2
-    assert len(x.shape) == 1
+    assert len(x.shape) >= 1
     assert len(b.shape) == 1
-    assert w.shape[1] == x.shape[0]
+    assert w.shape[1] == x.shape[-1]
     assert b.shape[0] == w.shape[0]
 
-    y = np.zeros((w.shape[0], ), dtype=x.dtype)
-
-    for n in range(w.shape[0]):
-        y[n] = np.dot(x, w[n]) + b[n]
-
-    return y
+    y = np.einsum("...k,nk->...n", x, w) + b
+    return y.astype(x.dtype)
 
 
 def quantize(x, scale_factor, num_levels=255):
@@ -338,6 +330,31 @@ def quantize_to_int(x, scale_factor, num_levels=255):
     return x
 
 
+def quantize_adc(x, factor, shift, num_levels=255):
+    """
+    Quantizes raw ADC codes with a fixed-point factor, bit-exact to the input stage on the device
+    (src/cl/net/input_stage.c). Approximates quantize_to_int(x * lsb, scale_factor), with the factor
+    computed by convert_torch_format.adc_factor. Like quantize_to_int, the value is truncated
+    towards zero.
+
+    Parameters:
+    - x: np.array(dtype=int), raw ADC codes
+    - factor: int, fixed-point factor
+    - shift: int, number of fractional bits of the factor
+    - num_levels: int, number of quantization levels, must be odd
+
+    Returns: np.array(dtype=int), where all values will be in the integer representation
+    """
+    assert num_levels % 2
+    val_range = (num_levels - 1) // 2
+    x = np.asarray(x, dtype=np.int64)
+    # clip the magnitude before multiplying, such that the product fits into 32 bits
+    clip = ((val_range + 1) * 2 ** shift + factor - 1) // factor
+    y = (np.minimum(np.abs(x), clip) * factor) >> shift
+    y = np.minimum(y, val_range)
+    return (np.sign(x) * y).astype(np.int)
+
+
 def dequantize(x, scale_factor, num_levels=255):
     """
     Reverse operation of quantize_to_int
@@ -35,21 +35,28 @@ import numpy as np
 
 import convert_torch_format as convert
 import functional as F
+import preprocessing
 
 class GoldenModel:
     """
     Golden EEGNet Model
     """
-    def __init__(self, config_file, net_file, clip_balanced=True, no_scale_between_l1_l2=False, reorder_bn=True):
+    def __init__(self, config_file, net_file, clip_balanced=True, no_scale_between_l1_l2=False, reorder_bn=True,
+                 preprocessing_spec=None):
         """
         Initialize the model based on the config file and the npz file containing all weights
 
         Parameters:
         - config_file: filename of config.json (from QuantLab)
         - net_file: filename of net.npz (exported from QuantLab)
+        - preprocessing_spec: linear preprocessing (dict or json file, see preprocessing.py), which
+                              is folded into layer 1 and 2. The model then expects the raw input.
         """
         # load network parameters
         net = np.load(net_file)
+        self.preprocessing_spec = preprocessing.load_spec(preprocessing_spec)
+        if self.preprocessing_spec is not None:
+            net, _ = preprocessing.fold(net, self.preprocessing_spec)
 
         # load configuration file
         with open(config_file, "r") as _f:
@@ -111,6 +118,9 @@ class GoldenModel:
         return ret
 
     def __call__(self, x):
+        """
+        Executes the model on a single trial x[C, T], or on a batch of trials x[B, C, T]
+        """
         for l in self.layers:
             x = l(x)
         return x
@@ -139,9 +149,19 @@ class Layer:
         self.clip_balanced = clip_balanced
 
     def __call__(self, x):
-        """ Executes the layer """
+        """
+        Executes the layer, either on a single input (shape: input_shape), or on a batch of inputs
+        (shape: [B, *input_shape]). The output has the same number of dimensions.
+        """
         return x
 
+    def _to_batch(self, x):
+        """ Returns (x[B, *input_shape], batched), adding the batch dimension if necessary """
+        if x.shape == tuple(self.input_shape):
+            return x[np.newaxis], False
+        assert x.shape[1:] == tuple(self.input_shape), "shape was {}".format(x.shape)
+        return x, True
+
     def __str__(self):
         """ returns a formated string with a summary of the layer """
         ret = "{}\n".format(self.name)
@@ -196,9 +216,9 @@ class FusedLayer12(Layer):
                                                                    self.output_scale, self.bn_scale_2,
                                                                    self.bn_offset_2, pool=8)
         # update the factors and scales
-        for k in range(16):
-            self.factor_2[k] *= self.factor_1[k // 2]
-            self.bias_2[k] *= self.factor_1[k // 2]
+        for k in range(self.F2):
+            self.factor_2[k] *= self.factor_1[k // (self.F2 // self.F1)]
+            self.bias_2[k] *= self.factor_1[k // (self.F2 // self.F1)]
 
     def num_params(self):
         count = reduce(mul, self.weights_1.shape)
@@ -219,18 +239,18 @@ class FusedLayer12(Layer):
         return count
 
     def __call__(self, x):
-        assert x.shape == self.input_shape, "shape was {}".format(x.shape)
+        x, batched = self._to_batch(x)
         y = F.conv_time(x, self.weights_1)
         # add the offset
-        for k in range(self.F1):
-            y[k] += self.bias_1[k]
+        y += np.reshape(self.bias_1, (self.F1, 1, 1))
 
         # do the second layer
         y = F.depthwise_conv_space(y, self.weights_2)
-        y = F.relu(y, -(self.bias_2 // 8))
+        y = F.relu(y, -(self.bias_2 // 8), axis=1)
         y = F.pool(y, (1, 8))
-        y = F.apply_factor_offset(y, self.factor_2, self.bias_2, clip_balanced=self.clip_balanced)
-        return y
+        y = F.apply_factor_offset(y, self.factor_2, self.bias_2, clip_balanced=self.clip_balanced,
+                                  axis=1)
+        return y if batched else y[0]
 
 
 class Layer1(Layer):
@@ -272,10 +292,11 @@ class Layer1(Layer):
         return count
         
     def __call__(self, x):
-        assert x.shape == self.input_shape, "shape was {}".format(x.shape)
+        x, batched = self._to_batch(x)
         y = F.conv_time(x, self.weights)
-        y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced)
-        return y
+        y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced,
+                                  axis=1)
+        return y if batched else y[0]
 
 
 class Layer2(Layer):
@@ -321,19 +342,20 @@ class Layer2(Layer):
         return count
 
     def __call__(self, x):
-        assert x.shape == self.input_shape
+        x, batched = self._to_batch(x)
         y = F.depthwise_conv_space(x, self.weights)
         if self.reorder_bn:
-            y = F.relu(y, -(self.bias // 8))
+            y = F.relu(y, -(self.bias // 8), axis=1)
             y = F.pool(y, (1, 8))
-            y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced)
+            y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced,
+                                      axis=1)
         else:
             y = F.apply_factor_offset(y, self.factor // 8, self.bias // 8,
-                                      clip_balanced=self.clip_balanced)
-            y = F.relu(y, (self.bias) * 0)
+                                      clip_balanced=self.clip_balanced, axis=1)
+            y = F.relu(y, (self.bias) * 0, axis=1)
             y = F.pool(y, (1, 8)) // 8
 
-        return y
+        return y if batched else y[0]
 
 
 class Layer3(Layer):
@@ -365,10 +387,10 @@ class Layer3(Layer):
         return reduce(mul, self.weights.shape) + 4
         
     def __call__(self, x):
-        assert x.shape == self.input_shape, "shape was {}".format(x.shape)
+        x, batched = self._to_batch(x)
         y = F.depthwise_conv_time(x, self.weights)
         y = F.apply_factor_offset(y, self.factor, clip_balanced=self.clip_balanced)
-        return y
+        return y if batched else y[0]
 
 
 class Layer4(Layer):
@@ -410,18 +432,19 @@ class Layer4(Layer):
         return count
         
     def __call__(self, x):
-        assert x.shape == self.input_shape, "shape was {}".format(x.shape)
+        x, batched = self._to_batch(x)
         y = F.pointwise_conv(x, self.weights)
         if self.reorder_bn:
-            y = F.relu(y, -(self.bias // 8))
+            y = F.relu(y, -(self.bias // 8), axis=1)
             y = F.pool(y, (1, 8))
-            y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced)
+            y = F.apply_factor_offset(y, self.factor, self.bias, clip_balanced=self.clip_balanced,
+                                      axis=1)
         else:
             y = F.apply_factor_offset(y, self.factor // 8, self.bias // 8,
-                                      clip_balanced=self.clip_balanced)
-            y = F.relu(y, (self.bias) * 0)
+                                      clip_balanced=self.clip_balanced, axis=1)
+            y = F.relu(y, (self.bias) * 0, axis=1)
             y = F.pool(y, (1, 8)) // 8
-        return y
+        return y if batched else y[0]
 
 
 class Layer5(Layer):
@@ -454,8 +477,8 @@ class Layer5(Layer):
         return self.num_params()
         
     def __call__(self, x):
-        assert x.shape == self.input_shape, "shape was {}".format(x.shape)
-        x = x.ravel()
+        x, batched = self._to_batch(x)
+        x = np.reshape(x, (x.shape[0], self.flatten_dim))
         y = F.linear(x, self.weights, self.bias)
         y = F.apply_factor_offset(y, self.factor, clip_balanced=self.clip_balanced)
-        return y
+        return y if batched else y[0]
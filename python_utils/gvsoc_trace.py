@@ -0,0 +1,368 @@
+"""
+Converts GVSOC instruction traces into a per-core timeline and a flame graph.
+
+The instruction trace (generated with ./run.sh -t, or with make run runner_args="--trace=insn") is
+combined with the symbol table of the ELF file, to find out which function is executed on every
+core at every point in time. The call stack is reconstructed from the function entries and
+returns. Time, where a core is sleeping on the event unit (p.elw), is attributed to a separate
+frame: [barrier], [dma wait] or [wait] (if addr2line is available, the inlined runtime function
+is used to distinguish between barrier and DMA wait).
+
+Outputs:
+- Chrome trace (json), which can be opened in chrome://tracing or https://ui.perfetto.dev. Every
+  core is a separate thread.
+- Collapsed stacks (one line per stack: "core;func1;func2 cycles"), which can be converted into a
+  flame graph with flamegraph.pl (https://github.com/brendangregg/FlameGraph) or speedscope. With
+  --lines, the leaf of every stack is the source line, which allows to distinguish the different
+  regions inside a kernel (e.g. _net_fused_layer_1_2_kernel).
+
+Usage:
+    python3 gvsoc_trace.py trace.log build/pulpissimo/eegnet/eegnet -c timeline.json -f stacks.txt
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/22"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import bisect
+import json
+import re
+import shutil
+import subprocess
+from collections import defaultdict
+
+DEFAULT_NM = ["riscv32-unknown-elf-nm", "nm"]
+DEFAULT_ADDR2LINE = ["riscv32-unknown-elf-addr2line", "addr2line"]
+
+SLEEP_INSN = "p.elw"
+UNKNOWN = "[unknown]"
+
+# example: "4890000: 489: [/sys/board/chip/cluster/pe0/insn] func:0 M 1c008080 c.li a0, 0 a0=0"
+_TRACE_RE = re.compile(r"^\s*(\d+):\s+(\d+):\s+\[([^\]]+)\]\s+(.*)$")
+_PC_RE = re.compile(r"^[0-9a-fA-F]{8}$")
+
+
+def _find_tool(candidates):
+    for tool in candidates:
+        if shutil.which(tool) is not None:
+            return tool
+    return None
+
+
+class SymbolTable:
+    """
+    Maps program counters to functions
+    """
+    def __init__(self, symbols):
+        """
+        Parameters:
+        - symbols: list of tuples (address, size, name), size can be None
+        """
+        self.symbols = sorted(symbols)
+        self.addresses = [s[0] for s in self.symbols]
+
+    @classmethod
+    def from_nm_output(cls, text):
+        """ Parse the output of nm -n -S --defined-only (only symbols in the text section) """
+        symbols = []
+        for line in text.splitlines():
+            parts = line.split()
+            if len(parts) == 4:
+                addr, size, kind, name = parts
+                size = int(size, 16)
+            elif len(parts) == 3:
+                addr, kind, name = parts
+                size = None
+            else:
+                continue
+            if kind not in "tTwW":
+                continue
+            symbols.append((int(addr, 16), size, name))
+        return cls(symbols)
+
+    @classmethod
+    def from_elf(cls, elf_file, nm=None):
+        """ Read the symbol table of the elf file with nm """
+        if nm is None:
+            nm = _find_tool(DEFAULT_NM)
+        assert nm is not None, "nm not found"
+        text = subprocess.check_output([nm, "-n", "-S", "--defined-only", elf_file])
+        return cls.from_nm_output(text.decode())
+
+    def lookup(self, pc):
+        """ Returns (name, start address) of the function containing pc, or (UNKNOWN, None) """
+        idx = bisect.bisect_right(self.addresses, pc) - 1
+        if idx < 0:
+            return UNKNOWN, None
+        addr, size, name = self.symbols[idx]
+        if size is not None and size > 0 and pc >= addr + size:
+            return UNKNOWN, None
+        return name, addr
+
+
+class LineTable:
+    """
+    Maps program counters to source lines and inlined functions, using addr2line
+    """
+    def __init__(self, elf_file, addr2line=None):
+        if addr2line is None:
+            addr2line = _find_tool(DEFAULT_ADDR2LINE)
+        self.elf_file = elf_file
+        self.addr2line = addr2line
+        self.cache = {}
+
+    def available(self):
+        return self.addr2line is not None
+
+    def resolve(self, pcs):
+        """ Resolve all program counters in pcs (with a single call of addr2line) """
+        pcs = sorted(set(pc for pc in pcs if pc not in self.cache))
+        if not pcs or not self.available():
+            return
+        # addr2line -i prints a variable number of lines per address, -a prints the address first
+        query = "\n".join("0x{:08x}".format(pc) for pc in pcs)
+        out = subprocess.run([self.addr2line, "-a", "-f", "-i", "-e", self.elf_file], input=query,
+                             stdout=subprocess.PIPE, universal_newlines=True).stdout.splitlines()
+        entries = []
+        i = 0
+        while i < len(out):
+            if out[i].startswith("0x"):
+                entries.append([])
+                i += 1
+                continue
+            func, loc = out[i], out[i + 1] if i + 1 < len(out) else "??:0"
+            if func != "??":
+                entries[-1].append((func, loc.split(" ")[0]))
+            i += 2
+        for pc, entry in zip(pcs, entries):
+            self.cache[pc] = entry
+
+    def inlined(self, pc):
+        """ Returns the list of (inlined) functions at pc, innermost first """
+        return [func for func, _ in self.cache.get(pc, [])]
+
+    def line(self, pc):
+        """ Returns the source location of pc (file:line, without the path) """
+        entry = self.cache.get(pc, [])
+        if not entry:
+            return None
+        return entry[0][1].split("/")[-1]
+
+
+def parse_trace(lines, cores=None):
+    """
+    Parses the instruction trace
+
+    Parameters:
+    - lines: iterable of str, lines of the trace (all other lines are ignored)
+    - cores: set of core names to keep (e.g. {"pe0", "fc"}), or None to keep all
+
+    Returns: dict: core -> list of (time [ps], cycle, pc, mnemonic)
+    """
+    trace = defaultdict(list)
+    for line in lines:
+        match = _TRACE_RE.match(line)
+        if match is None:
+            continue
+        path = match.group(3)
+        if not path.endswith("/insn"):
+            continue
+        core = path.split("/")[-2]
+        if cores is not None and core not in cores:
+            continue
+        tokens = match.group(4).split()
+        for i, token in enumerate(tokens):
+            if _PC_RE.match(token):
+                mnemonic = tokens[i + 1] if i + 1 < len(tokens) else ""
+                trace[core].append((int(match.group(1)), int(match.group(2)), int(token, 16),
+                                    mnemonic))
+                break
+    return trace
+
+
+def _sleep_frame(pc, line_table):
+    """ Returns the name of the frame for the time spent sleeping at pc """
+    if line_table is not None:
+        for func in line_table.inlined(pc):
+            if "barrier" in func:
+                return "[barrier]"
+            if "dma" in func:
+                return "[dma wait]"
+    return "[wait]"
+
+
+def build_profile(trace, symbols, line_table=None, use_lines=False):
+    """
+    Reconstructs the call stack of every core, and computes the time spent in every stack
+
+    Parameters:
+    - trace: dict, as returned by parse_trace
+    - symbols: SymbolTable
+    - line_table: LineTable or None
+    - use_lines: if True, add the source line as leaf to every stack of the flame graph
+
+    Returns: (segments, collapsed)
+    - segments: dict: core -> list of (start [ps], end [ps], stack), consecutive instructions with
+                the same stack are merged.
+    - collapsed: dict: (core, stack...) -> cycles
+    """
+    if line_table is not None:
+        pcs = set()
+        for insns in trace.values():
+            pcs |= set(pc for _, _, pc, mnemonic in insns if use_lines or mnemonic == SLEEP_INSN)
+        line_table.resolve(pcs)
+
+    segments = {}
+    collapsed = defaultdict(int)
+    for core, insns in trace.items():
+        core_segments = []
+        stack = []
+        for i, (time, cycle, pc, mnemonic) in enumerate(insns):
+            if i + 1 < len(insns):
+                end_time, end_cycle = insns[i + 1][0], insns[i + 1][1]
+            else:
+                end_time, end_cycle = time + (time - insns[i - 1][0] if i > 0 else 1), cycle + 1
+
+            # update the call stack
+            func, start = symbols.lookup(pc)
+            if not stack:
+                stack = [func]
+            elif stack[-1] != func:
+                if pc == start:
+                    # function entry
+                    stack.append(func)
+                elif func in stack:
+                    # return to a function on the stack
+                    del stack[stack.index(func) + 1:]
+                else:
+                    # jump into another function (tail call, or unknown caller)
+                    stack[-1] = func
+
+            frame = tuple(stack)
+            if mnemonic == SLEEP_INSN:
+                frame = frame + (_sleep_frame(pc, line_table), )
+
+            # flame graph
+            leaf = frame
+            if use_lines and line_table is not None and mnemonic != SLEEP_INSN:
+                line = line_table.line(pc)
+                if line is not None:
+                    leaf = frame + (line, )
+            collapsed[(core, ) + leaf] += end_cycle - cycle
+
+            # timeline
+            if core_segments and core_segments[-1][2] == frame and core_segments[-1][1] == time:
+                core_segments[-1] = (core_segments[-1][0], end_time, frame)
+            else:
+                core_segments.append((time, end_time, frame))
+        segments[core] = core_segments
+    return segments, dict(collapsed)
+
+
+def chrome_trace(segments):
+    """
+    Generates the chrome trace events (complete events, properly nested) of all segments
+
+    Returns: dict, which can be stored as json
+    """
+    events = []
+    core_names = sorted(segments)
+    for tid, core in enumerate(core_names):
+        events.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": tid,
+                       "args": {"name": core}})
+        opened = []  # list of (name, start [ps])
+        last_end = None
+        for start, end, stack in segments[core] + [(None, None, ())]:
+            # close all frames, which are not part of the new stack (or at a gap in the trace)
+            common = 0
+            if start is not None and start == last_end:
+                while (common < len(opened) and common < len(stack) and
+                       opened[common][0] == stack[common]):
+                    common += 1
+            for name, frame_start in reversed(opened[common:]):
+                events.append({"name": name, "ph": "X", "pid": 0, "tid": tid,
+                               "ts": frame_start / 1e6, "dur": (last_end - frame_start) / 1e6})
+            del opened[common:]
+            if start is None:
+                break
+            for name in stack[common:]:
+                opened.append((name, start))
+            last_end = end
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def collapsed_stacks(collapsed):
+    """ Returns the collapsed stacks as str (one stack per line) """
+    lines = ["{} {}".format(";".join(stack), cycles)
+             for stack, cycles in sorted(collapsed.items()) if cycles > 0]
+    return "\n".join(lines) + "\n"
+
+
+def summary(collapsed, top=20):
+    """ Returns a str with the functions with the most (exclusive) cycles, summed over all cores """
+    per_func = defaultdict(int)
+    for stack, cycles in collapsed.items():
+        per_func[stack[-1]] += cycles
+    total = sum(per_func.values())
+    ret = "{:>12} {:>7}  {}\n".format("cycles", "%", "function")
+    for func, cycles in sorted(per_func.items(), key=lambda x: -x[1])[:top]:
+        ret += "{:>12} {:>6.2f}%  {}\n".format(cycles, 100 * cycles / max(total, 1), func)
+    return ret
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Converts GVSOC instruction traces into a timeline and flame graph")
+    parser.add_argument("trace", help="instruction trace of GVSOC (--trace=insn)")
+    parser.add_argument("elf", help="elf file of the program")
+    parser.add_argument("-c", "--chrome", default=None, help="output file for the chrome trace (json)")
+    parser.add_argument("-f", "--flame", default=None, help="output file for the collapsed stacks")
+    parser.add_argument("--cores", default=None, help="comma separated list of cores, e.g. pe0,pe1")
+    parser.add_argument("--lines", action="store_true", help="add the source line to the flame graph")
+    parser.add_argument("--nm", default=None, help="nm executable")
+    parser.add_argument("--addr2line", default=None, help="addr2line executable")
+    args = parser.parse_args()
+
+    cores = None if args.cores is None else set(args.cores.split(","))
+    with open(args.trace, "r") as _f:
+        insn_trace = parse_trace(_f, cores)
+
+    symbol_table = SymbolTable.from_elf(args.elf, args.nm)
+    lines_table = LineTable(args.elf, args.addr2line)
+    if not lines_table.available():
+        print("Warning: addr2line not found, wait time cannot be attributed to barriers or DMA")
+        lines_table = None
+
+    segs, stacks = build_profile(insn_trace, symbol_table, lines_table, args.lines)
+
+    if args.chrome is not None:
+        with open(args.chrome, "w") as _f:
+            json.dump(chrome_trace(segs), _f)
+    if args.flame is not None:
+        with open(args.flame, "w") as _f:
+            _f.write(collapsed_stacks(stacks))
+
+    print(summary(stacks))
@@ -200,6 +200,32 @@ class HeaderArray(HeaderEntry):
         return ret
 
 
+class HeaderIfdef(HeaderEntry):
+    """
+    Only declares and defines the elements if the macro is defined
+    """
+    def __init__(self, macro, elements, blank_line=True):
+        self.macro = macro
+        self.elements = elements
+        self.blank_line = blank_line
+
+    def header_str(self, with_c=False):
+        ret = "#ifdef {}\n".format(self.macro)
+        ret += "".join([element.header_str(with_c) for element in self.elements])
+        ret += "#endif//{}\n".format(self.macro)
+        if self.blank_line:
+            ret += "\n"
+        return ret
+
+    def source_str(self):
+        ret = "#ifdef {}\n".format(self.macro)
+        ret += "".join([element.source_str() for element in self.elements])
+        ret += "#endif//{}\n".format(self.macro)
+        if self.blank_line:
+            ret += "\n"
+        return ret
+
+
 class HeaderComment(HeaderEntry):
     def __init__(self, text, mode="//", blank_line=True):
         assert mode in ["//", "/*"]
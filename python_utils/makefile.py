@@ -35,7 +35,12 @@ FILES_IN_ROOT = {".git", ".gitignore", "src", "test", "doc", "data", "Makefile"}
 
 class Makefile:
     """ Makefile generation """
-    def __init__(self, project_root=None, use_dsp=True, opt_level=3):
+    def __init__(self, project_root=None, use_dsp=True, opt_level=3, cl_src_dir=None):
+        """
+        cl_src_dir: directory of the cluster sources (default: root/src/cl), e.g. a copy of the
+        cluster sources with a different generated net header. If it is set, it is added to the
+        include path.
+        """
         self.fc_sources = []
         self.cl_sources = []
         self.defines = []
@@ -54,6 +59,11 @@ class Makefile:
         else:
             current_files = set(os.listdir(self.project_root))
             assert FILES_IN_ROOT <= current_files
+        self.cl_include = cl_src_dir is not None
+        if cl_src_dir is None:
+            self.cl_src_dir = os.path.join(self.project_root, "src/cl")
+        else:
+            self.cl_src_dir = os.path.realpath(cl_src_dir)
 
     def add_fc_test_source(self, name):
         """ add test source file, located in current directory """
@@ -68,15 +78,22 @@ class Makefile:
         source_file = os.path.join(self.project_root, "src/fc", name)
         assert os.path.exists(source_file)
         assert source_file.endswith(".c")
-        self.cl_sources.append(source_file)
+        self.fc_sources.append(source_file)
 
     def add_cl_prog_source(self, name):
-        """ add source file from the actual program, starting at root/src/cl/ """
-        source_file = os.path.join(self.project_root, "src/cl", name)
+        """ add source file from the actual program, starting at root/src/cl/ (or cl_src_dir) """
+        source_file = os.path.join(self.cl_src_dir, name)
         assert os.path.exists(source_file)
         assert source_file.endswith(".c")
         self.cl_sources.append(source_file)
 
+    def add_host_prog_source(self, name):
+        """ add source file of the host programs, starting at root/src/host/ (only for the host) """
+        source_file = os.path.join(self.project_root, "src/host", name)
+        assert os.path.exists(source_file)
+        assert source_file.endswith(".c")
+        self.fc_sources.append(source_file)
+
     def add_define(self, name, value=None):
         """ Those defines will be passed to gcc with -Dname=value flag """
         assert name.isupper()
@@ -110,9 +127,15 @@ class Makefile:
         # add compiler flags
         ret += "\n".join(["PULP_CFLAGS += -D{}".format(define) for define in self.defines])
         ret += "\n\n"
+        if self.cl_include:
+            ret += "PULP_CFLAGS += -I{}\n\n".format(self.cl_src_dir)
 
-        # include the pulp sdk
+        # include the pulp sdk, or the host build with the platform "host"
+        ret += "ifneq (,$(findstring platform=host,$(PULP_CURRENT_CONFIG_ARGS)))\n"
+        ret += "include {}\n".format(os.path.join(self.project_root, "src/host/host.mk"))
+        ret += "else\n"
         ret += "include $(PULP_SDK_HOME)/install/rules/pulp_rt.mk\n"
+        ret += "endif\n"
         return ret
 
     def write(self):
@@ -0,0 +1,165 @@
+"""
+Binary model blob, which can be loaded at runtime (src/cl/net/blob.h) instead of the parameters
+compiled into net.c. The blob is generated by data/gen_net_header.py (-b).
+
+The blob starts with a header of 16 little endian 32bit words (magic, version, header_crc,
+total_size, num_sections, F1, F2, D, C, T, N, l3_factor, l5_factor, input_factor, flags, and the
+16bit values l1_result_bits and l2_pool_bits in the last word), followed by the section table (id, offset, size, crc for every section) and the data of all
+sections, aligned to 4 bytes. The checksums are CRC-32 (zlib.crc32).
+
+If FLAG_COMPRESSED is set, the weights of every section are stored as 4bit codes (see
+convert_torch_format.inq_compress), and expanded by net_blob_load. A compressed section contains
+two words (byte offset and number of the weights in the expanded section), followed by the data of
+the section before the weights, the codes (aligned to 4 bytes), and the data after the weights.
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/27"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import zlib
+import numpy as np
+
+import convert_torch_format as convert
+
+# must be equal to the definitions in src/cl/net/blob.h
+MAGIC = 0x4e474545
+VERSION = 5
+ALIGN = 4
+HEADER_WORDS = 16
+SECTION_WORDS = 4
+DIMS = ["F1", "F2", "D", "C", "T", "N"]
+SCALARS = ["l3_factor", "l5_factor", "input_factor"]
+FLAGS_WORD = 14
+BITS = ["l1_result_bits", "l2_pool_bits"]
+BITS_WORD = 15
+FLAG_COMPRESSED = 1
+
+# section name and data type, the index is the section id
+SECTIONS = [
+    ("net_l1_params", np.int32),
+    ("net_l2_params", np.int32),
+    ("net_l3_weight", np.int8),
+    ("net_l4_params", np.int32),
+    ("net_l5_params", np.int32),
+]
+
+
+def _align(size):
+    return (size + ALIGN - 1) // ALIGN * ALIGN
+
+
+def compress_section(raw, weight_offset, num_weights):
+    """ Compresses the weights (int8) of a section, which start at the byte weight_offset """
+    weights = np.frombuffer(raw[weight_offset:weight_offset + num_weights], dtype=np.int8)
+    codes = convert.inq_compress(weights).tobytes()
+    prefix = np.array([weight_offset, num_weights], dtype="<u4").tobytes()
+    return (prefix + raw[:weight_offset] + codes + b"\0" * (_align(len(codes)) - len(codes)) +
+            raw[weight_offset + _align(num_weights):])
+
+
+def decompress_section(raw):
+    """ Expands a compressed section (see compress_section) """
+    weight_offset, num_weights = np.frombuffer(raw[:8], dtype="<u4")
+    raw = raw[8:]
+    codes_len = (num_weights + 1) // 2
+    codes = np.frombuffer(raw[weight_offset:weight_offset + codes_len], dtype=np.uint8)
+    weights = convert.inq_decompress(codes, num_weights).astype(np.int8).tobytes()
+    return (raw[:weight_offset] + weights + b"\0" * (_align(num_weights) - num_weights) +
+            raw[weight_offset + _align(codes_len):])
+
+
+def encode(dims, scalars, sections, weights=None):
+    """
+    Generates the blob
+
+    Parameters:
+    - dims: dict with the network dimensions (keys: DIMS)
+    - scalars: dict with the scalar parameters (keys: SCALARS and BITS, the latter are
+               NET_L1_RESULT_BITS and NET_L2_POOL_BITS, see python_utils/value_range.py)
+    - sections: dict {name: np.array} with all arrays of SECTIONS
+    - weights: None, or dict {name: (byte offset, number of weights)} for every section, to store the
+               weights compressed (FLAG_COMPRESSED)
+
+    Returns: bytes
+    """
+    table_size = 4 * (HEADER_WORDS + SECTION_WORDS * len(SECTIONS))
+    offset = _align(table_size)
+    table = []
+    data = b""
+    for section_id, (name, dtype) in enumerate(SECTIONS):
+        raw = np.asarray(sections[name]).ravel().astype(np.dtype(dtype).newbyteorder("<")).tobytes()
+        if weights is not None:
+            raw = compress_section(raw, *weights[name])
+        table += [section_id, offset + len(data), len(raw), zlib.crc32(raw)]
+        data += raw + b"\0" * (_align(len(raw)) - len(raw))
+
+    total_size = offset + len(data)
+    header = [MAGIC, VERSION, 0, total_size, len(SECTIONS)]
+    header += [dims[k] for k in DIMS]
+    header += [scalars[k] & 0xffffffff for k in SCALARS]
+    header += [0] * (HEADER_WORDS - len(header))
+    header[FLAGS_WORD] = 0 if weights is None else FLAG_COMPRESSED
+    header[BITS_WORD] = scalars[BITS[0]] | scalars[BITS[1]] << 16
+    words = np.array(header + table, dtype="<u4")
+    words[2] = zlib.crc32(words.tobytes())
+    head = words.tobytes()
+    return head + b"\0" * (offset - len(head)) + data
+
+
+def decode(blob):
+    """
+    Decodes the blob (without checking the checksums), compressed sections are expanded
+
+    Returns: (dims, scalars, sections), see encode
+    """
+    words = np.frombuffer(blob[:4 * HEADER_WORDS], dtype="<u4")
+    assert words[0] == MAGIC and words[1] == VERSION
+    dims = {k: int(v) for k, v in zip(DIMS, words[5:5 + len(DIMS)])}
+    scalar_words = words[5 + len(DIMS):5 + len(DIMS) + len(SCALARS)].astype(np.uint32)
+    scalars = {k: int(v) for k, v in zip(SCALARS, scalar_words.view(np.int32))}
+    scalars.update({k: int(words[BITS_WORD] >> (16 * i)) & 0xffff for i, k in enumerate(BITS)})
+    table = np.frombuffer(blob[4 * HEADER_WORDS:4 * (HEADER_WORDS + SECTION_WORDS * words[4])],
+                          dtype="<u4").reshape(-1, SECTION_WORDS)
+    sections = {}
+    for section_id, offset, size, _ in table:
+        name, dtype = SECTIONS[section_id]
+        raw = blob[offset:offset + size]
+        if words[FLAGS_WORD] & FLAG_COMPRESSED:
+            raw = decompress_section(raw)
+        sections[name] = np.frombuffer(raw, dtype=np.dtype(dtype).newbyteorder("<"))
+    return dims, scalars, sections
+
+
+def write(filename, dims, scalars, sections, weights=None):
+    """ Writes the blob into a file, see encode """
+    with open(filename, "wb") as _f:
+        _f.write(encode(dims, scalars, sections, weights))
+
+
+def read(filename):
+    """ Reads the blob from a file, see decode """
+    with open(filename, "rb") as _f:
+        return decode(_f.read())
@@ -0,0 +1,157 @@
+"""
+Number theoretic transform (NTT), used to compute the convolution of layer 1 exactly on integers
+(src/cl/func/ntt.c, NTT_CONV in the Makefile).
+
+All values are residues modulo the prime P = 119 * 2^23 + 1, which is large enough to represent
+every result of layer 1 (|y| < 2^21 for filters up to 128 taps) without ambiguity. Multiplications
+are done in the Montgomery domain with R = 2^32: the twiddle factors and the filter spectra are
+stored multiplied by R, such that the data itself stays in the normal domain.
+
+The forward transform (decimation in frequency) takes the data in natural order and returns the
+spectrum in bit-reversed order, and the inverse transform (decimation in time) takes the spectrum in
+bit-reversed order. Thus, no permutation is necessary. The factor 1 / N of the inverse transform is
+contained in the filter spectra.
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/10"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import numpy as np
+
+# must be equal to the definitions in src/cl/func/functional.h
+PRIME = 998244353
+ROOT = 3
+R = 2 ** 32
+
+
+def ntt_len(filter_len):
+    """ Returns the transform length: the smallest power of two, which is at least 4 times the filter """
+    n = 1
+    while n < 4 * filter_len:
+        n *= 2
+    return n
+
+
+def twiddles(n, inverse=False):
+    """
+    Returns the n / 2 twiddle factors w^i in the Montgomery domain (w^i * R mod P), where w is the
+    n'th root of unity (or its inverse)
+    """
+    assert (PRIME - 1) % n == 0
+    w = pow(ROOT, (PRIME - 1) // n, PRIME)
+    if inverse:
+        w = pow(w, PRIME - 2, PRIME)
+    result = np.zeros(n // 2, dtype=np.int64)
+    value = R % PRIME
+    for i in range(n // 2):
+        result[i] = value
+        value = value * w % PRIME
+    return result
+
+
+def _mont_mul(a, b):
+    """ Montgomery multiplication (a * b / R mod P), like the device """
+    return np.asarray(a, dtype=object) * np.asarray(b, dtype=object) * pow(R, PRIME - 2, PRIME) % PRIME
+
+
+def forward(x):
+    """ Forward transform, x: array of residues (natural order), returns the bit-reversed spectrum """
+    a = np.array(x, dtype=object) % PRIME
+    n = len(a)
+    w = twiddles(n)
+    length = n // 2
+    while length >= 1:
+        step = n // (2 * length)
+        for start in range(0, n, 2 * length):
+            u = a[start:start + length].copy()
+            v = a[start + length:start + 2 * length].copy()
+            a[start:start + length] = (u + v) % PRIME
+            a[start + length:start + 2 * length] = _mont_mul((u - v) % PRIME, w[0:n // 2:step])
+        length //= 2
+    return a
+
+
+def inverse(x):
+    """ Inverse transform (without the factor 1 / N), x: bit-reversed spectrum """
+    a = np.array(x, dtype=object) % PRIME
+    n = len(a)
+    w = twiddles(n, inverse=True)
+    length = 1
+    while length < n:
+        step = n // (2 * length)
+        for start in range(0, n, 2 * length):
+            u = a[start:start + length].copy()
+            v = _mont_mul(a[start + length:start + 2 * length], w[0:n // 2:step])
+            a[start:start + length] = (u + v) % PRIME
+            a[start + length:start + 2 * length] = (u - v) % PRIME
+        length *= 2
+    return a
+
+
+def filter_spectrum(weight_reverse, n):
+    """
+    Returns the spectrum of the filter for the cross correlation with weight_reverse, scaled by 1 / n
+    and stored in the Montgomery domain.
+
+    Parameters:
+    - weight_reverse: np.array(shape: [K]), weights as used for func_xcorr
+    - n: transform length
+
+    Returns: np.array(shape: [n], dtype=int)
+    """
+    g = np.zeros(n, dtype=object)
+    g[:len(weight_reverse)] = np.asarray(weight_reverse)[::-1].astype(int)
+    spectrum = forward(g)
+    scale = pow(n, PRIME - 2, PRIME) * R % PRIME
+    return np.array(spectrum * scale % PRIME, dtype=np.int64)
+
+
+def scale_constant(n):
+    """ Returns the constant, to scale a spectrum on the device such that it matches filter_spectrum """
+    return pow(n, PRIME - 2, PRIME) * R * R % PRIME
+
+
+def xcorr(a, b, n=None):
+    """
+    Cross correlation in the valid range (like np.correlate(a, b, mode="valid")), computed with the
+    NTT and overlap-save, exactly like the device. Used as reference.
+    """
+    a = np.asarray(a).astype(int)
+    K = len(b)
+    n = ntt_len(K) if n is None else n
+    step = n - K + 1
+    spectrum = filter_spectrum(b, n)
+    out_len = len(a) - K + 1
+    result = np.zeros(out_len, dtype=int)
+    for start in range(0, out_len, step):
+        block = np.zeros(n, dtype=int)
+        part = a[start:start + n]
+        block[:len(part)] = part
+        y = inverse(_mont_mul(forward(block), spectrum))
+        y = np.array([v - PRIME if v > PRIME // 2 else v for v in y], dtype=int)
+        num = min(step, out_len - start)
+        result[start:start + num] = y[K - 1:K - 1 + num]
+    return result
@@ -0,0 +1,201 @@
+"""
+Folds a linear preprocessing of the EEG (re-referencing, gain calibration, spatial filters and FIR
+filters) into the weights of layer 1 and layer 2, such that it costs no cycles on the device.
+
+The preprocessing is described by a specification (dict, or json file) with a list of steps, which
+are applied in this order to the input x[C, T]:
+
+    {"steps": [{"type": "car"},                          # common average reference
+               {"type": "gain", "gain": [g_0, ...]},     # per-channel gain, C values
+               {"type": "spatial", "matrix": [[...]]},   # arbitrary spatial filter, [C, C]
+               {"type": "fir", "taps": [h_0, ...]}],     # FIR filter in time (mode=same)
+     "input_scale": 1.0,                                 # optional: overwrite quant1
+     "intermediate_scale": 1.0}                          # optional: overwrite quant2
+
+All spatial steps are combined to a single matrix S, and all FIR filters to a single filter h. Since
+layer 1 is a convolution in time (the same for all channels) and layer 2 a linear combination of
+the channels, the network computes on the raw input x:
+
+    layer 1: w1' = w1 * h                      (truncated to the 64 taps of layer 1)
+    layer 2: w2' = w2 S, and the offset of batch_norm2 is corrected, because the offset of
+             batch_norm1 is no longer multiplied by S
+
+The weights of a layer, which is affected by the preprocessing, are quantized again with a new
+scale, and the requantization factors are derived from it. The result is not bit-exact to the unfolded pipeline (truncation of the filter, rounding and
+clipping after layer 1, and the zero padding at the border of the window). Use batch_eval.py with
+-p to report the difference.
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/04"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import json
+import numpy as np
+
+import convert_torch_format as convert
+import functional as F
+
+STEP_TYPES = ["car", "gain", "spatial", "fir"]
+
+
+def load_spec(spec):
+    """ Returns the specification as dict (spec can be a filename, a dict or None) """
+    if spec is None or isinstance(spec, dict):
+        return spec
+    with open(spec, "r") as _f:
+        return json.load(_f)
+
+
+def _step_matrix(step, C):
+    """ returns the spatial matrix [C, C] of a single step """
+    if step["type"] == "car":
+        return np.eye(C) - np.ones((C, C)) / C
+    if step["type"] == "gain":
+        gain = np.asarray(step["gain"], dtype=float)
+        assert gain.shape == (C, ), "gain must have {} values".format(C)
+        return np.diag(gain)
+    matrix = np.asarray(step["matrix"], dtype=float)
+    assert matrix.shape == (C, C), "spatial matrix must be of shape [{0}, {0}]".format(C)
+    return matrix
+
+
+def spatial_matrix(spec, C):
+    """ Returns the combined matrix S [C, C] of all spatial steps (x' = S x) """
+    S = np.eye(C)
+    for step in spec["steps"]:
+        assert step["type"] in STEP_TYPES, "Unknown step: {}".format(step["type"])
+        if step["type"] != "fir":
+            S = _step_matrix(step, C) @ S
+    return S
+
+
+def fir_taps(spec):
+    """ Returns the combined filter h of all FIR steps """
+    h = np.ones(1)
+    for step in spec["steps"]:
+        if step["type"] == "fir":
+            h = np.convolve(h, np.asarray(step["taps"], dtype=float))
+    return h
+
+
+def apply(spec, x):
+    """
+    Applies the preprocessing on the input (floating point, unfolded), like the original pipeline
+
+    Parameters:
+    - spec: specification (see above)
+    - x: np.array(shape: [..., C, T], dtype=float)
+
+    Returns: np.array(shape: [..., C, T], dtype=float)
+    """
+    x = np.asarray(x, dtype=float)
+    C = x.shape[-2]
+    for step in spec["steps"]:
+        assert step["type"] in STEP_TYPES, "Unknown step: {}".format(step["type"])
+        if step["type"] == "fir":
+            taps = np.asarray(step["taps"], dtype=float)
+            x = F.conv_time(x, taps[np.newaxis, :])[..., 0, :, :]
+        else:
+            x = np.einsum("dc,...ct->...dt", _step_matrix(step, C), x)
+    return x
+
+
+def _requantize(weights, num_levels):
+    """
+    Returns the weights and the scale factor, such that the weights lie exactly on the quantization
+    grid (convert.inq_conv2d quantizes them again, by truncating towards zero)
+    """
+    val_range = (num_levels - 1) / 2
+    scale = np.abs(weights).max()
+    weights_int = np.round(weights / scale * val_range)
+    # move the value slightly away from zero, to be robust against floating point errors
+    weights = (weights_int + 1e-3 * np.sign(weights_int)) * scale / val_range
+    return weights, scale
+
+
+def fold(net, spec, num_levels=255):
+    """
+    Folds the preprocessing into the network parameters
+
+    Parameters:
+    - net: dict, contains all network parameters (net.npz)
+    - spec: specification (see above), dict or filename
+    - num_levels: int, number of quantization levels
+
+    Returns: (net, dropped)
+    - net: dict, contains all (modified) network parameters
+    - dropped: float, relative energy of the filter taps of layer 1, which were truncated
+    """
+    spec = load_spec(spec)
+    net = {key: np.array(net[key]) for key in net.keys()}
+
+    w1 = net["conv1.weightFrozen"]  # [F1, 1, 1, K]
+    w2 = net["conv2.weightFrozen"]  # [F2, 1, C, 1]
+    F1, K = w1.shape[0], w1.shape[-1]
+    F2, C = w2.shape[0], w2.shape[2]
+
+    # layer 1: torch computes y[t] = sum_k w1[k] x[t + k - K//2 + 1], and the filter h (with mode
+    # same) x'[t] = sum_j h[j] x[t + L//2 - j]. Thus, w1'[m] = sum_j w1[m + j - L//2] h[j]
+    h = fir_taps(spec)
+    L = h.shape[0]
+    dropped = 0.0
+    if not np.array_equal(h, np.ones(1)):
+        w1_full = np.zeros((F1, K + L - 1))
+        for j in range(L):
+            w1_full[:, L - 1 - j:L - 1 - j + K] += w1[:, 0, 0, :] * h[j]
+        # the full filter starts at m = L//2 - (L - 1)
+        start = L - 1 - L // 2
+        w1_folded = w1_full[:, start:start + K]
+        dropped = 1 - (w1_folded ** 2).sum() / (w1_full ** 2).sum()
+        w1_folded, scale = _requantize(w1_folded, num_levels)
+        net["conv1.weightFrozen"] = np.reshape(w1_folded, w1.shape)
+        net["conv1.sParam"] = np.array([scale])
+
+    # layer 2: y[f] = sum_c w2[f, c] x[c]
+    S = spatial_matrix(spec, C)
+    if not np.array_equal(S, np.eye(C)):
+        w2_mat = w2[:, 0, :, 0]
+        w2_folded = w2_mat @ S
+
+        # layer 2 sees the offset of batch_norm1 without S applied, correct the offset of
+        # batch_norm2
+        _, bn_offset_1 = convert.batch_norm(net, "batch_norm1")
+        bn_scale_2, _ = convert.batch_norm(net, "batch_norm2")
+        correction = w2_mat @ (1 - S.sum(axis=1))
+        correction *= bn_offset_1[np.arange(F2) // (F2 // F1)] * bn_scale_2
+        net["batch_norm2.bias"] = net["batch_norm2.bias"] + correction
+
+        w2_folded, scale = _requantize(w2_folded, num_levels)
+        net["conv2.weightFrozen"] = np.reshape(w2_folded, w2.shape)
+        net["conv2.sParam"] = np.array([scale])
+
+    # the range of the raw input (and the output of layer 1) may differ from the preprocessed one
+    if "input_scale" in spec:
+        net["quant1.absMaxValue"] = np.array([spec["input_scale"]], dtype=float)
+    if "intermediate_scale" in spec:
+        net["quant2.absMaxValue"] = np.array([spec["intermediate_scale"]], dtype=float)
+
+    return net, dropped
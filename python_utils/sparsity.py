@@ -0,0 +1,187 @@
+"""
+Analyzes the zero weights of the quantized network, and estimates the savings of skipping them on
+the device. The kernels do not skip any weights, the report shows if it would pay off.
+
+The fused layer is parallelized over the spectral filters F1: Core f computes the convolution of
+layer 1 with filter f for all channels, and the output channels 2f and 2f+1 of layer 2. If both
+weights of layer 2 of a channel c are zero, the convolution of this channel (64 MACs per sample)
+and its contribution to layer 2 could be skipped. The schedule of core f contains all remaining
+channels.
+
+The report also lists the zero weights in groups, which would match the SIMD instructions (all-zero
+groups of 4 taps in layer 1 and all-zero groups of 4 input channels in layer 4). The cycles are estimated with the number of instructions in the inner loops
+of the kernels. Since all cores wait for the slowest one, the latency is only reduced by the
+minimum of the saved cycles over all cores (critical path).
+
+Usage:
+    python3 sparsity.py                             # report of ../data/net.npz
+    python3 sparsity.py -n net.npz -c config.json
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/08"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import json
+import numpy as np
+
+import convert_torch_format as convert
+
+DEFAULT_CONFIG_JSON = "../data/config.json"
+DEFAULT_NET_NPZ = "../data/net.npz"
+
+# cycles of the inner loops (see src/cl/net/fused_layer_1_2.c and src/cl/net/layer4.c)
+CYCLES_L1_GROUP = 9       # 4 taps for 4 outputs: 5 loads and 4 sdotp
+CYCLES_L1_CHANNEL = 12    # setup of the hardware loop and storing the 4 results
+CYCLES_L2_CHANNEL = 16    # 6 loads, 8 MACs and the pointer increments
+CYCLES_L4_GROUP = 3       # 2 loads and 1 sdotp
+
+
+def channel_schedule(w2, F1, D):
+    """
+    Computes the schedule of the fused layer 1+2
+
+    Parameters:
+    - w2: np.array(shape: [F2, C]), integer weights of layer 2
+    - F1, D: int, number of spectral filters and depth multiplier (F2 = F1 * D)
+
+    Returns: (lengths, schedule)
+    - lengths: np.array(shape: [F1], dtype=int), number of channels computed by core f
+    - schedule: np.array(shape: [F1, C], dtype=int), channels computed by core f (in increasing
+                order), padded with zeros
+    """
+    C = w2.shape[-1]
+    active = np.abs(np.reshape(w2, (F1, D, C))).sum(axis=1) != 0
+    lengths = active.sum(axis=1)
+    schedule = np.zeros((F1, C), dtype=int)
+    for f in range(F1):
+        channels = np.flatnonzero(active[f])
+        schedule[f, :len(channels)] = channels
+    return lengths, schedule
+
+
+def zero_groups(weight, group=4):
+    """ Returns the number of all-zero groups of the last dimension, for every row """
+    weight = np.reshape(weight, (weight.shape[0], -1))
+    pad = -weight.shape[-1] % group
+    weight = np.pad(weight, ((0, 0), (0, pad)))
+    return (np.abs(weight.reshape(weight.shape[0], -1, group)).sum(axis=-1) == 0).sum(axis=-1)
+
+
+def analyze(net, net_params):
+    """
+    Analyzes the zero weights of layer 1, 2 and 4
+
+    Parameters:
+    - net: dict, contains all network parameters (net.npz)
+    - net_params: dict, network dimensions (config.json: indiv.net.params)
+
+    Returns: list of dict (one per layer) with the keys: name, macs, zeros (fraction of zero weights),
+             skipped (MACs skipped with a schedule of the channels), cycles (saved cycles over all
+             cores), critical (saved cycles on the critical path), and unused (MACs with zero
+             weights, which are computed anyway)
+    """
+    F1, F2, D, C = net_params["F1"], net_params["F2"], net_params["D"], net_params["C"]
+    T8 = net_params["T"] // 8
+    T64 = net_params["T"] // 64
+    # number of calls of the layer 1 kernel (4 samples each) per core
+    num_calls = T8 * 8 // 4
+
+    w1, _ = convert.inq_conv2d(net, "conv1")
+    w1 = w1.reshape(F1, -1)
+    w2, _ = convert.inq_conv2d(net, "conv2")
+    w2 = w2.reshape(F2, C)
+    w4, _ = convert.inq_conv2d(net, "sep_conv2")
+    w4 = w4.reshape(F2, F2)
+    K = w1.shape[-1]
+
+    lengths, _ = channel_schedule(w2, F1, D)
+    skipped_ch = C - lengths
+
+    # layer 1: the schedule skips entire channels, the 4-tap groups are not skipped
+    l1_skipped = skipped_ch * T8 * 8 * K
+    l1_cycles = skipped_ch * num_calls * (CYCLES_L1_CHANNEL + CYCLES_L1_GROUP * K // 4)
+    l1_groups = zero_groups(w1)
+    layer1 = {"name": "layer 1",
+              "macs": F1 * C * T8 * 8 * K,
+              "zeros": float((w1 == 0).mean()),
+              "skipped": int(l1_skipped.sum()),
+              "cycles": int(l1_cycles.sum()),
+              "critical": int(l1_cycles.min()),
+              "unused": int(((w1 == 0).sum(axis=1) * (C - skipped_ch) * T8 * 8).sum()),
+              "note": "{} all-zero 4-tap groups".format(int(l1_groups.sum()))}
+
+    # layer 2: both outputs of a core skip the same channels
+    l2_cycles = skipped_ch * num_calls * CYCLES_L2_CHANNEL
+    layer2 = {"name": "layer 2",
+              "macs": F2 * C * T8 * 8,
+              "zeros": float((w2 == 0).mean()),
+              "skipped": int((skipped_ch * D * T8 * 8).sum()),
+              "cycles": int(l2_cycles.sum()),
+              "critical": int(l2_cycles.min()),
+              "unused": int(((w2 == 0).sum() - (skipped_ch * D).sum()) * T8 * 8),
+              "note": "skipped channels per core: {}".format(list(skipped_ch))}
+
+    # layer 4: the kernel computes the dot product with SIMD, over groups of 4 input channels
+    l4_groups = zero_groups(w4)
+    layer4 = {"name": "layer 4",
+              "macs": F2 * F2 * T64 * 8,
+              "zeros": float((w4 == 0).mean()),
+              "skipped": 0,
+              "cycles": 0,
+              "critical": 0,
+              "unused": int((w4 == 0).sum() * T64 * 8),
+              "note": "{} all-zero 4-channel groups ({} cycles)".format(
+                  int(l4_groups.sum()), int(l4_groups.sum()) * T64 * 8 * CYCLES_L4_GROUP)}
+
+    return [layer1, layer2, layer4]
+
+
+def print_report(layers):
+    """ Prints the result of analyze """
+    print("{:>8} {:>10} {:>8} {:>10} {:>10} {:>10} {:>10}  {}".format(
+        "", "MACs", "zeros", "skipped", "unused", "cycles", "critical", "note"))
+    for l in layers:
+        print("{:>8} {:>10} {:>7.1f}% {:>10} {:>10} {:>10} {:>10}  {}".format(
+            l["name"], l["macs"], 100 * l["zeros"], l["skipped"], l["unused"], l["cycles"],
+            l["critical"], l["note"]))
+    print("(skipped: MACs skipped with a schedule of the channels, unused: remaining MACs with zero weights, "
+          "cycles: estimated cycles saved over all cores, critical: on the slowest core)")
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Reports the zero weights, which can be skipped on the device")
+    parser.add_argument("-n", "--net", help="numpy file containing the network",
+                        default=DEFAULT_NET_NPZ)
+    parser.add_argument("-c", "--config", help="configuration file name",
+                        default=DEFAULT_CONFIG_JSON)
+    args = parser.parse_args()
+
+    with open(args.config, "r") as _f:
+        config = json.load(_f)
+
+    print_report(analyze(np.load(args.net), config["indiv"]["net"]["params"]))
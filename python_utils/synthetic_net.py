@@ -0,0 +1,292 @@
+"""
+Generates random, but valid, quantized EEGNet models of arbitrary shape.
+
+The generated files (net.npz and config.json) have exactly the same layout as the files exported
+from QuantLab, such that they are accepted by data/gen_net_header.py and by the GoldenModel. The
+weights are drawn from the INQ grid (powers of two of the scale factor), the batch norm statistics
+and the activation scales (absMaxValue) are calibrated with a floating point forward pass on random
+data, such that the integer network neither saturates nor collapses to zero.
+
+Usage:
+    python3 synthetic_net.py -C 64 -T 1125 --F1 8 --D 2 -N 4 -o /tmp/synth
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/18"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import json
+import os
+import numpy as np
+from numpy.lib.stride_tricks import as_strided
+
+NUM_LEVELS = 255
+BN_EPSILON = 0.001
+
+# number of INQ exponents (weights are +-s * 2^-k, k in [0, INQ_NUM_EXP))
+INQ_NUM_EXP = 7
+# probability that a weight is exactly zero
+INQ_ZERO_PROB = 0.15
+# percentile used to calibrate the activation scales
+CALIB_PERCENTILE = 99.9
+# number of random trials used for calibration
+CALIB_TRIALS = 8
+
+
+def _inq_weights(shape, scale, rng, zero_prob=INQ_ZERO_PROB):
+    """
+    Draws random weights on the INQ grid: {0} u {+-scale * 2^-k}.
+    Those values are mapped exactly to the integers {0, +-127, +-63, +-31, ...} by quantize_to_int.
+    """
+    exp = rng.randint(0, INQ_NUM_EXP, shape)
+    sign = rng.choice([-1.0, 1.0], shape)
+    weight = sign * scale * np.power(2.0, -exp)
+    weight[rng.rand(*shape) < zero_prob] = 0
+    return weight.astype(np.float32)
+
+
+def _conv_time(x, w, pad_start, pad_end):
+    """
+    Cross correlation along the last axis (like torch), with zero padding
+
+    Parameters:
+    - x: np.array of shape [B, K, T] (float)
+    - w: np.array of shape [K, L] (float), one filter per row of x
+    """
+    B, K, T = x.shape
+    L = w.shape[-1]
+    x_pad = np.zeros((B, K, T + pad_start + pad_end), dtype=x.dtype)
+    x_pad[:, :, pad_start:pad_start + T] = x
+    s = x_pad.strides
+    win = as_strided(x_pad, shape=(B, K, T, L), strides=(s[0], s[1], s[2], s[2]), writeable=False)
+    return np.einsum("bktl,kl->bkt", win, w)
+
+
+def _batch_norm_calibrate(y, rng):
+    """
+    Returns BN statistics (mean, var, gamma, beta), such that the output of y is roughly normalized.
+    y must be of shape [B, K, ...], the channel axis is 1.
+    """
+    axes = tuple(i for i in range(y.ndim) if i != 1)
+    K = y.shape[1]
+    mean = y.mean(axis=axes)
+    var = y.var(axis=axes) + BN_EPSILON
+    mean = mean + rng.randn(K) * 0.1 * np.sqrt(var)
+    var = var * rng.uniform(0.8, 1.25, K)
+    gamma = rng.uniform(0.5, 1.5, K)
+    beta = rng.randn(K) * 0.25
+    return (mean.astype(np.float32), var.astype(np.float32),
+            gamma.astype(np.float32), beta.astype(np.float32))
+
+
+def _apply_bn(y, mean, var, gamma, beta):
+    shape = [1] * y.ndim
+    shape[1] = -1
+    scale = (gamma / np.sqrt(var + BN_EPSILON)).reshape(shape)
+    offset = (beta - mean * gamma / np.sqrt(var + BN_EPSILON)).reshape(shape)
+    return y * scale + offset
+
+
+def _abs_max(y):
+    """ Returns the activation scale (absMaxValue) used to quantize y """
+    val = np.percentile(np.abs(y), CALIB_PERCENTILE)
+    if val <= 0:
+        val = np.abs(y).max()
+    if val <= 0:
+        val = 1.0
+    return np.array([val], dtype=np.float32)
+
+
+def _quant(y, scale):
+    """ Fake-quantizes y to the 255 levels in [-scale, scale] (rounds towards zero) """
+    r = (NUM_LEVELS - 1) / 2
+    return np.trunc(np.clip(y / scale, -1, 1) * r) / r * scale
+
+
+def gen_synthetic_net(C=22, T=1125, F1=8, D=2, F2=None, N=4, seed=0, input_std=1.0,
+                      zero_prob=INQ_ZERO_PROB):
+    """
+    Generates a random quantized EEGNet
+
+    Parameters:
+    - C, T, F1, D, F2, N: network dimensions (F2 defaults to F1 * D)
+    - seed: random seed, the same seed always generates the same network
+    - input_std: standard deviation of the (gaussian) input data used for calibration
+    - zero_prob: probability of a weight being zero
+
+    Returns: net, config, x
+    - net: dict, containing all parameters, as stored in net.npz
+    - config: dict, as stored in config.json
+    - x: np.array of shape [CALIB_TRIALS, C, T], the float data used for calibration
+    """
+    if F2 is None:
+        F2 = F1 * D
+    assert F2 == F1 * D, "F2 must be equal to F1 * D"
+    assert T >= 64, "T must be at least 64"
+
+    rng = np.random.RandomState(seed)
+    net = {}
+
+    # input
+    x = (rng.randn(CALIB_TRIALS, C, T) * input_std).astype(np.float32)
+    s_in = _abs_max(x)
+    net["quant1.absMaxValue"] = s_in
+    a = _quant(x, s_in[0])
+
+    # Layer 1: temporal convolution + BN
+    s_w = np.array([rng.uniform(0.25, 1.0)], dtype=np.float32)
+    w = _inq_weights((F1, 1, 1, 64), s_w[0], rng, zero_prob)
+    net["conv1.weightFrozen"] = w
+    net["conv1.sParam"] = s_w
+    y = np.stack([_conv_time(a, np.repeat(w[k:k + 1, 0, 0, :], C, axis=0), 31, 32)
+                  for k in range(F1)], axis=1)
+    bn = _batch_norm_calibrate(y, rng)
+    for key, val in zip(["running_mean", "running_var", "weight", "bias"], bn):
+        net["batch_norm1.{}".format(key)] = val
+    y = _apply_bn(y, *bn)
+    s_act = _abs_max(y)
+    net["quant2.absMaxValue"] = s_act
+    a = _quant(y, s_act[0])
+
+    # Layer 2: depthwise spatial convolution + BN + ReLU + pool
+    s_w = np.array([rng.uniform(0.25, 1.0)], dtype=np.float32)
+    w = _inq_weights((F2, 1, C, 1), s_w[0], rng, zero_prob)
+    net["conv2.weightFrozen"] = w
+    net["conv2.sParam"] = s_w
+    y = np.einsum("bkct,kc->bkt", a[:, np.arange(F2) // D], w[:, 0, :, 0])
+    bn = _batch_norm_calibrate(y, rng)
+    for key, val in zip(["running_mean", "running_var", "weight", "bias"], bn):
+        net["batch_norm2.{}".format(key)] = val
+    y = np.maximum(_apply_bn(y, *bn), 0)
+    y = y[:, :, :(T // 8) * 8].reshape(CALIB_TRIALS, F2, T // 8, 8).mean(axis=-1)
+    s_act = _abs_max(y)
+    net["quant3.absMaxValue"] = s_act
+    a = _quant(y, s_act[0])
+
+    # Layer 3: depthwise temporal convolution
+    s_w = np.array([rng.uniform(0.25, 1.0)], dtype=np.float32)
+    w = _inq_weights((F2, 1, 1, 16), s_w[0], rng, zero_prob)
+    net["sep_conv1.weightFrozen"] = w
+    net["sep_conv1.sParam"] = s_w
+    y = _conv_time(a, w[:, 0, 0, :], 7, 8)
+    s_act = _abs_max(y)
+    net["quant4.absMaxValue"] = s_act
+    a = _quant(y, s_act[0])
+
+    # Layer 4: pointwise convolution + BN + ReLU + pool
+    s_w = np.array([rng.uniform(0.25, 1.0)], dtype=np.float32)
+    w = _inq_weights((F2, F2, 1, 1), s_w[0], rng, zero_prob)
+    net["sep_conv2.weightFrozen"] = w
+    net["sep_conv2.sParam"] = s_w
+    y = np.einsum("bjt,kj->bkt", a, w[:, :, 0, 0])
+    bn = _batch_norm_calibrate(y, rng)
+    for key, val in zip(["running_mean", "running_var", "weight", "bias"], bn):
+        net["batch_norm3.{}".format(key)] = val
+    y = np.maximum(_apply_bn(y, *bn), 0)
+    T64 = (T // 8) // 8
+    y = y[:, :, :T64 * 8].reshape(CALIB_TRIALS, F2, T64, 8).mean(axis=-1)
+    s_act = _abs_max(y)
+    net["quant5.absMaxValue"] = s_act
+    a = _quant(y, s_act[0])
+
+    # Layer 5: linear layer
+    s_w = np.array([rng.uniform(0.25, 1.0)], dtype=np.float32)
+    w = _inq_weights((N, F2 * T64), s_w[0], rng, zero_prob)
+    bias = _inq_weights((N, ), s_w[0], rng, zero_prob) * 0.0625
+    net["fc.weightFrozen"] = w
+    net["fc.bias"] = bias
+    net["fc.sParam"] = s_w
+    y = a.reshape(CALIB_TRIALS, -1) @ w.T + bias
+    net["quant6.absMaxValue"] = _abs_max(y)
+
+    config = {
+        "indiv": {
+            "net": {
+                "class": "EEGNet",
+                "params": {
+                    "F1": F1,
+                    "F2": F2,
+                    "D": D,
+                    "C": C,
+                    "T": T,
+                    "N": N,
+                    "weightInqNumLevels": NUM_LEVELS,
+                    "actSTENumLevels": NUM_LEVELS,
+                    "floorToZero": True
+                }
+            }
+        },
+        "synthetic": {"seed": seed}
+    }
+
+    return net, config, x
+
+
+def write_synthetic_net(output_dir, net_file="net.npz", config_file="config.json",
+                        input_file=None, **params):
+    """
+    Generates a random network (see gen_synthetic_net) and stores it in output_dir
+
+    Parameters:
+    - output_dir: directory, where the files should be stored (created if it does not exist)
+    - net_file: filename of the npz file containing the weights
+    - config_file: filename of the json file containing the configuration
+    - input_file: if not None, store the calibration data (key "input", shape [B, C, T])
+    - params: parameters passed to gen_synthetic_net
+
+    Returns: (net_path, config_path)
+    """
+    net, config, x = gen_synthetic_net(**params)
+    os.makedirs(output_dir, exist_ok=True)
+    net_path = os.path.join(output_dir, net_file)
+    config_path = os.path.join(output_dir, config_file)
+    np.savez(net_path, **net)
+    with open(config_path, "w") as _f:
+        json.dump(config, _f, indent=4)
+    if input_file is not None:
+        np.savez(os.path.join(output_dir, input_file), input=x)
+    return net_path, config_path
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Generates a random quantized EEGNet (net.npz and config.json)")
+    parser.add_argument("-o", "--output", help="output directory", default=".")
+    parser.add_argument("-C", type=int, help="number of EEG channels", default=22)
+    parser.add_argument("-T", type=int, help="number of time samples", default=1125)
+    parser.add_argument("-N", type=int, help="number of classes", default=4)
+    parser.add_argument("--F1", type=int, help="number of temporal filters", default=8)
+    parser.add_argument("--D", type=int, help="depth multiplier", default=2)
+    parser.add_argument("--F2", type=int, help="number of pointwise filters (F1 * D)", default=None)
+    parser.add_argument("-s", "--seed", type=int, help="random seed", default=0)
+    parser.add_argument("-z", "--zero-prob", type=float, help="probability of zero weights",
+                        default=INQ_ZERO_PROB)
+    parser.add_argument("-i", "--input", help="also store the calibration data in this npz file",
+                        default=None)
+    args = parser.parse_args()
+
+    write_synthetic_net(args.output, input_file=args.input, C=args.C, T=args.T, F1=args.F1,
+                        D=args.D, F2=args.F2, N=args.N, seed=args.seed, zero_prob=args.zero_prob)
@@ -0,0 +1,266 @@
+"""
+Decodes the telemetry dump of the FC (src/fc/telemetry.h, enabled with TELEMETRY in the Makefile)
+and computes latency statistics: histogram, percentiles and jitter of the total and per-layer
+cycles, as well as the jitter of the period between two inferences.
+
+The dump is a sequence of 32bit words, printed in hex on lines starting with "#TLM ". All other
+lines of the UART output (or of the GVSOC output) are ignored, and a single log may contain
+multiple dumps (e.g. one per sweep in POWER mode).
+
+Usage:
+    python3 telemetry.py uart.log -f 100             # statistics of the last dump, cluster at 100MHz
+    python3 telemetry.py uart.log --all --csv out.csv
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/24"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import csv
+import numpy as np
+
+# must be equal to the definitions in src/fc/telemetry.h
+MAGIC = 0x54454c45
+VERSION = 1
+LINE_PREFIX = "#TLM "
+HEADER_WORDS = 4
+MASK = 0xffffffff
+
+
+class TelemetryError(Exception):
+    """ Raised if the dump is corrupted """
+
+
+def encode_dump(records, total=None, num_layers=5, line_words=16):
+    """
+    Generates the dump like the FC (used for testing)
+
+    Parameters:
+    - records: list of dict with the keys seq, timestamp, cycles and layer_cycles (list)
+    - total: total number of committed records (default: len(records))
+    - num_layers: number of layers in every record
+    - line_words: number of words per line
+
+    Returns: list of str (lines)
+    """
+    if total is None:
+        total = len(records)
+    words = [MAGIC, (VERSION << 16) | (num_layers << 8) | (3 + num_layers), total, len(records)]
+    for record in records:
+        assert len(record["layer_cycles"]) == num_layers
+        words += [record["seq"], record["timestamp"], record["cycles"]]
+        words += list(record["layer_cycles"])
+    words = [w & MASK for w in words]
+    words.append(sum(words) & MASK)
+    return [LINE_PREFIX + "".join("{:08x}".format(w) for w in words[i:i + line_words])
+            for i in range(0, len(words), line_words)]
+
+
+def _parse_words(lines):
+    """ Returns all words of all dump lines, as a list of int """
+    words = []
+    for line in lines:
+        line = line.strip()
+        if not line.startswith(LINE_PREFIX):
+            continue
+        payload = line[len(LINE_PREFIX):].strip()
+        if len(payload) % 8 != 0:
+            raise TelemetryError("Line length is not a multiple of 8: {}".format(line))
+        words += [int(payload[i:i + 8], 16) for i in range(0, len(payload), 8)]
+    return words
+
+
+def decode(lines):
+    """
+    Decodes all dumps in the output
+
+    Parameters:
+    - lines: iterable of str (e.g. an open file)
+
+    Returns: list of dumps, every dump is a dict with the keys: version, num_layers, total
+             (number of records committed since the start) and records (list of dict with the keys
+             seq, timestamp, cycles, layer_cycles). The records are sorted by seq.
+    """
+    words = _parse_words(lines)
+    dumps = []
+    pos = 0
+    while pos < len(words):
+        if words[pos] != MAGIC:
+            raise TelemetryError("Expected magic number at word {}".format(pos))
+        if pos + HEADER_WORDS > len(words):
+            raise TelemetryError("Dump is truncated")
+        info, total, num_records = words[pos + 1:pos + HEADER_WORDS]
+        version, num_layers, record_words = info >> 16, (info >> 8) & 0xff, info & 0xff
+        if version != VERSION:
+            raise TelemetryError("Unsupported version: {}".format(version))
+        if record_words != 3 + num_layers:
+            raise TelemetryError("Invalid record size: {}".format(record_words))
+
+        end = pos + HEADER_WORDS + num_records * record_words
+        if end + 1 > len(words):
+            raise TelemetryError("Dump is truncated")
+        if sum(words[pos:end]) & MASK != words[end]:
+            raise TelemetryError("Checksum mismatch in dump at word {}".format(pos))
+
+        records = []
+        for start in range(pos + HEADER_WORDS, end, record_words):
+            rec = words[start:start + record_words]
+            records.append({"seq": rec[0], "timestamp": rec[1], "cycles": rec[2],
+                            "layer_cycles": rec[3:]})
+        dumps.append({"version": version, "num_layers": num_layers, "total": total,
+                      "records": sorted(records, key=lambda r: r["seq"])})
+        pos = end + 1
+    return dumps
+
+
+def _jitter_stats(values):
+    """ returns a dict with mean, std, min, max, peak-to-peak jitter and percentiles """
+    values = np.asarray(values, dtype=float)
+    if values.size == 0:
+        return None
+    return {"n": int(values.size),
+            "mean": float(values.mean()),
+            "std": float(values.std()),
+            "min": float(values.min()),
+            "max": float(values.max()),
+            "jitter": float(values.max() - values.min()),
+            "p50": float(np.percentile(values, 50)),
+            "p90": float(np.percentile(values, 90)),
+            "p99": float(np.percentile(values, 99))}
+
+
+def statistics(records):
+    """
+    Computes the latency statistics
+
+    Parameters:
+    - records: list of records, as returned by decode
+
+    Returns: dict with the keys:
+             - cycles: statistics (see _jitter_stats) of the total cycles
+             - layers: list of statistics of the cycles for every layer
+             - period: statistics of the time between two consecutive inferences in us (only
+                       consecutive sequence numbers are considered), or None
+             - lost: number of missing sequence numbers between the first and the last record
+    """
+    cycles = [r["cycles"] for r in records]
+    num_layers = len(records[0]["layer_cycles"]) if records else 0
+    layers = [_jitter_stats([r["layer_cycles"][k] for r in records]) for k in range(num_layers)]
+    periods = [(b["timestamp"] - a["timestamp"]) & MASK for a, b in zip(records, records[1:])
+               if b["seq"] == a["seq"] + 1]
+    lost = 0
+    if records:
+        lost = records[-1]["seq"] - records[0]["seq"] + 1 - len(records)
+    return {"cycles": _jitter_stats(cycles), "layers": layers, "period": _jitter_stats(periods),
+            "lost": lost}
+
+
+def histogram(values, bins=10):
+    """ Returns the histogram of the values: list of (lower edge, upper edge, count) """
+    counts, edges = np.histogram(np.asarray(values, dtype=float), bins=bins)
+    return [(edges[i], edges[i + 1], int(counts[i])) for i in range(len(counts))]
+
+
+def print_report(records, freq=None, bins=10, width=40):
+    """
+    Prints the statistics and the histogram of the latency
+
+    Parameters:
+    - records: list of records, as returned by decode
+    - freq: cluster frequency in MHz (to convert the cycles into latency), or None
+    - bins: number of bins of the histogram
+    - width: width of the largest bar in the histogram
+    """
+    if not records:
+        print("No records")
+        return
+    stats = statistics(records)
+    unit, scale = ("cycles", 1.0) if freq is None else ("us", 1.0 / freq)
+
+    print("{} records (seq {} to {}, {} lost)".format(len(records), records[0]["seq"],
+                                                      records[-1]["seq"], stats["lost"]))
+    print("\n{:>8} {:>12} {:>10} {:>12} {:>12} {:>12} {:>12}".format(
+        "", "mean", "std", "min", "max", "p99", "jitter"))
+    rows = [("total", stats["cycles"])]
+    rows += [("layer {}".format(k + 1), s) for k, s in enumerate(stats["layers"])]
+    for name, s in rows:
+        print("{:>8} {:>12.1f} {:>10.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f}".format(
+            name, s["mean"] * scale, s["std"] * scale, s["min"] * scale, s["max"] * scale,
+            s["p99"] * scale, s["jitter"] * scale))
+    print("(values in {})".format(unit))
+
+    if stats["period"] is not None:
+        p = stats["period"]
+        print("\nPeriod: mean {:.1f} us, std {:.1f} us, jitter {:.1f} us".format(
+            p["mean"], p["std"], p["jitter"]))
+
+    print("\nLatency histogram [{}]:".format(unit))
+    hist = histogram([r["cycles"] * scale for r in records], bins)
+    max_count = max(c for _, _, c in hist)
+    for low, high, count in hist:
+        bar = "#" * int(round(width * count / max_count))
+        print("{:>12.1f} - {:>12.1f} {:>6} {}".format(low, high, count, bar))
+
+
+def write_csv(records, filename):
+    """ Writes all records into a csv file (one line per record) """
+    num_layers = len(records[0]["layer_cycles"]) if records else 0
+    keys = ["seq", "timestamp", "cycles"] + ["layer{}".format(k + 1) for k in range(num_layers)]
+    with open(filename, "w") as _f:
+        writer = csv.writer(_f)
+        writer.writerow(keys)
+        for r in records:
+            writer.writerow([r["seq"], r["timestamp"], r["cycles"]] + list(r["layer_cycles"]))
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Decodes the telemetry dump and computes latency statistics")
+    parser.add_argument("log", help="UART (or GVSOC) output, containing the dump")
+    parser.add_argument("-f", "--freq", type=float, default=None,
+                        help="cluster frequency in MHz, to report the latency in us")
+    parser.add_argument("-b", "--bins", type=int, default=10, help="number of histogram bins")
+    parser.add_argument("--all", action="store_true",
+                        help="merge all dumps in the log (default: only the last dump)")
+    parser.add_argument("--csv", default=None, help="store all records in this csv file")
+    args = parser.parse_args()
+
+    with open(args.log, "r") as _f:
+        all_dumps = decode(_f)
+
+    if not all_dumps:
+        print("No telemetry dump found")
+    else:
+        if args.all:
+            merged = {}
+            for dump in all_dumps:
+                merged.update({r["seq"]: r for r in dump["records"]})
+            all_records = [merged[k] for k in sorted(merged)]
+        else:
+            all_records = all_dumps[-1]["records"]
+        print_report(all_records, args.freq, args.bins)
+        if args.csv is not None:
+            write_csv(all_records, args.csv)
@@ -0,0 +1,107 @@
+"""
+Reads and writes the trial files of the host inference engine (src/host/engine), and converts a
+dataset (npz) into a trial file.
+
+A trial file consists of a header of 4 little endian uint32 (magic, num_trials, num_channels,
+num_samples), followed by the already quantized trials of type int8 and shape
+[num_trials, num_channels, num_samples]. The output of eegnet_score (-o) contains the raw network
+output of type int8 and shape [num_trials, N].
+
+Usage:
+    python3 trial_file.py trials.bin                 # convert data/verification.npz
+    python3 trial_file.py trials.bin -i dataset.npz -k samples
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/26"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import os
+import numpy as np
+
+from golden_model import GoldenModel
+import functional as F
+
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "../data")
+
+# must be equal to ENGINE_TRIAL_MAGIC in src/host/engine/engine.h
+MAGIC = 0x4c495254
+HEADER_DTYPE = np.dtype("<u4")
+
+
+def write_trials(filename, x):
+    """
+    Writes the trials into a trial file
+
+    Parameters:
+    - filename: str
+    - x: np.array(shape: [N, C, T], dtype=int), quantized trials in [-128, 127]
+    """
+    x = np.asarray(x)
+    assert x.ndim == 3
+    assert x.min(initial=0) >= -128 and x.max(initial=0) <= 127
+    header = np.array([MAGIC] + list(x.shape), dtype=HEADER_DTYPE)
+    with open(filename, "wb") as _f:
+        _f.write(header.tobytes())
+        _f.write(x.astype(np.int8).tobytes())
+
+
+def read_trials(filename):
+    """ Reads a trial file, returns np.array(shape: [N, C, T], dtype=int8) """
+    with open(filename, "rb") as _f:
+        header = np.frombuffer(_f.read(4 * HEADER_DTYPE.itemsize), dtype=HEADER_DTYPE)
+        if header.size != 4 or header[0] != MAGIC:
+            raise ValueError("{} is not a trial file".format(filename))
+        shape = tuple(int(v) for v in header[1:])
+        x = np.frombuffer(_f.read(int(np.prod(shape))), dtype=np.int8)
+    return np.reshape(x, shape)
+
+
+def read_output(filename, num_classes):
+    """ Reads the output of eegnet_score, returns np.array(shape: [N, num_classes], dtype=int8) """
+    y = np.fromfile(filename, dtype=np.int8)
+    return np.reshape(y, (-1, num_classes))
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Converts a dataset into a trial file of the host engine")
+    parser.add_argument("output", help="trial file to generate")
+    parser.add_argument("-i", "--input", default=os.path.join(DATA_DIR, "verification.npz"),
+                        help="npz file with the trials [N, C, T] (float or already quantized)")
+    parser.add_argument("-k", "--key", default="input", help="name of the trials in the npz file")
+    parser.add_argument("-c", "--config", default=os.path.join(DATA_DIR, "config.json"))
+    parser.add_argument("-n", "--net", default=os.path.join(DATA_DIR, "net.npz"))
+    args = parser.parse_args()
+
+    model = GoldenModel(args.config, args.net)
+    trials = np.load(args.input)[args.key]
+    trials = np.reshape(trials, (trials.shape[0], ) + tuple(model.input_shape))
+    if not np.issubdtype(trials.dtype, np.integer):
+        trials = F.quantize_to_int(trials, model.input_scale)
+    write_trials(args.output, trials)
+    print("{} trials of shape {} written to {}".format(trials.shape[0], trials.shape[1:],
+                                                     args.output))
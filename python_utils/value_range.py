@@ -0,0 +1,283 @@
+"""
+Static value range analysis of the quantized network. The exact integer bounds of all intermediate
+values are propagated through the network, using the trained weights, factors and offsets, and the
+arithmetic of the device (truncating division, ReLU with the threshold of the reordered batch norm
+and clipping to 8 bits, see src/host/engine/engine.c).
+
+For a linear function of independent inputs (convolution, dot product), the bounds are exact: the
+minimum (maximum) is reached if every input is at its lower or upper bound, depending on the sign
+of the weight. The bounds of the later layers are conservative, since the inputs are not
+independent anymore.
+
+The analysis is used by gen_net_header.py, to decide if the results of layer 1 in the fused layer
+1+2 (NO_INTERMEDIATE_SCALE) fit into 16 bits (NET_L1_RESULT_BITS). In this case, the fused layer
+stores them as 16 bit values and computes layer 2 with 2-way SIMD (pv.sdotsp.h) instead of 32 bit
+MACs. It also checks that the pool sums of layer 2 (without intermediate scale) plus the offset fit
+into the unsigned 32 bit accumulators of the fused layer (NET_L2_POOL_BITS), or else that capping
+the ReLU outputs bounds them enough (L2_RELU_CAP). All other layers already multiply 8 bit values
+with 4-way SIMD, the report only shows the headroom of their accumulators.
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/13"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import json
+import numpy as np
+
+import convert_torch_format as convert
+
+DEFAULT_CONFIG_JSON = "../data/config.json"
+DEFAULT_NET_NPZ = "../data/net.npz"
+
+INPUT_RANGE = (-128, 127)
+
+
+def bits(lo, hi):
+    """ Returns the number of bits of the smallest signed integer type, which contains [lo, hi] """
+    n = 1
+    while lo < -2 ** (n - 1) or hi > 2 ** (n - 1) - 1:
+        n += 1
+    return n
+
+
+def unsigned_bits(lo, hi):
+    """ Returns the number of bits of the smallest unsigned integer type, which contains [lo, hi] """
+    assert lo >= 0
+    n = 1
+    while hi > 2 ** n - 1:
+        n += 1
+    return n
+
+
+def _div(x, factor):
+    """ Division like in C (truncated towards zero), factor > 0 """
+    x = np.asarray(x, dtype=np.int64)
+    return np.sign(x) * (np.abs(x) // factor)
+
+
+def _clip(x):
+    return np.clip(x, -128, 127)
+
+
+def _linear(weight, lo, hi, offset=0):
+    """
+    Bounds of offset + sum_i weight[..., i] * x_i with lo[i] <= x_i <= hi[i]
+
+    Parameters:
+    - weight: np.array(shape: [..., N], dtype=int)
+    - lo, hi: np.array(shape: [N]) (or scalars), bounds of the inputs
+    - offset: np.array(shape: [...]) or scalar
+
+    Returns: (lo, hi), np.array(shape: [...], dtype=int64)
+    """
+    weight = np.asarray(weight, dtype=np.int64)
+    a = weight * np.asarray(lo, dtype=np.int64)
+    b = weight * np.asarray(hi, dtype=np.int64)
+    return (np.minimum(a, b).sum(axis=-1) + offset, np.maximum(a, b).sum(axis=-1) + offset)
+
+
+def _relu_pool_bn(lo, hi, factor, offset):
+    """
+    Bounds of ReLU, sum pooling over 8 samples and batch norm (REORDER_BN), like
+    _engine_relu_pool_bn. Returns the bounds of the pool sum and of the output.
+    """
+    threshold = -(np.asarray(offset, dtype=np.int64) >> 3)
+    sum_lo = 8 * np.maximum(lo, threshold)
+    sum_hi = 8 * np.maximum(hi, threshold)
+    out_lo = _clip(_div(sum_lo + offset, factor))
+    out_hi = _clip(_div(sum_hi + offset, factor))
+    return (sum_lo, sum_hi), (out_lo, out_hi)
+
+
+def analyze(net, net_params, input_range=INPUT_RANGE, no_intermediate_scale=True):
+    """
+    Propagates the bounds through all layers
+
+    Parameters:
+    - net: dict, contains all network parameters (net.npz)
+    - net_params: dict, network dimensions (config.json: indiv.net.params)
+    - input_range: (lo, hi), bounds of the quantized input
+    - no_intermediate_scale: if True, the results of layer 1 are not scaled (fused layer 1+2 with
+      NO_INTERMEDIATE_SCALE)
+
+    Returns: list of dict (one per intermediate value) with the keys: name, lo, hi, bits (of the
+             smallest signed type, or unsigned type if the container is unsigned), container (size
+             of the type on the device), unsigned and headroom (unused bits of the container,
+             negative if the value might overflow)
+    """
+    F1, F2, D, C = net_params["F1"], net_params["F2"], net_params["D"], net_params["C"]
+    T64 = net_params["T"] // 64
+    stages = []
+
+    def add(name, lo, hi, container, unsigned=False):
+        lo, hi = int(np.min(lo)), int(np.max(hi))
+        n = unsigned_bits(lo, hi) if unsigned else bits(lo, hi)
+        stages.append({"name": name, "lo": lo, "hi": hi, "bits": n, "container": container,
+                       "unsigned": unsigned, "headroom": container - n})
+
+    in_lo, in_hi = input_range
+    add("input", in_lo, in_hi, 8)
+
+    # layer 1
+    input_scale = convert.ste_quant(net, "quant1")
+    w1, weight_scale = convert.inq_conv2d(net, "conv1")
+    w1 = w1.reshape(F1, -1)
+    bn_scale, bn_offset = convert.batch_norm(net, "batch_norm1")
+    output_scale = convert.ste_quant(net, "quant2")
+    f1, o1 = convert.div_factor_batch_norm(input_scale, weight_scale, output_scale, bn_scale, bn_offset)
+    l1_lo, l1_hi = _linear(w1, in_lo, in_hi, o1)
+    add("l1 conv", l1_lo, l1_hi, 32)
+    if no_intermediate_scale:
+        # the results are stored as 16 bit values, if they fit, and as 32 bit values otherwise
+        add("l1 result", l1_lo, l1_hi, 16 if bits(np.min(l1_lo), np.max(l1_hi)) <= 16 else 32)
+    else:
+        l1_lo, l1_hi = _clip(_div(l1_lo, f1)), _clip(_div(l1_hi, f1))
+        add("l1 output", l1_lo, l1_hi, 8)
+
+    # layer 2 (all channels of spectral filter k have the same bounds)
+    input_scale = convert.ste_quant(net, "quant2")
+    w2, weight_scale = convert.inq_conv2d(net, "conv2")
+    w2 = w2.reshape(F2, C)
+    bn_scale, bn_offset = convert.batch_norm(net, "batch_norm2")
+    output_scale = convert.ste_quant(net, "quant3")
+    f2, o2 = convert.div_factor_batch_norm(input_scale, weight_scale, output_scale, bn_scale, bn_offset, pool=8)
+    k = np.arange(F2) // D
+    if no_intermediate_scale:
+        f2 = np.asarray(f2, dtype=np.int64) * f1[k]
+        o2 = np.asarray(o2, dtype=np.int64) * f1[k]
+        add("l2 factor", np.minimum(np.min(f2), np.min(o2)), np.maximum(np.max(f2), np.max(o2)), 32)
+    l2_lo, l2_hi = _linear(w2, l1_lo[k][:, None], l1_hi[k][:, None])
+    add("l2 dotp", l2_lo, l2_hi, 32)
+    (sum_lo, sum_hi), (l2_lo, l2_hi) = _relu_pool_bn(l2_lo, l2_hi, f2, o2)
+    if no_intermediate_scale:
+        # the fused layer accumulates the pool sums unsigned, only the sum plus the offset (which
+        # is at least offset & 7 due to the ReLU threshold) must fit
+        add("l2 pool", sum_lo + o2, sum_hi + o2, 32, unsigned=True)
+        if unsigned_bits(np.min(sum_lo + o2), np.max(sum_hi + o2)) > 32:
+            # the fused layer caps the ReLU outputs (L2_RELU_CAP), which does not change the result
+            threshold = -(np.asarray(o2, dtype=np.int64) >> 3)
+            cap = np.minimum(127 * np.asarray(f2, dtype=np.int64) - o2 - 7 * threshold, 2 ** 31 - 1)
+            add("l2 pool cap", sum_lo + o2, np.minimum(sum_hi, 8 * cap) + o2, 32, unsigned=True)
+    else:
+        add("l2 pool", np.minimum(sum_lo + o2, sum_lo), np.maximum(sum_hi + o2, sum_hi), 32)
+    add("l2 output", l2_lo, l2_hi, 8)
+
+    # layer 3 (the padding is zero)
+    input_scale = convert.ste_quant(net, "quant3")
+    w3, weight_scale = convert.inq_conv2d(net, "sep_conv1")
+    w3 = w3.reshape(F2, -1)
+    output_scale = convert.ste_quant(net, "quant4")
+    f3 = convert.div_factor(input_scale, weight_scale, output_scale)
+    l3_lo, l3_hi = _linear(w3, np.minimum(l2_lo, 0)[:, None], np.maximum(l2_hi, 0)[:, None])
+    add("l3 conv", l3_lo, l3_hi, 32)
+    l3_lo, l3_hi = _clip(_div(l3_lo, f3)), _clip(_div(l3_hi, f3))
+    add("l3 output", l3_lo, l3_hi, 8)
+
+    # layer 4
+    input_scale = convert.ste_quant(net, "quant4")
+    w4, weight_scale = convert.inq_conv2d(net, "sep_conv2")
+    w4 = w4.reshape(F2, F2)
+    output_scale = convert.ste_quant(net, "quant5")
+    bn_scale, bn_offset = convert.batch_norm(net, "batch_norm3")
+    f4, o4 = convert.div_factor_batch_norm(input_scale, weight_scale, output_scale, bn_scale, bn_offset, pool=8)
+    l4_lo, l4_hi = _linear(w4, l3_lo, l3_hi)
+    add("l4 dotp", l4_lo, l4_hi, 32)
+    (sum_lo, sum_hi), (l4_lo, l4_hi) = _relu_pool_bn(l4_lo, l4_hi, f4, o4)
+    add("l4 pool", np.minimum(sum_lo + o4, sum_lo), np.maximum(sum_hi + o4, sum_hi), 32)
+    add("l4 output", l4_lo, l4_hi, 8)
+
+    # layer 5 (the input is flattened as [F2, T64])
+    input_scale = convert.ste_quant(net, "quant5")
+    output_scale = convert.ste_quant(net, "quant6")
+    w5, b5, weight_scale = convert.inq_linear(net, "fc")
+    w5 = w5.reshape(net_params["N"], F2 * T64)
+    f5 = convert.div_factor(input_scale, weight_scale, output_scale)
+    l5_lo, l5_hi = _linear(w5, np.repeat(l4_lo, T64), np.repeat(l4_hi, T64), b5)
+    add("l5 dotp", l5_lo, l5_hi, 32)
+    add("l5 output", _clip(_div(l5_lo, f5)), _clip(_div(l5_hi, f5)), 8)
+
+    return stages
+
+
+def l1_result_bits(stages):
+    """ Returns the number of bits required for the unscaled results of layer 1 (NET_L1_RESULT_BITS) """
+    return next(s["bits"] for s in stages if s["name"] in ["l1 result", "l1 conv"])
+
+
+def l2_pool_bits(stages):
+    """
+    Returns the number of bits required for the pool sums of layer 2 (NET_L2_POOL_BITS), unsigned
+    bits of the sum plus the offset without intermediate scale
+    """
+    return next(s["bits"] for s in stages if s["name"] == "l2 pool")
+
+
+def check(stages):
+    """
+    Raises a ValueError if any value might overflow its type on the device. The pool sums of layer 2
+    are excluded if they need more than 32 bits, the fused layer (NO_INTERMEDIATE_SCALE) then caps
+    the ReLU outputs, and the capped sums (l2 pool cap) are checked.
+    """
+    overflow = [s["name"] for s in stages if s["headroom"] < 0 and s["name"] != "l2 pool"]
+    if overflow:
+        raise ValueError("Values might overflow on the device: {}".format(", ".join(overflow)))
+
+
+def print_report(stages):
+    """ Prints the result of analyze """
+    print("{:>10} {:>12} {:>12} {:>5} {:>10} {:>9}".format(
+        "", "min", "max", "bits", "container", "headroom"))
+    for s in stages:
+        print("{:>10} {:>12} {:>12} {:>5} {:>10} {:>9}{}".format(
+            s["name"], s["lo"], s["hi"], s["bits"],
+            "u{}".format(s["container"]) if s["unsigned"] else s["container"], s["headroom"],
+            "  overflow!" if s["headroom"] < 0 else ""))
+    print("(headroom: unused bits of the container on the device)")
+    if any(s["name"] == "l1 result" for s in stages):
+        result_bits = l1_result_bits(stages)
+        print("The results of layer 1 need {} bits, the fused layer computes layer 2 with {}".format(
+            result_bits, "16 bit SIMD" if result_bits <= 16 else "32 bit MACs"))
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Reports the value range of all intermediate values")
+    parser.add_argument("-n", "--net", help="numpy file containing the network",
+                        default=DEFAULT_NET_NPZ)
+    parser.add_argument("-c", "--config", help="configuration file name",
+                        default=DEFAULT_CONFIG_JSON)
+    parser.add_argument("-r", "--input-range", help="bounds of the quantized input", type=int,
+                        nargs=2, default=INPUT_RANGE)
+    parser.add_argument("--scale-l1", action="store_true",
+                        help="the results of layer 1 are scaled (without NO_INTERMEDIATE_SCALE)")
+    args = parser.parse_args()
+
+    with open(args.config, "r") as _f:
+        config = json.load(_f)
+
+    print_report(analyze(np.load(args.net), config["indiv"]["net"]["params"], tuple(args.input_range),
+                         not args.scale_l1))
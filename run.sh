@@ -21,18 +21,21 @@
 PLATFORM="gvsoc"
 RUN=true
 GTKWAVE=false
+TRACE=false
 
-while getopts "bp:nwh" name; do
+while getopts "bp:nwth" name; do
     case "$name" in
         b) PLATFORM="board";;
         p) PLATFORM=$OPTARG;;
         n) RUN=false;;
         w) GTKWAVE=true;;
-        h) printf "Usage: %s [-b] [-p platform] [-h] [-n] [-w]\n" $0
+        t) TRACE=true;;
+        h) printf "Usage: %s [-b] [-p platform] [-h] [-n] [-w] [-t]\n" $0
            printf " -b            build on the board, equivalent to -p board\n"
-           printf " -p <platform> build on the desired platform [board | gvsoc], default is gvsoc\n"
+           printf " -p <platform> build on the desired platform [board | gvsoc | host], default is gvsoc\n"
            printf " -n            do not run the program, just build it\n"
            printf " -w            generate GTK wave files\n"
+           printf " -t            generate instruction trace, timeline (timeline.json) and flame graph (stacks.txt)\n"
            printf " -h            show this help message\n"
            exit 0;;
         ?) printf "Usage: %s [-b] [-p platform] root_folder\n" $0
@@ -46,7 +49,7 @@ printf "Running EEGnet on Platform: %s\n\n" $PLATFORM
 export PYTHONPATH=$PYTHONPATH:$(pwd)/python_utils
 
 # set the platform
-PULP_CURRENT_CONFIG_ARGS="platform=$PLATFORM"
+export PULP_CURRENT_CONFIG_ARGS="platform=$PLATFORM"
 
 # enter data directory
 cd data
@@ -64,6 +67,10 @@ make clean all
 # run if requested
 if [ "$GTKWAVE" = true ] ; then
     make run runner_args="--vcd --event=.*"
+elif [ "$TRACE" = true ] ; then
+    make run runner_args="--trace=insn" > trace.log
+    ELF_FILE=$(find build -type f -name eegnet | head -n 1)
+    python3 python_utils/gvsoc_trace.py trace.log $ELF_FILE -c timeline.json -f stacks.txt --lines
 else
     if [ "$RUN" = true ] ; then
         make run
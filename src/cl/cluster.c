@@ -25,6 +25,13 @@
 #include "input.h"
 #include "net/model.h"
 #include "net/net.h"
+#ifdef ADC_INPUT
+#include "net/input_stage.h"
+#endif//ADC_INPUT
+
+#ifdef GOVERNOR
+unsigned int cluster_cycles = 0;
+#endif//GOVERNOR
 
 /** 
  * \brief Cluster entry point (main)
@@ -34,21 +41,47 @@ void cluster_entry(void *arg)
     // allocate output memory
     int8_t * _p_output = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * NET_N);
 
+#ifdef GOVERNOR
+    // measure the cycles for the governor
+    rt_perf_t _perf;
+    rt_perf_init(&_perf);
+    rt_perf_conf(&_perf, 1 << RT_PERF_CYCLES);
+    rt_perf_reset(&_perf);
+    rt_perf_start(&_perf);
+#endif//GOVERNOR
+
     // compute the model
 
-#ifdef DUPLICATE_FEATUREMAP
+#ifdef ADC_INPUT
+    // quantize the raw ADC samples first
+    int8_t * _p_input = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * NET_C * NET_INPUT_ROW_LEN);
+#ifdef INTERLEAVED_INPUT
+    net_input_stage(input_adc_interleaved, _p_input);
+#else//INTERLEAVED_INPUT
+    net_input_stage(input_adc, _p_input);
+#endif//INTERLEAVED_INPUT
+    net_model_compute(_p_input, _p_output);
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_input, sizeof(int8_t) * NET_C * NET_INPUT_ROW_LEN);
+#elif defined(INTERLEAVED_INPUT)
+    net_model_compute(input_data_interleaved, _p_output);
+#elif defined(DUPLICATE_FEATUREMAP)
     net_model_compute(input_data_pad, _p_output);
 #else//DUPLICATE_FEATUREMAP
     net_model_compute(input_data, _p_output);
-#endif//DUPLICATE_FEATUREMAP
+#endif//ADC_INPUT
+
+#ifdef GOVERNOR
+    rt_perf_stop(&_perf);
+    cluster_cycles = rt_perf_read(RT_PERF_CYCLES);
+#endif//GOVERNOR
 
-#ifndef POWER
+#if !defined(POWER) && !defined(GOVERNOR)
     // print the result
     printf("Result:\n");
     for (int i = 0; i < NET_N; i++) {
         printf("Class %d: %d\n", i + 1, _p_output[i]);
     }
-#endif//POWER
+#endif//!POWER && !GOVERNOR
 
     // free memory
     rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_output, sizeof(int8_t) * NET_N);
@@ -34,4 +34,11 @@
  */
 void cluster_entry(void *arg);
 
+#ifdef GOVERNOR
+/**
+ * @brief Number of cycles used by the last call of cluster_entry (for the DVFS governor)
+ */
+extern unsigned int cluster_cycles;
+#endif//GOVERNOR
+
 #endif//__CL_CLUSTER_H__
@@ -313,5 +313,138 @@ int32_t func_dotp(const int8_t* p_a,
                   const int8_t* p_b,
                   unsigned int length);
 
+/**
+ * @brief Prime of the number theoretic transform (119 * 2^23 + 1), must be equal to
+ * python_utils/ntt.py
+ */
+#define FUNC_NTT_PRIME 998244353
+
+/**
+ * @brief -1 / FUNC_NTT_PRIME mod 2^32, used for the Montgomery reduction
+ */
+#define FUNC_NTT_NEG_INV 998244351
+
+/**
+ * @brief Computes the forward number theoretic transform inplace (decimation in frequency)
+ *
+ * @warning Data must be already present in L1 memory
+ *
+ * @param p_data Pointer to the data (residues, natural order) of length len, the spectrum is
+ *        stored in bit-reversed order
+ * @param len Length of the transform, power of 2
+ * @param p_twiddle Pointer to the len / 2 twiddle factors (Montgomery domain)
+ */
+void func_ntt_forward(uint32_t* p_data,
+                      unsigned int len,
+                      const uint32_t* p_twiddle);
+
+/**
+ * @brief Computes the inverse number theoretic transform inplace (decimation in time), without
+ * the factor 1 / len (which is part of the filter spectra)
+ *
+ * @warning Data must be already present in L1 memory
+ *
+ * @param p_data Pointer to the spectrum (bit-reversed order) of length len, the result is stored
+ *        in natural order
+ * @param len Length of the transform, power of 2
+ * @param p_twiddle Pointer to the len / 2 inverse twiddle factors (Montgomery domain)
+ */
+void func_ntt_inverse(uint32_t* p_data,
+                      unsigned int len,
+                      const uint32_t* p_twiddle);
+
+/**
+ * @brief Converts a vector of 8bit values to residues and adds zero padding
+ *
+ * @param p_in Pointer to the input vector on L1 memory
+ * @param in_len Number of input elements, in_len <= len
+ * @param len Length of the transform
+ * @param p_res Pointer to the output vector of length len
+ */
+void func_ntt_load(const int8_t* p_in,
+                   unsigned int in_len,
+                   unsigned int len,
+                   uint32_t* p_res);
+
+/**
+ * @brief Multiplies two spectra element wise, where p_b is in the Montgomery domain
+ *
+ * @param p_a Pointer to the first spectrum on L1 memory
+ * @param p_b Pointer to the second spectrum (Montgomery domain) on L1 memory
+ * @param len Length of the transform
+ * @param p_res Pointer to the output vector, can be equal to p_a
+ */
+void func_ntt_pointwise(const uint32_t* p_a,
+                        const uint32_t* p_b,
+                        unsigned int len,
+                        uint32_t* p_res);
+
+/**
+ * @brief Converts residues back to 8 bits (by scaling and shifting)
+ *
+ * Per element k, p_res[k] = clip((x[k] + offset) / div_factor), where x[k] is the signed value of
+ * the residue p_in[k]
+ *
+ * @param p_in Pointer to the residues on L1 memory
+ * @param len Number of elements
+ * @param div_factor factor by which to divide
+ * @param offset Bias which is added to the result before division
+ * @param p_res Pointer to the output vector
+ */
+void func_ntt_transform_8bit(const uint32_t* p_in,
+                             unsigned int len,
+                             int32_t div_factor,
+                             int32_t offset,
+                             int8_t* p_res);
+
+/**
+ * @brief Computes the spectrum of a filter on the device, in the same format as the spectra
+ * generated by data/gen_net_header.py (scaled by 1 / len, Montgomery domain)
+ *
+ * @param p_b Pointer to the filter (as used by func_xcorr) on L1 memory
+ * @param b_len Length of the filter, b_len <= len
+ * @param len Length of the transform
+ * @param p_twiddle Pointer to the len / 2 twiddle factors of the forward transform
+ * @param scale 2^64 / len mod FUNC_NTT_PRIME (NET_L1_NTT_SCALE)
+ * @param p_res Pointer to the output spectrum of length len
+ */
+void func_ntt_spectrum(const int8_t* p_b,
+                       unsigned int b_len,
+                       unsigned int len,
+                       const uint32_t* p_twiddle,
+                       uint32_t scale,
+                       uint32_t* p_res);
+
+/**
+ * @brief Compute the cross correlation of vector a with a filter, given as spectrum, using the
+ * number theoretic transform (overlap-save), and scales the result back to 8 bit
+ *
+ * The result is bit-exact to func_xcorr_scale. The operation is performed only in the valid range.
+ * This means that the output size is a_len - b_len + 1.
+ *
+ * @warning Data must be already present in L1 memory, and the output vector must be allocated
+ *
+ * @param p_a Pointer to vector a on L1 memory
+ * @param a_len Length of vector a
+ * @param p_spectrum Pointer to the spectrum of the filter (see func_ntt_spectrum)
+ * @param b_len Length of the filter, b_len < len
+ * @param len Length of the transform, power of 2
+ * @param p_twiddle Pointer to the len / 2 forward, followed by the len / 2 inverse twiddle factors
+ * @param div_factor factor by which the result is divided
+ * @param offset Bias which is added to the result before division
+ * @param p_buffer Pointer to a temporary buffer of len elements on L1 memory
+ * @param p_res Pointer to the output vector
+ */
+void func_ntt_xcorr_scale(const int8_t* p_a,
+                          unsigned int a_len,
+                          const uint32_t* p_spectrum,
+                          unsigned int b_len,
+                          unsigned int len,
+                          const uint32_t* p_twiddle,
+                          int32_t div_factor,
+                          int32_t offset,
+                          uint32_t* p_buffer,
+                          int8_t* p_res);
+
 
 #endif//__CL_FUNC_FUNCTIONAL_H__
@@ -0,0 +1,207 @@
+/**
+ * @file ntt.c
+ * @author Tibor Schneider
+ * @date 2020/06/10
+ * @brief Implementation of the number theoretic transform (NTT), to compute long convolutions
+ *
+ * All values are residues modulo FUNC_NTT_PRIME. The data stays in the normal domain, while the
+ * twiddle factors and the filter spectra are stored in the Montgomery domain (multiplied by 2^32),
+ * such that every product needs a single Montgomery reduction and no division. The reference
+ * implementation (and the generation of the twiddle factors and the spectra) is in
+ * python_utils/ntt.py.
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt/rt_api.h"
+#include "functional.h"
+
+/**
+ * @brief Montgomery multiplication, returns a * b / 2^32 mod P, with a, b < P
+ */
+static inline uint32_t _func_ntt_mul(uint32_t a, uint32_t b) {
+    uint64_t _t = (uint64_t)a * b;
+    uint32_t _m = (uint32_t)_t * FUNC_NTT_NEG_INV;
+    uint32_t _r = (uint32_t)((_t + (uint64_t)_m * FUNC_NTT_PRIME) >> 32);
+    return _r >= FUNC_NTT_PRIME ? _r - FUNC_NTT_PRIME : _r;
+}
+
+static inline uint32_t _func_ntt_add(uint32_t a, uint32_t b) {
+    uint32_t _r = a + b;
+    return _r >= FUNC_NTT_PRIME ? _r - FUNC_NTT_PRIME : _r;
+}
+
+static inline uint32_t _func_ntt_sub(uint32_t a, uint32_t b) {
+    return a >= b ? a - b : a + FUNC_NTT_PRIME - b;
+}
+
+void func_ntt_forward(uint32_t* p_data,
+                      unsigned int len,
+                      const uint32_t* p_twiddle) {
+
+    uint32_t* _p_a;
+    uint32_t* _p_b;
+    const uint32_t* _p_w;
+    uint32_t _u, _v;
+
+    // decimation in frequency: natural order in, bit-reversed order out
+    for (unsigned int _half = len >> 1, _stride = 1; _half > 0; _half >>= 1, _stride <<= 1) {
+        for (unsigned int _start = 0; _start < len; _start += 2 * _half) {
+            _p_a = p_data + _start;
+            _p_b = _p_a + _half;
+            _p_w = p_twiddle;
+            for (unsigned int _i = 0; _i < _half; _i++) {
+                _u = *_p_a;
+                _v = *_p_b;
+                *(_p_a++) = _func_ntt_add(_u, _v);
+                *(_p_b++) = _func_ntt_mul(_func_ntt_sub(_u, _v), *_p_w);
+                _p_w += _stride;
+            }
+        }
+    }
+}
+
+void func_ntt_inverse(uint32_t* p_data,
+                      unsigned int len,
+                      const uint32_t* p_twiddle) {
+
+    uint32_t* _p_a;
+    uint32_t* _p_b;
+    const uint32_t* _p_w;
+    uint32_t _u, _v;
+
+    // decimation in time: bit-reversed order in, natural order out
+    for (unsigned int _half = 1, _stride = len >> 1; _half < len; _half <<= 1, _stride >>= 1) {
+        for (unsigned int _start = 0; _start < len; _start += 2 * _half) {
+            _p_a = p_data + _start;
+            _p_b = _p_a + _half;
+            _p_w = p_twiddle;
+            for (unsigned int _i = 0; _i < _half; _i++) {
+                _u = *_p_a;
+                _v = _func_ntt_mul(*_p_b, *_p_w);
+                *(_p_a++) = _func_ntt_add(_u, _v);
+                *(_p_b++) = _func_ntt_sub(_u, _v);
+                _p_w += _stride;
+            }
+        }
+    }
+}
+
+void func_ntt_load(const int8_t* p_in,
+                   unsigned int in_len,
+                   unsigned int len,
+                   uint32_t* p_res) {
+
+    int32_t _x;
+    unsigned int _i = 0;
+
+    for (; _i < in_len; _i++) {
+        _x = p_in[_i];
+        p_res[_i] = _x < 0 ? (uint32_t)(_x + FUNC_NTT_PRIME) : (uint32_t)_x;
+    }
+    for (; _i < len; _i++) {
+        p_res[_i] = 0;
+    }
+}
+
+void func_ntt_pointwise(const uint32_t* p_a,
+                        const uint32_t* p_b,
+                        unsigned int len,
+                        uint32_t* p_res) {
+
+    for (unsigned int _i = 0; _i < len; _i++) {
+        p_res[_i] = _func_ntt_mul(p_a[_i], p_b[_i]);
+    }
+}
+
+void func_ntt_transform_8bit(const uint32_t* p_in,
+                             unsigned int len,
+                             int32_t div_factor,
+                             int32_t offset,
+                             int8_t* p_res) {
+
+    int32_t _x;
+
+    for (unsigned int _i = 0; _i < len; _i++) {
+        // residues in the upper half represent negative values
+        _x = (int32_t)p_in[_i];
+        if (_x > FUNC_NTT_PRIME / 2) {
+            _x -= FUNC_NTT_PRIME;
+        }
+        _x = (_x + offset) / div_factor;
+        p_res[_i] = (int8_t)__CLIP_R(_x, 127);
+    }
+}
+
+void func_ntt_spectrum(const int8_t* p_b,
+                       unsigned int b_len,
+                       unsigned int len,
+                       const uint32_t* p_twiddle,
+                       uint32_t scale,
+                       uint32_t* p_res) {
+
+    int32_t _x;
+    unsigned int _i;
+
+    // load the filter in reversed order (p_b is used for the cross correlation)
+    for (_i = 0; _i < b_len; _i++) {
+        _x = p_b[b_len - 1 - _i];
+        p_res[_i] = _x < 0 ? (uint32_t)(_x + FUNC_NTT_PRIME) : (uint32_t)_x;
+    }
+    for (; _i < len; _i++) {
+        p_res[_i] = 0;
+    }
+
+    func_ntt_forward(p_res, len, p_twiddle);
+
+    // multiply by 1 / len and move to the Montgomery domain (scale = 2^64 / len mod P)
+    for (_i = 0; _i < len; _i++) {
+        p_res[_i] = _func_ntt_mul(p_res[_i], scale);
+    }
+}
+
+void func_ntt_xcorr_scale(const int8_t* p_a,
+                          unsigned int a_len,
+                          const uint32_t* p_spectrum,
+                          unsigned int b_len,
+                          unsigned int len,
+                          const uint32_t* p_twiddle,
+                          int32_t div_factor,
+                          int32_t offset,
+                          uint32_t* p_buffer,
+                          int8_t* p_res) {
+
+    unsigned int _out_len = a_len - b_len + 1;
+    unsigned int _step = len - b_len + 1;
+    unsigned int _in_len, _num;
+
+    // overlap-save: every block of len inputs yields _step valid outputs, starting at b_len - 1
+    for (unsigned int _start = 0; _start < _out_len; _start += _step) {
+        _in_len = a_len - _start < len ? a_len - _start : len;
+        _num = _out_len - _start < _step ? _out_len - _start : _step;
+
+        func_ntt_load(p_a + _start, _in_len, len, p_buffer);
+        func_ntt_forward(p_buffer, len, p_twiddle);
+        func_ntt_pointwise(p_buffer, p_spectrum, len, p_buffer);
+        func_ntt_inverse(p_buffer, len, p_twiddle + len / 2);
+        func_ntt_transform_8bit(p_buffer + b_len - 1, _num, div_factor, offset, p_res + _start);
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef __INPUT_H__
+#define __INPUT_H__
+
+#include "rt/rt_api.h"
+
+extern RT_L2_DATA const int8_t input_data[198528];
+
+extern RT_L2_DATA const int8_t input_data_pad[26136];
+
+extern RT_L2_DATA const int8_t input_data_interleaved[24750];
+
+extern RT_L2_DATA const int16_t input_adc[24750];
+
+extern RT_L2_DATA const int16_t input_adc_interleaved[24750];
+
+#endif//__INPUT_H__
\ No newline at end of file
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt/rt_api.h"
+#include "string.h"
+#include "blob.h"
+#include "net.h"
+#include "layers.h"
+
+// the spectra of layer 1 are only compiled into net.c with NTT_CONV
+#ifdef NTT_CONV
+#define _NET_L1_NTT_SPECTRUM net_l1_ntt_spectrum
+#else//NTT_CONV
+#define _NET_L1_NTT_SPECTRUM NULL
+#endif//NTT_CONV
+
+// parameters compiled into net.c
+#define _NET_PARAMS_BUILTIN { \
+    NET_INPUT_FACTOR, net_l1_params, net_l2_params, NET_L3_FACTOR, net_l3_weight, \
+    net_l4_params, NET_L5_FACTOR, net_l5_params, _NET_L1_NTT_SPECTRUM \
+}
+
+RT_L2_DATA net_params_t net_params = _NET_PARAMS_BUILTIN;
+
+// size of every section in bytes, indexed by the section id
+static const unsigned int _net_blob_section_size[NET_BLOB_NUM_SECTIONS] = {
+    sizeof(int32_t) * NET_L1_PARAMS_LEN,
+    sizeof(int32_t) * NET_L2_PARAMS_LEN,
+    sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN,
+    sizeof(int32_t) * NET_L4_PARAMS_LEN,
+    sizeof(int32_t) * NET_L5_PARAMS_LEN
+};
+
+#ifndef NUM_WORKERS
+#define NUM_WORKERS 8
+#endif
+
+#define _ALIGN(x) (((x) + NET_BLOB_ALIGN - 1) / NET_BLOB_ALIGN * NET_BLOB_ALIGN)
+
+// compressed sections start with the byte offset and the number of weights
+#define _COMPRESSED_PREFIX (2 * sizeof(uint32_t))
+
+// byte offset of the int8 weights in every section
+static const unsigned int _net_blob_weight_offset[NET_BLOB_NUM_SECTIONS] = {
+    sizeof(int32_t) * NET_L1_PARAMS_WEIGHT,
+    sizeof(int32_t) * NET_L2_PARAMS_WEIGHT,
+    0,
+    sizeof(int32_t) * NET_L4_PARAMS_WEIGHT,
+    sizeof(int32_t) * NET_L5_PARAMS_WEIGHT
+};
+
+// number of int8 weights in every section
+static const unsigned int _net_blob_weight_len[NET_BLOB_NUM_SECTIONS] = {
+    NET_F1 * NET_L1_WEIGHT_LEN_ALIGN,
+    NET_F2 * NET_L2_WEIGHT_LEN,
+    NET_F2 * NET_L3_WEIGHT_LEN,
+    NET_F2 * NET_L4_WEIGHT_LEN,
+    NET_N * NET_L5_WEIGHT_LEN
+};
+
+// currently loaded blob on L2, or NULL if the compiled model is used
+static int8_t* _net_blob_loaded = NULL;
+static unsigned int _net_blob_loaded_size = 0;
+
+/**
+ * @brief Computes the CRC-32 (polynomial 0xEDB88320, like zlib), 4 bits at a time
+ *
+ * @param crc CRC of the previous data (0 at the start)
+ * @param p_data Pointer to the data
+ * @param len Number of bytes
+ */
+static uint32_t _net_blob_crc32(uint32_t crc, const uint8_t* p_data, unsigned int len) {
+    static const uint32_t _table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    crc = ~crc;
+    for (unsigned int _i = 0; _i < len; _i++) {
+        crc ^= p_data[_i];
+        crc = (crc >> 4) ^ _table[crc & 0xf];
+        crc = (crc >> 4) ^ _table[crc & 0xf];
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Returns the size of a compressed section in bytes
+ */
+static unsigned int _net_blob_compressed_size(int id) {
+    return _COMPRESSED_PREFIX + _net_blob_section_size[id] - _ALIGN(_net_blob_weight_len[id])
+        + _ALIGN((_net_blob_weight_len[id] + 1) / 2);
+}
+
+/**
+ * @brief Validates the blob (already on L2 and aligned) and returns the pointer to every section
+ */
+static int _net_blob_validate(const int8_t* p_blob, unsigned int size,
+                              const int8_t* p_sections[NET_BLOB_NUM_SECTIONS]) {
+
+    net_blob_header_t* _p_header = (net_blob_header_t*)p_blob;
+    const net_blob_section_t* _p_table = (const net_blob_section_t*)(p_blob + sizeof(net_blob_header_t));
+
+    if (size < sizeof(net_blob_header_t) || _p_header->magic != NET_BLOB_MAGIC ||
+        _p_header->version != NET_BLOB_VERSION || _p_header->total_size != size ||
+        _p_header->num_sections != NET_BLOB_NUM_SECTIONS ||
+        size < sizeof(net_blob_header_t) + sizeof(net_blob_section_t) * NET_BLOB_NUM_SECTIONS) {
+        return NET_BLOB_ERR_FORMAT;
+    }
+
+    // check the header, with the checksum field set to 0
+    uint32_t _header_crc = _p_header->header_crc;
+    _p_header->header_crc = 0;
+    uint32_t _crc = _net_blob_crc32(0, (const uint8_t*)p_blob,
+                                    sizeof(net_blob_header_t) + sizeof(net_blob_section_t) * NET_BLOB_NUM_SECTIONS);
+    _p_header->header_crc = _header_crc;
+    if (_crc != _header_crc) {
+        return NET_BLOB_ERR_CRC;
+    }
+
+    if (_p_header->f1 != NET_F1 || _p_header->f2 != NET_F2 || _p_header->d != NET_D ||
+        _p_header->c != NET_C || _p_header->t != NET_T || _p_header->n != NET_N ||
+        _p_header->l3_factor == 0 || _p_header->l5_factor == 0 || _p_header->input_factor <= 0) {
+        return NET_BLOB_ERR_SHAPE;
+    }
+
+    // the fused layer 1+2 is compiled for the value ranges of the network in net.h
+#ifdef L1_RESULT_INT16
+    if (_p_header->l1_result_bits > 16) {
+        return NET_BLOB_ERR_SHAPE;
+    }
+#endif//L1_RESULT_INT16
+#if defined(NO_INTERMEDIATE_SCALE) && !defined(L2_RELU_CAP)
+    if (_p_header->l2_pool_bits > 32) {
+        return NET_BLOB_ERR_SHAPE;
+    }
+#endif//NO_INTERMEDIATE_SCALE && !L2_RELU_CAP
+
+    if ((_p_header->flags & ~NET_BLOB_FLAG_COMPRESSED) != 0) {
+        return NET_BLOB_ERR_FORMAT;
+    }
+    int _compressed = _p_header->flags & NET_BLOB_FLAG_COMPRESSED;
+
+    for (int _i = 0; _i < NET_BLOB_NUM_SECTIONS; _i++) {
+        p_sections[_i] = NULL;
+    }
+
+    for (int _i = 0; _i < NET_BLOB_NUM_SECTIONS; _i++) {
+        const net_blob_section_t* _p_section = _p_table + _i;
+        if (_p_section->id >= NET_BLOB_NUM_SECTIONS || p_sections[_p_section->id] != NULL ||
+            _p_section->offset % NET_BLOB_ALIGN != 0 || _p_section->offset > size ||
+            _p_section->size > size - _p_section->offset) {
+            return NET_BLOB_ERR_FORMAT;
+        }
+        if (_p_section->size != (_compressed ? _net_blob_compressed_size(_p_section->id)
+                                             : _net_blob_section_size[_p_section->id])) {
+            return NET_BLOB_ERR_SHAPE;
+        }
+        if (_net_blob_crc32(0, (const uint8_t*)p_blob + _p_section->offset, _p_section->size) != _p_section->crc) {
+            return NET_BLOB_ERR_CRC;
+        }
+        if (_compressed) {
+            const uint32_t* _p_prefix = (const uint32_t*)(p_blob + _p_section->offset);
+            if (_p_prefix[0] != _net_blob_weight_offset[_p_section->id] ||
+                _p_prefix[1] != _net_blob_weight_len[_p_section->id]) {
+                return NET_BLOB_ERR_SHAPE;
+            }
+        }
+        p_sections[_p_section->id] = p_blob + _p_section->offset;
+    }
+
+    return NET_BLOB_OK;
+}
+
+typedef struct {
+    const uint8_t* p_codes;
+    int8_t* p_weight;
+    unsigned int num_weights;
+} _net_blob_expand_kernel_t;
+
+/**
+ * @brief Expands the 4bit codes on L1, every core handles a contiguous part of the codes
+ */
+static void _net_blob_expand_kernel(void* args) {
+
+    // value of every code (2^e - 1, the sign is bit 3)
+    static const int8_t _lut[16] = {0, 1, 3, 7, 15, 31, 63, 127, 0, -1, -3, -7, -15, -31, -63, -127};
+
+    unsigned int _core_id = rt_core_id();
+    _net_blob_expand_kernel_t* _args = args;
+
+    unsigned int _num_codes = _args->num_weights / 2;
+    unsigned int _chunk = (_num_codes + NUM_WORKERS - 1) / NUM_WORKERS;
+    unsigned int _start = _core_id * _chunk;
+    unsigned int _end = _start + _chunk < _num_codes ? _start + _chunk : _num_codes;
+
+    const uint8_t* _p_codes_iter = _args->p_codes + _start;
+    int8_t* _p_weight_iter = _args->p_weight + 2 * _start;
+
+    for (unsigned int _i = _start; _i < _end; _i++) {
+        uint8_t _code = *(_p_codes_iter++);
+        *(_p_weight_iter++) = _lut[_code & 0xf];
+        *(_p_weight_iter++) = _lut[_code >> 4];
+    }
+
+    // last weight of an odd number of weights, and the padding up to the next word
+    if (_core_id == 0) {
+        _p_weight_iter = _args->p_weight + 2 * _num_codes;
+        if (_args->num_weights % 2 != 0) {
+            *(_p_weight_iter++) = _lut[_args->p_codes[_num_codes] & 0xf];
+        }
+        for (unsigned int _i = _args->num_weights; _i < _ALIGN(_args->num_weights); _i++) {
+            *(_p_weight_iter++) = 0;
+        }
+    }
+}
+
+/**
+ * @brief Expands all compressed sections into p_dst (on L2), and returns the pointer to every
+ * expanded section. The sections are copied to L1 with the DMA, and expanded by all cores.
+ *
+ * @returns NET_BLOB_OK, or NET_BLOB_ERR_NOMEM if there is not enough space on L1
+ */
+static int _net_blob_expand(const int8_t* p_sections[NET_BLOB_NUM_SECTIONS], int8_t* p_dst,
+                            const int8_t* p_expanded[NET_BLOB_NUM_SECTIONS]) {
+
+    unsigned int _max_size = 0;
+    for (int _i = 0; _i < NET_BLOB_NUM_SECTIONS; _i++) {
+        if (_net_blob_section_size[_i] > _max_size) {
+            _max_size = _net_blob_section_size[_i];
+        }
+    }
+
+    // the codes are at most half the size of the section
+    int8_t* _p_section_loc = rt_alloc(RT_ALLOC_CL_DATA, _max_size);
+    uint8_t* _p_codes_loc = rt_alloc(RT_ALLOC_CL_DATA, _max_size / 2 + NET_BLOB_ALIGN);
+    if (_p_section_loc == NULL || _p_codes_loc == NULL) {
+        if (_p_section_loc != NULL) rt_free(RT_ALLOC_CL_DATA, _p_section_loc, _max_size);
+        if (_p_codes_loc != NULL) rt_free(RT_ALLOC_CL_DATA, _p_codes_loc, _max_size / 2 + NET_BLOB_ALIGN);
+        return NET_BLOB_ERR_NOMEM;
+    }
+
+    rt_dma_copy_t _copy;
+    _net_blob_expand_kernel_t _args;
+
+    for (int _i = 0; _i < NET_BLOB_NUM_SECTIONS; _i++) {
+        unsigned int _size = _net_blob_section_size[_i];
+        unsigned int _offset = _net_blob_weight_offset[_i];
+        unsigned int _weight_size = _ALIGN(_net_blob_weight_len[_i]);
+        unsigned int _codes_size = _ALIGN((_net_blob_weight_len[_i] + 1) / 2);
+        const int8_t* _p_src = p_sections[_i] + _COMPRESSED_PREFIX;
+
+        // data before the weights, the codes, and the data after the weights
+        if (_offset > 0) {
+            rt_dma_memcpy((unsigned int)_p_src, (unsigned int)_p_section_loc, _offset,
+                          RT_DMA_DIR_EXT2LOC, 0, &_copy);
+        }
+        rt_dma_memcpy((unsigned int)(_p_src + _offset), (unsigned int)_p_codes_loc, _codes_size,
+                      RT_DMA_DIR_EXT2LOC, _offset > 0, &_copy);
+        if (_offset + _weight_size < _size) {
+            rt_dma_memcpy((unsigned int)(_p_src + _offset + _codes_size),
+                          (unsigned int)(_p_section_loc + _offset + _weight_size),
+                          _size - _offset - _weight_size, RT_DMA_DIR_EXT2LOC, 1, &_copy);
+        }
+        rt_dma_wait(&_copy);
+
+        _args.p_codes = _p_codes_loc;
+        _args.p_weight = _p_section_loc + _offset;
+        _args.num_weights = _net_blob_weight_len[_i];
+        rt_team_fork(NUM_WORKERS, _net_blob_expand_kernel, &_args);
+
+        // store the expanded section on L2
+        rt_dma_memcpy((unsigned int)p_dst, (unsigned int)_p_section_loc, _size,
+                      RT_DMA_DIR_LOC2EXT, 0, &_copy);
+        rt_dma_wait(&_copy);
+
+        p_expanded[_i] = p_dst;
+        p_dst += _ALIGN(_size);
+    }
+
+    rt_free(RT_ALLOC_CL_DATA, _p_section_loc, _max_size);
+    rt_free(RT_ALLOC_CL_DATA, _p_codes_loc, _max_size / 2 + NET_BLOB_ALIGN);
+
+    return NET_BLOB_OK;
+}
+
+int net_blob_load(const void* p_blob, unsigned int size) {
+
+    // place the blob on L2, aligned to a word
+    int8_t* _p_blob = rt_alloc(RT_ALLOC_L2_CL_DATA, size);
+    if (_p_blob == NULL) {
+        return NET_BLOB_ERR_NOMEM;
+    }
+    memcpy(_p_blob, p_blob, size);
+
+    const int8_t* _p_sections[NET_BLOB_NUM_SECTIONS];
+    int _status = _net_blob_validate(_p_blob, size, _p_sections);
+    if (_status != NET_BLOB_OK) {
+        rt_free(RT_ALLOC_L2_CL_DATA, _p_blob, size);
+        return _status;
+    }
+
+    const net_blob_header_t* _p_header = (const net_blob_header_t*)_p_blob;
+
+    // memory, which is kept on L2 while the model is active
+    int8_t* _p_keep = _p_blob;
+    unsigned int _keep_size = size;
+
+    // expand the weights, and only keep the expanded sections on L2
+    if (_p_header->flags & NET_BLOB_FLAG_COMPRESSED) {
+        unsigned int _expanded_size = 0;
+        for (int _i = 0; _i < NET_BLOB_NUM_SECTIONS; _i++) {
+            _expanded_size += _ALIGN(_net_blob_section_size[_i]);
+        }
+        int8_t* _p_expanded = rt_alloc(RT_ALLOC_L2_CL_DATA, _expanded_size);
+        if (_p_expanded == NULL) {
+            rt_free(RT_ALLOC_L2_CL_DATA, _p_blob, size);
+            return NET_BLOB_ERR_NOMEM;
+        }
+        _status = _net_blob_expand(_p_sections, _p_expanded, _p_sections);
+        if (_status != NET_BLOB_OK) {
+            rt_free(RT_ALLOC_L2_CL_DATA, _p_expanded, _expanded_size);
+            rt_free(RT_ALLOC_L2_CL_DATA, _p_blob, size);
+            return _status;
+        }
+        _p_keep = _p_expanded;
+        _keep_size = _expanded_size;
+    }
+
+    net_params.input_factor = _p_header->input_factor;
+    net_params.l1_params = (const int32_t*)_p_sections[NET_BLOB_L1_PARAMS];
+    net_params.l2_params = (const int32_t*)_p_sections[NET_BLOB_L2_PARAMS];
+    net_params.l3_factor = _p_header->l3_factor;
+    net_params.l3_weight = _p_sections[NET_BLOB_L3_WEIGHT];
+    net_params.l4_params = (const int32_t*)_p_sections[NET_BLOB_L4_PARAMS];
+    net_params.l5_factor = _p_header->l5_factor;
+    net_params.l5_params = (const int32_t*)_p_sections[NET_BLOB_L5_PARAMS];
+    net_params.l1_ntt_spectrum = NULL;
+
+    // the compressed blob is not needed anymore
+    if (_p_keep != _p_blob) {
+        rt_free(RT_ALLOC_L2_CL_DATA, _p_blob, size);
+    }
+
+    // free the previous blob, which is not used anymore
+    if (_net_blob_loaded != NULL) {
+        rt_free(RT_ALLOC_L2_CL_DATA, _net_blob_loaded, _net_blob_loaded_size);
+    }
+    _net_blob_loaded = _p_keep;
+    _net_blob_loaded_size = _keep_size;
+
+    return NET_BLOB_OK;
+}
+
+void net_blob_unload() {
+
+    net_params = (net_params_t)_NET_PARAMS_BUILTIN;
+
+    if (_net_blob_loaded != NULL) {
+        rt_free(RT_ALLOC_L2_CL_DATA, _net_blob_loaded, _net_blob_loaded_size);
+        _net_blob_loaded = NULL;
+        _net_blob_loaded_size = 0;
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_NET_BLOB_H__
+#define __CL_NET_BLOB_H__
+
+#include "rt/rt_api.h"
+
+/**
+ * @brief Parameters of the network, used by all layers.
+ *
+ * By default, net_params points to the arrays compiled into net.c. A model blob, generated by
+ * data/gen_net_header.py (-b), can replace them at runtime with net_blob_load, such that a
+ * retrained model can be used without rebuilding the binary. The dimensions of the network are
+ * still compile-time constants (net.h), and the blob must match them. The blob does not contain the
+ * filter spectra of layer 1 (NTT_CONV), they are derived from the weights on the device instead.
+ *
+ * The parameters of every layer are packed into one contiguous block of 32bit words (see net.h,
+ * NET_LX_PARAMS_*), such that a layer can load all its parameters with a single DMA transfer.
+ */
+typedef struct {
+    int32_t input_factor;      // fixed-point factor to quantize the ADC samples (input_stage.h)
+    const int32_t* l1_params;  // [factor, offset, reversed weights (int8)]
+    const int32_t* l2_params;  // [factor, offset, weights (int8)]
+    int32_t l3_factor;
+    const int8_t* l3_weight;
+    const int32_t* l4_params;  // [factor, offset, weights (int8)]
+    int32_t l5_factor;
+    const int32_t* l5_params;  // [bias (int8), weights (int8)]
+    const uint32_t* l1_ntt_spectrum; // [F1, NET_L1_NTT_LEN] (NTT_CONV), NULL: computed by layer 1
+} net_params_t;
+
+/**
+ * @brief Parameters of the currently active model
+ */
+extern net_params_t net_params;
+
+/**
+ * @brief Model blob format (all fields are little endian 32bit words, except the bits of the
+ * intermediate values in the last word of the header):
+ *
+ * | bytes      | content                                                      |
+ * |------------|--------------------------------------------------------------|
+ * | 0..63      | header (net_blob_header_t)                                   |
+ * | 64..       | section table, num_sections entries (net_blob_section_t)     |
+ * | offset(s)  | data of every section, aligned to 4 bytes, in the same layout |
+ * |            | as the arrays in net.h, such that it can be copied with DMA  |
+ *
+ * header_crc is the CRC-32 of the header (with header_crc set to 0) and the section table, and
+ * every section has its own CRC-32 (the same as zlib.crc32).
+ *
+ * If NET_BLOB_FLAG_COMPRESSED is set, the int8 weights of every section are stored as 4bit INQ
+ * codes, two per byte (gen_net_header.py -z). A code c represents 2^(c & 7) - 1, negated if bit 3
+ * is set. A compressed section starts with two words (byte offset and number of the weights in the
+ * expanded section), followed by the data before the weights, the codes (aligned to 4 bytes) and
+ * the data after the weights. net_blob_load expands the weights again.
+ *
+ * l1_result_bits and l2_pool_bits are NET_L1_RESULT_BITS and NET_L2_POOL_BITS of the network in the
+ * blob (see layers.h). net_blob_load rejects the blob if its values do not fit into the types of
+ * the compiled fused layer 1+2.
+ */
+#define NET_BLOB_MAGIC 0x4e474545
+#define NET_BLOB_VERSION 5
+#define NET_BLOB_ALIGN 4
+
+#define NET_BLOB_FLAG_COMPRESSED 0x1
+
+#define NET_BLOB_L1_PARAMS 0
+#define NET_BLOB_L2_PARAMS 1
+#define NET_BLOB_L3_WEIGHT 2
+#define NET_BLOB_L4_PARAMS 3
+#define NET_BLOB_L5_PARAMS 4
+#define NET_BLOB_NUM_SECTIONS 5
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_crc;
+    uint32_t total_size;       // size of the entire blob in bytes
+    uint32_t num_sections;
+    uint32_t f1;
+    uint32_t f2;
+    uint32_t d;
+    uint32_t c;
+    uint32_t t;
+    uint32_t n;
+    int32_t l3_factor;
+    int32_t l5_factor;
+    int32_t input_factor;
+    uint32_t flags;
+    uint16_t l1_result_bits;   // bits of the unscaled results of layer 1
+    uint16_t l2_pool_bits;     // unsigned bits of the pool sums of layer 2 plus the offset
+} net_blob_header_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t offset;           // offset from the start of the blob in bytes
+    uint32_t size;             // size in bytes
+    uint32_t crc;
+} net_blob_section_t;
+
+/**
+ * @brief Return values of net_blob_load
+ */
+#define NET_BLOB_OK 0
+#define NET_BLOB_ERR_FORMAT -1    // wrong magic number, version or size
+#define NET_BLOB_ERR_CRC -2       // checksum mismatch
+#define NET_BLOB_ERR_SHAPE -3     // dimensions do not match net.h, or values do not fit
+#define NET_BLOB_ERR_NOMEM -4     // not enough space on L2 memory
+
+/**
+ * @brief Validates a model blob, copies it to L2 memory and activates it. The previously loaded
+ * blob (if any) is freed. If the blob is invalid, the active model is not changed.
+ *
+ * The weights of a compressed blob are expanded by all cores on L1, and only the expanded sections
+ * are kept on L2. Thus, multiple models can be stored compressed, and loaded when they are needed.
+ * The layers always load the expanded weights, the active model does not save L2 memory.
+ *
+ * @warning Must not be called while the network is computed. Compressed blobs must be loaded on the
+ * cluster.
+ *
+ * @param p_blob Pointer to the blob (any memory accessible by the caller)
+ * @param size Size of the blob in bytes
+ *
+ * @returns NET_BLOB_OK on success, or a negative error code
+ */
+int net_blob_load(const void* p_blob, unsigned int size);
+
+/**
+ * @brief Switches back to the model compiled into net.c, and frees the loaded blob.
+ *
+ * @warning Must not be called while the network is computed.
+ */
+void net_blob_unload();
+
+#endif//__CL_NET_BLOB_H__
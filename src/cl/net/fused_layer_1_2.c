@@ -29,6 +29,8 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
+#include "pipeline.h"
 #include "../func/functional.h"
 
 #ifdef FUSE_LAYERS
@@ -54,6 +56,9 @@
 #error "The number of spectral filters must be equal to the number of workers"
 #endif
 
+// the ring buffer streams windows of any length
+#ifndef RING_BUFFER
+
 #if NET_L1_PAD_INPUT_LEN % 4 != 0
 #error "The padded input length must be divisible by 4"
 #endif
@@ -62,18 +67,175 @@
 #error "T / 8 must be divisible by 4"
 #endif
 
+#endif//RING_BUFFER
+
 #if NET_D != 2
 #error "D must be equal to 2"
 #endif
 
+#if defined(INTERLEAVED_INPUT) && !(defined(DUPLICATE_FEATUREMAP) && defined(NO_INTERMEDIATE_SCALE))
+#error "Duplicate featuremap and no intermediate scale are required for the interleaved input"
+#endif
+
+#if defined(DUPLICATE_IN_L1) && !(defined(DUPLICATE_FEATUREMAP) && defined(NO_INTERMEDIATE_SCALE))
+#error "Duplicate featuremap and no intermediate scale are required to duplicate the input in L1"
+#endif
+
+#if defined(PIPELINE) && !(defined(RING_BUFFER) && !defined(CHANNEL_TILES))
+#error "The pipeline of layer 3, 4 and 5 (PIPELINE) requires RING_BUFFER, and is not supported with CHANNEL_TILES"
+#endif
+
+#if defined(RING_BUFFER) && !defined(DUPLICATE_IN_L1)
+#error "Duplicate in L1 is required for the ring buffer"
+#endif
+
+// L1_RESULT_INT16 and L2_RELU_CAP are selected in layers.h
+#if defined(L1_RESULT_INT16) && !(defined(DUPLICATE_FEATUREMAP) && defined(NO_INTERMEDIATE_SCALE))
+#error "Duplicate featuremap and no intermediate scale are required for 16bit results of layer 1"
+#endif
+
+#ifdef L1_RESULT_INT16
+typedef int16_t _l1_result_t;
+// saturates the results of layer 1 to 16 bits, which they only exceed if L1_RESULT_INT16 is forced
+// (like in the test) for a network with NET_L1_RESULT_BITS > 16
+#define _L1_RESULT_CLIP(x) __CLIP_R(x, 32767)
+#else//L1_RESULT_INT16
+typedef int32_t _l1_result_t;
+#define _L1_RESULT_CLIP(x) (x)
+#endif//L1_RESULT_INT16
+
+// With the ReLU threshold -(offset >> 3), the sum of the 8 pooled values plus the offset is at least
+// offset & 7, i.e. never negative. Thus, the pool sums are accumulated unsigned, which covers twice
+// the range of int32 without intermediate scale (NET_L2_POOL_BITS, computed by
+// python_utils/value_range.py, is the number of unsigned bits of the sum plus the offset). The
+// partial sums may wrap around, but the sum plus the offset is exact, and the scaled result only
+// needs to be clipped at the top.
+typedef uint32_t _l2_pool_t;
+#define _L2_POOL_CLIP(x) ((x) > 127 ? 127 : (x))
+
+// If this is not enough, the outputs of the ReLU are additionally capped (L2_RELU_CAP, see
+// _net_fused_layer_1_2_relu_cap), which does not change the result. value_range.py makes sure that
+// the capped pool sums fit into 32 bits.
+#ifdef L2_RELU_CAP
+#define _L2_RELU(x, threshold, cap) __MIN(__MAX(x, threshold), cap)
+#else//L2_RELU_CAP
+#define _L2_RELU(x, threshold, cap) __MAX(x, threshold)
+#endif//L2_RELU_CAP
+
+/**
+ * @brief Returns the cap of the ReLU outputs of layer 2 (used with L2_RELU_CAP). If one of the 8
+ * pooled values exceeds the cap, the output saturates at 127, even if all others are at the
+ * threshold. Thus, capping the values does not change the result, but bounds the pool sum.
+ *
+ * @param factor Scaling division factor of the output channel
+ * @param offset Offset of the output channel
+ * @param threshold Threshold for ReLU of the output channel
+ */
+static inline int32_t _net_fused_layer_1_2_relu_cap(int32_t factor, int32_t offset, int32_t threshold) {
+    int64_t _cap = 127 * (int64_t)factor - offset - 7 * (int64_t)threshold;
+    return _cap > 0x7fffffff ? 0x7fffffff : (int32_t)_cap;
+}
+
 #define _SHUFFLEMASK1 (v4s){1,2,3,4}
 #define _SHUFFLEMASK2 (v4s){2,3,4,5}
 #define _SHUFFLEMASK3 (v4s){3,4,5,6}
 
+// masks to transpose a block of 4x4 bytes (interleave two words, and combine the halves)
+#define _SHUFFLEMASK_LO (v4s){0,4,1,5}
+#define _SHUFFLEMASK_HI (v4s){2,6,3,7}
+#define _SHUFFLEMASK_01 (v4s){0,1,4,5}
+#define _SHUFFLEMASK_23 (v4s){2,3,6,7}
+
 #ifdef NO_INTERMEDIATE_SCALE
 
+/**
+ * @brief Widens the 8bit weights of layer 2 (as stored in the parameters) to the type of the results
+ * of layer 1 (32bit, or 16bit with L1_RESULT_INT16)
+ *
+ * @param p_in Pointer to the 8bit weights of shape [NET_F2, NET_L2_WEIGHT_LEN] on L1
+ * @param p_out Pointer to the widened weights of shape [NET_F2, NET_L2_WEIGHT_LEN] on L1
+ */
+static void _net_fused_layer_1_2_widen_weight_l2(const int8_t* p_in, _l1_result_t* p_out) {
+    for (int _i = 0; _i < NET_F2 * NET_L2_WEIGHT_LEN; _i++) {
+        *(p_out++) = *(p_in++);
+    }
+}
+
 #ifdef DUPLICATE_FEATUREMAP
 
+#ifdef RING_BUFFER
+
+// The input is streamed through a circular buffer on L1, which holds _RING_SLOTS chunks of
+// _RING_CHUNK time samples of all channels (for each of the 4 copies). The first _RING_MIRROR
+// samples of every row are repeated after the end of the ring, such that the convolution never
+// needs to wrap around.
+#define _RING_CHUNK 128
+#define _RING_SLOTS 3
+#define _RING_LEN (_RING_SLOTS * _RING_CHUNK)
+#define _RING_MIRROR NET_L1_WEIGHT_LEN
+#define _RING_ROW (_RING_LEN + _RING_MIRROR)
+#if (_RING_CHUNK % 8 != 0)
+#error "The chunks must be divisible by 8!"
+#endif
+#if (_RING_CHUNK < NET_L1_WEIGHT_LEN)
+#error "The chunks must be at least as long as the filter of layer 1!"
+#endif
+
+#ifdef CHANNEL_TILES
+
+// Every chunk is computed in tiles of _TILE_C channels, which do not need to fit into L1 at the same
+// time. A tile contains the samples of the chunk and the _TILE_HALO samples after it (instead of a
+// ring over all channels), and the tiles are double buffered. The partial sums of layer 2 are
+// accumulated over all tiles of a chunk.
+#define _TILE_C 16
+#define _NUM_TILES ((NET_C + _TILE_C - 1) / _TILE_C)
+#define _TILE_HALO NET_L1_WEIGHT_LEN
+#define _TILE_ROW (_RING_CHUNK + _TILE_HALO)
+
+// distance between the 4 copies, and the stride of the thread data (result of the convolution)
+#define _COPY_MEM_SIZE (_TILE_ROW * _TILE_C)
+#define _THREAD_STRIDE _TILE_C
+
+// staging buffer for one tile of the interleaved input, of shape [_TILE_ROW, _TILE_C], after the copies
+#ifdef INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE (_TILE_ROW * _TILE_C)
+#else//INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE 0
+#endif//INTERLEAVED_INPUT
+#define _STAGE_MEM_OFFSET (8 * _COPY_MEM_SIZE)
+
+#define _DATA_MEM_SIZE (8 * _COPY_MEM_SIZE + _STAGE_MEM_SIZE)
+#define _ACC_MEM_SIZE (NUM_WORKERS * 2 * _RING_CHUNK)
+
+#else//CHANNEL_TILES
+
+// distance between the 4 copies, and the stride of the thread data (result of the convolution, even
+// such that pairs of channels are aligned with L1_RESULT_INT16)
+#define _COPY_MEM_SIZE (_RING_ROW * NET_C)
+#define _THREAD_STRIDE (NET_C + (NET_C & 1))
+
+// staging buffer for one chunk of the interleaved input, of shape [_RING_CHUNK, NET_C], after the copies
+#ifdef INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE (_RING_CHUNK * NET_C)
+#else//INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE 0
+#endif//INTERLEAVED_INPUT
+#define _STAGE_MEM_OFFSET (4 * _COPY_MEM_SIZE)
+
+#define _DATA_MEM_SIZE (4 * _COPY_MEM_SIZE + _STAGE_MEM_SIZE)
+#define _ACC_MEM_SIZE 0
+
+#endif//CHANNEL_TILES
+
+// the result of one chunk, of shape [NET_F2, _RESULT_CHUNK]
+#define _RESULT_CHUNK (_RING_CHUNK / 8)
+#define _RESULT_STRIDE _RESULT_CHUNK
+#define _RESULT_MEM_SIZE (2 * NET_F2 * _RESULT_CHUNK)
+
+#define _THREAD_MEM_OFFSET 0
+
+#else//RING_BUFFER
+
 // dimension the split, it is important that all parts are divisible by 8
 // We split it into 5 parts, of size
 
@@ -92,27 +254,646 @@
 
 #define _THREAD_MEM_OFFSET 0
 
+#ifdef DUPLICATE_IN_L1
+// the 4 time samples after every split (of each channel), needed to shift the last word of a row
+#define _T_SPLIT_TAIL_SIZE (4 * NET_C)
+#define _DATA_MEM_SIZE (8 * _T_SPLIT_MEM_SIZE + 2 * _T_SPLIT_TAIL_SIZE)
+#else//DUPLICATE_IN_L1
+// staging buffers for the interleaved input of both slots, of shape [len + 4, NET_C], after the
+// copies. With DUPLICATE_IN_L1, the copies 1 to 3 of the slot are used instead, which are free
+// until the split is shifted.
+#ifdef INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE (_T_SPLIT_MEM_SIZE + 4 * NET_C)
+#else//INTERLEAVED_INPUT
+#define _STAGE_MEM_SIZE 0
+#endif//INTERLEAVED_INPUT
+#define _DATA_MEM_SIZE (8 * _T_SPLIT_MEM_SIZE + 2 * _STAGE_MEM_SIZE)
+#endif//DUPLICATE_IN_L1
+
+#define _COPY_MEM_SIZE _T_SPLIT_MEM_SIZE
+#define _THREAD_STRIDE (NET_C + (NET_C & 1))  // even, such that pairs of channels are aligned
+#define _RESULT_STRIDE NET_T8_ALIGN
+
+#endif//RING_BUFFER
+
+/**
+ * @brief Maximal number of targets of a de-interleave job
+ */
+#define _DEINT_MAX_TARGETS 4
+
+/**
+ * @brief Rows on L1, which are filled from the interleaved input: element j of row ch contains the
+ * sample p_start + j of the padded window, of the channel ch_start + ch
+ */
+typedef struct {
+    int8_t* p_dst;      // first row, aligned to 4 bytes
+    int row_len;        // distance between the rows, divisible by 4
+    int p_start;        // first time sample (in the padded window)
+    int len;            // number of time samples per row, divisible by 4
+} _net_fused_layer_1_2_deint_target_t;
+
+/**
+ * @brief Block of the interleaved input (INTERLEAVED_INPUT), which is loaded with a single DMA
+ * transfer into a staging buffer on L1, and then transposed into the rows of the targets.
+ *
+ * The staging buffer has the shape [t_end - t_start, num_ch], like the input on L2. The time samples
+ * which are not in the input (the padding) are not loaded, and are written as zero by the transpose.
+ */
+typedef struct {
+    int8_t* p_stage;    // staging buffer on L1
+    int t_start;        // first time sample in the staging buffer (in the input, not padded)
+    int t_end;          // last time sample in the staging buffer (exclusive)
+    int num_ch;         // number of channels, the length of one time sample in the staging buffer
+    int num_targets;
+    _net_fused_layer_1_2_deint_target_t targets[_DEINT_MAX_TARGETS];
+} _net_fused_layer_1_2_deint_t;
+
+#ifdef INTERLEAVED_INPUT
+
+/**
+ * @brief Starts the DMA transfer, which loads the time samples needed by the targets of the job into
+ * its staging buffer
+ *
+ * Every time sample of the interleaved input contains all channels. Thus, the block is contiguous on
+ * L2 if all channels are loaded, and consists of rows of num_ch bytes otherwise. The targets and
+ * num_ch must already be set.
+ *
+ * @param p_job De-interleave job
+ * @param p_data_ext Pointer to the input data on L2, of shape [t_len, NET_C]
+ * @param t_len Number of time samples in the window (not padded)
+ * @param ch_start First channel to load
+ * @param p_copy DMA copy structure
+ * @returns Number of started transfers, rt_dma_wait must only be called if it is not zero
+ */
+static int _net_fused_layer_1_2_deint_load(_net_fused_layer_1_2_deint_t* p_job,
+                                           const int8_t* p_data_ext,
+                                           unsigned int t_len,
+                                           int ch_start,
+                                           rt_dma_copy_t* p_copy) {
+
+    // range of the time samples of all targets, limited to the input
+    int _t_start = (int)t_len;
+    int _t_end = 0;
+    int _t_first, _t_last;
+    for (int _k = 0; _k < p_job->num_targets; _k++) {
+        _t_first = p_job->targets[_k].p_start - NET_L1_PAD_START;
+        _t_last = _t_first + p_job->targets[_k].len;
+        _t_start = _t_first < _t_start ? _t_first : _t_start;
+        _t_end = _t_last > _t_end ? _t_last : _t_end;
+    }
+    _t_start = _t_start < 0 ? 0 : _t_start;
+    _t_end = _t_end > (int)t_len ? (int)t_len : _t_end;
+    _t_end = _t_end < _t_start ? _t_start : _t_end;
+
+    p_job->t_start = _t_start;
+    p_job->t_end = _t_end;
+
+    if (_t_end == _t_start) {
+        return 0;
+    }
+
+    if (p_job->num_ch == NET_C) {
+        rt_dma_memcpy((unsigned int)(p_data_ext + _t_start * NET_C),
+                      (unsigned int)p_job->p_stage,
+                      sizeof(int8_t) * (_t_end - _t_start) * NET_C,
+                      RT_DMA_DIR_EXT2LOC, 0, p_copy);
+    } else {
+        rt_dma_memcpy_2d((unsigned int)(p_data_ext + _t_start * NET_C + ch_start),
+                         (unsigned int)p_job->p_stage,
+                         sizeof(int8_t) * (_t_end - _t_start) * p_job->num_ch, // number of elements in total
+                         sizeof(int8_t) * NET_C,                               // length of each line (one time sample)
+                         sizeof(int8_t) * p_job->num_ch,                       // number of elements to transfer per line
+                         RT_DMA_DIR_EXT2LOC, 0, p_copy);
+    }
+    return 1;
+}
+
+/**
+ * @brief Transposes the staging buffer of the job into the rows of its targets (in parallel)
+ *
+ * Every core transposes a subset of the words (4 time samples) of the rows. Four words of the staging
+ * buffer (4 channels of 4 consecutive time samples) are transposed with 8 shuffles into one word of 4
+ * rows. The staging buffer is read with unaligned loads if num_ch is not divisible by 4. Words with
+ * padding, and the remaining channels are copied element by element. This function must be called
+ * by all cores after the transfer is complete, and must be followed by a barrier.
+ *
+ * @param p_job De-interleave job, loaded by _net_fused_layer_1_2_deint_load
+ * @param core_id
+ */
+static void _net_fused_layer_1_2_deint_transpose(const _net_fused_layer_1_2_deint_t* p_job, unsigned int core_id) {
+
+    const _net_fused_layer_1_2_deint_target_t* _p_target;
+    const int8_t* _p_src;
+    int8_t* _p_dst;
+    int _num_ch = p_job->num_ch;
+    int _t, _ch;
+    v4s _a, _b, _c, _d, _ab_lo, _ab_hi, _cd_lo, _cd_hi;
+
+    for (int _k = 0; _k < p_job->num_targets; _k++) {
+        _p_target = p_job->targets + _k;
+
+        for (int _j = core_id * 4; _j < _p_target->len; _j += NUM_WORKERS * 4) {
+
+            _t = _p_target->p_start + _j - NET_L1_PAD_START; // time sample of element j in the input
+            _p_dst = _p_target->p_dst + _j;
+
+            if (_t >= p_job->t_start && _t + 4 <= p_job->t_end) {
+
+                _p_src = p_job->p_stage + (_t - p_job->t_start) * _num_ch;
+
+                for (_ch = 0; _ch + 4 <= _num_ch; _ch += 4) {
+                    _a = *((v4s*)(_p_src + 0 * _num_ch + _ch));
+                    _b = *((v4s*)(_p_src + 1 * _num_ch + _ch));
+                    _c = *((v4s*)(_p_src + 2 * _num_ch + _ch));
+                    _d = *((v4s*)(_p_src + 3 * _num_ch + _ch));
+                    _ab_lo = __builtin_shuffle(_a, _b, _SHUFFLEMASK_LO);
+                    _ab_hi = __builtin_shuffle(_a, _b, _SHUFFLEMASK_HI);
+                    _cd_lo = __builtin_shuffle(_c, _d, _SHUFFLEMASK_LO);
+                    _cd_hi = __builtin_shuffle(_c, _d, _SHUFFLEMASK_HI);
+                    *((v4s*)(_p_dst + (_ch + 0) * _p_target->row_len)) = __builtin_shuffle(_ab_lo, _cd_lo, _SHUFFLEMASK_01);
+                    *((v4s*)(_p_dst + (_ch + 1) * _p_target->row_len)) = __builtin_shuffle(_ab_lo, _cd_lo, _SHUFFLEMASK_23);
+                    *((v4s*)(_p_dst + (_ch + 2) * _p_target->row_len)) = __builtin_shuffle(_ab_hi, _cd_hi, _SHUFFLEMASK_01);
+                    *((v4s*)(_p_dst + (_ch + 3) * _p_target->row_len)) = __builtin_shuffle(_ab_hi, _cd_hi, _SHUFFLEMASK_23);
+                }
+
+                // remaining channels
+                for (; _ch < _num_ch; _ch++) {
+                    for (int _i = 0; _i < 4; _i++) {
+                        _p_dst[_ch * _p_target->row_len + _i] = _p_src[_i * _num_ch + _ch];
+                    }
+                }
+
+            } else {
+
+                // the word contains padding
+                for (_ch = 0; _ch < _num_ch; _ch++) {
+                    for (int _i = 0; _i < 4; _i++) {
+                        _p_dst[_ch * _p_target->row_len + _i] =
+                            _t + _i >= p_job->t_start && _t + _i < p_job->t_end
+                            ? p_job->p_stage[(_t + _i - p_job->t_start) * _num_ch + _ch]
+                            : 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif//INTERLEAVED_INPUT
+
 /*
  * Method of duplicating the featuremap 4 times and storing it on L1, shifted by 1 element
  */
 
+#ifdef RING_BUFFER
+
+#ifndef INTERLEAVED_INPUT
 
 /**
- * @brief this function computes the convolution of 4 values in time of all channels
+ * @brief Starts the DMA transfers, which load time samples of some channels into copy 0 on L1
+ *
+ * Loads the time samples p_start .. p_start + len of the padded window into the rows of p_dst.
+ * Samples after the end of the padded window are set to zero. With INTERLEAVED_INPUT, the input is
+ * loaded with _net_fused_layer_1_2_deint_load instead.
+ *
+ * @param p_data_ext Pointer to the input data on L2
+ * @param t_len Number of time samples in the window (not padded)
+ * @param ch_start First channel to load
+ * @param num_ch Number of channels to load
+ * @param p_dst Pointer to the first row on L1
+ * @param row_len Distance between the rows on L1
+ * @param p_start First time sample to load (in the padded window)
+ * @param len Number of time samples to load
+ * @param p_num_transfers Number of transfers started on p_copy, is incremented for every transfer
+ * @param p_copy DMA copy structure, all transfers are merged
+ */
+static void _net_fused_layer_1_2_load_rows(const int8_t* p_data_ext,
+                                           unsigned int t_len,
+                                           int ch_start,
+                                           int num_ch,
+                                           int8_t* p_dst,
+                                           int row_len,
+                                           int p_start,
+                                           int len,
+                                           int* p_num_transfers,
+                                           rt_dma_copy_t* p_copy) {
+
+    int8_t* _p_row;
+
+    unsigned int _pad_len = t_len + NET_L1_PAD_START + NET_L1_PAD_END;
+    int _num = (int)_pad_len - p_start < len ? (int)_pad_len - p_start : len; // elements in the window
+
+    for (int _ch = 0; _ch < num_ch; _ch++) {
+        _p_row = p_dst + _ch * row_len;
+
+        // every row is transferred separately, such that the window length is not limited by the stride
+        if (_num > 0) {
+            rt_dma_memcpy((unsigned int)(p_data_ext + (ch_start + _ch) * _pad_len + p_start),
+                          (unsigned int)_p_row,
+                          sizeof(int8_t) * _num,
+                          RT_DMA_DIR_EXT2LOC, *p_num_transfers > 0, p_copy);
+            (*p_num_transfers)++;
+        }
+        for (int _j = _num > 0 ? _num : 0; _j < len; _j++) {
+            _p_row[_j] = 0;
+        }
+    }
+}
+
+#endif//INTERLEAVED_INPUT
+
+#ifdef CHANNEL_TILES
+
+/**
+ * @brief Starts the DMA transfers, which load one tile of the input into copy 0
+ *
+ * The tile contains the channels tile * _TILE_C .. (tile + 1) * _TILE_C (or less for the last tile)
+ * and the samples chunk * _RING_CHUNK .. (chunk + 1) * _RING_CHUNK + _TILE_HALO of the padded window.
+ *
+ * @param p_data_ext Pointer to the input data on L2
+ * @param t_len Number of time samples in the window (not padded)
+ * @param p_tile Pointer to the tile buffer on L1 (copy 0)
+ * @param chunk Index of the chunk
+ * @param tile Index of the channel tile
+ * @param p_job De-interleave job, the tile is only loaded into its staging buffer, and must be
+ *        transposed afterwards (only used with INTERLEAVED_INPUT)
+ * @param p_copy DMA copy structure, all transfers are merged
+ * @returns Number of started transfers, rt_dma_wait must only be called if it is not zero
+ */
+static int _net_fused_layer_1_2_tile_load(const int8_t* p_data_ext,
+                                          unsigned int t_len,
+                                          int8_t* p_tile,
+                                          int chunk,
+                                          int tile,
+                                          _net_fused_layer_1_2_deint_t* p_job,
+                                          rt_dma_copy_t* p_copy) {
+
+    int _ch_start = tile * _TILE_C;
+    int _num_ch = NET_C - _ch_start < _TILE_C ? NET_C - _ch_start : _TILE_C;
+
+#ifdef INTERLEAVED_INPUT
+
+    p_job->num_ch = _num_ch;
+    p_job->num_targets = 1;
+    p_job->targets[0] = (_net_fused_layer_1_2_deint_target_t){p_tile, _TILE_ROW, chunk * _RING_CHUNK, _TILE_ROW};
+
+    return _net_fused_layer_1_2_deint_load(p_job, p_data_ext, t_len, _ch_start, p_copy);
+
+#else//INTERLEAVED_INPUT
+
+    (void)p_job;
+    int _num_transfers = 0;
+
+    _net_fused_layer_1_2_load_rows(p_data_ext, t_len, _ch_start, _num_ch, p_tile, _TILE_ROW,
+                                   chunk * _RING_CHUNK, _TILE_ROW, &_num_transfers, p_copy);
+
+    return _num_transfers;
+
+#endif//INTERLEAVED_INPUT
+}
+
+/**
+ * @brief Builds the copies 1, 2 and 3 of a tile, by shifting copy 0 (in parallel)
+ *
+ * Every word of copy k is extracted from two neighbouring words of copy 0 with a shuffle. The last
+ * word of every row is not needed by the convolution, and is not computed. This function must be
+ * called by all cores, and must be followed by a barrier.
+ *
+ * @param p_tile Pointer to the tile buffer on L1 (copy 0)
+ * @param core_id
+ */
+static void _net_fused_layer_1_2_tile_shift(int8_t* p_tile, unsigned int core_id) {
+
+    const v4s* _p_src;
+    v4s* _p_dst1;
+    v4s* _p_dst2;
+    v4s* _p_dst3;
+    v4s _x0, _x1;
+
+    for (int _ch = core_id; _ch < _TILE_C; _ch += NUM_WORKERS) {
+
+        _p_src = (const v4s*)(p_tile + _ch * _TILE_ROW);
+        _p_dst1 = (v4s*)(p_tile + 1 * _COPY_MEM_SIZE + _ch * _TILE_ROW);
+        _p_dst2 = (v4s*)(p_tile + 2 * _COPY_MEM_SIZE + _ch * _TILE_ROW);
+        _p_dst3 = (v4s*)(p_tile + 3 * _COPY_MEM_SIZE + _ch * _TILE_ROW);
+
+        _x0 = *(_p_src++);
+        for (int _i = 0; _i < _TILE_ROW / 4 - 1; _i++) {
+            _x1 = *(_p_src++);
+            *(_p_dst1++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK1);
+            *(_p_dst2++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK2);
+            *(_p_dst3++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK3);
+            _x0 = _x1;
+        }
+    }
+}
+
+#else//CHANNEL_TILES
+
+/**
+ * @brief Starts the DMA transfers, which load one chunk of the input into copy 0 of the ring
+ *
+ * The chunk is stored in the slot chunk % _RING_SLOTS. The first chunk of the ring is also stored
+ * in the mirror after the end of the ring.
+ *
+ * @param p_data_ext Pointer to the input data on L2
+ * @param t_len Number of time samples in the window (not padded)
+ * @param p_ring Pointer to the ring on L1 (copy 0)
+ * @param chunk Index of the chunk, it contains the samples chunk * _RING_CHUNK of the padded window
+ * @param p_job De-interleave job, the chunk is only loaded into its staging buffer, and must be
+ *        transposed afterwards (only used with INTERLEAVED_INPUT)
+ * @param p_copy DMA copy structure, all transfers are merged
+ * @returns Number of started transfers, rt_dma_wait must only be called if it is not zero
+ */
+static int _net_fused_layer_1_2_ring_load(const int8_t* p_data_ext,
+                                          unsigned int t_len,
+                                          int8_t* p_ring,
+                                          int chunk,
+                                          _net_fused_layer_1_2_deint_t* p_job,
+                                          rt_dma_copy_t* p_copy) {
+
+    int _slot = chunk % _RING_SLOTS;
+
+#ifdef INTERLEAVED_INPUT
+
+    // the mirror is transposed from the same staging buffer
+    p_job->num_ch = NET_C;
+    p_job->num_targets = _slot == 0 ? 2 : 1;
+    p_job->targets[0] = (_net_fused_layer_1_2_deint_target_t){p_ring + _slot * _RING_CHUNK, _RING_ROW, chunk * _RING_CHUNK, _RING_CHUNK};
+    p_job->targets[1] = (_net_fused_layer_1_2_deint_target_t){p_ring + _RING_LEN, _RING_ROW, chunk * _RING_CHUNK, _RING_MIRROR};
+
+    return _net_fused_layer_1_2_deint_load(p_job, p_data_ext, t_len, 0, p_copy);
+
+#else//INTERLEAVED_INPUT
+
+    (void)p_job;
+    int _num_transfers = 0;
+
+    _net_fused_layer_1_2_load_rows(p_data_ext, t_len, 0, NET_C, p_ring + _slot * _RING_CHUNK, _RING_ROW,
+                                   chunk * _RING_CHUNK, _RING_CHUNK, &_num_transfers, p_copy);
+    if (_slot == 0) {
+        _net_fused_layer_1_2_load_rows(p_data_ext, t_len, 0, NET_C, p_ring + _RING_LEN, _RING_ROW,
+                                       chunk * _RING_CHUNK, _RING_MIRROR, &_num_transfers, p_copy);
+    }
+
+    return _num_transfers;
+
+#endif//INTERLEAVED_INPUT
+}
+
+/**
+ * @brief Builds the copies 1, 2 and 3 of a part of the ring, by shifting copy 0 (in parallel)
+ *
+ * Every word of copy k is extracted from two neighbouring words of copy 0 with a shuffle. When a
+ * chunk arrives, the words pos .. pos + len are shifted, which start 4 samples before the chunk
+ * (the last word of the previous chunk needs the first samples of this one). Words in the mirror
+ * region are written twice. This function must be called by all cores, and must be followed by a
+ * barrier.
+ *
+ * @param p_ring Pointer to the ring on L1 (copy 0)
+ * @param pos Position of the first word in the ring, divisible by 4
+ * @param len Number of time samples to shift, divisible by 4
+ * @param core_id
+ */
+static void _net_fused_layer_1_2_ring_shift(int8_t* p_ring,
+                                            int pos,
+                                            int len,
+                                            unsigned int core_id) {
+
+    int8_t* _p_row;
+    v4s _x0, _x1, _y1, _y2, _y3;
+    int _pos;
+
+    for (int _ch = core_id; _ch < NET_C; _ch += NUM_WORKERS) {
+
+        _p_row = p_ring + _ch * _RING_ROW;
+        _pos = pos;
+
+        _x0 = *((v4s*)(_p_row + _pos));
+        for (int _i = 0; _i < len / 4; _i++) {
+            // the word after the end of the ring is in the mirror, which contains the same samples as
+            // the start of the ring. Thus, _x0 is also valid after wrapping around
+            _x1 = *((v4s*)(_p_row + _pos + 4));
+            _y1 = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK1);
+            _y2 = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK2);
+            _y3 = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK3);
+            *((v4s*)(_p_row + 1 * _COPY_MEM_SIZE + _pos)) = _y1;
+            *((v4s*)(_p_row + 2 * _COPY_MEM_SIZE + _pos)) = _y2;
+            *((v4s*)(_p_row + 3 * _COPY_MEM_SIZE + _pos)) = _y3;
+            if (_pos < _RING_MIRROR) {
+                *((v4s*)(_p_row + 1 * _COPY_MEM_SIZE + _RING_LEN + _pos)) = _y1;
+                *((v4s*)(_p_row + 2 * _COPY_MEM_SIZE + _RING_LEN + _pos)) = _y2;
+                *((v4s*)(_p_row + 3 * _COPY_MEM_SIZE + _RING_LEN + _pos)) = _y3;
+            }
+            _x0 = _x1;
+            _pos += 4;
+            if (_pos == _RING_LEN) {
+                _pos = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the position in the ring of the first word, which must be shifted when the chunk arrives
+ */
+static inline int _net_fused_layer_1_2_ring_shift_pos(int chunk) {
+    int _slot = chunk % _RING_SLOTS;
+    return _slot == 0 ? _RING_LEN - 4 : _slot * _RING_CHUNK - 4;
+}
+
+#endif//CHANNEL_TILES
+
+#else//RING_BUFFER
+
+/**
+ * @brief Starts the DMA transfers, which load one split of the input into the 4 copies on L1
+ *
+ * Copy k contains the (padded) time samples t_start + k .. t_start + k + len of all channels, of
+ * shape [NET_C, len].
+ *
+ * If DUPLICATE_IN_L1 is enabled, only copy 0 and the 4 time samples after the split (p_tail, of
+ * shape [NET_C, 4]) are loaded, such that every input sample is read only once from L2. The other
+ * copies are built afterwards with _net_fused_layer_1_2_shift_split.
+ *
+ * If INTERLEAVED_INPUT is enabled, the input is not padded and stored as [NET_T, NET_C]. Then, the
+ * time samples of the split are loaded with a single transfer into the staging buffer of p_job, and
+ * must be transposed into the copies (and the tail) with _net_fused_layer_1_2_deint_transpose.
+ *
+ * @param p_data_ext Pointer to the input data on L2
+ * @param p_split Pointer to the first copy on L1, the copies are _T_SPLIT_MEM_SIZE apart
+ * @param p_tail Pointer to the tail on L1 (only used with DUPLICATE_IN_L1)
+ * @param t_start First time sample of the split (in the padded input)
+ * @param len Number of time samples in the split
+ * @param p_job De-interleave job of the slot (only used with INTERLEAVED_INPUT)
+ * @param p_copy DMA copy structure, all transfers are merged
+ */
+static void _net_fused_layer_1_2_load_split(const int8_t* p_data_ext,
+                                            int8_t* p_split,
+                                            int8_t* p_tail,
+                                            int t_start,
+                                            int len,
+                                            _net_fused_layer_1_2_deint_t* p_job,
+                                            rt_dma_copy_t* p_copy) {
+
+#ifdef INTERLEAVED_INPUT
+
+    p_job->num_ch = NET_C;
+
+#ifdef DUPLICATE_IN_L1
+    // copy 0 and the tail
+    p_job->num_targets = 2;
+    p_job->targets[0] = (_net_fused_layer_1_2_deint_target_t){p_split, len, t_start, len};
+    p_job->targets[1] = (_net_fused_layer_1_2_deint_target_t){p_tail, 4, t_start + len, 4};
+#else//DUPLICATE_IN_L1
+    // all 4 copies
+    (void)p_tail;
+    p_job->num_targets = 4;
+    for (int _k = 0; _k < 4; _k++) {
+        p_job->targets[_k] = (_net_fused_layer_1_2_deint_target_t){p_split + _k * _T_SPLIT_MEM_SIZE, len, t_start + _k, len};
+    }
+#endif//DUPLICATE_IN_L1
+
+    // the split always contains input samples, thus the transfer is always started
+    _net_fused_layer_1_2_deint_load(p_job, p_data_ext, NET_T, 0, p_copy);
+
+#else//INTERLEAVED_INPUT
+
+    (void)p_job;
+
+#ifdef DUPLICATE_IN_L1
+
+    rt_dma_memcpy_2d((unsigned int)(p_data_ext + t_start),
+                     (unsigned int)p_split,
+                     sizeof(int8_t) * NET_C * len,          // number of elements in total
+                     sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
+                     sizeof(int8_t) * len,                  // number of elements to transfer per line
+                     RT_DMA_DIR_EXT2LOC, 0, p_copy);
+
+    // The padded input length and all splits are divisible by 4: either, there are (at least) 4 more
+    // samples after the split, or it is the last split. Then, the tail is never used for the output.
+    if (t_start + len < NET_L1_PAD_INPUT_LEN) {
+        rt_dma_memcpy_2d((unsigned int)(p_data_ext + t_start + len),
+                         (unsigned int)p_tail,
+                         sizeof(int8_t) * NET_C * 4,
+                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN,
+                         sizeof(int8_t) * 4,
+                         RT_DMA_DIR_EXT2LOC, 1, p_copy);
+    } else {
+        for (int _i = 0; _i < NET_C; _i++) {
+            *((int32_t*)p_tail + _i) = 0;
+        }
+    }
+
+#else//DUPLICATE_IN_L1
+
+    (void)p_tail;
+
+    for (int _k = 0; _k < 4; _k++) {
+        rt_dma_memcpy_2d((unsigned int)(p_data_ext + t_start + _k),
+                         (unsigned int)(p_split + _k * _T_SPLIT_MEM_SIZE),
+                         sizeof(int8_t) * NET_C * len,         // number of elements in total
+                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
+                         sizeof(int8_t) * len,                 // number of elements to transfer per line
+                         RT_DMA_DIR_EXT2LOC, _k > 0, p_copy);
+    }
+
+#endif//DUPLICATE_IN_L1
+
+#endif//INTERLEAVED_INPUT
+
+}
+
+#ifdef DUPLICATE_IN_L1
+
+/**
+ * @brief Builds the copies 1, 2 and 3 of a split on L1, by shifting copy 0 (in parallel)
  *
+ * Every word of copy k is extracted from two neighbouring words of copy 0 with a shuffle, and the
+ * last word of every row uses the tail. Every core shifts a subset of the channels. This function
+ * must be called by all cores, and must be followed by a barrier.
+ *
+ * @param p_split Pointer to the first copy on L1, loaded by _net_fused_layer_1_2_load_split
+ * @param p_tail Pointer to the tail of shape [NET_C, 4] on L1
+ * @param len Number of time samples in the split, divisible by 4
  * @param core_id
+ */
+static void _net_fused_layer_1_2_shift_split(int8_t* p_split,
+                                             const int8_t* p_tail,
+                                             int len,
+                                             unsigned int core_id) {
+
+    const v4s* _p_src;
+    v4s* _p_dst1;
+    v4s* _p_dst2;
+    v4s* _p_dst3;
+    v4s _x0, _x1;
+
+    for (int _ch = core_id; _ch < NET_C; _ch += NUM_WORKERS) {
+
+        _p_src = (const v4s*)(p_split + _ch * len);
+        _p_dst1 = (v4s*)(p_split + 1 * _T_SPLIT_MEM_SIZE + _ch * len);
+        _p_dst2 = (v4s*)(p_split + 2 * _T_SPLIT_MEM_SIZE + _ch * len);
+        _p_dst3 = (v4s*)(p_split + 3 * _T_SPLIT_MEM_SIZE + _ch * len);
+
+        _x0 = *(_p_src++);
+        for (int _i = 0; _i < len / 4; _i++) {
+            // the word after the last one of the row is in the tail
+            _x1 = _i < len / 4 - 1 ? *(_p_src++) : *((const v4s*)(p_tail + _ch * 4));
+            *(_p_dst1++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK1);
+            *(_p_dst2++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK2);
+            *(_p_dst3++) = __builtin_shuffle(_x0, _x1, _SHUFFLEMASK3);
+            _x0 = _x1;
+        }
+    }
+}
+
+#endif//DUPLICATE_IN_L1
+
+#endif//RING_BUFFER
+
+
+#ifdef L1_RESULT_INT16
+
+/**
+ * @brief Sets the result of channel num_ch to zero, if num_ch is odd, since layer 2 is computed on
+ * pairs of channels
+ *
+ * @param num_ch Number of channels in p_result
+ * @param p_result Pointer to the thread local data of size [4, _THREAD_STRIDE]
+ */
+static inline void _net_fused_layer_1_2_pad_result(unsigned int num_ch, _l1_result_t* p_result) {
+    if (num_ch & 1) {
+        *(p_result + num_ch + 0 * _THREAD_STRIDE) = 0;
+        *(p_result + num_ch + 1 * _THREAD_STRIDE) = 0;
+        *(p_result + num_ch + 2 * _THREAD_STRIDE) = 0;
+        *(p_result + num_ch + 3 * _THREAD_STRIDE) = 0;
+    }
+}
+
+#endif//L1_RESULT_INT16
+
+/**
+ * @brief this function computes the convolution of 4 values in time of all channels
+ *
+ * @param core_id (unused)
  * @param p_data pointer to the current data where we start the convolution, must be in the first channel
  * @param stride number of elements in a single row of data
  * @param p_weight Pointer to the weight vector
  * @param offset Amount to offset the result at the end of the computation
- * @param p_result pointer to the result data of size [4, NET_C_ALIGN], must be thread local data
+ * @param num_ch Number of channels to compute (NET_C, or the channels of a tile)
+ * @param p_result pointer to the result data of size [4, _THREAD_STRIDE], must be thread local data
  */
 void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
                                       const int8_t* p_data,
                                       unsigned int stride,
                                       const int8_t* p_weight,
                                       uint32_t offset,
-                                      int32_t* p_result) {
+                                      unsigned int num_ch,
+                                      _l1_result_t* p_result) {
+
+    // the channels are not rotated by the core id
+    (void)core_id;
 
     // setup iterators
     const int8_t* _p_data_iter0;
@@ -124,7 +905,7 @@ void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
     // declare local variables
     int32_t _acc0, _acc1, _acc2, _acc3;
 
-    for (int _ch_t = 0; _ch_t < NET_C; _ch_t++) {
+    for (unsigned int _ch_t = 0; _ch_t < num_ch; _ch_t++) {
 
         //int _ch = _ch_t + core_id;
         //if (_ch >= NET_C) _ch -= NET_C;
@@ -132,9 +913,9 @@ void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
 
         // setup the iteration
         _p_data_iter0 = p_data + _ch * stride;
-        _p_data_iter1 = p_data + _ch * stride + 1 * _T_SPLIT_MEM_SIZE;
-        _p_data_iter2 = p_data + _ch * stride + 2 * _T_SPLIT_MEM_SIZE;
-        _p_data_iter3 = p_data + _ch * stride + 3 * _T_SPLIT_MEM_SIZE;
+        _p_data_iter1 = p_data + _ch * stride + 1 * _COPY_MEM_SIZE;
+        _p_data_iter2 = p_data + _ch * stride + 2 * _COPY_MEM_SIZE;
+        _p_data_iter3 = p_data + _ch * stride + 3 * _COPY_MEM_SIZE;
         _p_weight_iter = p_weight;
 
         _acc0 = offset;
@@ -142,6 +923,21 @@ void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
         _acc2 = offset;
         _acc3 = offset;
 
+#ifdef HOST
+        // replacement of the hardware loop (lp.setup) for the host build
+        for (unsigned int _k = 0; _k < NET_L1_WEIGHT_LEN / 4; _k++) {
+            v4s _w = *((const v4s*)_p_weight_iter);
+            _acc0 = __SUMDOTP4(*((const v4s*)_p_data_iter0), _w, _acc0);
+            _acc1 = __SUMDOTP4(*((const v4s*)_p_data_iter1), _w, _acc1);
+            _acc2 = __SUMDOTP4(*((const v4s*)_p_data_iter2), _w, _acc2);
+            _acc3 = __SUMDOTP4(*((const v4s*)_p_data_iter3), _w, _acc3);
+            _p_weight_iter += 4;
+            _p_data_iter0 += 4;
+            _p_data_iter1 += 4;
+            _p_data_iter2 += 4;
+            _p_data_iter3 += 4;
+        }
+#else//HOST
         asm volatile("lp.setup x0,%[num_t],36;"
                      "   p.lw s9,4(%[p_weight]!);"
                      "   p.lw s5,4(%[p_data0]!);"
@@ -163,15 +959,22 @@ void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
                        [p_data3] "+r" (_p_data_iter3)
                      : [num_t] "r" (NET_L1_WEIGHT_LEN / 4)
                      : "s5", "s6", "s7", "s8", "s9");
+#endif//HOST
 
         // store the values as 1 byte in the appropriate position
-        *(p_result + _ch + 0 * NET_C) = _acc0;
-        *(p_result + _ch + 1 * NET_C) = _acc1;
-        *(p_result + _ch + 2 * NET_C) = _acc2;
-        *(p_result + _ch + 3 * NET_C) = _acc3;
+        *(p_result + _ch_t + 0 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc0);
+        *(p_result + _ch_t + 1 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc1);
+        *(p_result + _ch_t + 2 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc2);
+        *(p_result + _ch_t + 3 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc3);
     }
+
+#ifdef L1_RESULT_INT16
+    _net_fused_layer_1_2_pad_result(num_ch, p_result);
+#endif//L1_RESULT_INT16
 }
 
+#ifndef RING_BUFFER
+
 /**
  * @brief this function computes the convolution of 4 values in time of all channels at a split transition
  *
@@ -182,7 +985,8 @@ void _net_fused_layer_1_2_kernel_conv(unsigned int core_id,
  * @param num_elems_in_a Number of elements which are in part A. Must be a multiple of 4
  * @param p_weight Pointer to the weight vector
  * @param offset Amount to offset the result at the end of the computation
- * @param p_result pointer to the result data of size [4, NET_C_ALIGN], must be thread local data
+ * @param num_ch Number of channels to compute (NET_C, or the channels of a tile)
+ * @param p_result pointer to the result data of size [4, _THREAD_STRIDE], must be thread local data
  */
 void _net_fused_layer_1_2_kernel_conv_transition(const int8_t* p_data_a,
                                                  const int8_t* p_data_b,
@@ -191,207 +995,1023 @@ void _net_fused_layer_1_2_kernel_conv_transition(const int8_t* p_data_a,
                                                  unsigned int num_elems_in_a,
                                                  const int8_t* p_weight,
                                                  uint32_t offset,
-                                                 int32_t* p_result) {
+                                                 unsigned int num_ch,
+                                                 _l1_result_t* p_result) {
+
+
+    // setup iterators
+    const int8_t* _p_data_iter0;
+    const int8_t* _p_data_iter1;
+    const int8_t* _p_data_iter2;
+    const int8_t* _p_data_iter3;
+    const int8_t* _p_weight_iter = p_weight;
+    _l1_result_t* _p_result_iter = p_result;
+
+    // declare local variables
+    int32_t _acc0, _acc1, _acc2, _acc3;
+
+    for (unsigned int _ch_t = 0; _ch_t < num_ch; _ch_t++) {
+
+        int _ch = _ch_t;
+
+        // setup the iteration
+        _p_weight_iter = p_weight;
+
+        _acc0 = offset;
+        _acc1 = offset;
+        _acc2 = offset;
+        _acc3 = offset;
+
+        // part in split A
+        _p_data_iter0 = p_data_a + _ch * stride_a;
+        _p_data_iter1 = p_data_a + _ch * stride_a + 1 * _T_SPLIT_MEM_SIZE;
+        _p_data_iter2 = p_data_a + _ch * stride_a + 2 * _T_SPLIT_MEM_SIZE;
+        _p_data_iter3 = p_data_a + _ch * stride_a + 3 * _T_SPLIT_MEM_SIZE;
+
+#ifdef HOST
+        // replacement of the hardware loop (lp.setup) for the host build
+        for (unsigned int _k = 0; _k < num_elems_in_a / 4; _k++) {
+            v4s _w = *((const v4s*)_p_weight_iter);
+            _acc0 = __SUMDOTP4(*((const v4s*)_p_data_iter0), _w, _acc0);
+            _acc1 = __SUMDOTP4(*((const v4s*)_p_data_iter1), _w, _acc1);
+            _acc2 = __SUMDOTP4(*((const v4s*)_p_data_iter2), _w, _acc2);
+            _acc3 = __SUMDOTP4(*((const v4s*)_p_data_iter3), _w, _acc3);
+            _p_weight_iter += 4;
+            _p_data_iter0 += 4;
+            _p_data_iter1 += 4;
+            _p_data_iter2 += 4;
+            _p_data_iter3 += 4;
+        }
+#else//HOST
+        asm volatile("lp.setup x0,%[num_t],36;"
+                     "   p.lw s9,4(%[p_weight]!);"
+                     "   p.lw s5,4(%[p_data0]!);"
+                     "   p.lw s6,4(%[p_data1]!);"
+                     "   p.lw s7,4(%[p_data2]!);"
+                     "   p.lw s8,4(%[p_data3]!);"
+                     "   pv.sdotsp.b %[_acc0],s5,s9;"
+                     "   pv.sdotsp.b %[_acc1],s6,s9;"
+                     "   pv.sdotsp.b %[_acc2],s7,s9;"
+                     "36:pv.sdotsp.b %[_acc3],s8,s9;"
+                     : [p_weight] "+r" (_p_weight_iter),
+                       [_acc0] "+r" (_acc0),
+                       [_acc1] "+r" (_acc1),
+                       [_acc2] "+r" (_acc2),
+                       [_acc3] "+r" (_acc3),
+                       [p_data0] "+r" (_p_data_iter0),
+                       [p_data1] "+r" (_p_data_iter1),
+                       [p_data2] "+r" (_p_data_iter2),
+                       [p_data3] "+r" (_p_data_iter3)
+                     : [num_t] "r" (num_elems_in_a / 4)
+                     : "s5", "s6", "s7", "s8", "s9");
+#endif//HOST
+
+        if (num_elems_in_a < NET_L1_WEIGHT_LEN) {
+            // part in split B
+            _p_data_iter0 = p_data_b + _ch * stride_b;
+            _p_data_iter1 = p_data_b + _ch * stride_b + 1 * _T_SPLIT_MEM_SIZE;
+            _p_data_iter2 = p_data_b + _ch * stride_b + 2 * _T_SPLIT_MEM_SIZE;
+            _p_data_iter3 = p_data_b + _ch * stride_b + 3 * _T_SPLIT_MEM_SIZE;
+
+#ifdef HOST
+            // replacement of the hardware loop (lp.setup) for the host build
+            for (unsigned int _k = 0; _k < (NET_L1_WEIGHT_LEN - num_elems_in_a) / 4; _k++) {
+                v4s _w = *((const v4s*)_p_weight_iter);
+                _acc0 = __SUMDOTP4(*((const v4s*)_p_data_iter0), _w, _acc0);
+                _acc1 = __SUMDOTP4(*((const v4s*)_p_data_iter1), _w, _acc1);
+                _acc2 = __SUMDOTP4(*((const v4s*)_p_data_iter2), _w, _acc2);
+                _acc3 = __SUMDOTP4(*((const v4s*)_p_data_iter3), _w, _acc3);
+                _p_weight_iter += 4;
+                _p_data_iter0 += 4;
+                _p_data_iter1 += 4;
+                _p_data_iter2 += 4;
+                _p_data_iter3 += 4;
+            }
+#else//HOST
+            asm volatile("lp.setup x0,%[num_t],36;"
+                        "   p.lw s9,4(%[p_weight]!);"
+                        "   p.lw s5,4(%[p_data0]!);"
+                        "   p.lw s6,4(%[p_data1]!);"
+                        "   p.lw s7,4(%[p_data2]!);"
+                        "   p.lw s8,4(%[p_data3]!);"
+                        "   pv.sdotsp.b %[_acc0],s5,s9;"
+                        "   pv.sdotsp.b %[_acc1],s6,s9;"
+                        "   pv.sdotsp.b %[_acc2],s7,s9;"
+                        "36:pv.sdotsp.b %[_acc3],s8,s9;"
+                        : [p_weight] "+r" (_p_weight_iter),
+                        [_acc0] "+r" (_acc0),
+                        [_acc1] "+r" (_acc1),
+                        [_acc2] "+r" (_acc2),
+                        [_acc3] "+r" (_acc3),
+                        [p_data0] "+r" (_p_data_iter0),
+                        [p_data1] "+r" (_p_data_iter1),
+                        [p_data2] "+r" (_p_data_iter2),
+                        [p_data3] "+r" (_p_data_iter3)
+                        : [num_t] "r" ((NET_L1_WEIGHT_LEN - num_elems_in_a) / 4)
+                        : "s5", "s6", "s7", "s8", "s9");
+#endif//HOST
+        }
+
+        // store the values as 1 byte in the appropriate position
+        *(_p_result_iter + 0 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc0);
+        *(_p_result_iter + 1 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc1);
+        *(_p_result_iter + 2 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc2);
+        *(_p_result_iter + 3 * _THREAD_STRIDE) = _L1_RESULT_CLIP(_acc3);
+
+        // go to the next value in the thread data
+        _p_result_iter++;
+    }
+
+#ifdef L1_RESULT_INT16
+    _net_fused_layer_1_2_pad_result(num_ch, p_result);
+#endif//L1_RESULT_INT16
+}
+
+#endif//RING_BUFFER
+
+/**
+ * @brief Compute the result of the dot product for the second layer and add them to the current pooling sum
+ *
+ * @param p_data Pointer to input data of shape [4, _THREAD_STRIDE], must be the thread local data, the result of the function above
+ * @param p_weight Pointer to the weight vector of the layer 2
+ * @param num_ch Number of channels in p_data (padded to an even number with L1_RESULT_INT16)
+ * @param threshold_0 Threshold for ReLU of the first output channel
+ * @param threshold_1 Threshold for ReLU of the second output channel
+ * @param cap_0 Cap of the ReLU of the first output channel (only used with L2_RELU_CAP)
+ * @param cap_1 Cap of the ReLU of the second output channel (only used with L2_RELU_CAP)
+ * @param p_pool_sum_0 Pointer to the first pool sum value, which is updated in this function
+ * @param p_pool_sum_1 Pointer to the second pool sum value, which is updated in this function
+ */
+void _net_fused_layer_1_2_kernel_dotp_acc(const _l1_result_t* p_data,
+                                          const _l1_result_t* p_weight,
+                                          unsigned int num_ch,
+                                          int32_t threshold_0,
+                                          int32_t threshold_1,
+                                          int32_t cap_0,
+                                          int32_t cap_1,
+                                          _l2_pool_t* p_pool_sum_0,
+                                          _l2_pool_t* p_pool_sum_1) {
+
+    // iterators
+    const _l1_result_t* _p_data_iter = p_data;
+    const _l1_result_t* _p_weight_iter = p_weight;
+
+    // local registers
+    int32_t _elem_0_0 = 0, _elem_0_1 = 0, _elem_0_2 = 0, _elem_0_3 = 0;
+    int32_t _elem_1_0 = 0, _elem_1_1 = 0, _elem_1_2 = 0, _elem_1_3 = 0;
+
+    // registers for the pool sum
+    _l2_pool_t _pool_sum_0 = *p_pool_sum_0;
+    _l2_pool_t _pool_sum_1 = *p_pool_sum_1;
+
+#ifdef L1_RESULT_INT16
+
+    v2s _a0, _a1, _a2, _a3;
+    v2s _b0, _b1;
+
+    // two channels at once
+    for (unsigned int _ch = 0; _ch < num_ch; _ch += 2) {
+
+        _a0 = *((v2s*)(_p_data_iter + 0 * _THREAD_STRIDE));
+        _a1 = *((v2s*)(_p_data_iter + 1 * _THREAD_STRIDE));
+        _a2 = *((v2s*)(_p_data_iter + 2 * _THREAD_STRIDE));
+        _a3 = *((v2s*)(_p_data_iter + 3 * _THREAD_STRIDE));
+
+        _b0 = *((v2s*)_p_weight_iter);
+        _b1 = *((v2s*)(_p_weight_iter + NET_L2_WEIGHT_LEN));
+
+        _p_data_iter += 2;
+        _p_weight_iter += 2;
+
+        _elem_0_0 = __SUMDOTP2(_a0, _b0, _elem_0_0);
+        _elem_0_1 = __SUMDOTP2(_a1, _b0, _elem_0_1);
+        _elem_0_2 = __SUMDOTP2(_a2, _b0, _elem_0_2);
+        _elem_0_3 = __SUMDOTP2(_a3, _b0, _elem_0_3);
+
+        _elem_1_0 = __SUMDOTP2(_a0, _b1, _elem_1_0);
+        _elem_1_1 = __SUMDOTP2(_a1, _b1, _elem_1_1);
+        _elem_1_2 = __SUMDOTP2(_a2, _b1, _elem_1_2);
+        _elem_1_3 = __SUMDOTP2(_a3, _b1, _elem_1_3);
+
+    }
+
+#else//L1_RESULT_INT16
+
+    int32_t _a0, _a1, _a2, _a3;
+    int32_t _b0, _b1;
+
+    for (unsigned int _ch = 0; _ch < num_ch; _ch++) {
+
+        _a0 = *(_p_data_iter + 0 * _THREAD_STRIDE);
+        _a1 = *(_p_data_iter + 1 * _THREAD_STRIDE);
+        _a2 = *(_p_data_iter + 2 * _THREAD_STRIDE);
+        _a3 = *(_p_data_iter + 3 * _THREAD_STRIDE);
+
+        _b0 = *_p_weight_iter;
+        _b1 = *(_p_weight_iter + NET_L2_WEIGHT_LEN);
+
+        _p_data_iter++;
+        _p_weight_iter++;
+
+        _elem_0_0 = __MAC(_elem_0_0, _b0, _a0);
+        _elem_0_1 = __MAC(_elem_0_1, _b0, _a1);
+        _elem_0_2 = __MAC(_elem_0_2, _b0, _a2);
+        _elem_0_3 = __MAC(_elem_0_3, _b0, _a3);
+
+        _elem_1_0 = __MAC(_elem_1_0, _b1, _a0);
+        _elem_1_1 = __MAC(_elem_1_1, _b1, _a1);
+        _elem_1_2 = __MAC(_elem_1_2, _b1, _a2);
+        _elem_1_3 = __MAC(_elem_1_3, _b1, _a3);
+
+    }
+
+#endif//L1_RESULT_INT16
+
+    // do ReLU on the first and second element
+    _elem_0_0 = _L2_RELU(_elem_0_0, threshold_0, cap_0);
+    _elem_0_1 = _L2_RELU(_elem_0_1, threshold_0, cap_0);
+    _elem_0_2 = _L2_RELU(_elem_0_2, threshold_0, cap_0);
+    _elem_0_3 = _L2_RELU(_elem_0_3, threshold_0, cap_0);
+
+    _elem_1_0 = _L2_RELU(_elem_1_0, threshold_1, cap_1);
+    _elem_1_1 = _L2_RELU(_elem_1_1, threshold_1, cap_1);
+    _elem_1_2 = _L2_RELU(_elem_1_2, threshold_1, cap_1);
+    _elem_1_3 = _L2_RELU(_elem_1_3, threshold_1, cap_1);
+
+    // sum up the values (unsigned, the partial sums may wrap around)
+    _pool_sum_0 += (_l2_pool_t)_elem_0_0 + _elem_0_1 + _elem_0_2 + _elem_0_3;
+    _pool_sum_1 += (_l2_pool_t)_elem_1_0 + _elem_1_1 + _elem_1_2 + _elem_1_3;
+
+    // store the results back
+    *p_pool_sum_0 = _pool_sum_0;
+    *p_pool_sum_1 = _pool_sum_1;
+}
+
+/**
+ * @brief Applies the final transformation of the pooling result and stores it back into the array
+ *
+ * @param pool_sum_0 Sum of all results for output cannel 0
+ * @param pool_sum_1 Sum of all results for output cannel 1
+ * @param factor_0 Scaling division factor for output cannel 0
+ * @param factor_1 Scaling division factor for output cannel 1
+ * @param offset_0 Offset for output channel 0
+ * @param offset_1 Offset for output channel 1
+ * @param p_result Pointer to result array (already at the correct position)
+ */
+inline void _net_fused_layer_1_2_kernel_store_result(_l2_pool_t pool_sum_0,
+                                                     _l2_pool_t pool_sum_1,
+                                                     int32_t factor_0,
+                                                     int32_t factor_1,
+                                                     int32_t offset_0,
+                                                     int32_t offset_1,
+                                                     int8_t* p_result) {
+
+    // scale it (the sum plus the offset is not negative, and the factor is positive)
+    pool_sum_0 = (pool_sum_0 + (uint32_t)offset_0) / (uint32_t)factor_0;
+    pool_sum_1 = (pool_sum_1 + (uint32_t)offset_1) / (uint32_t)factor_1;
+
+    // clip it
+    pool_sum_0 = _L2_POOL_CLIP(pool_sum_0);
+    pool_sum_1 = _L2_POOL_CLIP(pool_sum_1);
+
+    // store it
+    *(p_result + 0 * _RESULT_STRIDE) = pool_sum_0;
+    *(p_result + 1 * _RESULT_STRIDE) = pool_sum_1;
+
+}
+
+#ifdef RING_BUFFER
+
+typedef struct {
+    const int8_t* p_data_ext;
+    int8_t* p_result_ext;
+    unsigned int t_len;
+    unsigned int result_stride;
+
+    int8_t* p_data;
+    int8_t* p_result;
+
+    int8_t* p_weight_l1;
+    int32_t* p_factor_l1;
+    int32_t* p_offset_l1;
+
+    _l1_result_t* p_weight_l2;
+    int32_t* p_factor_l2;
+    int32_t* p_offset_l2;
+
+    _l1_result_t* p_thread_data;
+    int32_t* p_acc;
+
+    net_pipeline_t* p_pipeline;
+
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t deint; // shared by all cores, filled by core 0
+#endif//INTERLEAVED_INPUT
+} _net_fused_layer_1_2_kernel_t;
+
+#ifdef CHANNEL_TILES
+
+/**
+ * @brief Computes the partial dot product of the layer 2 over one tile of channels
+ *
+ * @param p_data Pointer to the result of the convolution, of shape [4, _THREAD_STRIDE], the thread local data
+ * @param p_weight Pointer to the weights of layer 2 of the first channel in the tile
+ * @param num_ch Number of channels in the tile (padded to an even number with L1_RESULT_INT16)
+ * @param p_acc_0 Pointer to the 4 partial sums of the first output channel, which are updated
+ * @param p_acc_1 Pointer to the 4 partial sums of the second output channel, which are updated
+ */
+static void _net_fused_layer_1_2_kernel_dotp_partial(const _l1_result_t* p_data,
+                                                     const _l1_result_t* p_weight,
+                                                     unsigned int num_ch,
+                                                     int32_t* p_acc_0,
+                                                     int32_t* p_acc_1) {
+
+    // iterators
+    const _l1_result_t* _p_data_iter = p_data;
+    const _l1_result_t* _p_weight_iter = p_weight;
+
+    // local registers
+    int32_t _elem_0_0 = p_acc_0[0], _elem_0_1 = p_acc_0[1], _elem_0_2 = p_acc_0[2], _elem_0_3 = p_acc_0[3];
+    int32_t _elem_1_0 = p_acc_1[0], _elem_1_1 = p_acc_1[1], _elem_1_2 = p_acc_1[2], _elem_1_3 = p_acc_1[3];
+
+#ifdef L1_RESULT_INT16
+
+    v2s _a0, _a1, _a2, _a3;
+    v2s _b0, _b1;
+
+    // two channels at once
+    for (unsigned int _ch = 0; _ch < num_ch; _ch += 2) {
+
+        _a0 = *((v2s*)(_p_data_iter + 0 * _THREAD_STRIDE));
+        _a1 = *((v2s*)(_p_data_iter + 1 * _THREAD_STRIDE));
+        _a2 = *((v2s*)(_p_data_iter + 2 * _THREAD_STRIDE));
+        _a3 = *((v2s*)(_p_data_iter + 3 * _THREAD_STRIDE));
+
+        _b0 = *((v2s*)_p_weight_iter);
+        _b1 = *((v2s*)(_p_weight_iter + NET_L2_WEIGHT_LEN));
+
+        _p_data_iter += 2;
+        _p_weight_iter += 2;
+
+        _elem_0_0 = __SUMDOTP2(_a0, _b0, _elem_0_0);
+        _elem_0_1 = __SUMDOTP2(_a1, _b0, _elem_0_1);
+        _elem_0_2 = __SUMDOTP2(_a2, _b0, _elem_0_2);
+        _elem_0_3 = __SUMDOTP2(_a3, _b0, _elem_0_3);
+
+        _elem_1_0 = __SUMDOTP2(_a0, _b1, _elem_1_0);
+        _elem_1_1 = __SUMDOTP2(_a1, _b1, _elem_1_1);
+        _elem_1_2 = __SUMDOTP2(_a2, _b1, _elem_1_2);
+        _elem_1_3 = __SUMDOTP2(_a3, _b1, _elem_1_3);
+    }
+
+#else//L1_RESULT_INT16
+
+    int32_t _a0, _a1, _a2, _a3;
+    int32_t _b0, _b1;
+
+    for (unsigned int _ch = 0; _ch < num_ch; _ch++) {
+
+        _a0 = *(_p_data_iter + 0 * _THREAD_STRIDE);
+        _a1 = *(_p_data_iter + 1 * _THREAD_STRIDE);
+        _a2 = *(_p_data_iter + 2 * _THREAD_STRIDE);
+        _a3 = *(_p_data_iter + 3 * _THREAD_STRIDE);
+
+        _b0 = *_p_weight_iter;
+        _b1 = *(_p_weight_iter + NET_L2_WEIGHT_LEN);
+
+        _p_data_iter++;
+        _p_weight_iter++;
+
+        _elem_0_0 = __MAC(_elem_0_0, _b0, _a0);
+        _elem_0_1 = __MAC(_elem_0_1, _b0, _a1);
+        _elem_0_2 = __MAC(_elem_0_2, _b0, _a2);
+        _elem_0_3 = __MAC(_elem_0_3, _b0, _a3);
+
+        _elem_1_0 = __MAC(_elem_1_0, _b1, _a0);
+        _elem_1_1 = __MAC(_elem_1_1, _b1, _a1);
+        _elem_1_2 = __MAC(_elem_1_2, _b1, _a2);
+        _elem_1_3 = __MAC(_elem_1_3, _b1, _a3);
+    }
+
+#endif//L1_RESULT_INT16
+
+    // store the results back
+    p_acc_0[0] = _elem_0_0; p_acc_0[1] = _elem_0_1; p_acc_0[2] = _elem_0_2; p_acc_0[3] = _elem_0_3;
+    p_acc_1[0] = _elem_1_0; p_acc_1[1] = _elem_1_1; p_acc_1[2] = _elem_1_2; p_acc_1[3] = _elem_1_3;
+}
+
+/**
+ * @brief Applies ReLU and pooling on the accumulated sums of layer 2 of one chunk, and stores the result
+ *
+ * @param p_acc_0 Pointer to the sums of the first output channel, of length 8 * num_pool
+ * @param p_acc_1 Pointer to the sums of the second output channel, of length 8 * num_pool
+ * @param num_pool Number of outputs (after pooling) in the chunk
+ * @param threshold_0 Threshold for ReLU of the first output channel
+ * @param threshold_1 Threshold for ReLU of the second output channel
+ * @param cap_0 Cap of the ReLU of the first output channel (only used with L2_RELU_CAP)
+ * @param cap_1 Cap of the ReLU of the second output channel (only used with L2_RELU_CAP)
+ * @param factor_0 Scaling division factor for output cannel 0
+ * @param factor_1 Scaling division factor for output cannel 1
+ * @param offset_0 Offset for output channel 0
+ * @param offset_1 Offset for output channel 1
+ * @param p_result Pointer to result array (already at the correct position)
+ */
+static void _net_fused_layer_1_2_kernel_pool(const int32_t* p_acc_0,
+                                             const int32_t* p_acc_1,
+                                             int num_pool,
+                                             int32_t threshold_0,
+                                             int32_t threshold_1,
+                                             int32_t cap_0,
+                                             int32_t cap_1,
+                                             int32_t factor_0,
+                                             int32_t factor_1,
+                                             int32_t offset_0,
+                                             int32_t offset_1,
+                                             int8_t* p_result) {
+
+    _l2_pool_t _pool_sum_0;
+    _l2_pool_t _pool_sum_1;
+
+    for (int _t_out = 0; _t_out < num_pool; _t_out++) {
+        _pool_sum_0 = 0;
+        _pool_sum_1 = 0;
+        for (int _t_pad = 0; _t_pad < 8; _t_pad++) {
+            _pool_sum_0 += _L2_RELU(*(p_acc_0++), threshold_0, cap_0);
+            _pool_sum_1 += _L2_RELU(*(p_acc_1++), threshold_1, cap_1);
+        }
+        _net_fused_layer_1_2_kernel_store_result(_pool_sum_0, _pool_sum_1, factor_0, factor_1, offset_0, offset_1, p_result++);
+    }
+}
+
+/**
+ * @brief Kernel for doing the computation
+ *
+ * The window is processed in chunks of _RING_CHUNK outputs of layer 1, and every chunk in tiles of
+ * _TILE_C channels. For every tile, the convolution of layer 1 and the partial sums of layer 2 are
+ * computed, while the next tile is loaded. After the last tile of a chunk, ReLU and pooling are
+ * applied, and the result is copied back to L2.
+ */
+void _net_fused_layer_1_2_kernel(void* args) {
+
+    unsigned int _core_id = rt_core_id();
+
+    // get values from args
+    _net_fused_layer_1_2_kernel_t* _args = args;
+
+    const int8_t* _p_data_ext = _args->p_data_ext;
+    int8_t* _p_result_ext = _args->p_result_ext;
+    unsigned int _t_len = _args->t_len;
+    unsigned int _result_stride = _args->result_stride;
+    int8_t* _p_tiles = _args->p_data;
+    int8_t* _p_result = _args->p_result;
+    int8_t* _p_weight_l1 = _args->p_weight_l1;
+    int32_t* _p_factor_l1 = _args->p_factor_l1;
+    int32_t* _p_offset_l1 = _args->p_offset_l1;
+    _l1_result_t* _p_weight_l2 = _args->p_weight_l2;
+    int32_t* _p_factor_l2 = _args->p_factor_l2;
+    int32_t* _p_offset_l2 = _args->p_offset_l2;
+    _l1_result_t* _p_thread_data = _args->p_thread_data;
+    int32_t* _p_acc_0 = _args->p_acc;
+
+    // de-interleave job of the next block of the input (only used with INTERLEAVED_INPUT)
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint = &_args->deint;
+#else//INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint = NULL;
+#endif//INTERLEAVED_INPUT
+
+    // change the pointers to point to the data used by the specific core
+    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN_ALIGN;
+    _p_factor_l1 += _core_id;
+    _p_offset_l1 += _core_id;
+    _p_weight_l2 += _core_id * 2 * NET_L2_WEIGHT_LEN;
+    _p_factor_l2 += _core_id * 2;
+    _p_offset_l2 += _core_id * 2;
+    _p_thread_data += _core_id * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET);
+    _p_acc_0 += _core_id * 2 * _RING_CHUNK;
+    int32_t* _p_acc_1 = _p_acc_0 + _RING_CHUNK;
+
+    // load the scaling factors
+    int32_t _factor_l1 = *_p_factor_l1;
+    int32_t _offset_l1 = *_p_offset_l1;
+    int32_t _factor_l2_0 = *(_p_factor_l2 + 0) * _factor_l1;
+    int32_t _offset_l2_0 = *(_p_offset_l2 + 0) * _factor_l1;
+    int32_t _factor_l2_1 = *(_p_factor_l2 + 1) * _factor_l1;
+    int32_t _offset_l2_1 = *(_p_offset_l2 + 1) * _factor_l1;
+
+    // compute the ReLU threshold
+    int32_t _threshold_0 = -(_offset_l2_0 >> 3);
+    int32_t _threshold_1 = -(_offset_l2_1 >> 3);
+    // compute the cap of the ReLU (only used with L2_RELU_CAP)
+    int32_t _cap_0 = _net_fused_layer_1_2_relu_cap(_factor_l2_0, _offset_l2_0, _threshold_0);
+    int32_t _cap_1 = _net_fused_layer_1_2_relu_cap(_factor_l2_1, _offset_l2_1, _threshold_1);
+
+    // number of outputs of layer 1, which are pooled, and the number of tiles to compute
+    int _num_out = (_t_len / 8) * 8;
+    int _num_chunks = (_num_out + _RING_CHUNK - 1) / _RING_CHUNK;
+    int _num_units = _num_chunks * _NUM_TILES;
+    int _chunk, _tile, _ch_start, _num_ch, _num_pool;
+
+    int8_t* _p_data_iter;
+    int8_t* _p_result_loc;
+
+    rt_dma_copy_t _copy_in;
+    rt_dma_copy_t _copy_out;
+    int _num_transfers;
+
+    // load the first tile
+    if (_core_id == 0 && _num_units > 0) {
+        _num_transfers = _net_fused_layer_1_2_tile_load(_p_data_ext, _t_len, _p_tiles, 0, 0, _p_deint, &_copy_in);
+        if (_num_transfers > 0) {
+            rt_dma_wait(&_copy_in);
+        }
+    }
+    rt_team_barrier();
+
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the first tile
+    if (_num_units > 0) {
+        _net_fused_layer_1_2_deint_transpose(_p_deint, _core_id);
+    }
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+    // build the shifted copies of the first tile
+    _net_fused_layer_1_2_tile_shift(_p_tiles, _core_id);
+    rt_team_barrier();
+
+    for (int _unit = 0; _unit < _num_units; _unit++) {
+
+        _chunk = _unit / _NUM_TILES;
+        _tile = _unit % _NUM_TILES;
+        _ch_start = _tile * _TILE_C;
+        _num_ch = NET_C - _ch_start < _TILE_C ? NET_C - _ch_start : _TILE_C;
+
+        // start loading the next tile into the other buffer
+        _num_transfers = 0;
+        if (_core_id == 0 && _unit + 1 < _num_units) {
+            _num_transfers = _net_fused_layer_1_2_tile_load(_p_data_ext, _t_len,
+                                                            _p_tiles + ((_unit + 1) % 2) * 4 * _COPY_MEM_SIZE,
+                                                            (_unit + 1) / _NUM_TILES, (_unit + 1) % _NUM_TILES,
+                                                            _p_deint, &_copy_in);
+        }
+
+        _num_pool = _num_out - _chunk * _RING_CHUNK;
+        _num_pool = (_num_pool < _RING_CHUNK ? _num_pool : _RING_CHUNK) / 8;
+
+        // the partial sums start at zero for every chunk
+        if (_tile == 0) {
+            for (int _t = 0; _t < _RING_CHUNK; _t++) {
+                _p_acc_0[_t] = 0;
+                _p_acc_1[_t] = 0;
+            }
+        }
+
+        _p_data_iter = _p_tiles + (_unit % 2) * 4 * _COPY_MEM_SIZE;
+
+        // compute the convolution and the partial sums of layer 2, 4 time samples at a time
+        for (int _t = 0; _t < _num_pool * 8; _t += 4) {
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _TILE_ROW, _p_weight_l1, _offset_l1, _num_ch, _p_thread_data);
+            _p_data_iter += 4;
+            _net_fused_layer_1_2_kernel_dotp_partial(_p_thread_data, _p_weight_l2 + _ch_start, _num_ch, _p_acc_0 + _t, _p_acc_1 + _t);
+        }
+
+        // after the last tile, apply ReLU and pooling
+        if (_tile == _NUM_TILES - 1) {
+            _p_result_loc = _p_result + (_chunk % 2) * NET_F2 * _RESULT_CHUNK;
+            _net_fused_layer_1_2_kernel_pool(_p_acc_0, _p_acc_1, _num_pool, _threshold_0, _threshold_1, _cap_0, _cap_1,
+                                             _factor_l2_0, _factor_l2_1, _offset_l2_0, _offset_l2_1,
+                                             _p_result_loc + _core_id * 2 * _RESULT_CHUNK);
+        }
+
+        // wait until the next tile is loaded, and until the result buffer of the previous chunk is free
+        if (_core_id == 0) {
+            if (_num_transfers > 0) {
+                rt_dma_wait(&_copy_in);
+            }
+            if (_tile == _NUM_TILES - 1 && _chunk > 0) {
+                rt_dma_wait(&_copy_out);
+            }
+        }
+        rt_team_barrier();
+
+        // copy the result of this chunk back, while the next one is computed
+        if (_core_id == 0 && _tile == _NUM_TILES - 1) {
+            for (int _k = 0; _k < NET_F2; _k++) {
+                rt_dma_memcpy((unsigned int)(_p_result_ext + _k * _result_stride + _chunk * _RESULT_CHUNK),
+                              (unsigned int)(_p_result_loc + _k * _RESULT_CHUNK),
+                              sizeof(int8_t) * _num_pool,
+                              RT_DMA_DIR_LOC2EXT, _k > 0, &_copy_out);
+            }
+        }
+
+#ifdef INTERLEAVED_INPUT
+        // de-interleave the next tile
+        if (_unit + 1 < _num_units) {
+            _net_fused_layer_1_2_deint_transpose(_p_deint, _core_id);
+        }
+        rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+        // build the shifted copies of the next tile
+        if (_unit + 1 < _num_units) {
+            _net_fused_layer_1_2_tile_shift(_p_tiles + ((_unit + 1) % 2) * 4 * _COPY_MEM_SIZE, _core_id);
+        }
+        rt_team_barrier();
+    }
+
+    // wait until the last result is stored
+    if (_core_id == 0 && _num_chunks > 0) {
+        rt_dma_wait(&_copy_out);
+    }
+}
+
+#else//CHANNEL_TILES
+
+/**
+ * @brief Kernel for doing the computation
+ *
+ * The window is processed in chunks of _RING_CHUNK outputs of layer 1. Chunk j needs the input
+ * chunks j and j + 1 (the filter is shorter than a chunk), while chunk j + 2 is loaded into the slot
+ * of chunk j - 1. After every chunk, the result is copied back to L2, while the next one is computed.
+ * With PIPELINE, the result is instead pushed into the pipeline of layer 3, 4 and 5 (if given) at the
+ * start of the next chunk, after the barrier and while chunk j + 2 is loaded. Every core advances
+ * the pipeline as far as possible before it computes the next chunk.
+ */
+void _net_fused_layer_1_2_kernel(void* args) {
+
+    unsigned int _core_id = rt_core_id();
+
+    // get values from args
+    _net_fused_layer_1_2_kernel_t* _args = args;
+
+    const int8_t* _p_data_ext = _args->p_data_ext;
+    int8_t* _p_result_ext = _args->p_result_ext;
+    unsigned int _t_len = _args->t_len;
+    unsigned int _result_stride = _args->result_stride;
+    int8_t* _p_ring = _args->p_data;
+    int8_t* _p_result = _args->p_result;
+    int8_t* _p_weight_l1 = _args->p_weight_l1;
+    int32_t* _p_factor_l1 = _args->p_factor_l1;
+    int32_t* _p_offset_l1 = _args->p_offset_l1;
+    _l1_result_t* _p_weight_l2 = _args->p_weight_l2;
+    int32_t* _p_factor_l2 = _args->p_factor_l2;
+    int32_t* _p_offset_l2 = _args->p_offset_l2;
+    _l1_result_t* _p_thread_data = _args->p_thread_data;
+
+    // de-interleave job of the next block of the input (only used with INTERLEAVED_INPUT)
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint = &_args->deint;
+#else//INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint = NULL;
+#endif//INTERLEAVED_INPUT
+
+#ifdef PIPELINE
+    // with the pipeline, the result stays on L1, and is not stored on L2
+    net_pipeline_t* _p_pipeline = _args->p_pipeline;
+    int _store_result = _p_pipeline == NULL;
+#else//PIPELINE
+    int _store_result = 1;
+#endif//PIPELINE
+
+    // change the pointers to point to the data used by the specific core
+    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN_ALIGN;
+    _p_factor_l1 += _core_id;
+    _p_offset_l1 += _core_id;
+    _p_weight_l2 += _core_id * 2 * NET_L2_WEIGHT_LEN;
+    _p_factor_l2 += _core_id * 2;
+    _p_offset_l2 += _core_id * 2;
+    _p_thread_data += _core_id * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET);
+
+
+    // load the scaling factors
+    int32_t _factor_l1 = *_p_factor_l1;
+    int32_t _offset_l1 = *_p_offset_l1;
+    int32_t _factor_l2_0 = *(_p_factor_l2 + 0) * _factor_l1;
+    int32_t _offset_l2_0 = *(_p_offset_l2 + 0) * _factor_l1;
+    int32_t _factor_l2_1 = *(_p_factor_l2 + 1) * _factor_l1;
+    int32_t _offset_l2_1 = *(_p_offset_l2 + 1) * _factor_l1;
+
+    // compute the ReLU threshold
+    int32_t _threshold_0 = -(_offset_l2_0 >> 3);
+    int32_t _threshold_1 = -(_offset_l2_1 >> 3);
+    // compute the cap of the ReLU (only used with L2_RELU_CAP)
+    int32_t _cap_0 = _net_fused_layer_1_2_relu_cap(_factor_l2_0, _offset_l2_0, _threshold_0);
+    int32_t _cap_1 = _net_fused_layer_1_2_relu_cap(_factor_l2_1, _offset_l2_1, _threshold_1);
+
+    // number of outputs of layer 1, which are pooled, and the number of chunks to compute
+    int _num_out = (_t_len / 8) * 8;
+    int NET_Cunks = (_num_out + _RING_CHUNK - 1) / _RING_CHUNK;
+    int _num_pool;
+
+    int8_t* _p_data_iter;
+    int8_t* _p_result_loc;
+    int8_t* _p_result_iter;
+
+    // registers for the second layer
+    _l2_pool_t _pool_sum_0;
+    _l2_pool_t _pool_sum_1;
+
+    rt_dma_copy_t _copy_in;
+    rt_dma_copy_t _copy_out;
+    int _num_transfers;
+
+    // load the first two chunks
+    if (_core_id == 0) {
+        _num_transfers = _net_fused_layer_1_2_ring_load(_p_data_ext, _t_len, _p_ring, 0, _p_deint, &_copy_in);
+        if (_num_transfers > 0) {
+            rt_dma_wait(&_copy_in);
+        }
+    }
+
+#ifdef INTERLEAVED_INPUT
+    // the staging buffer only holds one chunk, de-interleave the first one before loading the second
+    rt_team_barrier();
+    _net_fused_layer_1_2_deint_transpose(_p_deint, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+    if (_core_id == 0) {
+        _num_transfers = _net_fused_layer_1_2_ring_load(_p_data_ext, _t_len, _p_ring, 1, _p_deint, &_copy_in);
+        if (_num_transfers > 0) {
+            rt_dma_wait(&_copy_in);
+        }
+    }
+    rt_team_barrier();
+
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_transpose(_p_deint, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+    // build the shifted copies of the first two chunks
+    _net_fused_layer_1_2_ring_shift(_p_ring, 0, _RING_CHUNK - 4, _core_id);
+    _net_fused_layer_1_2_ring_shift(_p_ring, _net_fused_layer_1_2_ring_shift_pos(1), _RING_CHUNK, _core_id);
+    rt_team_barrier();
+
+    for (int _chunk = 0; _chunk < NET_Cunks; _chunk++) {
+
+        // the slot of the previous chunk is no longer used, start loading chunk + 2 into it
+        _num_transfers = 0;
+        if (_core_id == 0 && _chunk + 2 <= NET_Cunks) {
+            _num_transfers = _net_fused_layer_1_2_ring_load(_p_data_ext, _t_len, _p_ring, _chunk + 2, _p_deint, &_copy_in);
+        }
+
+#ifdef PIPELINE
+        // hand the two channels of the previous (complete) chunk of this core to layer 3, and do the
+        // work of the pipeline which is ready, while the next chunk is loaded
+        if (_p_pipeline != NULL && _chunk > 0) {
+            net_pipeline_push(_p_pipeline, _p_result_loc + _core_id * 2 * _RESULT_CHUNK, _RESULT_STRIDE,
+                              (_chunk - 1) * _RESULT_CHUNK, _RESULT_CHUNK);
+        }
+#endif//PIPELINE
 
-    // setup iterators
-    const int8_t* _p_data_iter0;
-    const int8_t* _p_data_iter1;
-    const int8_t* _p_data_iter2;
-    const int8_t* _p_data_iter3;
-    const int8_t* _p_weight_iter = p_weight;
-    int32_t* _p_result_iter = p_result;
+        _p_data_iter = _p_ring + (_chunk % _RING_SLOTS) * _RING_CHUNK;
+        _p_result_loc = _p_result + (_chunk % 2) * NET_F2 * _RESULT_CHUNK;
+        _p_result_iter = _p_result_loc + _core_id * 2 * _RESULT_CHUNK;
 
-    // declare local variables
-    int32_t _acc0, _acc1, _acc2, _acc3;
+        _num_pool = _num_out - _chunk * _RING_CHUNK;
+        _num_pool = (_num_pool < _RING_CHUNK ? _num_pool : _RING_CHUNK) / 8;
 
-    for (int _ch = 0; _ch < NET_C; _ch++) {
+        for (int _t_out = 0; _t_out < _num_pool; _t_out++) {
 
-        // setup the iteration
-        _p_weight_iter = p_weight;
+            // reset the pooling summation register
+            _pool_sum_0 = 0;
+            _pool_sum_1 = 0;
 
-        _acc0 = offset;
-        _acc1 = offset;
-        _acc2 = offset;
-        _acc3 = offset;
+            // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
+            for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
+                // compute the intermediate vector
+                _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _RING_ROW, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
-        // part in split A
-        _p_data_iter0 = p_data_a + _ch * stride_a;
-        _p_data_iter1 = p_data_a + _ch * stride_a + 1 * _T_SPLIT_MEM_SIZE;
-        _p_data_iter2 = p_data_a + _ch * stride_a + 2 * _T_SPLIT_MEM_SIZE;
-        _p_data_iter3 = p_data_a + _ch * stride_a + 3 * _T_SPLIT_MEM_SIZE;
+                // move to the next 4 time samples
+                _p_data_iter += 4;
 
-        asm volatile("lp.setup x0,%[num_t],36;"
-                     "   p.lw s9,4(%[p_weight]!);"
-                     "   p.lw s5,4(%[p_data0]!);"
-                     "   p.lw s6,4(%[p_data1]!);"
-                     "   p.lw s7,4(%[p_data2]!);"
-                     "   p.lw s8,4(%[p_data3]!);"
-                     "   pv.sdotsp.b %[_acc0],s5,s9;"
-                     "   pv.sdotsp.b %[_acc1],s6,s9;"
-                     "   pv.sdotsp.b %[_acc2],s7,s9;"
-                     "36:pv.sdotsp.b %[_acc3],s8,s9;"
-                     : [p_weight] "+r" (_p_weight_iter),
-                       [_acc0] "+r" (_acc0),
-                       [_acc1] "+r" (_acc1),
-                       [_acc2] "+r" (_acc2),
-                       [_acc3] "+r" (_acc3),
-                       [p_data0] "+r" (_p_data_iter0),
-                       [p_data1] "+r" (_p_data_iter1),
-                       [p_data2] "+r" (_p_data_iter2),
-                       [p_data3] "+r" (_p_data_iter3)
-                     : [num_t] "r" (num_elems_in_a / 4)
-                     : "s5", "s6", "s7", "s8", "s9");
+                // compute the dot product of the layer 2, and add accumulate the values for padding.
+                _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
+            }
 
-        if (num_elems_in_a < NET_L1_WEIGHT_LEN) {
-            // part in split B
-            _p_data_iter0 = p_data_b + _ch * stride_b;
-            _p_data_iter1 = p_data_b + _ch * stride_b + 1 * _T_SPLIT_MEM_SIZE;
-            _p_data_iter2 = p_data_b + _ch * stride_b + 2 * _T_SPLIT_MEM_SIZE;
-            _p_data_iter3 = p_data_b + _ch * stride_b + 3 * _T_SPLIT_MEM_SIZE;
+            // transform it and store back to memory
+            _net_fused_layer_1_2_kernel_store_result(_pool_sum_0, _pool_sum_1, _factor_l2_0, _factor_l2_1, _offset_l2_0, _offset_l2_1, _p_result_iter++);
+        }
 
-            asm volatile("lp.setup x0,%[num_t],36;"
-                        "   p.lw s9,4(%[p_weight]!);"
-                        "   p.lw s5,4(%[p_data0]!);"
-                        "   p.lw s6,4(%[p_data1]!);"
-                        "   p.lw s7,4(%[p_data2]!);"
-                        "   p.lw s8,4(%[p_data3]!);"
-                        "   pv.sdotsp.b %[_acc0],s5,s9;"
-                        "   pv.sdotsp.b %[_acc1],s6,s9;"
-                        "   pv.sdotsp.b %[_acc2],s7,s9;"
-                        "36:pv.sdotsp.b %[_acc3],s8,s9;"
-                        : [p_weight] "+r" (_p_weight_iter),
-                        [_acc0] "+r" (_acc0),
-                        [_acc1] "+r" (_acc1),
-                        [_acc2] "+r" (_acc2),
-                        [_acc3] "+r" (_acc3),
-                        [p_data0] "+r" (_p_data_iter0),
-                        [p_data1] "+r" (_p_data_iter1),
-                        [p_data2] "+r" (_p_data_iter2),
-                        [p_data3] "+r" (_p_data_iter3)
-                        : [num_t] "r" ((NET_L1_WEIGHT_LEN - num_elems_in_a) / 4)
-                        : "s5", "s6", "s7", "s8", "s9");
+        // wait until the next chunk is loaded, and until the result buffer of the previous chunk is free
+        if (_core_id == 0) {
+            if (_num_transfers > 0) {
+                rt_dma_wait(&_copy_in);
+            }
+            if (_chunk > 0 && _store_result) {
+                rt_dma_wait(&_copy_out);
+            }
+        }
+        rt_team_barrier();
+
+        // copy the result of this chunk back, while the next one is computed
+        if (_core_id == 0 && _store_result) {
+            for (int _k = 0; _k < NET_F2; _k++) {
+                rt_dma_memcpy((unsigned int)(_p_result_ext + _k * _result_stride + _chunk * _RESULT_CHUNK),
+                              (unsigned int)(_p_result_loc + _k * _RESULT_CHUNK),
+                              sizeof(int8_t) * _num_pool,
+                              RT_DMA_DIR_LOC2EXT, _k > 0, &_copy_out);
+            }
         }
 
-        // store the values as 1 byte in the appropriate position
-        *(_p_result_iter + 0 * NET_C) = _acc0;
-        *(_p_result_iter + 1 * NET_C) = _acc1;
-        *(_p_result_iter + 2 * NET_C) = _acc2;
-        *(_p_result_iter + 3 * NET_C) = _acc3;
+#ifdef INTERLEAVED_INPUT
+        // de-interleave the new chunk
+        if (_chunk + 2 <= NET_Cunks) {
+            _net_fused_layer_1_2_deint_transpose(_p_deint, _core_id);
+        }
+        rt_team_barrier();
+#endif//INTERLEAVED_INPUT
 
-        // go to the next value in the thread data
-        _p_result_iter++;
+        // build the shifted copies of the new chunk
+        if (_chunk + 2 <= NET_Cunks) {
+            _net_fused_layer_1_2_ring_shift(_p_ring, _net_fused_layer_1_2_ring_shift_pos(_chunk + 2), _RING_CHUNK, _core_id);
+        }
+        rt_team_barrier();
+    }
+
+    // wait until the last result is stored
+    if (_core_id == 0 && NET_Cunks > 0 && _store_result) {
+        rt_dma_wait(&_copy_out);
+    }
+
+#ifdef PIPELINE
+    // push the last chunk, complete layer 3, 4 and 5, and store the output of the network
+    if (_p_pipeline != NULL) {
+        if (NET_Cunks > 0) {
+            net_pipeline_push(_p_pipeline, _p_result_loc + _core_id * 2 * _RESULT_CHUNK, _RESULT_STRIDE,
+                              (NET_Cunks - 1) * _RESULT_CHUNK, _num_pool);
+        }
+        net_pipeline_finish(_p_pipeline);
     }
+#endif//PIPELINE
 }
 
+#endif//CHANNEL_TILES
+
 /**
- * @brief Compute the result of the dot product for the second layer and add them to the current pooling sum
+ * @brief Execute the 1st and the 2nd layer on a window of any length, by streaming it through L1
  *
- * @param p_data Pointer to input data of shape [4, NET_C_ALIGN], must be the thread local data, the result of the function above
- * @param p_weight Pointer to the weight vector of the layer 2
- * @param threshold_0 Threshold for ReLU of the first output channel
- * @param threshold_1 Threshold for ReLU of the second output channel
- * @param p_pool_sum_0 Pointer to the first pool sum value, which is updated in this function
- * @param p_pool_sum_1 Pointer to the second pool sum value, which is updated in this function
+ * @param p_data Pointer to the input data on L2 (see net_fused_layer_1_2_window)
+ * @param p_result Pointer to the output data on L2, of shape [NET_F2, t_len / 8]
+ * @param t_len Number of time samples in the window
+ * @param result_stride Distance between the rows of p_result
+ * @param p_pipeline Pipeline of layer 3, 4 and 5, which consumes the result instead of storing it on
+ *        L2 (only with PIPELINE, NULL otherwise)
  */
-void _net_fused_layer_1_2_kernel_dotp_acc(const int32_t* p_data,
-                                          const int32_t* p_weight,
-                                          int32_t threshold_0,
-                                          int32_t threshold_1,
-                                          int32_t* p_pool_sum_0,
-                                          int32_t* p_pool_sum_1) {
+static void _net_fused_layer_1_2_stream(const int8_t* p_data,
+                                        int8_t* p_result,
+                                        unsigned int t_len,
+                                        unsigned int result_stride,
+                                        net_pipeline_t* p_pipeline) {
 
-    // iterators
-    const int32_t* _p_data_iter = p_data;
-    const int32_t* _p_weight_iter = p_weight;
+    // allocate memory for the ring and for two chunks of the result
+    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _DATA_MEM_SIZE);
 
-    // local registers
-    int32_t _a0, _a1, _a2, _a3;
-    int32_t _b0, _b1;
-    int32_t _elem_0_0 = 0, _elem_0_1 = 0, _elem_0_2 = 0, _elem_0_3 = 0;
-    int32_t _elem_1_0 = 0, _elem_1_1 = 0, _elem_1_2 = 0, _elem_1_3 = 0;
+    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _RESULT_MEM_SIZE);
 
-    // registers for the pool sum
-    int32_t _pool_sum_0 = *p_pool_sum_0;
-    int32_t _pool_sum_1 = *p_pool_sum_1;
+    int32_t* _p_params_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+    int32_t* _p_factor_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_FACTOR;
+    int32_t* _p_offset_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_OFFSET;
+    int8_t* _p_weight_l1_loc = (int8_t*)(_p_params_l1_loc + NET_L1_PARAMS_WEIGHT);
 
-    for (int _ch = 0; _ch < NET_C; _ch++) {
+    int32_t* _p_params_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_OFFSET;
+    _l1_result_t* _p_weight_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(_l1_result_t) * NET_F2 * NET_L2_WEIGHT_LEN);
 
-        _a0 = *(_p_data_iter + 0 * NET_C);
-        _a1 = *(_p_data_iter + 1 * NET_C);
-        _a2 = *(_p_data_iter + 2 * NET_C);
-        _a3 = *(_p_data_iter + 3 * NET_C);
+    // partial sums of layer 2 (only used with CHANNEL_TILES)
+#ifdef CHANNEL_TILES
+    int32_t* _p_acc_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * _ACC_MEM_SIZE);
+#else//CHANNEL_TILES
+    int32_t* _p_acc_loc = NULL;
+#endif//CHANNEL_TILES
 
-        _b0 = *_p_weight_iter;
-        _b1 = *(_p_weight_iter + NET_L2_WEIGHT_LEN);
+    _l1_result_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(_l1_result_t) * NUM_WORKERS * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET));
 
-        _p_data_iter++;
-        _p_weight_iter++;
+    // error handling
+    if (_p_thread_data_loc == NULL) {
+        printf("Error! Not enough space in L1 memory!");
+        return;
+    }
 
-        _elem_0_0 = __MAC(_elem_0_0, _b0, _a0);
-        _elem_0_1 = __MAC(_elem_0_1, _b0, _a1);
-        _elem_0_2 = __MAC(_elem_0_2, _b0, _a2);
-        _elem_0_3 = __MAC(_elem_0_3, _b0, _a3);
+    rt_dma_copy_t _copy;
 
-        _elem_1_0 = __MAC(_elem_1_0, _b1, _a0);
-        _elem_1_1 = __MAC(_elem_1_1, _b1, _a1);
-        _elem_1_2 = __MAC(_elem_1_2, _b1, _a2);
-        _elem_1_3 = __MAC(_elem_1_3, _b1, _a3);
+    // load all the parameters of layer 1
+    rt_dma_memcpy((unsigned int)net_params.l1_params,
+                  (unsigned int)_p_params_l1_loc,
+                  sizeof(int32_t) * NET_L1_PARAMS_LEN,
+                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
 
-    }
+    // load all the parameters of layer 2
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_l2_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
+                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
-    // do ReLU on the first and second element
-    _elem_0_0 = __MAX(_elem_0_0, threshold_0);
-    _elem_0_1 = __MAX(_elem_0_1, threshold_0);
-    _elem_0_2 = __MAX(_elem_0_2, threshold_0);
-    _elem_0_3 = __MAX(_elem_0_3, threshold_0);
+    // wait until all dma transfers of the input data is complete
+    rt_dma_wait(&_copy);
+
+    // widen the weights of layer 2 to the type of the results of layer 1
+    _net_fused_layer_1_2_widen_weight_l2((int8_t*)(_p_params_l2_loc + NET_L2_PARAMS_WEIGHT), _p_weight_l2_loc);
+
+    // now, all the data necessary for computation resides in local memory! Prepare the kernel
+    _net_fused_layer_1_2_kernel_t _args;
+    _args.p_data_ext = p_data;
+    _args.p_result_ext = p_result;
+    _args.t_len = t_len;
+    _args.result_stride = result_stride;
+    _args.p_data = _p_data_loc;
+    _args.p_result = _p_result_loc;
+    _args.p_weight_l1 = _p_weight_l1_loc;
+    _args.p_factor_l1 = _p_factor_l1_loc;
+    _args.p_offset_l1 = _p_offset_l1_loc;
+    _args.p_weight_l2 = _p_weight_l2_loc;
+    _args.p_factor_l2 = _p_factor_l2_loc;
+    _args.p_offset_l2 = _p_offset_l2_loc;
+    _args.p_thread_data = _p_thread_data_loc;
+    _args.p_acc = _p_acc_loc;
+    _args.p_pipeline = p_pipeline;
+#ifdef INTERLEAVED_INPUT
+    _args.deint.p_stage = _p_data_loc + _STAGE_MEM_OFFSET;
+#endif//INTERLEAVED_INPUT
 
-    _elem_1_0 = __MAX(_elem_1_0, threshold_1);
-    _elem_1_1 = __MAX(_elem_1_1, threshold_1);
-    _elem_1_2 = __MAX(_elem_1_2, threshold_1);
-    _elem_1_3 = __MAX(_elem_1_3, threshold_1);
+    // start the kernel, it stores the result directly to L2
+    rt_team_fork(NUM_WORKERS, _net_fused_layer_1_2_kernel, &_args);
 
-    // sum up the values
-    _pool_sum_0 += (_elem_0_0 + _elem_0_1) + (_elem_0_2 + _elem_0_3);
-    _pool_sum_1 += (_elem_1_0 + _elem_1_1) + (_elem_1_2 + _elem_1_3);
+    // free all the memory
+    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * _DATA_MEM_SIZE);
+    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * _RESULT_MEM_SIZE);
+
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l1_loc, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l2_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(_l1_result_t) * NET_F2 * NET_L2_WEIGHT_LEN);
+
+    rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(_l1_result_t) * NUM_WORKERS * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET));
+
+#ifdef CHANNEL_TILES
+    rt_free(RT_ALLOC_CL_DATA, _p_acc_loc, sizeof(int32_t) * _ACC_MEM_SIZE);
+#endif//CHANNEL_TILES
 
-    // store the results back
-    *p_pool_sum_0 = _pool_sum_0;
-    *p_pool_sum_1 = _pool_sum_1;
 }
 
 /**
- * @brief Applies the final transformation of the pooling result and stores it back into the array
+ * @brief Execute the 1st and the 2nd layer
+ * 
+ * @warning p_result must already be allocated on L2!
  *
- * @param pool_sum_0 Sum of all results for output cannel 0
- * @param pool_sum_1 Sum of all results for output cannel 1
- * @param factor_0 Scaling division factor for output cannel 0
- * @param factor_1 Scaling division factor for output cannel 1
- * @param offset_0 Offset for output channel 0
- * @param offset_1 Offset for output channel 1
- * @param p_result Pointer to result array (already at the correct position)
+ * @param p_data Pointer to the input data, of shape [NET_C, NET_L1_PAD_INPUT_LEN] (padded), or of
+ *               shape [NET_T, NET_C] (not padded) if INTERLEAVED_INPUT is enabled
+ * @param p_result Pointer to the output data of shape [NET_F2, NET_T8] aligned to [NET_F2, NET_T8_ALIGN].
  */
-inline void _net_fused_layer_1_2_kernel_store_result(int32_t pool_sum_0,
-                                                     int32_t pool_sum_1,
-                                                     int32_t factor_0,
-                                                     int32_t factor_1,
-                                                     int32_t offset_0,
-                                                     int32_t offset_1,
-                                                     int8_t* p_result) {
+void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
+    _net_fused_layer_1_2_stream(p_data, p_result, NET_T, NET_T8_ALIGN, NULL);
+}
 
-    // scale it
-    pool_sum_0 = (pool_sum_0 + offset_0) / factor_0;
-    pool_sum_1 = (pool_sum_1 + offset_1) / factor_1;
+/**
+ * @brief Execute the 1st and the 2nd layer on a window of any length
+ *
+ * @warning p_result must already be allocated on L2!
+ *
+ * @param p_data Pointer to the input data, of shape [NET_C, t_len + NET_L1_PAD_START + NET_L1_PAD_END]
+ *               (padded), or of shape [t_len, NET_C] (not padded) if INTERLEAVED_INPUT is enabled
+ * @param p_result Pointer to the output data of shape [NET_F2, t_len / 8]
+ * @param t_len Number of time samples in the window
+ */
+void net_fused_layer_1_2_window(const int8_t* p_data, int8_t* p_result, unsigned int t_len) {
+    _net_fused_layer_1_2_stream(p_data, p_result, t_len, t_len / 8, NULL);
+}
 
-    // clip it
-    pool_sum_0 = __CLIP_R(pool_sum_0, 127);
-    pool_sum_1 = __CLIP_R(pool_sum_1, 127);
+#ifdef PIPELINE
 
-    // store it
-    *(p_result + 0 * NET_T8_ALIGN) = pool_sum_0;
-    *(p_result + 1 * NET_T8_ALIGN) = pool_sum_1;
+/**
+ * @brief Execute the entire network in a single pass over the window (PIPELINE)
+ *
+ * Layer 3, 4 and 5 consume the output of layer 2 on L1, chunk by chunk, while the next chunk of
+ * layer 1 and 2 is computed. See net_pipeline_t.
+ *
+ * @param p_data Pointer to the input data (see net_fused_layer_1_2)
+ * @param p_output Pointer to the output of the network on L2, of shape [NET_N]
+ */
+void net_fused_pipeline(const int8_t* p_data, int8_t* p_output) {
+
+    net_pipeline_t _pipeline;
+    if (net_pipeline_init(&_pipeline, p_output) != NET_PIPELINE_OK) {
+        printf("Error! Not enough space in L1 memory!");
+        return;
+    }
+
+    _net_fused_layer_1_2_stream(p_data, NULL, NET_T, 0, &_pipeline);
 
+    net_pipeline_free(&_pipeline);
 }
 
+#endif//PIPELINE
+
+#else//RING_BUFFER
+
 typedef struct {
     const int8_t* p_data_ext;
     int8_t* p_data;
@@ -401,11 +2021,15 @@ typedef struct {
     int32_t* p_factor_l1;
     int32_t* p_offset_l1;
 
-    int32_t* p_weight_l2;
+    _l1_result_t* p_weight_l2;
     int32_t* p_factor_l2;
     int32_t* p_offset_l2;
 
-    int32_t* p_thread_data;
+    _l1_result_t* p_thread_data;
+
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t deint[2]; // of slot A and B, shared by all cores, filled by core 0
+#endif//INTERLEAVED_INPUT
 } _net_fused_layer_1_2_kernel_t;
 
 /**
@@ -424,13 +2048,31 @@ void _net_fused_layer_1_2_kernel(void* args) {
     int8_t* _p_weight_l1 = _args->p_weight_l1;
     int32_t* _p_factor_l1 = _args->p_factor_l1;
     int32_t* _p_offset_l1 = _args->p_offset_l1;
-    int32_t* _p_weight_l2 = _args->p_weight_l2;
+    _l1_result_t* _p_weight_l2 = _args->p_weight_l2;
     int32_t* _p_factor_l2 = _args->p_factor_l2;
     int32_t* _p_offset_l2 = _args->p_offset_l2;
-    int32_t* _p_thread_data = _args->p_thread_data;
+    _l1_result_t* _p_thread_data = _args->p_thread_data;
 
     int8_t* _p_data_b = _p_data_a + 4 * _T_SPLIT_MEM_SIZE;
 
+    // the tails of both slots are stored after the copies (only used with DUPLICATE_IN_L1)
+#ifdef DUPLICATE_IN_L1
+    int8_t* _p_tail_a = _p_data_a + 8 * _T_SPLIT_MEM_SIZE;
+    int8_t* _p_tail_b = _p_tail_a + _T_SPLIT_TAIL_SIZE;
+#else//DUPLICATE_IN_L1
+    int8_t* _p_tail_a = NULL;
+    int8_t* _p_tail_b = NULL;
+#endif//DUPLICATE_IN_L1
+
+    // de-interleave jobs of both slots (only used with INTERLEAVED_INPUT)
+#ifdef INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint_a = _args->deint + 0;
+    _net_fused_layer_1_2_deint_t* _p_deint_b = _args->deint + 1;
+#else//INTERLEAVED_INPUT
+    _net_fused_layer_1_2_deint_t* _p_deint_a = NULL;
+    _net_fused_layer_1_2_deint_t* _p_deint_b = NULL;
+#endif//INTERLEAVED_INPUT
+
     // change the pointers to point to the data used by the specific core
     _p_result += _core_id * 2 * NET_T8_ALIGN;
     _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN_ALIGN;
@@ -439,7 +2081,8 @@ void _net_fused_layer_1_2_kernel(void* args) {
     _p_weight_l2 += _core_id * 2 * NET_L2_WEIGHT_LEN;
     _p_factor_l2 += _core_id * 2;
     _p_offset_l2 += _core_id * 2;
-    _p_thread_data += _core_id * (NET_C * 4 + _THREAD_MEM_OFFSET);
+    _p_thread_data += _core_id * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET);
+
 
     // load the scaling factors
     int32_t _factor_l1 = *_p_factor_l1;
@@ -452,6 +2095,9 @@ void _net_fused_layer_1_2_kernel(void* args) {
     // compute the ReLU threshold
     int32_t _threshold_0 = -(_offset_l2_0 >> 3);
     int32_t _threshold_1 = -(_offset_l2_1 >> 3);
+    // compute the cap of the ReLU (only used with L2_RELU_CAP)
+    int32_t _cap_0 = _net_fused_layer_1_2_relu_cap(_factor_l2_0, _offset_l2_0, _threshold_0);
+    int32_t _cap_1 = _net_fused_layer_1_2_relu_cap(_factor_l2_1, _offset_l2_1, _threshold_1);
 
     int8_t* _p_data_iter;            // iterator over the current elements for which we do the computation
     int8_t* _p_data_iter2;           // iterator over the current elements for which we do the computation, for the reference to array 2
@@ -461,8 +2107,8 @@ void _net_fused_layer_1_2_kernel(void* args) {
     int _num_comp_in_range_1;
 
     // registers for the second layer
-    int32_t _pool_sum_0;
-    int32_t _pool_sum_1;
+    _l2_pool_t _pool_sum_0;
+    _l2_pool_t _pool_sum_1;
 
     // copy the first data over
     rt_dma_copy_t _copy_start;
@@ -470,56 +2116,10 @@ void _net_fused_layer_1_2_kernel(void* args) {
 
     // Copy the first split and also start copying the second split over
     if (_core_id == 0) {
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext,
-                         (unsigned int)_p_data_a + 0 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 0, &_copy_start);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 1,
-                         (unsigned int)_p_data_a + 1 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_start);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 2,
-                         (unsigned int)_p_data_a + 2 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_start);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 3,
-                         (unsigned int)_p_data_a + 3 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_start);
+        _net_fused_layer_1_2_load_split(_p_data_ext, _p_data_a, _p_tail_a, 0, _T_SPLIT_LEN, _p_deint_a, &_copy_start);
 
         // also start to copy the next part over
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + _T_SPLIT_LEN,
-                         (unsigned int)_p_data_b + 0 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 0, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + _T_SPLIT_LEN + 1,
-                         (unsigned int)_p_data_b + 1 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + _T_SPLIT_LEN + 2,
-                         (unsigned int)_p_data_b + 2 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + _T_SPLIT_LEN + 3,
-                         (unsigned int)_p_data_b + 3 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
+        _net_fused_layer_1_2_load_split(_p_data_ext, _p_data_b, _p_tail_b, _T_SPLIT_LEN, _T_SPLIT_LEN, _p_deint_b, &_copy_comp);
 
         // wait for the start dma to finish
         rt_dma_wait(&_copy_start);
@@ -527,6 +2127,18 @@ void _net_fused_layer_1_2_kernel(void* args) {
 
     rt_team_barrier();
 
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the new split
+    _net_fused_layer_1_2_deint_transpose(_p_deint_a, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+#ifdef DUPLICATE_IN_L1
+    // build the shifted copies of the new split
+    _net_fused_layer_1_2_shift_split(_p_data_a, _p_tail_a, _T_SPLIT_LEN, _core_id);
+    rt_team_barrier();
+#endif//DUPLICATE_IN_L1
+
     /***********
      * Region 1: 0 .. _T_SPLIT_LEN - L1_WEIGHT_LEN
      ***********/
@@ -542,13 +2154,13 @@ void _net_fused_layer_1_2_kernel(void* args) {
         // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
         for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
             // compute the intermediate vector
-            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, _p_thread_data);
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
             // move to the next 4 time samples
             _p_data_iter += 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -565,6 +2177,18 @@ void _net_fused_layer_1_2_kernel(void* args) {
     }
     rt_team_barrier();
 
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the new split
+    _net_fused_layer_1_2_deint_transpose(_p_deint_b, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+#ifdef DUPLICATE_IN_L1
+    // build the shifted copies of the new split
+    _net_fused_layer_1_2_shift_split(_p_data_b, _p_tail_b, _T_SPLIT_LEN, _core_id);
+    rt_team_barrier();
+#endif//DUPLICATE_IN_L1
+
     _p_data_iter = _p_data_a + (_T_SPLIT_LEN - NET_L1_WEIGHT_LEN);
 
     // this counter is counted down by 1 after every dot product computation, to use more and more of the new data.
@@ -583,7 +2207,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _net_fused_layer_1_2_kernel_conv_transition(_p_data_iter, _p_data_b,
                                                         _T_SPLIT_LEN, _T_SPLIT_LEN,
                                                         _num_comp_in_range_1, _p_weight_l1, _offset_l1,
-                                                        _p_thread_data);
+                                                        NET_C, _p_thread_data);
 
             // move to the next 4 time samples, the second iterator does not need to be updated
             _p_data_iter += 4;
@@ -592,7 +2216,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _num_comp_in_range_1 -= 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -608,30 +2232,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
     // data in slot A is no longer used! copy the data of split 3 over to slot A
     if (_core_id == 0) {
         // also start to copy the next part over
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 2 *_T_SPLIT_LEN,
-                         (unsigned int)_p_data_a + 0 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 0, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 2 *_T_SPLIT_LEN + 1,
-                         (unsigned int)_p_data_a + 1 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 2 *_T_SPLIT_LEN + 2,
-                         (unsigned int)_p_data_a + 2 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 2 *_T_SPLIT_LEN + 3,
-                         (unsigned int)_p_data_a + 3 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
+        _net_fused_layer_1_2_load_split(_p_data_ext, _p_data_a, _p_tail_a, 2 * _T_SPLIT_LEN, _T_SPLIT_LEN, _p_deint_a, &_copy_comp);
     }
 
     _p_data_iter = _p_data_b;
@@ -645,13 +2246,13 @@ void _net_fused_layer_1_2_kernel(void* args) {
         // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
         for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
             // compute the intermediate vector
-            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, _p_thread_data);
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
             // move to the next 4 time samples
             _p_data_iter += 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -668,6 +2269,18 @@ void _net_fused_layer_1_2_kernel(void* args) {
     }
     rt_team_barrier();
 
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the new split
+    _net_fused_layer_1_2_deint_transpose(_p_deint_a, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+#ifdef DUPLICATE_IN_L1
+    // build the shifted copies of the new split
+    _net_fused_layer_1_2_shift_split(_p_data_a, _p_tail_a, _T_SPLIT_LEN, _core_id);
+    rt_team_barrier();
+#endif//DUPLICATE_IN_L1
+
     _p_data_iter = _p_data_b + (_T_SPLIT_LEN - NET_L1_WEIGHT_LEN);
 
     // this counter is counted down by 1 after every dot product computation, to use more and more of the new data.
@@ -686,7 +2299,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _net_fused_layer_1_2_kernel_conv_transition(_p_data_iter, _p_data_a,
                                                         _T_SPLIT_LEN, _T_SPLIT_LEN,
                                                         _num_comp_in_range_1, _p_weight_l1, _offset_l1,
-                                                        _p_thread_data);
+                                                        NET_C, _p_thread_data);
 
             // move to the next 4 time samples, the second iterator does not need to be updated
             _p_data_iter += 4;
@@ -695,7 +2308,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _num_comp_in_range_1 -= 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -711,30 +2324,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
     // data in slot b is no longer used! copy the data of split 4 over to slot b
     if (_core_id == 0) {
         // also start to copy the next part over
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 3 *_T_SPLIT_LEN,
-                         (unsigned int)_p_data_b + 0 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 0, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 3 *_T_SPLIT_LEN + 1,
-                         (unsigned int)_p_data_b + 1 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 3 *_T_SPLIT_LEN + 2,
-                         (unsigned int)_p_data_b + 2 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 3 *_T_SPLIT_LEN + 3,
-                         (unsigned int)_p_data_b + 3 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN, // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
+        _net_fused_layer_1_2_load_split(_p_data_ext, _p_data_b, _p_tail_b, 3 * _T_SPLIT_LEN, _T_SPLIT_LEN, _p_deint_b, &_copy_comp);
     }
 
     _p_data_iter = _p_data_a;
@@ -748,13 +2338,13 @@ void _net_fused_layer_1_2_kernel(void* args) {
         // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
         for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
             // compute the intermediate vector
-            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, _p_thread_data);
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
             // move to the next 4 time samples
             _p_data_iter += 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -771,6 +2361,18 @@ void _net_fused_layer_1_2_kernel(void* args) {
     }
     rt_team_barrier();
 
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the new split
+    _net_fused_layer_1_2_deint_transpose(_p_deint_b, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+#ifdef DUPLICATE_IN_L1
+    // build the shifted copies of the new split
+    _net_fused_layer_1_2_shift_split(_p_data_b, _p_tail_b, _T_SPLIT_LEN, _core_id);
+    rt_team_barrier();
+#endif//DUPLICATE_IN_L1
+
     _p_data_iter = _p_data_a + (_T_SPLIT_LEN - NET_L1_WEIGHT_LEN);
 
     // this counter is counted down by 1 after every dot product computation, to use more and more of the new data.
@@ -789,7 +2391,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _net_fused_layer_1_2_kernel_conv_transition(_p_data_iter, _p_data_b,
                                                         _T_SPLIT_LEN, _T_SPLIT_LEN,
                                                         _num_comp_in_range_1, _p_weight_l1, _offset_l1,
-                                                        _p_thread_data);
+                                                        NET_C, _p_thread_data);
 
             // move to the next 4 time samples, the second iterator does not need to be updated
             _p_data_iter += 4;
@@ -798,7 +2400,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _num_comp_in_range_1 -= 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -814,30 +2416,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
     // data in slot A is no longer used! copy the data of split 5 (different size) over to slot A
     if (_core_id == 0) {
         // also start to copy the next part over
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 4 *_T_SPLIT_LEN,
-                         (unsigned int)_p_data_a + 0 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN_LAST, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN,      // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN_LAST,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 0, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 4 *_T_SPLIT_LEN + 1,
-                         (unsigned int)_p_data_a + 1 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN_LAST, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN,      // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN_LAST,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 4 *_T_SPLIT_LEN + 2,
-                         (unsigned int)_p_data_a + 2 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN_LAST, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN,      // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN_LAST,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
-        rt_dma_memcpy_2d((unsigned int)_p_data_ext + 4 *_T_SPLIT_LEN + 3,
-                         (unsigned int)_p_data_a + 3 * _T_SPLIT_MEM_SIZE,
-                         sizeof(int8_t) * NET_C * _T_SPLIT_LEN_LAST, // number of elements in total
-                         sizeof(int8_t) * NET_L1_PAD_INPUT_LEN,      // length of each line (row)
-                         sizeof(int8_t) * _T_SPLIT_LEN_LAST,         // number of elements to transfer per line
-                         RT_DMA_DIR_EXT2LOC, 1, &_copy_comp);
+        _net_fused_layer_1_2_load_split(_p_data_ext, _p_data_a, _p_tail_a, 4 * _T_SPLIT_LEN, _T_SPLIT_LEN_LAST, _p_deint_a, &_copy_comp);
     }
 
     _p_data_iter = _p_data_b;
@@ -851,13 +2430,13 @@ void _net_fused_layer_1_2_kernel(void* args) {
         // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
         for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
             // compute the intermediate vector
-            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, _p_thread_data);
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
             // move to the next 4 time samples
             _p_data_iter += 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -874,6 +2453,18 @@ void _net_fused_layer_1_2_kernel(void* args) {
     }
     rt_team_barrier();
 
+#ifdef INTERLEAVED_INPUT
+    // de-interleave the new split
+    _net_fused_layer_1_2_deint_transpose(_p_deint_a, _core_id);
+    rt_team_barrier();
+#endif//INTERLEAVED_INPUT
+
+#ifdef DUPLICATE_IN_L1
+    // build the shifted copies of the new split
+    _net_fused_layer_1_2_shift_split(_p_data_a, _p_tail_a, _T_SPLIT_LEN_LAST, _core_id);
+    rt_team_barrier();
+#endif//DUPLICATE_IN_L1
+
     _p_data_iter = _p_data_b + (_T_SPLIT_LEN - NET_L1_WEIGHT_LEN);
 
     // this counter is counted down by 1 after every dot product computation, to use more and more of the new data.
@@ -892,7 +2483,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _net_fused_layer_1_2_kernel_conv_transition(_p_data_iter, _p_data_a,
                                                         _T_SPLIT_LEN, _T_SPLIT_LEN_LAST,
                                                         _num_comp_in_range_1, _p_weight_l1, _offset_l1,
-                                                        _p_thread_data);
+                                                        NET_C, _p_thread_data);
 
             // move to the next 4 time samples, the second iterator does not need to be updated
             _p_data_iter += 4;
@@ -901,7 +2492,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
             _num_comp_in_range_1 -= 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -925,13 +2516,13 @@ void _net_fused_layer_1_2_kernel(void* args) {
         // iterate over all the padding samples divided by 4, because we compute 4 values at the same time
         for (int _t_pad = 0; _t_pad < 8 / 4; _t_pad++) {
             // compute the intermediate vector
-            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN_LAST, _p_weight_l1, _offset_l1, _p_thread_data);
+            _net_fused_layer_1_2_kernel_conv(_core_id, _p_data_iter, _T_SPLIT_LEN_LAST, _p_weight_l1, _offset_l1, NET_C, _p_thread_data);
 
             // move to the next 4 time samples
             _p_data_iter += 4;
 
             // compute the dot product of the layer 2, and add accumulate the values for padding.
-            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, _threshold_0, _threshold_1, &_pool_sum_0, &_pool_sum_1);
+            _net_fused_layer_1_2_kernel_dotp_acc(_p_thread_data, _p_weight_l2, NET_C, _threshold_0, _threshold_1, _cap_0, _cap_1, &_pool_sum_0, &_pool_sum_1);
         }
 
         // transform it and store back to memory
@@ -946,25 +2537,28 @@ void _net_fused_layer_1_2_kernel(void* args) {
  * 
  * @warning p_result must already be allocated on L2!
  *
- * @param p_data Pointer to the input data, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN]
+ * @param p_data Pointer to the input data, of shape [NET_C, NET_L1_PAD_INPUT_LEN] (padded), or of
+ *               shape [NET_T, NET_C] (not padded) if INTERLEAVED_INPUT is enabled
  * @param p_result Pointer to the output data of shape [NET_F2, NET_T8] aligned to [NET_F2, NET_T8_ALIGN].
  */
 void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
 
     // allocate memory for two results and two inputs
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * 8 * _T_SPLIT_MEM_SIZE);
+    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _DATA_MEM_SIZE);
 
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    int8_t* _p_weight_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN_ALIGN);
-    int32_t* _p_factor_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
-    int32_t* _p_offset_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
+    int32_t* _p_params_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+    int32_t* _p_factor_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_FACTOR;
+    int32_t* _p_offset_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_OFFSET;
+    int8_t* _p_weight_l1_loc = (int8_t*)(_p_params_l1_loc + NET_L1_PARAMS_WEIGHT);
 
-    int32_t* _p_weight_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
+    int32_t* _p_params_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_OFFSET;
+    _l1_result_t* _p_weight_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(_l1_result_t) * NET_F2 * NET_L2_WEIGHT_LEN);
 
-    int32_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NUM_WORKERS * (NET_C * 4 + _THREAD_MEM_OFFSET));
+    _l1_result_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(_l1_result_t) * NUM_WORKERS * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET));
 
     // error handling
     if (_p_thread_data_loc == NULL) {
@@ -974,37 +2568,24 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
 
     rt_dma_copy_t _copy;
 
-    // load all the weights of layer 1
-    rt_dma_memcpy((unsigned int)net_l1_weight_reverse_pad,
-                  (unsigned int)_p_weight_l1_loc,
-                  sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN_ALIGN,
+    // load all the parameters of layer 1
+    rt_dma_memcpy((unsigned int)net_params.l1_params,
+                  (unsigned int)_p_params_l1_loc,
+                  sizeof(int32_t) * NET_L1_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_factor,
-                  (unsigned int)_p_factor_l1_loc,
-                  sizeof(int32_t) * NET_F1,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_offset,
-                  (unsigned int)_p_offset_l1_loc,
-                  sizeof(int32_t) * NET_F1,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
-    // load all the weights of layer 2
-    rt_dma_memcpy((unsigned int)net_l2_weight_32,
-                  (unsigned int)_p_weight_l2_loc,
-                  sizeof(int32_t) * NET_F2 * NET_L2_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_l2_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_l2_loc,
-                  sizeof(int32_t) * NET_F2,
+    // load all the parameters of layer 2
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_l2_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
     // wait until all dma transfers of the input data is complete
     rt_dma_wait(&_copy);
 
+    // widen the weights of layer 2 to the type of the results of layer 1
+    _net_fused_layer_1_2_widen_weight_l2((int8_t*)(_p_params_l2_loc + NET_L2_PARAMS_WEIGHT), _p_weight_l2_loc);
+
     // now, all the data necessary for computation resides in local memory! Prepare the kernel
     _net_fused_layer_1_2_kernel_t _args;
     _args.p_data_ext = p_data;
@@ -1018,6 +2599,17 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     _args.p_offset_l2 = _p_offset_l2_loc;
     _args.p_thread_data = _p_thread_data_loc;
 
+    // staging buffers of the interleaved input (see _STAGE_MEM_SIZE)
+#ifdef INTERLEAVED_INPUT
+#ifdef DUPLICATE_IN_L1
+    _args.deint[0].p_stage = _p_data_loc + 1 * _T_SPLIT_MEM_SIZE;
+    _args.deint[1].p_stage = _p_data_loc + 5 * _T_SPLIT_MEM_SIZE;
+#else//DUPLICATE_IN_L1
+    _args.deint[0].p_stage = _p_data_loc + 8 * _T_SPLIT_MEM_SIZE;
+    _args.deint[1].p_stage = _p_data_loc + 8 * _T_SPLIT_MEM_SIZE + _STAGE_MEM_SIZE;
+#endif//DUPLICATE_IN_L1
+#endif//INTERLEAVED_INPUT
+
     // start the kernel
     rt_team_fork(NUM_WORKERS, _net_fused_layer_1_2_kernel, &_args);
 
@@ -1029,21 +2621,19 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     rt_dma_wait(&_copy);
 
     // free all the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * 8 * _T_SPLIT_MEM_SIZE);
+    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * _DATA_MEM_SIZE);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l1_loc, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l1_loc, sizeof(int32_t) * NET_F1);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l1_loc, sizeof(int32_t) * NET_F1);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l1_loc, sizeof(int32_t) * NET_L1_PARAMS_LEN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l2_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l2_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l2_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(_l1_result_t) * NET_F2 * NET_L2_WEIGHT_LEN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(int32_t) * NUM_WORKERS * (NET_C * 4 + _THREAD_MEM_OFFSET));
+    rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(_l1_result_t) * NUM_WORKERS * (_THREAD_STRIDE * 4 + _THREAD_MEM_OFFSET));
 
 }
 
+#endif//RING_BUFFER
 
 #else //DUPLICATE_FEATUREMAP
 
@@ -1085,7 +2675,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
 
     // change the pointers to point to the data used by the specific core
     _p_result += _core_id * 2 * NET_T8_ALIGN;
-    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN;
+    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN_ALIGN;
     _p_factor_l1 += _core_id;
     _p_offset_l1 += _core_id;
     _p_weight_l2 += _core_id * 2 * NET_L2_WEIGHT_LEN;
@@ -1104,6 +2694,11 @@ void _net_fused_layer_1_2_kernel(void* args) {
     // compute the ReLU threshold
     int32_t _threshold_0 = -(_offset_l2_0 >> 3);
     int32_t _threshold_1 = -(_offset_l2_1 >> 3);
+#ifdef L2_RELU_CAP
+    // compute the cap of the ReLU
+    int32_t _cap_0 = _net_fused_layer_1_2_relu_cap(_factor_l2_0, _offset_l2_0, _threshold_0);
+    int32_t _cap_1 = _net_fused_layer_1_2_relu_cap(_factor_l2_1, _offset_l2_1, _threshold_1);
+#endif//L2_RELU_CAP
 
     int8_t* _p_data_iter = _p_data; // iterator over the current elements for which we do the computation
     int8_t* _p_data_iter_comp;      // Pointer to the data while doing the dot product
@@ -1118,8 +2713,8 @@ void _net_fused_layer_1_2_kernel(void* args) {
     int32_t _acc0, _acc1, _acc2, _acc3;
 
     // registers for the second layer
-    int32_t _pool_sum_0;
-    int32_t _pool_sum_1;
+    _l2_pool_t _pool_sum_0;
+    _l2_pool_t _pool_sum_1;
     int32_t _elem_0, _elem_1;
     int32_t _a, _b0, _b1;
 
@@ -1217,8 +2812,8 @@ void _net_fused_layer_1_2_kernel(void* args) {
                 }
 
                 // do ReLU on the first and second element
-                _elem_0 = __MAX(_elem_0, _threshold_0);
-                _elem_1 = __MAX(_elem_1, _threshold_1);
+                _elem_0 = _L2_RELU(_elem_0, _threshold_0, _cap_0);
+                _elem_1 = _L2_RELU(_elem_1, _threshold_1, _cap_1);
 
                 // add them to the pooling sum
                 _pool_sum_0 += _elem_0;
@@ -1232,11 +2827,11 @@ void _net_fused_layer_1_2_kernel(void* args) {
 
         // now, we have computed the temporary _pool_sum.
         // scale it
-        _pool_sum_0 = (_pool_sum_0 + _offset_l2_0) / _factor_l2_0;
-        _pool_sum_1 = (_pool_sum_1 + _offset_l2_1) / _factor_l2_1;
+        _pool_sum_0 = (_pool_sum_0 + (uint32_t)_offset_l2_0) / (uint32_t)_factor_l2_0;
+        _pool_sum_1 = (_pool_sum_1 + (uint32_t)_offset_l2_1) / (uint32_t)_factor_l2_1;
 
-        _pool_sum_0 = __CLIP_R(_pool_sum_0, 127);
-        _pool_sum_1 = __CLIP_R(_pool_sum_1, 127);
+        _pool_sum_0 = _L2_POOL_CLIP(_pool_sum_0);
+        _pool_sum_1 = _L2_POOL_CLIP(_pool_sum_1);
 
         // store the values
         *(_p_result_iter + 0 * NET_T8_ALIGN) = _pool_sum_0;
@@ -1266,13 +2861,15 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    int8_t* _p_weight_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    int32_t* _p_factor_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
-    int32_t* _p_offset_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
+    int32_t* _p_params_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+    int32_t* _p_factor_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_FACTOR;
+    int32_t* _p_offset_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_OFFSET;
+    int8_t* _p_weight_l1_loc = (int8_t*)(_p_params_l1_loc + NET_L1_PARAMS_WEIGHT);
 
+    int32_t* _p_params_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_OFFSET;
     int32_t* _p_weight_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
 
     int32_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NUM_WORKERS * NET_C_ALIGN * 4);
 
@@ -1308,37 +2905,24 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
         _p_data_loc_iter += NET_L1_PAD_INPUT_LEN_ALIGN;
     }
 
-    // load all the weights of layer 1
-    rt_dma_memcpy((unsigned int)net_l1_weight_reverse,
-                  (unsigned int)_p_weight_l1_loc,
-                  sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_factor,
-                  (unsigned int)_p_factor_l1_loc,
-                  sizeof(int32_t) * NET_F1,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_offset,
-                  (unsigned int)_p_offset_l1_loc,
-                  sizeof(int32_t) * NET_F1,
+    // load all the parameters of layer 1
+    rt_dma_memcpy((unsigned int)net_params.l1_params,
+                  (unsigned int)_p_params_l1_loc,
+                  sizeof(int32_t) * NET_L1_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
-    // load all the weights of layer 2
-    rt_dma_memcpy((unsigned int)net_l2_weight_32,
-                  (unsigned int)_p_weight_l2_loc,
-                  sizeof(int32_t) * NET_F2 * NET_L2_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_l2_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_l2_loc,
-                  sizeof(int32_t) * NET_F2,
+    // load all the parameters of layer 2
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_l2_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
     // wait until all dma transfers of the input data is complete
     rt_dma_wait(&_copy);
 
+    // the kernel accumulates in 32bit, widen the weights of layer 2
+    _net_fused_layer_1_2_widen_weight_l2((int8_t*)(_p_params_l2_loc + NET_L2_PARAMS_WEIGHT), _p_weight_l2_loc);
+
     // now, all the data necessary for computation resides in local memory! Prepare the kernel
     _net_fused_layer_1_2_kernel_t _args;
     _args.p_data = _p_data_loc;
@@ -1365,13 +2949,10 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l1_loc, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l1_loc, sizeof(int32_t) * NET_F1);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l1_loc, sizeof(int32_t) * NET_F1);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l1_loc, sizeof(int32_t) * NET_L1_PARAMS_LEN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l2_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l2_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l2_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(int32_t) * NET_F2 * NET_L2_WEIGHT_LEN);
 
     rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(int32_t) * NUM_WORKERS * NET_C_ALIGN * 4);
 
@@ -1419,7 +3000,7 @@ void _net_fused_layer_1_2_kernel(void* args) {
 
     // change the pointers to point to the data used by the specific core
     _p_result += _core_id * 2 * NET_T8_ALIGN;
-    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN;
+    _p_weight_l1 += _core_id * NET_L1_WEIGHT_LEN_ALIGN;
     _p_factor_l1 += _core_id;
     _p_offset_l1 += _core_id;
     _p_weight_l2 += _core_id * 2 * NET_L2_WEIGHT_LEN;
@@ -1591,13 +3172,15 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    int8_t* _p_weight_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    int32_t* _p_factor_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
-    int32_t* _p_offset_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
+    int32_t* _p_params_l1_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+    int32_t* _p_factor_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_FACTOR;
+    int32_t* _p_offset_l1_loc = _p_params_l1_loc + NET_L1_PARAMS_OFFSET;
+    int8_t* _p_weight_l1_loc = (int8_t*)(_p_params_l1_loc + NET_L1_PARAMS_WEIGHT);
 
-    int8_t* _p_weight_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
+    int32_t* _p_params_l2_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_l2_loc = _p_params_l2_loc + NET_L2_PARAMS_OFFSET;
+    int8_t* _p_weight_l2_loc = (int8_t*)(_p_params_l2_loc + NET_L2_PARAMS_WEIGHT);
 
     int8_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NUM_WORKERS * NET_C_ALIGN * 4);
 
@@ -1633,32 +3216,16 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
         _p_data_loc_iter += NET_L1_PAD_INPUT_LEN_ALIGN;
     }
 
-    // load all the weights of layer 1
-    rt_dma_memcpy((unsigned int)net_l1_weight_reverse,
-                  (unsigned int)_p_weight_l1_loc,
-                  sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_factor,
-                  (unsigned int)_p_factor_l1_loc,
-                  sizeof(int32_t) * NET_F1,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_offset,
-                  (unsigned int)_p_offset_l1_loc,
-                  sizeof(int32_t) * NET_F1,
+    // load all the parameters of layer 1
+    rt_dma_memcpy((unsigned int)net_params.l1_params,
+                  (unsigned int)_p_params_l1_loc,
+                  sizeof(int32_t) * NET_L1_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
-    // load all the weights of layer 2
-    rt_dma_memcpy((unsigned int)net_l2_weight,
-                  (unsigned int)_p_weight_l2_loc,
-                  sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_l2_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_l2_loc,
-                  sizeof(int32_t) * NET_F2,
+    // load all the parameters of layer 2
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_l2_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
     // wait until all dma transfers of the input data is complete
@@ -1690,13 +3257,9 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result) {
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l1_loc, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l1_loc, sizeof(int32_t) * NET_F1);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l1_loc, sizeof(int32_t) * NET_F1);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l1_loc, sizeof(int32_t) * NET_L1_PARAMS_LEN);
 
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_l2_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_l2_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_l2_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_l2_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
 
     rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(int8_t) * NUM_WORKERS * NET_C_ALIGN * 4);
 
@@ -0,0 +1,189 @@
+/**
+ * @file input_stage.c
+ * @author Tibor Schneider
+ * @date 2020/06/02
+ * @brief This file contains the Implementation for the input stage (quantization of the ADC samples)
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rt/rt_api.h"
+#include "input_stage.h"
+#include "net.h"
+#include "blob.h"
+
+#ifndef NUM_WORKERS
+#define NUM_WORKERS 8
+#endif
+
+// number of blocks of every row, and length of the padding at the end of every row
+#define _NUM_BLOCKS ((NET_T + NET_INPUT_BLOCK - 1) / NET_INPUT_BLOCK)
+#define _ROW_END_LEN (NET_INPUT_ROW_LEN - NET_INPUT_ROW_START - NET_T)
+
+// size of a local result buffer (a block with the padding at the start and the end of the row)
+#define _RESULT_LOC_LEN (NET_INPUT_ROW_START + NET_INPUT_BLOCK + _ROW_END_LEN)
+
+typedef struct
+{
+    const net_adc_t* p_adc;   // pointer to the ADC samples on L2
+    int8_t* p_result;         // pointer to the result on L2
+    net_adc_t* p_adc_loc;     // thread local buffers for the ADC samples of two blocks
+    int8_t* p_result_loc;     // thread local buffers for the result of two blocks
+    uint32_t factor;          // fixed-point factor
+    uint32_t clip;            // samples with larger magnitude saturate
+} _net_input_stage_kernel_t;
+
+/**
+ * @brief Starts to load the ADC samples of a block
+ *
+ * @param p_adc Pointer to the ADC samples on L2
+ * @param block Index of the block (row * _NUM_BLOCKS + block in the row)
+ * @param p_adc_loc Local buffer of size NET_INPUT_BLOCK
+ * @param p_copy DMA transfer
+ */
+static void _net_input_stage_load(const net_adc_t* p_adc,
+                                  unsigned int block,
+                                  net_adc_t* p_adc_loc,
+                                  rt_dma_copy_t* p_copy) {
+    unsigned int _row = block / _NUM_BLOCKS;
+    unsigned int _t = (block % _NUM_BLOCKS) * NET_INPUT_BLOCK;
+    unsigned int _len = NET_T - _t < NET_INPUT_BLOCK ? NET_T - _t : NET_INPUT_BLOCK;
+    rt_dma_memcpy((unsigned int)(p_adc + _row * NET_T + _t),
+                  (unsigned int)p_adc_loc,
+                  sizeof(net_adc_t) * _len,
+                  RT_DMA_DIR_EXT2LOC, 0, p_copy);
+}
+
+/**
+ * @brief Input stage kernel (quantizes the blocks core_id, core_id + NUM_WORKERS, ...)
+ */
+void _net_input_stage_kernel(void* args) {
+
+    unsigned int _core_id = rt_core_id();
+
+    _net_input_stage_kernel_t* _args = args;
+
+    const net_adc_t* _p_adc = _args->p_adc;
+    int8_t* _p_result = _args->p_result;
+    net_adc_t* _p_adc_loc = _args->p_adc_loc + _core_id * 2 * NET_INPUT_BLOCK;
+    int8_t* _p_result_loc = _args->p_result_loc + _core_id * 2 * _RESULT_LOC_LEN;
+    uint32_t _factor = _args->factor;
+    uint32_t _clip = _args->clip;
+
+    const net_adc_t* _p_adc_iter;
+    int8_t* _p_result_iter;
+    int8_t* _p_result_start;
+    int32_t _x;
+    uint32_t _abs;
+    int32_t _y;
+
+    unsigned int _row, _block, _t, _len, _store_len;
+    unsigned int _buf = 0;
+
+    rt_dma_copy_t _copy_in;
+    rt_dma_copy_t _copy_out;
+
+    if (_core_id < NET_C * _NUM_BLOCKS) {
+        _net_input_stage_load(_p_adc, _core_id, _p_adc_loc, &_copy_in);
+    }
+
+    for (unsigned int _b = _core_id; _b < NET_C * _NUM_BLOCKS; _b += NUM_WORKERS) {
+
+        _row = _b / _NUM_BLOCKS;
+        _block = _b % _NUM_BLOCKS;
+        _t = _block * NET_INPUT_BLOCK;
+        _len = NET_T - _t < NET_INPUT_BLOCK ? NET_T - _t : NET_INPUT_BLOCK;
+
+        // wait for the samples of this block, and load the next block into the other buffer
+        rt_dma_wait(&_copy_in);
+        if (_b + NUM_WORKERS < NET_C * _NUM_BLOCKS) {
+            _net_input_stage_load(_p_adc, _b + NUM_WORKERS, _p_adc_loc + (1 - _buf) * NET_INPUT_BLOCK, &_copy_in);
+        }
+
+        // the first block of a row starts with the padding of the row (the buffer is not in use, the
+        // transfer of this buffer was already waited for before the previous store)
+        _p_result_start = _p_result_loc + _buf * _RESULT_LOC_LEN;
+        _p_result_iter = _p_result_start;
+        if (_block == 0) {
+            for (int _i = 0; _i < NET_INPUT_ROW_START; _i++) {
+                *(_p_result_iter++) = 0;
+            }
+        }
+
+        // quantize the samples (clip the magnitude first, such that the product fits into 32 bits)
+        _p_adc_iter = _p_adc_loc + _buf * NET_INPUT_BLOCK;
+        for (unsigned int _i = 0; _i < _len; _i++) {
+            _x = *(_p_adc_iter++);
+            _abs = _x < 0 ? -_x : _x;
+            _abs = _abs > _clip ? _clip : _abs;
+            _y = (_abs * _factor) >> NET_INPUT_SHIFT;
+            _y = _y > 127 ? 127 : _y;
+            *(_p_result_iter++) = _x < 0 ? -_y : _y;
+        }
+
+        // the last block of a row ends with the padding of the row
+        if (_block == _NUM_BLOCKS - 1) {
+            for (int _i = 0; _i < _ROW_END_LEN; _i++) {
+                *(_p_result_iter++) = 0;
+            }
+        }
+        _store_len = _p_result_iter - _p_result_start;
+
+        // store the block, after the store of the previous block is done
+        if (_b != _core_id) {
+            rt_dma_wait(&_copy_out);
+        }
+        rt_dma_memcpy((unsigned int)(_p_result + _row * NET_INPUT_ROW_LEN + (_block == 0 ? 0 : NET_INPUT_ROW_START + _t)),
+                      (unsigned int)_p_result_start,
+                      sizeof(int8_t) * _store_len,
+                      RT_DMA_DIR_LOC2EXT, 0, &_copy_out);
+
+        _buf = 1 - _buf;
+    }
+
+    if (_core_id < NET_C * _NUM_BLOCKS) {
+        rt_dma_wait(&_copy_out);
+    }
+
+    rt_team_barrier();
+}
+
+void net_input_stage(const net_adc_t* p_adc, int8_t* p_result) {
+
+    // allocate the thread local buffers
+    net_adc_t* _p_adc_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(net_adc_t) * NUM_WORKERS * 2 * NET_INPUT_BLOCK);
+    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NUM_WORKERS * 2 * _RESULT_LOC_LEN);
+
+    _net_input_stage_kernel_t _args;
+    _args.p_adc = p_adc;
+    _args.p_result = p_result;
+    _args.p_adc_loc = _p_adc_loc;
+    _args.p_result_loc = _p_result_loc;
+    _args.factor = net_params.input_factor;
+    // smallest magnitude, for which the result is larger than 127
+    _args.clip = ((128u << NET_INPUT_SHIFT) + _args.factor - 1) / _args.factor;
+
+    rt_team_fork(NUM_WORKERS, _net_input_stage_kernel, &_args);
+
+    rt_free(RT_ALLOC_CL_DATA, _p_adc_loc, sizeof(net_adc_t) * NUM_WORKERS * 2 * NET_INPUT_BLOCK);
+    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NUM_WORKERS * 2 * _RESULT_LOC_LEN);
+}
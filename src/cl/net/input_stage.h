@@ -0,0 +1,86 @@
+/**
+ * @file input_stage.h
+ * @author Tibor Schneider
+ * @date 2020/06/02
+ * @brief This file contains the definitions for the input stage (quantization of the ADC samples)
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_NET_INPUT_STAGE_H__
+#define __CL_NET_INPUT_STAGE_H__
+
+#include "rt/rt_api.h"
+#include "net.h"
+
+/**
+ * @brief Raw ADC sample. 24bit samples are stored sign extended in 32bit words.
+ */
+#if NET_INPUT_ADC_BITS > 16
+typedef int32_t net_adc_t;
+#else
+typedef int16_t net_adc_t;
+#endif
+
+/**
+ * @brief Layout of the quantized input, as expected by the first layer. If DUPLICATE_FEATUREMAP is
+ * enabled, every channel is padded with NET_L1_PAD_START zeros at the start and NET_L1_PAD_END
+ * zeros at the end. Otherwise, every channel is aligned to NET_T_ALIGN (filled with zeros).
+ *
+ * With INTERLEAVED_INPUT, the input is of shape [NET_T, NET_C] and not padded. It is then handled
+ * as NET_C rows of NET_T consecutive samples, which do not correspond to channels.
+ */
+#if defined(INTERLEAVED_INPUT)
+#define NET_INPUT_ROW_LEN NET_T
+#define NET_INPUT_ROW_START 0
+#elif defined(DUPLICATE_FEATUREMAP)
+#define NET_INPUT_ROW_LEN NET_L1_PAD_INPUT_LEN
+#define NET_INPUT_ROW_START NET_L1_PAD_START
+#else//DUPLICATE_FEATUREMAP
+#define NET_INPUT_ROW_LEN NET_T_ALIGN
+#define NET_INPUT_ROW_START 0
+#endif//DUPLICATE_FEATUREMAP
+
+/**
+ * @brief Number of samples, which are quantized at once by a core
+ */
+#define NET_INPUT_BLOCK 256
+
+/**
+ * @brief Quantizes the raw ADC samples to the input of the network (on the cluster, in parallel)
+ *
+ * Per sample x, the result is sign(x) * min(127, (|x| * net_params.input_factor) >> NET_INPUT_SHIFT),
+ * which is bit-exact to functional.quantize_adc (python_utils), and approximates quantize_to_int
+ * with the scale of the input quantization (quant1). The rows are split into blocks of
+ * NET_INPUT_BLOCK samples, which are distributed over the cores. Every core loads the next block
+ * while it quantizes the current one, and stores it (with the padding of the row) while it
+ * quantizes the next one, such that at most two transfers of every core are in flight.
+ *
+ * @warning p_result must already be allocated on L2!
+ *
+ * @param p_adc Pointer to the raw ADC samples on L2, of shape [NET_C, NET_T], or [NET_T, NET_C]
+ *              with INTERLEAVED_INPUT
+ * @param p_result Pointer to the result on L2, of shape [NET_C, NET_INPUT_ROW_LEN], or [NET_T, NET_C]
+ *                 with INTERLEAVED_INPUT
+ */
+void net_input_stage(const net_adc_t* p_adc, int8_t* p_result);
+
+#endif//__CL_NET_INPUT_STAGE_H__
@@ -29,8 +29,29 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
+#include "stream.h"
 #include "../func/functional.h"
 
+#ifndef CROSS_CORRELATE
+/**
+ * @brief Reverts the weights of a filter inplace. The parameters only contain the reversed weights
+ * (used for the cross correlation), but the convolution needs them in the original order.
+ *
+ * @param p_weight Pointer to the weights of a single filter, of length NET_L1_WEIGHT_LEN
+ */
+static void _net_layer1_revert_weight(int8_t* p_weight) {
+    int8_t* _p_a = p_weight;
+    int8_t* _p_b = p_weight + NET_L1_WEIGHT_LEN - 1;
+    int8_t _tmp;
+    while (_p_a < _p_b) {
+        _tmp = *_p_a;
+        *(_p_a++) = *_p_b;
+        *(_p_b--) = _tmp;
+    }
+}
+#endif //CROSS_CORRELATE
+
 #ifdef PARALLEL
 
 #ifndef NUM_WORKERS
@@ -81,8 +102,12 @@ void _net_layer1_kernel(void* args) {
         _ch = _iter % NET_C;
 
         _p_data_iter = _p_data + _ch * NET_L1_PAD_INPUT_LEN_ALIGN;
-        _p_weight_iter = _p_weight + _k * NET_L1_WEIGHT_LEN;
+        _p_weight_iter = _p_weight + _k * NET_L1_WEIGHT_LEN_ALIGN;
+#ifdef DMA_FLIP
+        _p_result_iter = _p_result + _k * NET_C_ALIGN * NET_T_ALIGN + _ch;
+#else//DMA_FLIP
         _p_result_iter = _p_result + (_k * NET_C_ALIGN + _ch) * NET_T_ALIGN;
+#endif//DMA_FLIP
         _factor = _p_factor[_k];
         _offset = _p_offset[_k];
 
@@ -99,10 +124,19 @@ void _net_layer1_kernel(void* args) {
 
         rt_team_critical_enter();
         // copy back the results
+#ifdef DMA_FLIP
+        // store the channel as a column of the output [NET_T_ALIGN, NET_C_ALIGN]
+        rt_dma_memcpy_2d((unsigned int)_p_result_iter,
+                         (unsigned int)_p_thread_data,
+                         sizeof(int8_t) * NET_T,
+                         sizeof(int8_t) * NET_C_ALIGN, sizeof(int8_t),
+                         RT_DMA_DIR_LOC2EXT, 0, &_copy);
+#else//DMA_FLIP
         rt_dma_memcpy((unsigned int)_p_result_iter,
                       (unsigned int)_p_thread_data,
                       sizeof(int8_t) * NET_T,
                       RT_DMA_DIR_LOC2EXT, 0, &_copy);
+#endif//DMA_FLIP
         rt_dma_wait(&_copy);
         rt_team_critical_exit();
 
@@ -113,6 +147,111 @@ void _net_layer1_kernel(void* args) {
     // wait for all workers to finish
     rt_team_barrier();
 }
+
+#ifdef NTT_CONV
+
+typedef struct
+{
+    int8_t* p_data;             // pointer to entire data vector on L1
+    const int8_t* p_weight;     // pointer to entire weight vector on L1
+    int32_t* p_factor;          // pointer to all factors on L1
+    int32_t* p_offset;          // pointer to all offsets on L1
+    uint32_t* p_twiddle;        // pointer to the forward and inverse twiddle factors on L1
+    uint32_t* p_spectrum;       // pointer to the spectra of all filters on L1
+    int compute_spectrum;       // if set, the spectra are computed from the weights first
+    uint32_t* p_thread_buffer;  // pointer to thread local transform buffers (2 per core)
+    int8_t* p_thread_data;      // pointer to thread local data
+    int8_t* p_result;           // pointer to result on L2
+} _net_layer1_ntt_kernel_t;
+
+/**
+ * @brief Layer1 kernel with the number theoretic transform
+ *
+ * Every core transforms a block of NET_L1_NTT_LEN samples of a channel once, and computes the
+ * NET_L1_NTT_STEP outputs of this block for all filters (overlap-save), such that the forward
+ * transform is shared by all NET_F1 filters.
+ */
+void _net_layer1_ntt_kernel(void* args) {
+
+    // get core id
+    unsigned int core_id = rt_core_id();
+
+    // extract parameters
+    int8_t* _p_data = ((_net_layer1_ntt_kernel_t*)args)->p_data;
+    const int8_t* _p_weight = ((_net_layer1_ntt_kernel_t*)args)->p_weight;
+    int32_t* _p_factor = ((_net_layer1_ntt_kernel_t*)args)->p_factor;
+    int32_t* _p_offset = ((_net_layer1_ntt_kernel_t*)args)->p_offset;
+    uint32_t* _p_twiddle = ((_net_layer1_ntt_kernel_t*)args)->p_twiddle;
+    uint32_t* _p_spectrum = ((_net_layer1_ntt_kernel_t*)args)->p_spectrum;
+    uint32_t* _p_input = (((_net_layer1_ntt_kernel_t*)args)->p_thread_buffer) + core_id * 2 * NET_L1_NTT_LEN;
+    uint32_t* _p_product = _p_input + NET_L1_NTT_LEN;
+    int8_t* _p_thread_data = (((_net_layer1_ntt_kernel_t*)args)->p_thread_data) + core_id * NET_L1_NTT_STEP_ALIGN;
+    int8_t* _p_result = ((_net_layer1_ntt_kernel_t*)args)->p_result;
+
+    unsigned int _iter;
+    unsigned int _ch, _start, _num, _in_len;
+
+    rt_dma_copy_t _copy;
+
+    // compute the spectra of the filters, if they are not part of the parameters (model blob)
+    if (((_net_layer1_ntt_kernel_t*)args)->compute_spectrum) {
+        for (_iter = core_id; _iter < NET_F1; _iter += NUM_WORKERS) {
+            func_ntt_spectrum(_p_weight + _iter * NET_L1_WEIGHT_LEN_ALIGN, NET_L1_WEIGHT_LEN,
+                              NET_L1_NTT_LEN, _p_twiddle, NET_L1_NTT_SCALE,
+                              _p_spectrum + _iter * NET_L1_NTT_LEN);
+        }
+        rt_team_barrier();
+    }
+
+    // loop until all blocks of all channels are computed
+    for (_iter = core_id; _iter < NET_C * NET_L1_NTT_BLOCKS; _iter += NUM_WORKERS) {
+
+        _ch = _iter / NET_L1_NTT_BLOCKS;
+        _start = (_iter % NET_L1_NTT_BLOCKS) * NET_L1_NTT_STEP;
+        _num = NET_T - _start < NET_L1_NTT_STEP ? NET_T - _start : NET_L1_NTT_STEP;
+        _in_len = NET_L1_PAD_INPUT_LEN - _start < NET_L1_NTT_LEN ? NET_L1_PAD_INPUT_LEN - _start : NET_L1_NTT_LEN;
+
+        // transform the input block once
+        func_ntt_load(_p_data + _ch * NET_L1_PAD_INPUT_LEN_ALIGN + _start, _in_len, NET_L1_NTT_LEN, _p_input);
+        func_ntt_forward(_p_input, NET_L1_NTT_LEN, _p_twiddle);
+
+        for (unsigned int _k = 0; _k < NET_F1; _k++) {
+
+            // multiply with the filter, transform back and scale the valid part
+            func_ntt_pointwise(_p_input, _p_spectrum + _k * NET_L1_NTT_LEN, NET_L1_NTT_LEN, _p_product);
+            func_ntt_inverse(_p_product, NET_L1_NTT_LEN, _p_twiddle + NET_L1_NTT_LEN / 2);
+            func_ntt_transform_8bit(_p_product + NET_L1_WEIGHT_LEN - 1, _num,
+                                    _p_factor[_k], _p_offset[_k], _p_thread_data);
+
+            rt_team_critical_enter();
+            // copy back the results
+#ifdef DMA_FLIP
+            rt_dma_memcpy_2d((unsigned int)(_p_result + (_k * NET_T_ALIGN + _start) * NET_C_ALIGN + _ch),
+                             (unsigned int)_p_thread_data,
+                             sizeof(int8_t) * _num,
+                             sizeof(int8_t) * NET_C_ALIGN, sizeof(int8_t),
+                             RT_DMA_DIR_LOC2EXT, 0, &_copy);
+#else//DMA_FLIP
+            rt_dma_memcpy((unsigned int)(_p_result + (_k * NET_C_ALIGN + _ch) * NET_T_ALIGN + _start),
+                          (unsigned int)_p_thread_data,
+                          sizeof(int8_t) * _num,
+                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
+#endif//DMA_FLIP
+            rt_dma_wait(&_copy);
+            rt_team_critical_exit();
+        }
+    }
+
+    // wait for all workers to finish
+    rt_team_barrier();
+}
+
+#endif //NTT_CONV
+
+#endif //PARALLEL
+
+#if defined(NTT_CONV) && !defined(PARALLEL)
+#error "The NTT convolution (NTT_CONV) requires PARALLEL"
 #endif
 
 /**
@@ -126,6 +265,9 @@ void _net_layer1_kernel(void* args) {
  *
  * @info The output be allocated to NET_F1 * NET_C_ALIGN * NET_T_ALIGN, because it will be flipped inplace afterwards.
  *
+ * @info With DMA_FLIP, the DMA stores every channel as a column of the output, which is of shape
+ *       [NET_F1, NET_T, NET_C] aligned to [NET_F1, NET_T_ALIGN, NET_C_ALIGN], and must not be flipped.
+ *
  * @param p_data Pointer to the input data, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN]
  * @param p_result Pointer to the output data of shape [NET_F1, NET_C, NET_T] aligned to [NET_F1, NET_C_ALIGN, NET_T_ALIGN].
  */
@@ -134,14 +276,20 @@ void net_layer1(const int8_t* p_data, int8_t* p_result) {
 #ifdef PARALLEL
 
     const int8_t* _p_data_iter = p_data; // only used for data loading
-    int8_t* _p_result_iter = p_result; // iterator over the result location
 
     // allocate memory for two results and two inputs
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    int8_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NUM_WORKERS * NET_T_ALIGN);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F1);
+#ifdef NTT_CONV
+    // only a single block of every filter is computed at once
+#define _NET_L1_THREAD_DATA_LEN NET_L1_NTT_STEP_ALIGN
+#else //NTT_CONV
+#define _NET_L1_THREAD_DATA_LEN NET_T_ALIGN
+#endif //NTT_CONV
+    int8_t* _p_thread_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NUM_WORKERS * _NET_L1_THREAD_DATA_LEN);
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L1_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L1_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L1_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L1_PARAMS_WEIGHT);
 
     rt_dma_copy_t _copy;
 
@@ -174,31 +322,59 @@ void net_layer1(const int8_t* p_data, int8_t* p_result) {
         _p_data_loc_iter += NET_L1_PAD_INPUT_LEN_ALIGN;
     }
 
-    // load all the weights
-#ifdef CROSS_CORRELATE
-    rt_dma_memcpy((unsigned int)net_l1_weight_reverse,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-#else //CROSS_CORRELATE
-    rt_dma_memcpy((unsigned int)net_l1_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-#endif //CROSS_CORRELATE
-
-    rt_dma_memcpy((unsigned int)net_l1_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F1,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_memcpy((unsigned int)net_l1_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F1,
+    // load all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l1_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L1_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 1, &_copy);
 
     // wait until all dma transfers of the input data is complete
     rt_dma_wait(&_copy);
 
+#if !defined(CROSS_CORRELATE) && !defined(NTT_CONV)
+    for (int _k = 0; _k < NET_F1; _k++) {
+        _net_layer1_revert_weight(_p_weight_loc + _k * NET_L1_WEIGHT_LEN_ALIGN);
+    }
+#endif //CROSS_CORRELATE, NTT_CONV
+
+#ifdef NTT_CONV
+
+    // load the twiddle factors and the spectra of the filters (if available)
+    uint32_t* _p_ntt_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(uint32_t) * (NET_F1 + 1) * NET_L1_NTT_LEN);
+    uint32_t* _p_thread_buffer_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(uint32_t) * NUM_WORKERS * 2 * NET_L1_NTT_LEN);
+    rt_dma_memcpy((unsigned int)net_l1_ntt_twiddle,
+                  (unsigned int)_p_ntt_loc,
+                  sizeof(uint32_t) * NET_L1_NTT_LEN,
+                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
+    if (net_params.l1_ntt_spectrum != NULL) {
+        rt_dma_memcpy((unsigned int)net_params.l1_ntt_spectrum,
+                      (unsigned int)(_p_ntt_loc + NET_L1_NTT_LEN),
+                      sizeof(uint32_t) * NET_F1 * NET_L1_NTT_LEN,
+                      RT_DMA_DIR_EXT2LOC, 1, &_copy);
+    }
+    rt_dma_wait(&_copy);
+
+    // prepare the arguments for the cluster
+    _net_layer1_ntt_kernel_t args;
+    args.p_data = _p_data_loc;
+    args.p_weight = _p_weight_loc;
+    args.p_factor = _p_factor_loc;
+    args.p_offset = _p_offset_loc;
+    args.p_twiddle = _p_ntt_loc;
+    args.p_spectrum = _p_ntt_loc + NET_L1_NTT_LEN;
+    args.compute_spectrum = net_params.l1_ntt_spectrum == NULL;
+    args.p_thread_buffer = _p_thread_buffer_loc;
+    args.p_thread_data = _p_thread_data_loc;
+    args.p_result = p_result;
+
+    // call the cluster
+    rt_team_fork(NUM_WORKERS, _net_layer1_ntt_kernel, (void*)(&args));
+
+    rt_free(RT_ALLOC_CL_DATA, _p_ntt_loc, sizeof(uint32_t) * (NET_F1 + 1) * NET_L1_NTT_LEN);
+    rt_free(RT_ALLOC_CL_DATA, _p_thread_buffer_loc, sizeof(uint32_t) * NUM_WORKERS * 2 * NET_L1_NTT_LEN);
+
+#else //NTT_CONV
+
     // prepare the arguments for the cluster
     _net_layer1_kernel_t args;
     args.p_data = _p_data_loc;
@@ -211,75 +387,89 @@ void net_layer1(const int8_t* p_data, int8_t* p_result) {
     // call the cluster
     rt_team_fork(NUM_WORKERS, _net_layer1_kernel, (void*)(&args));
 
+#endif //NTT_CONV
+
     // free up the memory
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_C * NET_L1_PAD_INPUT_LEN_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(int8_t) * NUM_WORKERS * NET_T_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F1 * NET_L1_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F1);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F1);
+    rt_free(RT_ALLOC_CL_DATA, _p_thread_data_loc, sizeof(int8_t) * NUM_WORKERS * _NET_L1_THREAD_DATA_LEN);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L1_PARAMS_LEN);
 
 #else //PARALLEL
 
-    const int8_t* _p_data_iter = p_data;
-    const int8_t* _p_weight_iter = net_l1_weight;
-    int8_t* _p_result_iter = p_result;
-
     /*
-     * Just copy the files, compute and copy the files back
+     * Stream every channel (for every filter) through L1: the input, the weights and the result are
+     * streams, such that the transfers overlap with the computation (with DMA_STREAM).
      */
 
-    // allocate memory for two results and two inputs
-    int8_t * _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_L1_PAD_INPUT_LEN_ALIGN);
-    int8_t * _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T_ALIGN);
+    // allocate memory for the result of the convolution
 #ifndef INTRINSIC_SCALE
     int32_t * _p_conv_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_T);
 #endif
-    int8_t * _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_L1_WEIGHT_LEN);
 
-    rt_dma_copy_t _copy;
-
-    // initialize input to have zero padding
-    // initialize padding start (with loop unrolling)
-    int32_t* tmp__p_data_loc = (int32_t*)(_p_data_loc);
-    for (unsigned int i = 0; i < (NET_L1_PAD_START + 7) / 8; i++) {
-        *(tmp__p_data_loc++) = 0;
-        *(tmp__p_data_loc++) = 0;
-    }
-    // initialize padding end (with loop unrolling)
-    tmp__p_data_loc = (int32_t*)(_p_data_loc + NET_L1_PAD_INPUT_LEN_ALIGN - 4);
-    for (unsigned int i = 0; i < (NET_L1_PAD_END + 7) / 8; i++) {
-        *(tmp__p_data_loc--) = 0;
-        *(tmp__p_data_loc--) = 0;
-    }
+    // one input channel per tile (for every filter), padded with zeros on L1
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * NET_T,
+        .num = {NET_C, NET_F1},
+        .stride = {sizeof(int8_t) * NET_T_ALIGN, 0},
+        .loc_offset = NET_L1_PAD_START,
+        .buffer_len = sizeof(int8_t) * NET_L1_PAD_INPUT_LEN_ALIGN,
+    };
+    // one filter per tile
+    net_stream_desc_t _weight_desc = {
+        .p_ext = (const int8_t*)(net_params.l1_params + NET_L1_PARAMS_WEIGHT),
+        .size = sizeof(int8_t) * NET_L1_WEIGHT_LEN,
+        .num = {NET_F1, 1},
+        .stride = {sizeof(int8_t) * NET_L1_WEIGHT_LEN_ALIGN, 0},
+    };
+#ifdef DMA_FLIP
+    // one channel per tile, stored as a column of the output [NET_T_ALIGN, NET_C_ALIGN]
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T,
+        .num = {NET_C, NET_F1},
+        .stride = {sizeof(int8_t), sizeof(int8_t) * NET_T_ALIGN * NET_C_ALIGN},
+        .row_len = sizeof(int8_t),
+        .row_stride = sizeof(int8_t) * NET_C_ALIGN,
+        .buffer_len = sizeof(int8_t) * NET_T_ALIGN,
+    };
+#else//DMA_FLIP
+    // one channel per tile
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T_ALIGN,
+        .num = {NET_C, NET_F1},
+        .stride = {sizeof(int8_t) * NET_T_ALIGN, sizeof(int8_t) * NET_C_ALIGN * NET_T_ALIGN},
+    };
+#endif//DMA_FLIP
+
+    net_stream_t _input;
+    net_stream_t _weight;
+    net_stream_t _output;
+    net_stream_open(&_weight, &_weight_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+    net_stream_open(&_output, &_output_desc, NET_STREAM_DEPTH, NET_STREAM_OUT);
+
+    int8_t* _p_data_loc;
+    int8_t* _p_weight_loc;
+    int8_t* _p_result_loc;
 
     // start the main loop
     for (int _k = 0; _k < NET_F1; _k++) {
         // load scale factor and offset
-        int32_t _convert_factor = net_l1_factor[_k];
-        int32_t _convert_offset = net_l1_offset[_k];
-
-        // load the weights
-        rt_dma_memcpy((unsigned int)_p_weight_iter,
-                      (unsigned int)_p_weight_loc,
-                      sizeof(int8_t) * NET_L1_WEIGHT_LEN,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
-
-        // reset the current data pointer back to the first channel
-        _p_data_iter = p_data;
+        int32_t _convert_factor = net_params.l1_params[NET_L1_PARAMS_FACTOR + _k];
+        int32_t _convert_offset = net_params.l1_params[NET_L1_PARAMS_OFFSET + _k];
 
-        // set the result pointer to point to the start of the next k in F1:
-        _p_result_iter = p_result + _k * NET_C_ALIGN * NET_T_ALIGN;
+        // get the weights
+        _p_weight_loc = net_stream_next(&_weight);
+        _net_layer1_revert_weight(_p_weight_loc);
 
         // loop over all input channels
         for (int _ch = 0; _ch < NET_C; _ch++) {
 
-            // copy the data
-            rt_dma_memcpy((unsigned int)_p_data_iter,
-                          (unsigned int)(_p_data_loc + NET_L1_PAD_START),
-                          sizeof(int8_t) * NET_T,
-                          RT_DMA_DIR_EXT2LOC, 0, &_copy);
-            rt_dma_wait(&_copy);
+            // get the data (with padding) and the buffer for the result
+            _p_data_loc = net_stream_next(&_input);
+            _p_result_loc = net_stream_next(&_output);
 
 #ifdef INTRINSIC_SCALE
             // convolve and scale the data (always the correct parts)
@@ -298,31 +488,16 @@ void net_layer1(const int8_t* p_data, int8_t* p_result) {
                                       _convert_factor, _convert_offset, 1,
                                       _p_result_loc);
 #endif
-
-            // copy back the results
-            rt_dma_memcpy((unsigned int)_p_result_iter,
-                          (unsigned int)_p_result_loc,
-                          sizeof(int8_t) * NET_T_ALIGN,
-                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
-            rt_dma_wait(&_copy);
-
-            // increment the data and results iterator
-            _p_data_iter += NET_T_ALIGN;
-            _p_result_iter += NET_T_ALIGN;
         }
-
-        // increment the current weight pointer
-        _p_weight_iter += NET_L1_WEIGHT_LEN;
-
     }
 
-    // free up the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_L1_PAD_INPUT_LEN_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T_ALIGN);
+    // store the last result and free up the memory
+    net_stream_close(&_output);
+    net_stream_close(&_input);
+    net_stream_close(&_weight);
 #ifndef INTRINSIC_SCALE
     rt_free(RT_ALLOC_CL_DATA, _p_conv_result_loc, sizeof(int32_t) * NET_T);
 #endif
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_L1_WEIGHT_LEN);
 
 #endif //PARALLEL
 
@@ -29,6 +29,8 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
+#include "stream.h"
 #include "../func/functional.h"
 
 #ifdef PARALLEL
@@ -39,28 +41,27 @@
 
 typedef struct
 {
-    int8_t* p_data;    // pointer to current input image (L1 memory)
-    int8_t* p_weight;  // pointer to current weight vector (L1 memory)
-    int32_t offset;    // BN offset
-    int32_t factor;    // BN factor
-    int8_t* p_result; // pointer to result vector (L1 memory)
+    net_stream_t* p_input;   // stream of the input images [NET_T, NET_C_ALIGN]
+    net_stream_t* p_output;  // stream of the output vectors [NET_T8]
+    int8_t* p_weight;        // pointer to the weights (L1 memory)
+    int32_t* p_factor;       // pointer to the BN factors (L1 memory)
+    int32_t* p_offset;       // pointer to the BN offsets (L1 memory)
 } _net_layer2_kernel_t;
 
 /**
- * @brief Layer2 kernel
+ * @brief Computes the output time samples core_id, core_id + NUM_WORKERS, ... of one output channel
  */
-void _net_layer2_kernel(void* args) {
+static void _net_layer2_kernel_channel(const int8_t* p_data,
+                                       const int8_t* p_weight,
+                                       int32_t offset,
+                                       int32_t factor,
+                                       int8_t* p_result) {
 
     // get core id
     unsigned int core_id = rt_core_id();
 
-    // extract parameters
-    int8_t* _p_data = ((_net_layer2_kernel_t*)args)->p_data;
-    int8_t* _p_weight = ((_net_layer2_kernel_t*)args)->p_weight;
-    int32_t _offset = ((_net_layer2_kernel_t*)args)->offset;
-    int32_t _factor = ((_net_layer2_kernel_t*)args)->factor;
-    int8_t* _p_result = ((_net_layer2_kernel_t*)args)->p_result;
-
+    int32_t _offset = offset;
+    int32_t _factor = factor;
 
 #ifdef REORDER_BN
     // in case of reorder bn, compute the relu threshold
@@ -73,13 +74,13 @@ void _net_layer2_kernel(void* args) {
 
     unsigned int _t_out = core_id;
 
-    int8_t* _p_data_iter = _p_data + core_id * 8 * NET_C_ALIGN;
-    int8_t* _p_result_iter = _p_result + core_id;
+    const int8_t* _p_data_iter = p_data + core_id * 8 * NET_C_ALIGN;
+    int8_t* _p_result_iter = p_result + core_id;
 
     int32_t _sum, _elem;
 
     // loop until all elements are computed
-    while (_t_out < NET_T8_ALIGN) {
+    while (_t_out < NET_T8) {
 
         _sum = 0;
 
@@ -87,7 +88,7 @@ void _net_layer2_kernel(void* args) {
 
             // do the dot product
             // we copute the dot product over C_ALIGN instead of C, it is faster and the additional elements are 0
-            _elem = func_dotp(_p_data_iter, _p_weight, NET_C_ALIGN);
+            _elem = func_dotp(_p_data_iter, p_weight, NET_C_ALIGN);
 
 #ifdef REORDER_BN
             // do the ReLU
@@ -124,6 +125,44 @@ void _net_layer2_kernel(void* args) {
         _p_result_iter += NUM_WORKERS;
 
     }
+}
+
+/**
+ * @brief Layer2 kernel
+ *
+ * All cores compute the same output channel at the same time. The input images and the output
+ * vectors are exchanged with the streams, which load the next image and store the previous vector
+ * while the current one is computed (with DMA_STREAM).
+ */
+void _net_layer2_kernel(void* args) {
+
+    // extract parameters
+    _net_layer2_kernel_t* _args = args;
+
+    const int8_t* _p_weight_iter = _args->p_weight;
+    const int32_t* _p_factor_iter = _args->p_factor;
+    const int32_t* _p_offset_iter = _args->p_offset;
+
+    int8_t* _p_data;
+    int8_t* _p_result;
+
+    // loop over all input images
+    for (unsigned int _k = 0; _k < NET_F1; _k++) {
+
+        _p_data = net_stream_team_next(_args->p_input);
+
+        // loop over all output filters for the corresponding input image
+        for (unsigned int _i = 0; _i < NET_D; _i++) {
+
+            _p_result = net_stream_team_next(_args->p_output);
+
+            _net_layer2_kernel_channel(_p_data, _p_weight_iter, *(_p_offset_iter++), *(_p_factor_iter++),
+                                       _p_result);
+
+            // use the next filter
+            _p_weight_iter += NET_L2_WEIGHT_LEN;
+        }
+    }
 
     // wait for all workers to finish
     rt_team_barrier();
@@ -151,242 +190,69 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
 
 #ifdef PARALLEL
 
-#ifdef DMA_STREAM
-
     /*
-     * Parallel implementation with data streaming
+     * Parallel implementation, the input images and the output vectors are streamed (with
+     * DMA_STREAM, the transfers overlap with the computation).
      */
 
-    const int8_t* _p_data_iter = p_data;          // iterator over the current image of the input
-    const int8_t* _p_result_iter = p_result;      // iterator over the current vector of the output
-
     rt_dma_copy_t _copy;
-    rt_dma_copy_t _data_copy;
 
     // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    int8_t* _p_data_loc_next = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-
-    if (_p_offset_loc == NULL) {
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L2_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L2_PARAMS_WEIGHT);
+
+    if (_p_params_loc == NULL) {
         printf("Not Enough space on L1 memory");
         return;
     }
 
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l2_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN,
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    rt_dma_wait(&_copy);
-
-    int8_t* _p_weight_loc_iter = _p_weight_loc;  // iterator over the current weights (filter)
-    int32_t* _p_factor_loc_iter = _p_factor_loc; // iterator over the current factor
-    int32_t* _p_offset_loc_iter = _p_offset_loc; // iterator over the current offset
-    int8_t* _p_data_loc_iter;                    // iterator over the current local data row
 
-    int32_t _convert_factor;
-    int32_t _convert_offset;
-    int32_t _relu_threshold;
-
-    int32_t _elem; // stores the current element, for doing dot product and ReLU
-    int32_t _sum;  // stores the sum for the pooling
-
-    // copy the first input
-    rt_dma_memcpy((unsigned int)_p_data_iter,
-                  (unsigned int)_p_data_loc_next,
-                  sizeof(int8_t) * NET_T * NET_C_ALIGN,
-                  RT_DMA_DIR_EXT2LOC, 0, &_data_copy);
-
-    // loop over all input images
-    for (unsigned int _k = 0; _k < NET_F1; _k++) {
-
-        // wait until the first data is present
-        rt_dma_wait(&_data_copy);
-
-        //swap pointer to the next with pointer to the current
-        uint8_t* _p_tmp = _p_data_loc;
-        _p_data_loc = _p_data_loc_next;
-        _p_data_loc_next = _p_tmp;
-
-        if (_k < NET_F1 - 1) {
-
-            // go to the next image (next one of F1)
-            _p_data_iter += NET_T_ALIGN * NET_C_ALIGN;
-
-            // copy the corresponding input data to local memory
-            rt_dma_memcpy((unsigned int)_p_data_iter,
-                        (unsigned int)_p_data_loc_next,
-                        sizeof(int8_t) * NET_T * NET_C_ALIGN,
-                        RT_DMA_DIR_EXT2LOC, 0, &_data_copy);
-        }
-
-        // reset the local data iterator
-        _p_data_loc_iter = _p_data_loc;
-        
-        // loop over all output filters for the corresponding input image
-        for (unsigned int _i = 0; _i < 2; _i++) {
-
-            // get new convert factors
-            _convert_factor = *_p_factor_loc_iter++;
-            _convert_offset = *_p_offset_loc_iter++;
-
-            // compute the threshold
-            _relu_threshold = -(_convert_offset >> 3);
-
-            // prepare the arguments for the cluster
-            _net_layer2_kernel_t args;
-            args.p_data = _p_data_loc;
-            args.p_weight = _p_weight_loc_iter;
-            args.factor = _convert_factor;
-            args.offset = _convert_offset;
-            args.p_result = _p_result_loc;
-
-            // call the cluster
-            rt_team_fork(NUM_WORKERS, _net_layer2_kernel, (void*)(&args));
-
-            // copy the values back to L2 memory
-            rt_dma_memcpy((unsigned int)_p_result_iter,
-                          (unsigned int)_p_result_loc,
-                          sizeof(int8_t) * NET_T8,
-                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
-            rt_dma_wait(&_copy);
-
-            // go to the next output channel
-            _p_result_iter += NET_T8_ALIGN;
-            // use the next filter
-            _p_weight_loc_iter += NET_L2_WEIGHT_LEN;
-
-        }
+    // one input image [NET_T, NET_C_ALIGN] per tile, and one output vector per tile
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * NET_T * NET_C_ALIGN,
+        .num = {NET_F1, 1},
+        .stride = {sizeof(int8_t) * NET_T_ALIGN * NET_C_ALIGN, 0},
+    };
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t) * NET_T8_ALIGN, 0},
+    };
+    net_stream_t _input;
+    net_stream_t _output;
+
+    if (net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN) != NET_STREAM_OK ||
+        net_stream_open(&_output, &_output_desc, NET_STREAM_DEPTH, NET_STREAM_OUT) != NET_STREAM_OK) {
+        printf("Not Enough space on L1 memory");
+        return;
     }
 
-    // free up the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
-
-#else //DMA_STREAM
-
-    /*
-     * Parallel implementation without data streaming
-     */
-
-    const int8_t* _p_data_iter = p_data;          // iterator over the current image of the input
-    const int8_t* _p_result_iter = p_result;      // iterator over the current vector of the output
-
-    rt_dma_copy_t _copy;
-
-    // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l2_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN,
-                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
     rt_dma_wait(&_copy);
 
-    int8_t* _p_weight_loc_iter = _p_weight_loc;  // iterator over the current weights (filter)
-    int32_t* _p_factor_loc_iter = _p_factor_loc; // iterator over the current factor
-    int32_t* _p_offset_loc_iter = _p_offset_loc; // iterator over the current offset
-    int8_t* _p_data_loc_iter;                    // iterator over the current local data row
-
-    int32_t _convert_factor;
-    int32_t _convert_offset;
-    int32_t _relu_threshold;
-
-    int32_t _elem; // stores the current element, for doing dot product and ReLU
-    int32_t _sum;  // stores the sum for the pooling
-
-    // loop over all input images
-    for (unsigned int _k = 0; _k < NET_F1; _k++) {
-
-        // copy the corresponding input data to local memory
-        rt_dma_memcpy((unsigned int)_p_data_iter,
-                      (unsigned int)_p_data_loc,
-                      sizeof(int8_t) * NET_T * NET_C_ALIGN,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
+    // prepare the arguments for the cluster
+    _net_layer2_kernel_t args;
+    args.p_input = &_input;
+    args.p_output = &_output;
+    args.p_weight = _p_weight_loc;
+    args.p_factor = _p_factor_loc;
+    args.p_offset = _p_offset_loc;
 
-        // reset the local data iterator
-        _p_data_loc_iter = _p_data_loc;
-        
-        // loop over all output filters for the corresponding input image
-        for (unsigned int _i = 0; _i < 2; _i++) {
-
-            // get new convert factors
-            _convert_factor = *_p_factor_loc_iter++;
-            _convert_offset = *_p_offset_loc_iter++;
+    // call the cluster
+    rt_team_fork(NUM_WORKERS, _net_layer2_kernel, (void*)(&args));
 
-            // compute the threshold
-            _relu_threshold = -(_convert_offset >> 3);
-
-            // prepare the arguments for the cluster
-            _net_layer2_kernel_t args;
-            args.p_data = _p_data_loc;
-            args.p_weight = _p_weight_loc_iter;
-            args.factor = _convert_factor;
-            args.offset = _convert_offset;
-            args.p_result = _p_result_loc;
-
-            // call the cluster
-            rt_team_fork(NUM_WORKERS, _net_layer2_kernel, (void*)(&args));
-
-            // copy the values back to L2 memory
-            rt_dma_memcpy((unsigned int)_p_result_iter,
-                          (unsigned int)_p_result_loc,
-                          sizeof(int8_t) * NET_T8,
-                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
-            rt_dma_wait(&_copy);
-
-            // go to the next output channel
-            _p_result_iter += NET_T8_ALIGN;
-            // use the next filter
-            _p_weight_loc_iter += NET_L2_WEIGHT_LEN;
-
-        }
-
-        // go to the next image (next one of F1)
-        _p_data_iter += NET_T_ALIGN * NET_C_ALIGN;
-    }
-
-    // free up the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
-
-#endif //DMA_STREAM
+    // store the last output vector and free up the memory
+    net_stream_close(&_output);
+    net_stream_close(&_input);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
 
 #else //PARALLEL
     
@@ -395,38 +261,44 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
      * We compute one output channel (one of F2) at a time.
      */
 
-    const int8_t* _p_data_iter = p_data;          // iterator over the current image of the input
-    const int8_t* _p_result_iter = p_result;      // iterator over the current vector of the output
-
     rt_dma_copy_t _copy;
 
     // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l2_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN,
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L2_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L2_PARAMS_WEIGHT);
+
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
+
+    // one input image [NET_T, NET_C_ALIGN] per tile, and one output vector per tile
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * NET_T * NET_C_ALIGN,
+        .num = {NET_F1, 1},
+        .stride = {sizeof(int8_t) * NET_T_ALIGN * NET_C_ALIGN, 0},
+    };
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t) * NET_T8_ALIGN, 0},
+    };
+    net_stream_t _input;
+    net_stream_t _output;
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+    net_stream_open(&_output, &_output_desc, NET_STREAM_DEPTH, NET_STREAM_OUT);
+
     rt_dma_wait(&_copy);
 
     int8_t* _p_weight_loc_iter = _p_weight_loc;  // iterator over the current weights (filter)
     int32_t* _p_factor_loc_iter = _p_factor_loc; // iterator over the current factor
     int32_t* _p_offset_loc_iter = _p_offset_loc; // iterator over the current offset
+    int8_t* _p_data_loc;                         // current input image
     int8_t* _p_data_loc_iter;                    // iterator over the current local data row
     int8_t* _p_result_loc_iter;                 // iterator over the current temporary result
 
@@ -440,21 +312,14 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
     // loop over all input images
     for (unsigned int _k = 0; _k < NET_F1; _k++) {
 
-        // copy the corresponding input data to local memory
-        rt_dma_memcpy((unsigned int)_p_data_iter,
-                      (unsigned int)_p_data_loc,
-                      sizeof(int8_t) * NET_T * NET_C_ALIGN,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
+        // get the corresponding input image (the next one is loaded meanwhile with DMA_STREAM)
+        _p_data_loc = net_stream_next(&_input);
 
-        // reset the local data iterator
-        _p_data_loc_iter = _p_data_loc;
-        
         // loop over all output filters for the corresponding input image
-        for (unsigned int _i = 0; _i < 2; _i++) {
+        for (unsigned int _i = 0; _i < NET_D; _i++) {
 
-            // reset the temporary local result iterator
-            _p_result_loc_iter = _p_result_loc;
+            // get the buffer for the output vector (the previous one is stored meanwhile)
+            _p_result_loc_iter = net_stream_next(&_output);
 
             // reset the local input iterator to point to the first line
             _p_data_loc_iter = _p_data_loc;
@@ -515,30 +380,16 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
 
             }
 
-            // copy the values back to L2 memory
-            rt_dma_memcpy((unsigned int)_p_result_iter,
-                          (unsigned int)_p_result_loc,
-                          sizeof(int8_t) * NET_T8,
-                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
-            rt_dma_wait(&_copy);
-
-            // go to the next output channel
-            _p_result_iter += NET_T8_ALIGN;
             // use the next filter
             _p_weight_loc_iter += NET_L2_WEIGHT_LEN;
 
         }
-
-        // go to the next image (next one of F1)
-        _p_data_iter += NET_T_ALIGN * NET_C_ALIGN;
     }
 
-    // free up the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T * NET_C_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
+    // store the last output vector and free up the memory
+    net_stream_close(&_output);
+    net_stream_close(&_input);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
 
 #endif //PARALLEL
 
@@ -549,38 +400,44 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
      * We compute one output channel (one of F2) at a time.
      */
 
-    const int8_t* _p_data_iter = p_data;          // iterator over the current image of the input
-    const int8_t* _p_result_iter = p_result;      // iterator over the current vector of the output
-
     rt_dma_copy_t _copy;
 
     // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_C * NET_T_ALIGN);
-    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l2_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN,
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L2_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L2_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L2_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L2_PARAMS_WEIGHT);
+
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l2_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L2_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l2_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l2_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
+
+    // one input image [NET_C, NET_T_ALIGN] per tile, and one output vector per tile
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * NET_C * NET_T_ALIGN,
+        .num = {NET_F1, 1},
+        .stride = {sizeof(int8_t) * NET_C * NET_T_ALIGN, 0},
+    };
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t) * NET_T8_ALIGN, 0},
+    };
+    net_stream_t _input;
+    net_stream_t _output;
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+    net_stream_open(&_output, &_output_desc, NET_STREAM_DEPTH, NET_STREAM_OUT);
+
     rt_dma_wait(&_copy);
 
     int8_t* _p_weight_loc_iter = _p_weight_loc;  // iterator over the current weights (filter)
     int32_t* _p_factor_loc_iter = _p_factor_loc; // iterator over the current factor
     int32_t* _p_offset_loc_iter = _p_offset_loc; // iterator over the current offset
+    int8_t* _p_data_loc;                         // current input image
     int8_t* _p_data_loc_iter;                    // iterator over the current local data row
     int8_t* _p_result_loc_iter;                 // iterator over the current temporary result
 
@@ -594,21 +451,14 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
     // loop over all input images
     for (unsigned int _k = 0; _k < NET_F1; _k++) {
 
-        // copy the corresponding input data to local memory
-        rt_dma_memcpy((unsigned int)_p_data_iter,
-                      (unsigned int)_p_data_loc,
-                      sizeof(int8_t) * NET_C * NET_T_ALIGN,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
+        // get the corresponding input image (the next one is loaded meanwhile with DMA_STREAM)
+        _p_data_loc = net_stream_next(&_input);
 
-        // reset the local data iterator
-        _p_data_loc_iter = _p_data_loc;
-        
         // loop over all output filters for the corresponding input image
-        for (unsigned int _i = 0; _i < 2; _i++) {
+        for (unsigned int _i = 0; _i < NET_D; _i++) {
 
-            // reset the temporary local result iterator
-            _p_result_loc_iter = _p_result_loc;
+            // get the buffer for the output vector (the previous one is stored meanwhile)
+            _p_result_loc_iter = net_stream_next(&_output);
             // reset the local input iterator to point to the first line
             _p_data_loc_iter = _p_data_loc;
 
@@ -667,30 +517,16 @@ void net_layer2(const int8_t* p_data, int8_t * p_result) {
 
             }
 
-            // copy the values back to L2 memory
-            rt_dma_memcpy((unsigned int)_p_result_iter,
-                          (unsigned int)_p_result_loc,
-                          sizeof(int8_t) * NET_T8,
-                          RT_DMA_DIR_LOC2EXT, 0, &_copy);
-            rt_dma_wait(&_copy);
-
-            // go to the next output channel
-            _p_result_iter += NET_T8_ALIGN;
             // use the next filter
             _p_weight_loc_iter += NET_L2_WEIGHT_LEN;
 
         }
-
-        // go to the next image (next one of F1)
-        _p_data_iter += NET_C * NET_T_ALIGN;
     }
 
-    // free up the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_C * NET_T_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L2_WEIGHT_LEN);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
+    // store the last output vector and free up the memory
+    net_stream_close(&_output);
+    net_stream_close(&_input);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L2_PARAMS_LEN);
 
 
 #endif //FLIP LAYERS
@@ -29,8 +29,14 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
+#include "stream.h"
 #include "../func/functional.h"
 
+#if defined(LAYER3_TIME_BLOCKS) && !defined(PARALLEL)
+#error "LAYER3_TIME_BLOCKS requires PARALLEL"
+#endif
+
 #ifdef PARALLEL
 
 #ifndef NUM_WORKERS
@@ -41,6 +47,9 @@ typedef struct {
     int8_t* p_data;
     int8_t* p_result;
     int8_t* p_weight;
+#ifdef LAYER3_TIME_BLOCKS
+    net_stream_t* p_input;  // stream of the input, 4 padded channels per tile
+#endif //LAYER3_TIME_BLOCKS
 } _net_layer3_kernel_t;
 
 /**
@@ -67,7 +76,7 @@ void _net_layer3_kernel(void* args) {
     while (_k < NET_F2) {
 
         // do the computation
-        func_conv_scale(_p_data_iter, NET_L3_PAD_INPUT_LEN, _p_weight_iter, NET_L3_WEIGHT_LEN, NET_L3_FACTOR, 0, _p_result_iter);
+        func_conv_scale(_p_data_iter, NET_L3_PAD_INPUT_LEN, _p_weight_iter, NET_L3_WEIGHT_LEN, net_params.l3_factor, 0, _p_result_iter);
 
         // go to the next _k (for this core)
         _k += NUM_WORKERS;
@@ -82,6 +91,130 @@ void _net_layer3_kernel(void* args) {
 
 }
 
+#ifdef LAYER3_TIME_BLOCKS
+
+#if (NET_F2 % 4 != 0)
+#error "LAYER3_TIME_BLOCKS requires NET_F2 to be divisible by 4"
+#endif
+
+#define _SHUFFLEMASK1 (v4s){1,2,3,4}
+#define _SHUFFLEMASK2 (v4s){2,3,4,5}
+#define _SHUFFLEMASK3 (v4s){3,4,5,6}
+
+// masks to transpose a 4x4 block of bytes
+#define _TRANSPOSEMASK_LO (v4s){0,4,1,5}
+#define _TRANSPOSEMASK_HI (v4s){2,6,3,7}
+#define _TRANSPOSEMASK_0 (v4s){0,1,4,5}
+#define _TRANSPOSEMASK_1 (v4s){2,3,6,7}
+
+// number of blocks of 4 time steps
+#define _NUM_T_BLOCKS ((NET_T8 + 3) / 4)
+
+/**
+ * @brief Computes 4 consecutive outputs of a single channel (cross correlation with the reversed filter)
+ *
+ * @param p_data Pointer to the padded input of the channel, at the first output (4 byte aligned)
+ * @param p_weight Pointer to the reversed filter of the channel (4 byte aligned)
+ * @param factor Division factor
+ * @returns The 4 outputs, scaled and packed
+ */
+static inline v4s _net_layer3_time_kernel_channel(const int8_t* p_data,
+                                                  const int8_t* p_weight,
+                                                  int32_t factor) {
+
+    const v4s* _p_x = (const v4s*)p_data;
+    const v4s* _p_w = (const v4s*)p_weight;
+
+    v4s _x0, _x1, _w;
+    int32_t _acc0 = 0, _acc1 = 0, _acc2 = 0, _acc3 = 0;
+
+    _x0 = *(_p_x++);
+    for (int _i = 0; _i < NET_L3_WEIGHT_LEN / 4; _i++) {
+        _x1 = *(_p_x++);
+        _w = *(_p_w++);
+        // the shifted words contain the samples for the next 3 outputs
+        _acc0 = __SUMDOTP4(_x0, _w, _acc0);
+        _acc1 = __SUMDOTP4(__builtin_shuffle(_x0, _x1, _SHUFFLEMASK1), _w, _acc1);
+        _acc2 = __SUMDOTP4(__builtin_shuffle(_x0, _x1, _SHUFFLEMASK2), _w, _acc2);
+        _acc3 = __SUMDOTP4(__builtin_shuffle(_x0, _x1, _SHUFFLEMASK3), _w, _acc3);
+        _x0 = _x1;
+    }
+
+    return func_transform_32to8_bias_elem(_acc0, _acc1, _acc2, _acc3, factor, 0);
+}
+
+/**
+ * @brief Kernel doing the layer3 work, parallelized over blocks of time steps
+ *
+ * The input is streamed in tiles of 4 channels. For every tile, each core computes a contiguous
+ * range of blocks of 4 time steps. The outputs of 4 channels and 4 time steps are transposed in
+ * registers, and stored with one word per time step, such that the result has the flipped shape
+ * [NET_T8_ALIGN, NET_F2].
+ */
+void _net_layer3_time_kernel(void* args) {
+
+    unsigned int _core_id = rt_core_id();
+
+    // get values from args
+    _net_layer3_kernel_t* _args = args;
+
+    const int8_t* _p_data;
+    const int8_t* _p_weight = _args->p_weight;
+    int8_t* _p_result = _args->p_result;
+    int32_t _factor = net_params.l3_factor;
+
+    // range of blocks computed by this core
+    int _blocks_per_core = (_NUM_T_BLOCKS + NUM_WORKERS - 1) / NUM_WORKERS;
+    int _block_start = _core_id * _blocks_per_core;
+    int _block_end = _block_start + _blocks_per_core;
+    if (_block_end > _NUM_T_BLOCKS) {
+        _block_end = _NUM_T_BLOCKS;
+    }
+
+    const int8_t* _p_data_iter;
+    v4s* _p_result_iter;
+    v4s _c0, _c1, _c2, _c3;
+    v4s _lo01, _hi01, _lo23, _hi23;
+
+    for (int _k = 0; _k < NET_F2; _k += 4) {
+
+        // get the next 4 channels
+        _p_data = net_stream_team_next(_args->p_input);
+
+        for (int _block = _block_start; _block < _block_end; _block++) {
+
+            _p_data_iter = _p_data + _block * 4;
+            _p_result_iter = (v4s*)(_p_result + _block * 4 * NET_F2 + _k);
+
+            // 4 time steps of 4 channels
+            _c0 = _net_layer3_time_kernel_channel(_p_data_iter + 0 * NET_L3_PAD_INPUT_LEN_ALIGN, _p_weight + 0 * NET_L3_WEIGHT_LEN, _factor);
+            _c1 = _net_layer3_time_kernel_channel(_p_data_iter + 1 * NET_L3_PAD_INPUT_LEN_ALIGN, _p_weight + 1 * NET_L3_WEIGHT_LEN, _factor);
+            _c2 = _net_layer3_time_kernel_channel(_p_data_iter + 2 * NET_L3_PAD_INPUT_LEN_ALIGN, _p_weight + 2 * NET_L3_WEIGHT_LEN, _factor);
+            _c3 = _net_layer3_time_kernel_channel(_p_data_iter + 3 * NET_L3_PAD_INPUT_LEN_ALIGN, _p_weight + 3 * NET_L3_WEIGHT_LEN, _factor);
+
+            // transpose, such that every word contains the 4 channels of one time step
+            _lo01 = __builtin_shuffle(_c0, _c1, _TRANSPOSEMASK_LO);
+            _hi01 = __builtin_shuffle(_c0, _c1, _TRANSPOSEMASK_HI);
+            _lo23 = __builtin_shuffle(_c2, _c3, _TRANSPOSEMASK_LO);
+            _hi23 = __builtin_shuffle(_c2, _c3, _TRANSPOSEMASK_HI);
+
+            *(_p_result_iter + 0 * NET_F2 / 4) = __builtin_shuffle(_lo01, _lo23, _TRANSPOSEMASK_0);
+            *(_p_result_iter + 1 * NET_F2 / 4) = __builtin_shuffle(_lo01, _lo23, _TRANSPOSEMASK_1);
+            *(_p_result_iter + 2 * NET_F2 / 4) = __builtin_shuffle(_hi01, _hi23, _TRANSPOSEMASK_0);
+            *(_p_result_iter + 3 * NET_F2 / 4) = __builtin_shuffle(_hi01, _hi23, _TRANSPOSEMASK_1);
+        }
+
+        // go to the filters of the next 4 channels
+        _p_weight += 4 * NET_L3_WEIGHT_LEN;
+    }
+
+    // wait for all cores to finish
+    rt_team_barrier();
+
+}
+
+#endif //LAYER3_TIME_BLOCKS
+
 #endif //PARALLEL
 
 /**
@@ -92,6 +225,10 @@ void _net_layer3_kernel(void* args) {
  *
  * @warning p_result must already be allocated on L2!
  *
+ * @info With DMA_FLIP, the DMA stores every channel as a column of the output, which is of shape
+ *       [NET_T8, NET_F2] aligned to [NET_T8_ALIGN, NET_F2], and must not be flipped. With
+ *       LAYER3_TIME_BLOCKS, the kernel computes the output directly in this shape.
+ *
  * @param p_data Pointer to the input data, of shape [NET_F2, NET_T8], aligned to [NET_F2, NET_T8_ALIGN]
  * @param p_result Pointer to the output data of shape [NET_F2, NET_T8] aligned to [NET_F2, NET_T8_ALIGN]
  */
@@ -99,18 +236,89 @@ void net_layer3(const int8_t* p_data, int8_t * p_result) {
 
 #ifdef PARALLEL
 
-    const int8_t* _p_data_iter = p_data;          // iterator over the current input vector
-    const int8_t* _p_result_iter = p_result;      // iterator over the current output vector
-
     rt_dma_copy_t _copy;
 
+#ifdef LAYER3_TIME_BLOCKS
+
+    /*
+     * The input is streamed in tiles of 4 channels (with DMA_STREAM, the next tile is loaded while
+     * the current one is computed).
+     */
+
+    // allocate local memory
+    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
+
+    // copy all the weights at once, because we get less overhead
+    rt_dma_memcpy((unsigned int)net_params.l3_weight,
+                  (unsigned int)_p_weight_loc,
+                  sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN,
+                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
+
+    // 4 channels per tile, every channel is stored with its zero padding on L1 (the last block may
+    // read one word after the last channel)
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * 4 * NET_T8,
+        .num = {NET_F2 / 4, 1},
+        .stride = {sizeof(int8_t) * 4 * NET_T8_ALIGN, 0},
+        .row_len = sizeof(int8_t) * NET_T8,
+        .row_stride = sizeof(int8_t) * NET_T8_ALIGN,
+        .loc_row_stride = sizeof(int8_t) * NET_L3_PAD_INPUT_LEN_ALIGN,
+        .loc_offset = NET_L3_PAD_START,
+        .buffer_len = sizeof(int8_t) * (4 * NET_L3_PAD_INPUT_LEN_ALIGN + 4),
+    };
+    net_stream_t _input;
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+
+    rt_dma_wait(&_copy);
+
+    // revert the filters, such that the kernel can compute the cross correlation
+    int8_t* _p_a;
+    int8_t* _p_b;
+    int8_t _tmp;
+    for (int _k = 0; _k < NET_F2; _k++) {
+        _p_a = _p_weight_loc + _k * NET_L3_WEIGHT_LEN;
+        _p_b = _p_a + NET_L3_WEIGHT_LEN - 1;
+        while (_p_a < _p_b) {
+            _tmp = *_p_a;
+            *(_p_a++) = *_p_b;
+            *(_p_b--) = _tmp;
+        }
+    }
+
+    // prepare the arguments
+    _net_layer3_kernel_t _args;
+    _args.p_data = NULL;
+    _args.p_result = _p_result_loc;
+    _args.p_weight = _p_weight_loc;
+    _args.p_input = &_input;
+
+    rt_team_fork(NUM_WORKERS, _net_layer3_time_kernel, &_args);
+
+    net_stream_close(&_input);
+
+    // copy back the results, which are already flipped
+    rt_dma_memcpy((unsigned int)p_result,
+                  (unsigned int)_p_result_loc,
+                  sizeof(int8_t) * NET_T8 * NET_F2,
+                  RT_DMA_DIR_LOC2EXT, 0, &_copy);
+    rt_dma_wait(&_copy);
+
+    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
+
+#else //LAYER3_TIME_BLOCKS
+
+    const int8_t* _p_data_iter = p_data;          // iterator over the current input vector
+
     // allocate local memory
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L3_PAD_INPUT_LEN_ALIGN);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
     int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
 
     // copy all the weights at once, because we get less overhead
-    rt_dma_memcpy((unsigned int)net_l3_weight,
+    rt_dma_memcpy((unsigned int)net_params.l3_weight,
                   (unsigned int)_p_weight_loc,
                   sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
@@ -148,82 +356,110 @@ void net_layer3(const int8_t* p_data, int8_t * p_result) {
     rt_team_fork(NUM_WORKERS, _net_layer3_kernel, &_args);
 
     // copy back the results
+#ifdef DMA_FLIP
+    // store every channel as a column of the output [NET_T8_ALIGN, NET_F2]
+    for (int _k = 0; _k < NET_F2; _k++) {
+        rt_dma_memcpy_2d((unsigned int)(p_result + _k),
+                         (unsigned int)(_p_result_loc + _k * NET_T8_ALIGN),
+                         sizeof(int8_t) * NET_T8,
+                         sizeof(int8_t) * NET_F2, sizeof(int8_t),
+                         RT_DMA_DIR_LOC2EXT, _k > 0, &_copy);
+    }
+#else//DMA_FLIP
     rt_dma_memcpy((unsigned int)p_result,
                   (unsigned int)_p_result_loc,
                   sizeof(int8_t) * NET_F2 * NET_T8,
                   RT_DMA_DIR_LOC2EXT, 0, &_copy);
+#endif//DMA_FLIP
     rt_dma_wait(&_copy);
 
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_F2 * NET_L3_PAD_INPUT_LEN_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
 
+#endif //LAYER3_TIME_BLOCKS
+
 #else //PARALLEL
 
     /*
-     * Depthwise Convoluton, compute every channel separately
+     * Depthwise Convoluton, compute every channel separately. The input and the result are streamed
+     * channel by channel (with DMA_STREAM, the transfers overlap with the computation).
      */
 
-    const int8_t* _p_data_iter = p_data;          // iterator over the current input vector
-    const int8_t* _p_result_iter = p_result;      // iterator over the current output vector
-
     rt_dma_copy_t _copy;
 
     // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_L3_PAD_INPUT_LEN_ALIGN);
     int32_t* _p_tmp_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_T8);
-    int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN);
     int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
 
-    // initialize input to have zero padding
-    *((int32_t*)(_p_data_loc + 0)) = 0;
-    *((int32_t*)(_p_data_loc + 4)) = 0;
-    *((int32_t*)(_p_data_loc + NET_L3_PAD_INPUT_LEN_ALIGN - 4)) = 0;
-    *((int32_t*)(_p_data_loc + NET_L3_PAD_INPUT_LEN_ALIGN - 8)) = 0;
-    *((int32_t*)(_p_data_loc + NET_L3_PAD_INPUT_LEN_ALIGN - 12)) = 0;
-
     // copy all the weights at once, because we get less overhead
-    rt_dma_memcpy((unsigned int)net_l3_weight,
+    rt_dma_memcpy((unsigned int)net_params.l3_weight,
                   (unsigned int)_p_weight_loc,
                   sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
+
+    // one channel per tile, padded with zeros on L1
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t) * NET_T8_ALIGN, 0},
+        .loc_offset = NET_L3_PAD_START,
+        .buffer_len = sizeof(int8_t) * NET_L3_PAD_INPUT_LEN_ALIGN,
+    };
+#ifdef DMA_FLIP
+    // one channel per tile, stored as a column of the output [NET_T8_ALIGN, NET_F2]
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t), 0},
+        .row_len = sizeof(int8_t),
+        .row_stride = sizeof(int8_t) * NET_F2,
+        .buffer_len = sizeof(int8_t) * NET_T8_ALIGN,
+    };
+#else//DMA_FLIP
+    // one channel per tile
+    net_stream_desc_t _output_desc = {
+        .p_ext = p_result,
+        .size = sizeof(int8_t) * NET_T8,
+        .num = {NET_F2, 1},
+        .stride = {sizeof(int8_t) * NET_T8_ALIGN, 0},
+    };
+#endif//DMA_FLIP
+
+    net_stream_t _input;
+    net_stream_t _output;
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
+    net_stream_open(&_output, &_output_desc, NET_STREAM_DEPTH, NET_STREAM_OUT);
+
     rt_dma_wait(&_copy);
 
     int8_t* _p_weight_loc_iter = _p_weight_loc;  // iterator over the current weights (filter)
+    int8_t* _p_data_loc;
+    int8_t* _p_result_loc;
 
     // loop over all channels
     for (unsigned int _k = 0; _k < NET_F2; _k++) {
 
-        // copy the corresponding input data to local memory, keeping the padding
-        rt_dma_memcpy((unsigned int)_p_data_iter,
-                      (unsigned int)_p_data_loc + NET_L3_PAD_START,
-                      sizeof(int8_t) * NET_T8,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
+        // get the input data (with padding) and the buffer for the result
+        _p_data_loc = net_stream_next(&_input);
+        _p_result_loc = net_stream_next(&_output);
 
         // do the convolution
         func_conv(_p_data_loc, NET_L3_PAD_INPUT_LEN, _p_weight_loc_iter, NET_L3_WEIGHT_LEN, _p_tmp_result_loc);
 
         // scale the values
-        func_transform_32to8(_p_tmp_result_loc, NET_T8, NET_L3_FACTOR, 1, _p_result_loc);
-
-        // copy the results back
-        rt_dma_memcpy((unsigned int)_p_result_iter,
-                      (unsigned int)_p_result_loc,
-                      sizeof(int8_t) * NET_T8,
-                      RT_DMA_DIR_LOC2EXT, 0, &_copy);
-        rt_dma_wait(&_copy);
+        func_transform_32to8(_p_tmp_result_loc, NET_T8, net_params.l3_factor, 1, _p_result_loc);
 
-        // move the iterators to the next elements
-        _p_data_iter += NET_T8_ALIGN;
-        _p_result_iter += NET_T8_ALIGN;
         _p_weight_loc_iter += NET_L3_WEIGHT_LEN;
 
     }
 
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_L3_PAD_INPUT_LEN_ALIGN);
+    // store the last result and free up the memory
+    net_stream_close(&_output);
+    net_stream_close(&_input);
     rt_free(RT_ALLOC_CL_DATA, _p_tmp_result_loc, sizeof(int32_t) * NET_T8);
-    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_L3_WEIGHT_LEN);
 
 
@@ -266,4 +502,7 @@ void net_layer3_flip_inplace(int8_t* p_data) {
                   RT_DMA_DIR_LOC2EXT, 0, &_copy);
     rt_dma_wait(&_copy);
 
+    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
+
 }
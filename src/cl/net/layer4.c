@@ -29,6 +29,8 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
+#include "stream.h"
 #include "../func/functional.h"
 
 #ifdef PARALLEL
@@ -38,7 +40,7 @@
 #endif
 
 typedef struct {
-    int8_t* p_data;
+    net_stream_t* p_input; // stream of the input, one pooling window [8, NET_F2] per tile
     int8_t* p_result;
     int8_t* p_weight;
     int32_t* p_factor;
@@ -47,6 +49,9 @@ typedef struct {
 
 /**
  * @brief kernel for the parallel layer 4 implementation
+ *
+ * The input is streamed with one pooling window per tile, and every core computes its output
+ * channels of this window.
  */
 void _net_layer4_kernel(void* args) {
 
@@ -55,48 +60,35 @@ void _net_layer4_kernel(void* args) {
     // get values from args
     _net_layer4_kernel_t* _args = args;
 
-    int8_t* _p_data = _args->p_data;
-    int8_t* _p_result = _args->p_result;
-    int8_t* _p_weight = _args->p_weight;
-    int32_t* _p_factor_iter = _args->p_factor;
-    int32_t* _p_offset_iter = _args->p_offset;
-
-    // go to the correct position for the thread
-    _p_weight += _core_id * NET_L4_WEIGHT_LEN;
-    _p_result += _core_id * NET_T64_ALIGN;
-    _p_factor_iter += _core_id;
-    _p_offset_iter += _core_id;
-
-    int8_t* _p_data_iter = _p_data;
-    int8_t* _p_weight_iter = _p_weight;
-    int8_t* _p_result_iter = _p_result;
-    int8_t* _p_result_inner_iter;
-
+    int8_t* _p_data_iter;
+    int8_t* _p_weight_iter;
     int32_t _factor;
     int32_t _offset;
     int32_t _relu_threshold;
     int32_t _elem; // stores the current element, for doing dot product and ReLU
     int32_t _sum;  // stores the sum for the pooling
 
-    unsigned int _k = _core_id;
+    // iterate over all output time samples
+    for (int _t_out = 0; _t_out < NET_T64; _t_out++) {
 
-    while (_k < NET_F2) {
+        // get the next pooling window
+        int8_t* _p_data = net_stream_team_next(_args->p_input);
 
-        _factor = *_p_factor_iter;
-        _offset = *_p_offset_iter;
+        // iterate over the output channels of this core
+        for (unsigned int _k = _core_id; _k < NET_F2; _k += NUM_WORKERS) {
+
+            _factor = _args->p_factor[_k];
+            _offset = _args->p_offset[_k];
 
 #ifdef REORDER_BN
-        _relu_threshold = -(_offset >> 3);
+            _relu_threshold = -(_offset >> 3);
 #else//REORDER_BN
-        _factor = _factor >> 3;
-        _offset = _offset >> 3;
+            _factor = _factor >> 3;
+            _offset = _offset >> 3;
 #endif//REORDER_BN
 
-        _p_data_iter = _p_data;
-        _p_result_inner_iter = _p_result_iter;
-
-        // iterate over all output time samples
-        for (int _t_out = 0; _t_out < NET_T64; _t_out++) {
+            _p_data_iter = _p_data;
+            _p_weight_iter = _args->p_weight + _k * NET_L4_WEIGHT_LEN;
 
             // reset the sum
             _sum = 0;
@@ -135,17 +127,9 @@ void _net_layer4_kernel(void* args) {
             // clip
             _sum = __CLIP_R(_sum, 127);
             // store the result
-            *(_p_result_inner_iter++) = _sum;
-
+            _args->p_result[_k * NET_T64_ALIGN + _t_out] = _sum;
         }
 
-        // go to the next _k (for this core)
-        _k += NUM_WORKERS;
-        _p_weight_iter += NUM_WORKERS * NET_L4_WEIGHT_LEN;
-        _p_result_iter += NUM_WORKERS * NET_T64_ALIGN;
-        _p_factor_iter += NUM_WORKERS;
-        _p_offset_iter += NUM_WORKERS;
-
     }
 
     // wait for all threads to finish
@@ -175,44 +159,38 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
 
 #ifdef PARALLEL
 
-    // we can keep everything in l1, because the data is so small. (data: 1k, result: 0.25k)
+    // the input is streamed (with DMA_STREAM, the next window is loaded while the current one is
+    // computed), and the result is small enough (0.25k) to keep it on L1.
     // allocate local memory
-    int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_F2);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L4_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L4_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L4_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L4_PARAMS_WEIGHT);
 
     rt_dma_copy_t _copy;
 
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l4_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_F2,
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l4_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L4_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
 
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l4_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
+    // one pooling window [8, NET_F2] per tile
+    net_stream_desc_t _input_desc = {
+        .p_ext = p_data,
+        .size = sizeof(int8_t) * 8 * NET_F2,
+        .num = {NET_T64, 1},
+        .stride = {sizeof(int8_t) * 8 * NET_F2, 0},
+    };
+    net_stream_t _input;
+    net_stream_open(&_input, &_input_desc, NET_STREAM_DEPTH, NET_STREAM_IN);
 
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l4_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
-
-    // copy all the data at once
-    rt_dma_memcpy((unsigned int)p_data,
-                  (unsigned int)_p_data_loc,
-                  sizeof(int8_t) * NET_F2 * NET_T8_ALIGN,
-                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
     rt_dma_wait(&_copy);
 
     // prepare the kernel
     _net_layer4_kernel_t _args;
-    _args.p_data = _p_data_loc;
+    _args.p_input = &_input;
     _args.p_result = _p_result_loc;
     _args.p_weight = _p_weight_loc;
     _args.p_factor = _p_factor_loc;
@@ -221,6 +199,8 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     // call the kernel
     rt_team_fork(NUM_WORKERS, _net_layer4_kernel, &_args);
 
+    net_stream_close(&_input);
+
     // copy back the results
     rt_dma_memcpy((unsigned int)p_result,
                   (unsigned int)_p_result_loc,
@@ -229,11 +209,8 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     rt_dma_wait(&_copy);
 
     // free the memory
-    rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L4_PARAMS_LEN);
 
 #else //PARALLEL
 
@@ -241,30 +218,17 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     // allocate local memory
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_F2);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L4_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L4_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L4_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L4_PARAMS_WEIGHT);
 
     rt_dma_copy_t _copy;
 
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l4_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    rt_dma_wait(&_copy);
-
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l4_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    rt_dma_wait(&_copy);
-
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l4_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l4_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L4_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
     rt_dma_wait(&_copy);
 
@@ -371,9 +335,7 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     // free the memory
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L4_PARAMS_LEN);
 
 #endif //PARALLEL
 
@@ -383,30 +345,17 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     // allocate local memory
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_F2);
-    int32_t* _p_factor_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
-    int32_t* _p_offset_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_F2);
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L4_PARAMS_LEN);
+    int32_t* _p_factor_loc = _p_params_loc + NET_L4_PARAMS_FACTOR;
+    int32_t* _p_offset_loc = _p_params_loc + NET_L4_PARAMS_OFFSET;
+    int8_t* _p_weight_loc = (int8_t*)(_p_params_loc + NET_L4_PARAMS_WEIGHT);
 
     rt_dma_copy_t _copy;
 
-    // copy all the weights at once, because copying 6 words would generate too much overhead
-    rt_dma_memcpy((unsigned int)net_l4_weight,
-                  (unsigned int)_p_weight_loc,
-                  sizeof(int8_t) * NET_F2 * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    rt_dma_wait(&_copy);
-
-    // copy all factors
-    rt_dma_memcpy((unsigned int)net_l4_factor,
-                  (unsigned int)_p_factor_loc,
-                  sizeof(int32_t) * NET_F2,
-                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
-    rt_dma_wait(&_copy);
-
-    // copy all offsets
-    rt_dma_memcpy((unsigned int)net_l4_offset,
-                  (unsigned int)_p_offset_loc,
-                  sizeof(int32_t) * NET_F2,
+    // copy all parameters (factors, offsets and weights) with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l4_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L4_PARAMS_LEN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
     rt_dma_wait(&_copy);
 
@@ -513,9 +462,7 @@ void net_layer4(const int8_t* p_data, int8_t * p_result) {
     // free the memory
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_T8_ALIGN * NET_F2);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_factor_loc, sizeof(int32_t) * NET_F2);
-    rt_free(RT_ALLOC_CL_DATA, _p_offset_loc, sizeof(int32_t) * NET_F2);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L4_PARAMS_LEN);
 
 #endif
 
@@ -29,6 +29,7 @@
 #include "rt/rt_api.h"
 #include "layers.h"
 #include "net.h"
+#include "blob.h"
 #include "../func/functional.h"
 
 /**
@@ -42,13 +43,12 @@
  */
 void net_layer5(const int8_t* p_data, int8_t * p_result) {
 
-    // keep the entire input vector in local memory, but only one weight vector (of the 4)
+    // keep the entire input vector and all parameters (bias and weights) in local memory
 
     int8_t* _p_data_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
     int8_t* _p_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_N);
     int32_t* _p_tmp_result_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_N);
-    int8_t* _p_weight_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    int8_t* _p_bias_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NET_N);
+    int32_t* _p_params_loc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L5_PARAMS_LEN);
 
     rt_dma_copy_t _copy;
 
@@ -57,45 +57,41 @@ void net_layer5(const int8_t* p_data, int8_t * p_result) {
                   (unsigned int)_p_data_loc,
                   sizeof(int8_t) * NET_F2 * NET_T64_ALIGN,
                   RT_DMA_DIR_EXT2LOC, 0, &_copy);
+    // copy all parameters with a single transfer
+    rt_dma_memcpy((unsigned int)net_params.l5_params,
+                  (unsigned int)_p_params_loc,
+                  sizeof(int32_t) * NET_L5_PARAMS_LEN,
+                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
     rt_dma_wait(&_copy);
 
-    // copy the bias vector (simply one word)
-    *((int32_t*)_p_bias_loc) = *((int32_t*)net_l5_bias);
-
-    // prepare the weight iterator
-    const int8_t* _p_weight_iter = net_l5_weight;
-    int8_t* _p_bias_loc_iter = _p_bias_loc;
+    // prepare the iterators
+    int8_t* _p_weight_loc_iter = (int8_t*)(_p_params_loc + NET_L5_PARAMS_WEIGHT);
+    int8_t* _p_bias_loc_iter = (int8_t*)(_p_params_loc + NET_L5_PARAMS_BIAS);
     int32_t* _p_tmp_result_loc_iter = _p_tmp_result_loc;
 
     // loop over all output elements
     for (unsigned int _n = 0; _n < NET_N; _n++) {
 
-        // load weights
-        rt_dma_memcpy((unsigned int)_p_weight_iter,
-                      (unsigned int)_p_weight_loc,
-                      sizeof(int8_t) * NET_F2 * NET_T64_ALIGN,
-                      RT_DMA_DIR_EXT2LOC, 0, &_copy);
-        rt_dma_wait(&_copy);
-
         // we multiply the aligned vectors here. It will be faster, and the weight vector has zeros at the aligned positions
-        *(_p_tmp_result_loc_iter++) = func_dotp(_p_data_loc, _p_weight_loc, NET_F2 * NET_T64_ALIGN) + (*_p_bias_loc_iter++);
+        *(_p_tmp_result_loc_iter++) = func_dotp(_p_data_loc, _p_weight_loc_iter, NET_F2 * NET_T64_ALIGN) + (*_p_bias_loc_iter++);
 
         // go to the next iteration
-        _p_weight_iter += NET_F2 * NET_T64_ALIGN;
+        _p_weight_loc_iter += NET_F2 * NET_T64_ALIGN;
     }
 
 
     // transform the vector
-    func_transform_32to8(_p_tmp_result_loc, NET_N, NET_L5_FACTOR, 1, _p_result_loc);
+    func_transform_32to8(_p_tmp_result_loc, NET_N, net_params.l5_factor, 1, _p_result_loc);
 
-    // copy the data back (one word, do not use DMA)
-    *((int32_t*)p_result) = *((int32_t*)_p_result_loc);
+    // copy the data back (only NET_N elements, do not use DMA)
+    for (unsigned int _n = 0; _n < NET_N; _n++) {
+        p_result[_n] = _p_result_loc[_n];
+    }
 
     // free the memory
     rt_free(RT_ALLOC_CL_DATA, _p_data_loc, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
     rt_free(RT_ALLOC_CL_DATA, _p_result_loc, sizeof(int8_t) * NET_N);
     rt_free(RT_ALLOC_CL_DATA, _p_tmp_result_loc, sizeof(int32_t) * NET_N);
-    rt_free(RT_ALLOC_CL_DATA, _p_weight_loc, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
-    rt_free(RT_ALLOC_CL_DATA, _p_bias_loc, sizeof(int8_t) * NET_N);
+    rt_free(RT_ALLOC_CL_DATA, _p_params_loc, sizeof(int32_t) * NET_L5_PARAMS_LEN);
 
 }
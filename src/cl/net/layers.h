@@ -29,6 +29,28 @@
 #ifndef __CL_NET_LAYERS_H__
 #define __CL_NET_LAYERS_H__
 
+#include "net.h"
+
+/*
+ * Kernels of the fused layer 1+2 without intermediate scale, selected with the bits computed by
+ * python_utils/value_range.py for the trained parameters. net_blob_load rejects a model blob which
+ * needs more bits.
+ */
+
+#if defined(NO_INTERMEDIATE_SCALE) && !(defined(NET_L1_RESULT_BITS) && defined(NET_L2_POOL_BITS))
+#error "NET_L1_RESULT_BITS or NET_L2_POOL_BITS is missing, regenerate net.h with data/gen_net_header.py"
+#endif
+
+// store the results of layer 1 as 16bit values, and compute layer 2 with 2-way SIMD, if they fit
+#if defined(DUPLICATE_FEATUREMAP) && defined(NO_INTERMEDIATE_SCALE) && (NET_L1_RESULT_BITS <= 16)
+#define L1_RESULT_INT16
+#endif
+
+// cap the outputs of the ReLU of layer 2, if the unsigned pool sums do not fit into 32 bits
+#if defined(NO_INTERMEDIATE_SCALE) && (NET_L2_POOL_BITS > 32)
+#define L2_RELU_CAP
+#endif
+
 /**
  * @brief Execute the 1st layer
  * 
@@ -40,6 +62,9 @@
  *
  * @info The output be allocated to NET_F1 * NET_C_ALIGN * NET_T_ALIGN, because it will be flipped inplace afterwards.
  *
+ * @info With DMA_FLIP, the DMA stores every channel as a column of the output, which is of shape
+ *       [NET_F1, NET_T, NET_C] aligned to [NET_F1, NET_T_ALIGN, NET_C_ALIGN], and must not be flipped.
+ *
  * @param p_data Pointer to the input data, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN]
  * @param p_result Pointer to the output data of shape [NET_F1, NET_C, NET_T] aligned to [NET_F1, NET_C_ALIGN, NET_T_ALIGN].
  */
@@ -78,11 +103,38 @@ void net_layer2(const int8_t* p_data, int8_t * p_result);
  * 
  * @warning p_result must already be allocated on L2!
  *
- * @param p_data Pointer to the input data, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN]
+ * @param p_data Pointer to the input data, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN].
+ *               If DUPLICATE_FEATUREMAP is enabled, of shape [NET_C, NET_L1_PAD_INPUT_LEN] (padded),
+ *               and if INTERLEAVED_INPUT is enabled, of shape [NET_T, NET_C] (not padded).
  * @param p_result Pointer to the output data of shape [NET_F2, NET_T8] aligned to [NET_F2, NET_T8_ALIGN].
  */
 void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result);
 
+/**
+ * @brief Execute the 1st and the 2nd layer on a window of any length (requires RING_BUFFER)
+ *
+ * The input is streamed through L1, such that the window can be much larger than L1.
+ *
+ * @warning p_result must already be allocated on L2!
+ *
+ * @param p_data Pointer to the input data, of shape [NET_C, t_len + NET_L1_PAD_START + NET_L1_PAD_END]
+ *               (padded), or of shape [t_len, NET_C] (not padded) if INTERLEAVED_INPUT is enabled.
+ * @param p_result Pointer to the output data of shape [NET_F2, t_len / 8].
+ * @param t_len Number of time samples in the window
+ */
+void net_fused_layer_1_2_window(const int8_t* p_data, int8_t* p_result, unsigned int t_len);
+
+/**
+ * @brief Execute the entire network in a single pass over the window (requires PIPELINE)
+ *
+ * The fused layer 1+2 streams the window through L1, and layer 3, 4 and 5 consume every chunk of
+ * its output on L1, while the next chunk is computed (see pipeline.h).
+ *
+ * @param p_data Pointer to the input data (see net_fused_layer_1_2)
+ * @param p_output Pointer to the output data on L2, of shape [NET_N]
+ */
+void net_fused_pipeline(const int8_t* p_data, int8_t* p_output);
+
 /**
  * @brief Execute the 3rd layer
  * 
@@ -91,6 +143,10 @@ void net_fused_layer_1_2(const int8_t* p_data, int8_t* p_result);
  *
  * @warning p_result must already be allocated on L2!
  *
+ * @info With DMA_FLIP, the DMA stores every channel as a column of the output, which is of shape
+ *       [NET_T8, NET_F2] aligned to [NET_T8_ALIGN, NET_F2], and must not be flipped. With
+ *       LAYER3_TIME_BLOCKS, the kernel computes the output directly in this shape.
+ *
  * @param p_data Pointer to the input data, of shape [NET_F2, NET_T8], aligned to [NET_F2, NET_T8_ALIGN]
  * @param p_result Pointer to the output data of shape [NET_F2, NET_T8] aligned to [NET_F2, NET_T8_ALIGN]
  */
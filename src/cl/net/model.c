@@ -31,6 +31,30 @@
 #include "layers.h"
 #include "net.h"
 
+#ifdef TELEMETRY
+#include "../telemetry.h"
+#endif//TELEMETRY
+
+#if defined(INTERLEAVED_INPUT) && !defined(FUSE_LAYERS)
+#error "Fused layers are required for the interleaved input"
+#endif
+
+#if defined(DMA_FLIP) && !defined(FLIP_LAYERS)
+#error "The DMA can only flip the layers (DMA_FLIP) if the flipped layers are used (FLIP_LAYERS)"
+#endif
+
+#if defined(LAYER3_TIME_BLOCKS) && !defined(FLIP_LAYERS)
+#error "Layer 3 can only compute the flipped output (LAYER3_TIME_BLOCKS) if the flipped layers are used (FLIP_LAYERS)"
+#endif
+
+#if defined(PIPELINE) && !defined(FUSE_LAYERS)
+#error "The pipeline of layer 3, 4 and 5 (PIPELINE) requires the fused layers"
+#endif
+
+#if defined(NTT_CONV) && defined(FUSE_LAYERS)
+#error "The NTT convolution (NTT_CONV) is only implemented for layer 1, not for the fused layers"
+#endif
+
 /**
  * @brief computes the output of the entire model
  *
@@ -38,10 +62,27 @@
  *
  * @param p_data Pointer to input data on L2 memory, of shape [NET_C, NET_T], aligned to [NET_C, NET_T_ALIGN]
  *               If DUPLICATE_FEATUREMAP is enabled, the data must be padded, of shape [NET_C, NET_L1_PAD_INPUT_LEN]
+ *               If INTERLEAVED_INPUT is enabled, the data is not padded, of shape [NET_T, NET_C]
  * @param p_output Pointer to output data, allocated on L2 memory, of shape [NET_N]
  */
 void net_model_compute(const int8_t* p_data, int8_t* p_output) {
 
+#ifdef TELEMETRY
+    telemetry_begin();
+#endif//TELEMETRY
+
+#ifdef PIPELINE
+
+    // all layers at once, layer 3, 4 and 5 consume the output of layer 2 while it is computed
+    net_fused_pipeline(p_data, p_output);
+
+#ifdef TELEMETRY
+    telemetry_layer(0);
+    telemetry_end();
+#endif//TELEMETRY
+
+#else//PIPELINE
+
     /*
      * Layer 1
      */
@@ -52,6 +93,10 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
 
     net_fused_layer_1_2(p_data, _p_l2_output);
 
+#ifdef TELEMETRY
+    telemetry_layer(0);
+#endif//TELEMETRY
+
 #else //FUSE_LAYERS
     // allocate data for result
     int8_t * _p_l1_output = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * NET_F1 * NET_C_ALIGN * NET_T_ALIGN);
@@ -59,10 +104,14 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
     // compute layer 1
     net_layer1(p_data, _p_l1_output);
 
-#ifdef FLIP_LAYERS
-    // flip the dimension
+#if defined(FLIP_LAYERS) && !defined(DMA_FLIP)
+    // flip the dimension (with DMA_FLIP, layer 1 already stores the flipped output)
     net_layer1_flip_inplace(_p_l1_output);
-#endif //FLIP_LAYERS
+#endif //FLIP_LAYERS, DMA_FLIP
+
+#ifdef TELEMETRY
+    telemetry_layer(0);
+#endif//TELEMETRY
 
     /*
      * Layer 2
@@ -77,6 +126,10 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
     // free l1 memory
     rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_l1_output, sizeof(int8_t) * NET_F1 * NET_C_ALIGN * NET_T_ALIGN);
 
+#ifdef TELEMETRY
+    telemetry_layer(1);
+#endif//TELEMETRY
+
 #endif //FUSE_LAYERS
 
     /*
@@ -89,10 +142,14 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
     // compute layer 3
     net_layer3(_p_l2_output, _p_l3_output);
 
-#ifdef FLIP_LAYERS
-    // flip the dimension
+#if defined(FLIP_LAYERS) && !defined(DMA_FLIP) && !defined(LAYER3_TIME_BLOCKS)
+    // flip the dimension (with DMA_FLIP or LAYER3_TIME_BLOCKS, layer 3 already stores the flipped output)
     net_layer3_flip_inplace(_p_l3_output);
-#endif //FLIP_LAYERS
+#endif //FLIP_LAYERS, DMA_FLIP, LAYER3_TIME_BLOCKS
+
+#ifdef TELEMETRY
+    telemetry_layer(2);
+#endif//TELEMETRY
 
     // free l2 memory
     rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_l2_output, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
@@ -110,6 +167,10 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
     // free l3 memory
     rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_l3_output, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
 
+#ifdef TELEMETRY
+    telemetry_layer(3);
+#endif//TELEMETRY
+
     /*
      * Layer 5
      */
@@ -119,4 +180,11 @@ void net_model_compute(const int8_t* p_data, int8_t* p_output) {
 
     // free l4 memory
     rt_free(RT_ALLOC_L2_CL_DATA, (void*)_p_l4_output, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
+
+#ifdef TELEMETRY
+    telemetry_layer(4);
+    telemetry_end();
+#endif//TELEMETRY
+
+#endif//PIPELINE
 }
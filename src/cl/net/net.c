@@ -0,0 +1,445 @@
+#include "net.h"
+
+/*
+ * Network Dimensions
+ */
+/*
+ * Input Stage
+ * ===========
+ * Quantization of the raw ADC samples
+ * 
+ * Input:  [C, T] (ADC codes)
+ * Output: [C, T] (padded like the input of layer 1)
+ */
+
+/*
+ * Layer 1
+ * =======
+ * Convolution + BN
+ * 
+ * Input:  [C, T]
+ * Weight: [F1, 64] (reversed, aligned to [F1, NET_L1_WEIGHT_LEN_ALIGN])
+ * Output: [F1, C, T]
+ */
+
+RT_L2_DATA const int32_t net_l1_params[] = {
+    368, 463, 835, 380, 603, 549, 398, 692, 4937, -4411, -3835, 3520, 9207, 3931, -8, -8268,
+    -520077561, 52412679, 8470279, -113307904, 123136, 16744959, 16581617, -1056448127, 18812672,
+    983545, -511607040, -458749, 33422841, 8470272, -2128641537, -247465728, 521092864, 2132795651,
+    -251135551, 50395521, -520091651, 2064129, -42008449, 51379459, 268009231, -50134787,
+    -109052447, -109084191, -16744704, -2114371777, 1057079801, 2031809, -1044315841, 253689985,
+    522133377, -115400929, -16256543, 253723007, -50085625, 15794176, -518029568, 520585023,
+    50560769, 1058012928, -2129661471, 2095361, -50331648, 117522176, -517998083, -50233088,
+    12664576, -1044283641, 16320449, 2147287937, 50331889, -12646403, -519577313, 1069614065,
+    -109117177, -101121729, -2113929472, -1040642175, 16584673, -518012419, 520585665, -101056639,
+    252645247, -235331809, 131057, -2122188544, 2132770567, 66977031, 15796221, -2118057981,
+    -409329, 1061126593, 12681472, -1041170429, 260170015, 251720161, 134029311, 4128799,
+    -235855879, 12681215, 536863169, 33419761, 66658051, 253698047, -34005055, -2122379295,
+    259981312, 117444479, 536739809, -41815777, 255787071, 50790407, 17237767, 251674399, -163584,
+    520158471, -116916351, 2031887, 252117473, 117698945, 130311, 1056964879, -2118057216, 8324895,
+    2132738175, 63969, 2089279, -1056948479, -46201857, 25165695, -1040584385, 16322304, 16715535,
+    66912271, 251658465, -12586749, 15826695, 65142209, 8324065, 54476547, -50216463, -235028209,
+    521078655, 198401};
+
+#ifdef NTT_CONV
+RT_L2_DATA const uint32_t net_l1_ntt_twiddle[] = {
+    301989884, 5152499, 34051923, 497641863, 232329203, 805806040, 859989969, 237774497, 568407860,
+    403515082, 893559224, 593306309, 623097534, 942150178, 708531813, 297518433, 54518517,
+    569899965, 941037252, 361097972, 88281993, 709915619, 993032099, 948710611, 120027324, 22510134,
+    339604140, 916832999, 973928502, 106620515, 42476083, 560132525, 888603487, 203852186,
+    946126456, 680621466, 76554946, 950070141, 493732309, 689955314, 743862480, 722074899,
+    465031752, 619753297, 231410720, 207063297, 493709398, 903497785, 431422394, 461716010,
+    27238351, 800497870, 572742501, 756223400, 185341594, 856740545, 284325195, 921029803,
+    527327664, 992276152, 377662087, 628602650, 700438310, 100416806, 691295370, 866899242,
+    549037670, 464687805, 226113911, 705116950, 667509969, 228645778, 247146486, 545164023,
+    906708918, 479077080, 912112646, 126466098, 648841455, 446840080, 138723248, 34521003,
+    870009876, 819100233, 425999157, 857083925, 40932602, 436846382, 529822938, 111928755,
+    741117592, 856361390, 549020191, 458939691, 642572124, 668133559, 690661211, 652011471,
+    693597605, 389209905, 525055482, 248819602, 523871630, 787669134, 65668869, 598639276,
+    914330593, 638948514, 762791960, 741673980, 731905317, 921620063, 49870511, 99918314, 501433720,
+    116928280, 842568658, 360060670, 282458672, 693850175, 83114827, 882237060, 953245971,
+    855310397, 810197528, 195169681, 690908315, 336865748, 301989884, 661378605, 307336038,
+    803074672, 188046825, 142933956, 44998382, 116007293, 915129526, 304394178, 715785681,
+    638183683, 155675695, 881316073, 496810633, 898326039, 948373842, 76624290, 266339036,
+    256570373, 235452393, 359295839, 83913760, 399605077, 932575484, 210575219, 474372723,
+    749424751, 473188871, 609034448, 304646748, 346232882, 307583142, 330110794, 355672229,
+    539304662, 449224162, 141882963, 257126761, 886315598, 468421415, 561397971, 957311751,
+    141160428, 572245196, 179144120, 128234477, 963723350, 859521105, 551404273, 349402898,
+    871778255, 86131707, 519167273, 91535435, 453080330, 751097867, 769598575, 330734384, 293127403,
+    772130442, 533556548, 449206683, 131345111, 306948983, 897827547, 297806043, 369641703,
+    620582266, 5968201, 470916689, 77214550, 713919158, 141503808, 812902759, 242020953, 425501852,
+    197746483, 971006002, 536528343, 566821959, 94746568, 504534955, 791181056, 766833633,
+    378491056, 533212601, 276169454, 254381873, 308289039, 504512044, 48174212, 921689407,
+    317622887, 52117897, 794392167, 109640866, 438111828, 955768270, 891623838, 24315851, 81411354,
+    658640213, 975734219, 878217029, 49533742, 5212254, 288328734, 909962360, 637146381, 57207101,
+    428344388, 943725836, 700725920, 289712540, 56094175, 375146819, 404938044, 104685129,
+    594729271, 429836493, 760469856, 138254384, 192438313, 765915150, 500602490, 964192430,
+    993091854};
+RT_L2_DATA const uint32_t net_l1_ntt_spectrum[] = {
+    981467147, 629145601, 307895742, 925229643, 988005583, 338581537, 457419659, 204093312,
+    534081534, 601812045, 908247850, 728196655, 344536008, 437342381, 538752920, 931806816,
+    644362631, 402744878, 657831665, 443441517, 56240107, 285193515, 838853453, 126068650,
+    898548848, 566492035, 834536737, 431184260, 872664757, 690689816, 761701339, 649805756,
+    157735701, 446263511, 471547307, 381067915, 882130929, 769614370, 509154700, 550169702,
+    828710546, 58108271, 903256180, 605333215, 891854053, 47006553, 658400594, 242123428, 85164291,
+    654776774, 818354468, 340700225, 157389387, 840803845, 847105801, 270377036, 409136546,
+    857366976, 804878523, 442645798, 977640115, 823070568, 516043749, 535917875, 905177115,
+    50577014, 855722101, 117310924, 613474595, 883634729, 866151265, 301453443, 205640015,
+    286892793, 70331951, 950490662, 447540518, 819111148, 405268008, 213460201, 792873222,
+    398797469, 4166943, 374092776, 187619433, 363751881, 495053901, 592495294, 711553504, 471120895,
+    564836648, 690251056, 501225945, 264756241, 802426839, 993496254, 742568093, 769281716,
+    126117469, 548748982, 276408105, 857989774, 657464471, 594137028, 528060770, 398883281,
+    832507634, 871999587, 961401208, 425252269, 488520981, 40079299, 230005616, 887295752,
+    599164264, 268909507, 764130825, 317398065, 827518039, 384841599, 836152211, 390906121,
+    132504094, 238935189, 841183396, 399836395, 347422748, 21466666, 46115896, 626898923, 585754680,
+    468329929, 568003767, 445407200, 621915856, 136304816, 400457367, 841989678, 708906996,
+    780525244, 262413563, 399989193, 815580673, 296192004, 389775575, 585584879, 176346430,
+    719472549, 29712563, 520440423, 597887660, 13315470, 364948925, 442145655, 689176052, 94379761,
+    583807965, 665361116, 84383911, 61525922, 475120357, 671431314, 246600457, 527610752, 458001869,
+    8907270, 879069650, 43502668, 66430158, 824906377, 970083566, 327905295, 538362498, 48531948,
+    515899610, 245180850, 909804225, 296185011, 422974106, 369039222, 990037289, 188506873,
+    531773468, 151755256, 438820345, 249889138, 274327209, 718614112, 488808214, 976993059,
+    59733471, 877012247, 188202003, 267080343, 415332176, 344086889, 762613415, 611608423,
+    458854176, 370854191, 327406695, 547655000, 664576424, 133266508, 955988433, 7656292, 459596087,
+    461960392, 346045431, 441573467, 489871012, 466513372, 694125081, 454444751, 256944549,
+    940827150, 397153475, 51743905, 874484093, 354760142, 880749416, 988365126, 887582605,
+    579047219, 532300675, 419971040, 94545787, 19129168, 22043183, 187952210, 174883902, 493236672,
+    714677870, 793888542, 740967279, 850689490, 829670563, 841065610, 556106880, 966111377,
+    760365278, 302427561, 461962930, 614395831, 569867661, 3803530, 789650940, 703124704, 417920822,
+    380373861, 503897226, 973716814, 578631438, 152582683, 962223621, 314692548, 864026613,
+    922746882, 285482947, 150724677, 951128412, 815091562, 572231067, 891163046, 348855257,
+    696660266, 462612935, 133130475, 51283754, 485221770, 160932257, 924471801, 47175210, 237384019,
+    132988461, 39845670, 61892486, 358076638, 553367823, 512643753, 775084541, 362962116, 343233495,
+    472140613, 711366697, 312379616, 546445992, 405038474, 769291384, 825227201, 622880233,
+    388248675, 496544787, 791869709, 562323653, 415431668, 446387818, 687040472, 410892189,
+    178954826, 236204074, 614530590, 211458692, 339108320, 441436432, 819720256, 905454184,
+    823288069, 838121032, 151239875, 806842950, 623997574, 272944943, 109816324, 499802914,
+    281907913, 859950467, 897704053, 884399837, 143008857, 955016890, 154831356, 334201967,
+    961733083, 595181333, 41796280, 210457094, 179311298, 334592982, 278975105, 680570743,
+    346987559, 326825386, 851962675, 401794767, 827727507, 12392820, 707691740, 533712223,
+    782696050, 861305066, 3161472, 942327542, 231456483, 496682129, 104714794, 483463043, 949461219,
+    620644531, 419023523, 495274781, 356488706, 435991459, 251383963, 528527832, 966978371,
+    59551927, 747292169, 194743875, 174482544, 382404805, 491066304, 870593795, 717832178,
+    695901628, 273103098, 404542237, 401609087, 826629693, 979813763, 760377797, 434505151,
+    877208746, 900399139, 239157810, 605440478, 359627474, 220089321, 29449039, 544930156, 57897627,
+    362916972, 187879440, 480784918, 327799805, 77110408, 320118296, 894644387, 714232214, 82631673,
+    531485528, 610783548, 215816219, 57967468, 254825854, 131533780, 813740849, 287129153, 85159902,
+    309017859, 946278089, 97808252, 862299851, 473137579, 990292622, 60011592, 837515071, 983783070,
+    47260734, 612551642, 358714125, 858112572, 31881838, 80301197, 879663990, 849379715, 648697008,
+    617922829, 886608361, 704327782, 656965190, 778085685, 264713842, 46790288, 255410425,
+    371711909, 725055462, 620191055, 406946952, 747621338, 425699804, 216454319, 537360256,
+    500679890, 334925121, 418327894, 801990564, 677950914, 408392593, 932174409, 766331959,
+    829331932, 715417824, 138413680, 860923785, 202631316, 32426064, 730349964, 353842368,
+    965937777, 768478430, 797417762, 316422146, 594566968, 57913878, 457736765, 954783564,
+    837329922, 496193213, 774439695, 345474996, 228791417, 254487616, 960473206, 385898146,
+    855913229, 902050312, 220108133, 101792011, 256699450, 769250890, 797783633, 608741818,
+    375628049, 326876633, 117822086, 189529997, 640551436, 815365711, 576070154, 367043085,
+    918254524, 30439875, 96764195, 517967534, 658109244, 454963823, 410991948, 564003776, 498944022,
+    486288243, 190242709, 416877484, 904146019, 78351402, 892918592, 343687453, 149718443,
+    492859112, 564142302, 783833638, 192887413, 499927040, 108944325, 461739957, 530519090,
+    182878729, 1725802, 903358244, 213029689, 990306098, 933584075, 796917755, 226492415, 516502560,
+    750177261, 994111046, 472863494, 610460610, 296540895, 944567485, 534657814, 762573164,
+    530401532, 219864071, 676951944, 186140853, 406256005, 879647466, 911768999, 501130032,
+    711204944, 394255472, 14677502, 560208373, 447727026, 956463118, 947357794, 47071392, 680473990,
+    649910236, 497240326, 154969399, 453932353, 938144754, 951557144, 245264950, 431826730,
+    925969148, 330630258, 788608193, 919238001, 632103933, 262827121, 656969396, 873983770,
+    961318763, 435216125, 11339209, 779250794, 545362834, 651800802, 845324698, 534753715, 39809905,
+    90902601, 327956884, 536130884, 627985686, 870238142, 73844822, 376286906, 701319589, 352753647,
+    520798968, 493998954, 932279103, 861558467, 839798739, 946540417, 786913456, 158134777,
+    371395531, 300067736, 308015375, 686134993, 948653938, 788466349, 623961858, 321935175,
+    153786403, 789778502, 681462850, 965251397, 984711632, 379167717, 577503241, 449170316,
+    547432920, 188002808, 428847198, 335795650, 209911682, 707006981, 816260636, 275342197,
+    995810113, 372663522, 45557259, 800532142, 237053295, 61271649, 752062977, 631639546, 271176370,
+    791789541, 432367266, 150314886, 225457310, 463904037, 538397669, 790248782, 445762141,
+    816521962, 679901193, 427709684, 550185933, 655292769, 944751191, 807285460, 494125323,
+    412334330, 973460059, 679685139, 209308094, 800342201, 302407649, 75164213, 380382416,
+    888880487, 990778055, 990517673, 987730590, 481933607, 444525666, 916476187, 774149577,
+    519101726, 215131673, 437052140, 659156881, 880617306, 520110525, 905650915, 592619462,
+    261663389, 730635632, 330075259, 68554513, 842278654, 369198042, 979902266, 862203528,
+    870348025, 686414839, 78603265, 511433620, 14560350, 452742334, 290683746, 76454368, 990457866,
+    933121218, 958979379, 347573929, 885922321, 842112933, 37015814, 844826540, 138339236,
+    285146968, 90128169, 393897835, 142690785, 225315946, 960669220, 618967370, 170335336,
+    217374750, 633235532, 907533875, 32737678, 783731333, 402919039, 381860537, 521980285,
+    747496782, 935509832, 647719807, 594154402, 475502026, 265608691, 720715335, 592150070,
+    163320014, 423395094, 756984909, 615495585, 78418205, 60426230, 283916251, 596359709, 115002796,
+    796748047, 81839024, 456620148, 844268077, 410258959, 509540918, 840496717, 850613706,
+    457554228, 594020390, 531004568, 781027323, 616359947, 283276755, 623871741, 740077865,
+    654297672, 131244820, 194292580, 764407612, 200378676, 656667368, 624842686, 843753434,
+    726787791, 341763206, 471946459, 964453779, 375102287, 14975518, 50004514, 685118178, 981480641,
+    437681698, 736166975, 979266165, 655499265, 145286251, 530755946, 306793247, 501899536,
+    239649708, 692899351, 15880259, 111039860, 407341281, 708542476, 866665177, 444491021, 61694109,
+    616849606, 521657452, 930992436, 471041792, 897793555, 377487367, 310378495, 200135256,
+    613559727, 368803526, 746021813, 360120101, 974528084, 582023659, 182199835, 751724746,
+    382974878, 794213647, 862856817, 18734819, 32373073, 867789000, 535221242, 742633451, 836542251,
+    961484314, 290024165, 792903659, 908770768, 124786295, 795150211, 798430598, 883053042,
+    26276427, 554256124, 663823255, 419402526, 701574940, 454780134, 137510573, 752747204,
+    476461298, 709007619, 821596960, 133869212, 228028134, 257774975, 651778900, 726060295,
+    158559397, 922650378, 535671936, 673819102, 80964760, 111706594, 693879882, 789056377,
+    263418813, 469924490, 865227650, 77373787, 401558964, 779022455, 157197228, 206773782,
+    637327896, 291481694, 718211527, 952674980, 614250535, 659867387, 77488509, 24742549, 522897550,
+    163375788, 713484527, 74993204, 643308738, 513413061, 147504632, 580162130, 599649082,
+    962252875, 467173785, 230008538, 579494237, 257400176, 849840059, 166089611, 996071653,
+    434603632, 899149452, 734135367, 65079380, 116360875, 677574694, 189381730, 685585451,
+    752303069, 530553457, 535774458, 389356714, 137933467, 456118730, 551455985, 344441055,
+    852234951, 788910935, 440114956, 388221257, 856800229, 595395956, 104920497, 864967988,
+    796373152, 743898018, 822214926, 505424245, 338705567, 98769501, 571477122, 201103572,
+    668641664, 165581975, 649940870, 949626769, 677624440, 805334992, 489854737, 981345666,
+    48614336, 918262141, 928738503, 654794470, 520935362, 142390018, 7236248, 743066038, 878024313,
+    305689271, 260640070, 229774258, 773660595, 633086095, 273869241, 940660996, 453989807,
+    244046995, 307798019, 878421367, 670814467, 229707421, 833288643, 247837319, 522421662,
+    955442113, 868866844, 678449681, 543970899, 838008436, 767708384, 152334249, 177166023,
+    658333035, 669021411, 213681024, 225512246, 924398069, 631273394, 405594040, 275474823,
+    52392818, 677645193, 217333746, 80799103, 734343102, 474780864, 179002349, 506338090, 519262504,
+    725546228, 952565322, 477103418, 882343853, 947924779, 220335471, 391962467, 624470347,
+    464694035, 250327390, 471744638, 817387544, 747163088, 746369787, 916569807, 112140220,
+    668441598, 72315285, 928217526, 303101344, 125715236, 472831732, 428057879, 654247322,
+    327740345, 538967285, 212933597, 971891443, 725471187, 352639725, 306579750, 695470934,
+    891324592, 699438579, 784007267, 315345932, 417152098, 679142585, 527668388, 827472512,
+    915047652, 76031512, 163637028, 659066857, 193848082, 546332526, 751369327, 606352281,
+    417656550, 68967880, 917531598, 419489452, 909228528, 476097680, 521061808, 25563616, 820303596,
+    259155461, 630191527, 68577643, 528980884, 386724993, 944459739, 824592785, 198072319,
+    218980989, 9243974, 598089325, 479874786, 795718610, 410132477, 78191099, 653453013, 39200403,
+    947134013, 952324799, 972403614, 48055466, 731439776, 557666047, 520148496, 754974734, 33554432,
+    407184656, 29022952, 415465049, 952395067, 171512829, 541001871, 382479676, 732627325,
+    922092426, 997262018, 681291782, 672340627, 584970449, 454365026, 867297564, 106750423,
+    566868312, 106762093, 427069876, 642660526, 68245466, 463124003, 296090025, 380092805,
+    499375288, 628611881, 772868815, 214598050, 316650647, 563535841, 29469586, 344141963,
+    877981012, 787051159, 847138574, 800974659, 141226126, 526597716, 612941799, 495616838,
+    927890306, 609093153, 901336478, 38105051, 359079101, 538696674, 78789299, 167812855, 431355891,
+    806330548, 750003239, 720996907, 493459565, 141015799, 340256675, 490518804, 621715422,
+    746002124, 805350873, 939858545, 713351960, 338980126, 60827124, 212342673, 710094353,
+    651330309, 476345073, 965343510, 653011794, 388195735, 839011889, 174107872, 350187230,
+    190665344, 547692996, 155182018, 725803683, 281731096, 280916910, 420877523, 263903856,
+    659377950, 754690071, 365327059, 889974127, 807541928, 933630638, 459431227, 54884432,
+    730008773, 725236859, 224490282, 663994304, 931656718, 881005457, 877160126, 857949705,
+    431691049, 410381652, 307514490, 551409823, 230405708, 190773452, 243345740, 24179798,
+    563046342, 778509606, 184927176, 301704940, 571468717, 574161813, 525818479, 396061205,
+    23953500, 55208955, 974167913, 954409136, 494158990, 150100119, 376113377, 199059406, 969188921,
+    830453894, 605133202, 656357875, 340401086, 492957389, 151379678, 896504274, 1281767, 750900363,
+    116291075, 30084687, 286833838, 271257679, 849631031, 13333020, 85670739, 159394051, 148919327,
+    687610794, 933011610, 292436160, 683550366, 211205513, 928173541, 713663756, 99239973,
+    598736906, 849258921, 997454276, 19903527, 611124231, 284823315, 368081946, 72169503, 322166972,
+    824803157, 825851172, 635494265, 471224005, 735622745, 282894109, 477523567, 744275350,
+    551707294, 452355100, 777658200, 677212380, 935952462, 404357339, 935344346, 995948735,
+    289379040, 667836693, 267786709, 230649619, 63165179, 750841723, 224843176, 185697294,
+    461859756, 412235225, 664245882, 794740531, 355028230, 861980041, 287412571, 676326654,
+    230489878, 725629277, 322129327, 764854561, 166608377, 968573016, 519794054, 814397350,
+    312567572, 874776395, 232106770, 623115966, 397585733, 56961814, 59205012, 219012512, 720258029,
+    633357353, 712233666, 541351216, 3714671, 656484393, 151453896, 890797644, 919141067, 945917230,
+    2915688, 831361932, 238983141, 211759353, 889242937, 821931657, 943258658, 102349855, 99723073,
+    680837293, 945135694, 664074760, 981370141, 815214488, 138923709, 624520943, 668458756,
+    59803368, 661733370, 843115601, 507560828, 675360982, 486383859, 789168204, 242532647,
+    536578535, 555452873, 393110883, 345948093, 170910526, 355972590, 989461743, 24661025,
+    788528309, 258166911, 568415795, 210453497, 733997621, 985119475, 864026617, 864026625,
+    371498560, 551248330, 53793462, 826157288, 417071789, 61931971, 851871903, 12537458, 242123097,
+    224684070, 672175578, 843804794, 770725841, 81453370, 492644678, 349870650, 830991454,
+    573220316, 682181339, 418594329, 728527277, 38347232, 175948617, 503016162, 574656528,
+    974448329, 395885769, 240129667, 795834489, 169714945, 376669374, 310272795, 632881101,
+    912395052, 837818307, 500553306, 10339615, 935764956, 70372824, 391956325, 129442099, 334000471,
+    54056387, 326049137, 443279460, 423466941, 467549639, 189958426, 152071340, 485039023,
+    223336286, 796210585, 385010080, 504675691, 479656950, 751557850, 595028388, 472207934,
+    339945436, 618773812, 883788181, 486552698, 744013993, 720011665, 391305325, 811826701,
+    744877572, 246826036, 37336225, 690291330, 560342511, 227359069, 146092867, 549934372,
+    195357470, 893108255, 810169096, 125163706, 720601436, 898213611, 593921791, 768947368,
+    928246893, 820441243, 369522015, 326101642, 604186642, 446926455, 920466140, 315244857,
+    641011133, 921059965, 293394946, 667715608, 628466693, 412928629, 634563349, 104707335,
+    757857422, 618556113, 250463336, 334393359, 213149598, 815072829, 621307464, 465027763,
+    409832323, 331801637, 778205452, 632270856, 551497700, 230495713, 338631858, 119038854,
+    153461552, 123049784, 772170966, 778454663, 933616761, 584291875, 833872747, 747254929,
+    144930262, 228720845, 815916721, 672773089, 755884492, 46619862, 807039401, 840961754, 50696218,
+    400207908, 244142244, 548233830, 298323381, 211943778, 581811335, 257844356, 28246794,
+    360802074, 303501687, 667625551, 823350582, 661365642, 104757571, 30084228, 204912050,
+    409992861, 411328494, 24719717, 320154355, 901271840, 138852154, 856910707, 182221412,
+    545588138, 51273170, 65495321, 100373163, 967975494, 827393143, 578787169, 274061351, 796212017,
+    422879576, 507902913, 847850583, 309726828, 400789313, 709689251, 699909306, 147477055,
+    238091933, 252158021, 617525214, 200881479, 917132273, 874076790, 840468824, 675890785,
+    713345538, 519427788, 365555436, 389558030, 336364008, 490026533, 468549040, 522490423,
+    409243321, 617603145, 666098971, 721932559, 435685558, 865639565, 661444652, 742176152,
+    235661412, 743400420, 121480576, 780238099, 542529435, 565111818, 742650887, 531685021, 7209585,
+    578265672, 83849241, 720430966, 943468335, 231396641, 775715574, 35604661, 613160186, 92369198,
+    428728405, 895540329, 297731800, 932838818, 362029062, 249663766, 831286655, 820341062,
+    723652213, 346547475, 195076090, 283790128, 465838461, 969288758, 732673289, 331687575,
+    953042981, 476076220, 270587900, 859682544, 905182892, 46056521, 955324247, 399760626,
+    635516282, 135226756, 647113440, 311841490, 377263148, 814824510, 150857416, 736472565,
+    471574973, 459168166, 314240547, 162483356, 300826830, 744406728, 463062171, 274044683,
+    142606333, 528482307, 269552401, 158266604, 883982613, 647377739, 531210221, 957328307,
+    709113523, 22624601, 683297431, 687403088, 988142346, 197121420, 750027393, 106242568,
+    254259880, 926026651, 742105370, 375002198, 489419431, 673522565, 521756008, 428730, 368168755,
+    936170420, 172781444, 559369429, 486210325, 64101732, 336773749, 685593584, 398546345,
+    728777736, 732957628, 44165065, 112122225, 426053886, 278975739, 415562895, 851496010, 9455141,
+    749119783, 102791026, 577661901, 500331893, 260762980, 10047858, 257097777, 755318877,
+    816825023, 32703660, 893058625, 897462622, 380507564, 366143932, 386914184, 779838865,
+    775796934, 380336378, 894188331, 752626224, 343748576, 414591186, 398179606, 318170913,
+    549981798, 603242100, 902414914, 494996296, 82920464, 306591030, 188796989, 579255084,
+    626613905, 806881894, 41149672, 45019217, 48133163, 11899821, 81300384, 746616477, 992533497,
+    139146895, 505321971, 601117243, 959460661, 394103450, 139167013, 454332663, 975045993,
+    661525522, 580124921, 102121978, 822707311, 788433180, 447735942, 808684013, 852068283,
+    668424765, 880866668, 30492653, 523339798, 977154561, 705142494, 515422427, 64563108, 707166035,
+    524138843, 496404569, 854185079, 720064751, 747394019, 586000410, 776081904, 686146933,
+    796025810, 978874702, 653010142, 456245426, 680955676, 812243778, 164743044, 266460560,
+    395530311, 745440344, 14628593, 692247428, 59460798, 631059169, 142070375, 677107341, 284338036,
+    933539027, 762034833, 765948391, 420787407, 272333652, 688081969, 694309571, 61859407,
+    208970390, 397582192, 335739019, 717076946, 208663342, 345294458, 119782588, 27042763,
+    395074928, 945000642, 208355554, 236162614, 558702097, 257745343, 656430234, 496939979,
+    386070437, 848049791, 5751349, 72499564, 439130722, 213037587, 705647484, 368241467, 461820557,
+    169424826, 602687178, 997905242, 412084525, 485796775, 318349089, 47121700, 978588545,
+    770335948, 142274115, 901178129, 844454820, 425029386, 581194793, 852831231, 694874221,
+    546134395, 620981921, 555186480, 769870711, 687676870, 700891017, 168537035, 65291647,
+    905050081, 928963332, 574950003, 801827572, 250388335, 629747746, 665973081, 687338333,
+    365074925, 407969531, 903407352, 630788024, 370368658, 717808693, 428206019, 867970050,
+    806422641, 6432596, 117277653, 961951198, 897105936, 136815525, 828456721, 495128443, 205054178,
+    268108711, 462661775, 139264644, 745560540, 725814007, 607615913, 125521454, 357833345,
+    879176784, 377203471, 979580256, 918952312, 942936868, 709763732, 412099637, 722919659,
+    985878638, 368569338, 824729272, 280980714, 311759354, 208970181, 826454014, 752636726,
+    197170828, 275219804, 516616320, 170622015, 78490324, 752019795, 814739282, 226426964,
+    898307171, 562127079, 427443532, 65740038, 124750367, 291530885, 835214690, 876669757,
+    370645685, 444596213, 268435466, 350270680, 983517997, 954882912, 994010050, 495525366,
+    692921066, 699941331, 89039557, 110805009, 369974480, 129359401, 712795120, 713867678,
+    512883410, 198888045, 67524955, 109473837, 399902886, 849129412, 594232309, 776157527,
+    115149844, 924226592, 824968009, 970785399, 871899212, 202231053, 5057044, 541119297, 459711932,
+    415566917, 481758795, 803406733, 720367446, 297230247, 942632627, 541068252, 344373465,
+    808025563, 908874017, 300057790, 217370582, 5869565, 734252530, 257040458, 730893719, 974280996,
+    105981100, 67257095, 909797368, 660230782, 308597953, 327616110, 562836398, 191647929,
+    561012693, 671777221, 972473293, 502779112, 933123889, 283186288, 965637980, 489569264,
+    947106151, 833529513, 857616141, 977623344, 603253595, 984345009, 231605070, 43315148,
+    199704538, 858916630, 205939227, 490661520, 444703123, 52807698, 699739583, 383786933,
+    194166223, 839334767, 923022356, 36977294, 491726144, 142807776, 97427189, 936141297, 990701469,
+    79603997, 951662983, 355186277, 266381846, 118172806, 407523904, 400622114, 970217689,
+    919760450, 17725226, 330754963, 153254599, 137005109, 162430713, 48128738, 883595145, 476869178,
+    283640163, 176620635, 747698566, 197623304, 568175824, 787843655, 40429763, 393067004,
+    200324180, 192508449, 527149807, 601684000, 895455605, 635069132, 874823086, 681015527,
+    444630026, 995674048, 278262409, 53000132, 735456889, 855447729, 245313422, 791502893,
+    460239709, 444295524, 190770315, 216096272, 496502039, 469241288, 850377825, 24109688,
+    837530499, 720629848, 830552440, 277989841, 230039996, 456698403, 409378779, 119812813,
+    748481191, 591076868, 503100679, 571147823, 959951637, 702489348, 38586152, 535640938,
+    834182241, 447305091, 575872522, 938665118, 361269090, 742771311, 712551512, 575780624,
+    891867992, 850951352, 119253646, 18431403, 947246253, 509651878, 670083636, 830172147,
+    920607575, 555309332, 295728495, 55687574, 432043046, 418952632, 287522256, 842651611, 38538234,
+    751797407, 956470433, 192514063, 333532853, 50609480, 353304020, 760220310, 179566665,
+    904291717, 972589083, 102080398, 933231043, 356537974, 805542397, 675274778, 125084577,
+    577033628, 334475750, 590006363, 436947847, 305947921, 888953398, 419452054, 970221864,
+    642886686, 268984393, 908560630, 528843474, 734950541, 904807550, 977709319, 188881455,
+    773166769, 715734485, 913497231, 966947196, 84335648, 812916985, 953684174, 66686900, 84405019,
+    903345900, 127516063, 213068366, 387436614, 729981584, 883594219, 603861396, 598940146,
+    884195436, 893985638, 231497297, 142832968, 828838657, 405567530, 323582899, 208312822,
+    724673214, 159603733, 530689894, 70631453, 979513372, 924173860, 798746407, 982772480,
+    700104708, 392138135, 309420306, 911511362, 116856911, 292357754, 182691657, 506053936,
+    307415293, 944929309, 723478383};
+#endif//NTT_CONV
+
+/*
+ * Layer 2
+ * =======
+ * Convolution + BN + ReLU + Pooling
+ * 
+ * Input:  [F1, C, T]
+ * Weight: [F2, C] (aligned to [F2, 24]
+ * Output: [F2, T // 8]
+ */
+
+RT_L2_DATA const int32_t net_l2_params[] = {
+    1961, 1773, 1252, 713, 384, 620, 338, 898, 1279, 1066, 1119, 497, 721, 602, 386, 684, 41026,
+    -56845, 25025, 12503, 5726, -13478, -4663, 16723, 34560, -21530, 13158, -15164, 24404, 11043,
+    16191, -26006, 8462329, -2130460401, -950528, 535888769, 258557, 509, -235806463, 4162033,
+    -251657984, 1057955711, 1056972769, 65280, 134213919, 491779, 2147057601, -35521277, -235274977,
+    64993, 62983999, -50315265, 2145460209, 16785279, 251781376, 16383, 134216189, -1056767999,
+    -49815055, 50331903, -247529409, 64768, -2114380031, 252174599, 12656511, 16596989, 522745,
+    1023, -250611456, 50395633, -251461632, 521126145, 251731727, 57793, 528449919, 12697985, 16143,
+    58786041, -505298435, 1792, -503774211, 1057030912, -507428927, -101638400, 8486687, 897,
+    8454273, 2146516736, 2147336448, -519847680, -1056948239, 249, -16711695, 33095809, 54509951,
+    -2130706177, 50332416, 16128, -235800127, -15777921, 14761743, 33160448, -100726799, 65023,
+    251674609, 66126083, -1052835615, -100856061, 528416783, 3, -251590905, -41950849, 54460669,
+    16875776, -1040367869, 4089, 16326527, 117570816, 125771649, 117907455, 33097472, 7951,
+    532750209, 4128775, 117539103, 29433825, 66928625, 8191};
+
+/*
+ * Layer 3
+ * =======
+ * Convolution
+ * 
+ * Input:  [F2, T // 8]
+ * Weight: [F2, 16]
+ * Output: [F2, T // 8]
+ */
+RT_L2_DATA const int8_t net_l3_weight[] = {
+    127, 31, 3, -127, 1, 7, -31, 0, 15, 1, 63, -15, 3, 7, -31, -1, 0, 63, -63, -1, -3, 0, 7, 15, 1,
+    3, 7, 31, -7, -7, -15, 0, 7, -3, -15, 127, 0, -7, 1, 0, 63, 127, 1, 15, -1, 3, -127, 3, 0, 0,
+    31, -1, 1, 0, 127, 15, 15, 15, -15, 7, 1, 31, 15, 0, 0, 63, 7, 0, -127, 15, -1, 3, 7, 3, 63,
+    -15, 63, 3, -31, 63, 1, 0, 127, 0, -3, 0, -127, -63, 63, 0, -7, 0, 31, 63, -3, 127, 1, -15, 1,
+    63, 31, 3, 7, -1, -127, 0, 7, 0, -127, 0, 7, 1, -7, 31, 127, -3, -127, -63, 3, 127, -1, 7, 0, 0,
+    -15, 127, -7, -31, 15, 1, 3, -3, 63, -3, 31, 127, 7, -3, -127, -7, -3, -1, 7, -3, 0, -3, -1,
+    -31, 31, 31, 0, -15, -7, 1, 127, -127, -31, -7, 15, 0, -3, 3, 31, -127, 0, 0, 0, 7, 63, 3, 1,
+    63, 0, 0, -31, 15, 3, -3, 63, 1, -63, -63, -63, -63, 0, -15, -3, 1, -3, 31, 15, 31, 63, 127, 7,
+    1, 3, -127, 7, -7, 3, 3, 63, -31, -127, 127, 15, -63, 63, 1, 63, 7, 31, 7, 0, -63, -31, -7, -63,
+    -15, 0, 0, -127, 127, -31, -3, -3, 7, -1, 63, 0, 0, 63, 31, 0, -31, -31, -1, 31, 7, -15, 127, 0,
+    15, -7, 0, 1, 3, -1, 0, -7, 63, -63, -31, -127, -15};
+
+/*
+ * Layer 4
+ * =======
+ * Convolution + BN + ReLU + Pooling
+ * 
+ * Input:  [F2, T // 8]
+ * Weight: [F2, F2]
+ * Output: [F2, T // 64]
+ */
+
+RT_L2_DATA const int32_t net_l4_params[] = {
+    398, 477, 622, 212, 240, 360, 663, 440, 237, 249, 408, 706, 492, 208, 570, 458, 53686, -27335,
+    91907, 9896, 17173, 39055, -35566, 2946, 26543, -27925, 26160, 4325, -22088, 14899, -25906,
+    -32894, -505286397, 528424953, 8455041, 32571649, -100728545, 2130835953, 15794207, 117964547,
+    -1056866553, -2130704511, 50395393, 532758497, -251135519, 121570297, -33570560, -117243399,
+    119472377, -16285199, 2143354895, -250675200, -100727040, -42007801, 16645379, 1069670785,
+    -100720896, 50823105, -1040318991, -116980865, 1048351, 12706177, -235831549, 65110279,
+    62980159, -520024065, -16317955, 520306435, 25164273, 252117233, -115343616, -4127993, 50396931,
+    -2114322688, -2130648583, -8322063, -50269825, -519847553, 536838081, -2130215137, -503709889,
+    2134837055, 117570033, 267976705, -239009024, 61696, -517996799, 4186621, 1058996487, 50331648,
+    -1054924929, 29489633, 33111935, 32572223, 16809981, 117441407};
+
+/*
+ * Layer 5
+ * =======
+ * Linear Layer (without scaling in the end)
+ * 
+ * Input:  [F2, T // 64]
+ * Weight: [N, F2 * (T // 64)]
+ * Bias:   [N]
+ * Output: [N]
+ */
+
+RT_L2_DATA const int32_t net_l5_params[] = {
+    16777217, 229120, 2130722809, 1072824065, 204785, 249, -503504959, -109113569, 25231487,
+    -1048510208, 249, 520617217, 1073549309, -2115903231, -2128674785, 0, -247527427, -50327745,
+    -251600513, 117899265, 249, 118487549, 197089, -234946175, 66650361, 255, 1057963905, -16662272,
+    1071767815, 2031873, 0, -1056835135, 12712433, 2039793, 2064383, 249, 125821247, 32519,
+    16773601, 12652417, 31, -518054137, 16613361, 536813313, 17764127, 241, 12648703, 4129567,
+    267992959, -15793401, 63, 4161807, 134201600, 8454641, -235831552, 241, 383, 16777216,
+    528417273, 2095423, 3, -101613824, -503717601, -504266367, 267453199, 0, 520354049, -49823233,
+    -1056964608, -520091775, 0, 241, -33562241, 536469763, -1056706304, 7, 33153281, -2128642301,
+    -16769249, 51315073, 225, 62981889, -117382719, 50839823, -251588863, 241, 268247033, 57853,
+    1056980736, -2122188295, 255, -251198657, -2115896049, 2143416769, -16776991, 225, -519896257,
+    -519577217, 1065419520, 287, 241, 50331841, 1059045885, 2147295201, 1057038087, 127,
+    -2126513920, 1057014047, 2033411, -102692927, 1, -519832067, 15856125, -49332287, -16744065,
+    255, 536674497, 1073709567, 16744897, 33111811, 7, 267452672, 2132754239, 4128768, 528612623, 0,
+    50364401, 1072824071, 2131705727, 63, 129, -1040646143, 119472609, -180465, 67045183, 255,
+    133236609, -4128513, 229361, 2134893049, 0, 2132787463, 64895, 16596737, -238952191, 193,
+    1072766783, 2147089793, -950303, 255789055, 0, -1054929145, -235274255, -520060419, -236896512,
+    1, -251530783, -50329853, 133775119, -1048640641, 225, 528480512, -2130583047, -503767041,
+    -519102467, 0, -2129690368, 8454431, 1065418752, -104792033, 127, 2131165191, 12681727,
+    251789063, 2130919409, 127, 8339215, 2130706495, 520552701, -2114387681, 31, 1057165063,
+    260145411, 58654969, 66127869, 15, -519634559, -16712223, 65521, 33128385, 15, -4064897,
+    2146501113, 33099520, 1056968451, 225, -116948735, -520028161, 12681185, -517996575, 1,
+    -117375217, 33039, -504298752, 460544, 241, 252703103, -1041170191, 267976833, 2130706561, 129,
+    -1040318593, -48292081, -520027911, 134201615, 129, -2126561409, 33419520, -1040642111,
+    65141185, 0, 25231361, -1048508479, -235331809, -1056915200, 0, -12582943, 133822721, 268296463,
+    -251593345, 255, 2139193825, -2129690353, 1065452025, 129, 7, -33558209, 1073577983, 16776577,
+    -7935, 127, 2145468353, 8462333, -235830791, -2130245857, 0, 532804095, 14803425, 33521661,
+    117506335, 241, -117390849, -35536625, -251592449, 1071710271, 0, 33095711, -2118049985,
+    266436359, 2130768143, 249, 133292537, -1042157249, 117505280, -1040596729, 15, 63775,
+    -49869055, 520208769, 2093439, 7, 986883, 536674305, 50822975, 521126337, 0, 1065337337,
+    -50264320, 8454145, 267976833, 0, 134037501, -2114060541, 1056997120, -515932289, 193,
+    -518061824, -505298688, 2131697408, 16382461, 0, -117309696, -1054875391, -2130640447,
+    -247464704, 129, -520093567, -117438591, -251657983, -503512825, 31, 66189631, -2128674816,
+    1073725889, -101121791, 193, 198407, 1072759025, 20939261, -102661857, 63, 252166400, 20939071,
+    961, 51315456, 249, -33734897, -520028401, -117440063, 33087, 253};
+
@@ -0,0 +1,163 @@
+#ifndef __NET_NET_H__
+#define __NET_NET_H__
+
+#include "rt/rt_api.h"
+
+/*
+ * Network Dimensions
+ */
+#define NET_F1 8
+#define NET_F2 16
+#define NET_D 2
+#define NET_C 22
+#define NET_C_ALIGN 24
+#define NET_T 1125
+#define NET_T_ALIGN 1128
+#define NET_T8 140
+#define NET_T8_ALIGN 140
+#define NET_T64 17
+#define NET_T64_ALIGN 20
+#define NET_N 4
+
+/*
+ * Input Stage
+ * ===========
+ * Quantization of the raw ADC samples
+ * 
+ * Input:  [C, T] (ADC codes)
+ * Output: [C, T] (padded like the input of layer 1)
+ */
+
+#define NET_INPUT_ADC_BITS 16
+
+#define NET_INPUT_SHIFT 23
+
+#define NET_INPUT_FACTOR 79098
+
+/*
+ * Layer 1
+ * =======
+ * Convolution + BN
+ * 
+ * Input:  [C, T]
+ * Weight: [F1, 64] (reversed, aligned to [F1, NET_L1_WEIGHT_LEN_ALIGN])
+ * Output: [F1, C, T]
+ */
+
+#define NET_L1_PAD_START 31
+
+#define NET_L1_PAD_END 32
+
+#define NET_L1_PAD_INPUT_LEN 1188
+
+#define NET_L1_PAD_INPUT_LEN_ALIGN 1188
+
+#define NET_L1_WEIGHT_LEN 64
+
+#define NET_L1_WEIGHT_LEN_ALIGN 64
+
+#define NET_L1_RESULT_BITS 20
+
+#define NET_L2_POOL_BITS 31
+
+#define NET_L1_PARAMS_FACTOR 0
+#define NET_L1_PARAMS_OFFSET 8
+#define NET_L1_PARAMS_WEIGHT 16
+#define NET_L1_PARAMS_LEN 144
+
+extern RT_L2_DATA const int32_t net_l1_params[144];
+
+#define NET_L1_NTT_LEN 256
+#define NET_L1_NTT_STEP 193
+#define NET_L1_NTT_STEP_ALIGN 196
+#define NET_L1_NTT_BLOCKS 6
+#define NET_L1_NTT_SCALE 229805564
+
+#ifdef NTT_CONV
+extern RT_L2_DATA const uint32_t net_l1_ntt_twiddle[256];
+extern RT_L2_DATA const uint32_t net_l1_ntt_spectrum[2048];
+#endif//NTT_CONV
+
+/*
+ * Layer 2
+ * =======
+ * Convolution + BN + ReLU + Pooling
+ * 
+ * Input:  [F1, C, T]
+ * Weight: [F2, C] (aligned to [F2, 24]
+ * Output: [F2, T // 8]
+ */
+
+#define NET_L2_WEIGHT_LEN 24
+
+#define NET_L2_PARAMS_FACTOR 0
+#define NET_L2_PARAMS_OFFSET 16
+#define NET_L2_PARAMS_WEIGHT 32
+#define NET_L2_PARAMS_LEN 128
+
+extern RT_L2_DATA const int32_t net_l2_params[128];
+
+/*
+ * Layer 3
+ * =======
+ * Convolution
+ * 
+ * Input:  [F2, T // 8]
+ * Weight: [F2, 16]
+ * Output: [F2, T // 8]
+ */
+#define NET_L3_PAD_START 7
+
+#define NET_L3_PAD_END 8
+
+#define NET_L3_PAD_INPUT_LEN 155
+
+#define NET_L3_PAD_INPUT_LEN_ALIGN 156
+
+#define NET_L3_FACTOR 185
+
+#define NET_L3_WEIGHT_LEN 16
+
+extern RT_L2_DATA const int8_t net_l3_weight[256];
+
+/*
+ * Layer 4
+ * =======
+ * Convolution + BN + ReLU + Pooling
+ * 
+ * Input:  [F2, T // 8]
+ * Weight: [F2, F2]
+ * Output: [F2, T // 64]
+ */
+
+#define NET_L4_WEIGHT_LEN 16
+
+#define NET_L4_PARAMS_FACTOR 0
+#define NET_L4_PARAMS_OFFSET 16
+#define NET_L4_PARAMS_WEIGHT 32
+#define NET_L4_PARAMS_LEN 96
+
+extern RT_L2_DATA const int32_t net_l4_params[96];
+
+/*
+ * Layer 5
+ * =======
+ * Linear Layer (without scaling in the end)
+ * 
+ * Input:  [F2, T // 64]
+ * Weight: [N, F2 * (T // 64)]
+ * Bias:   [N]
+ * Output: [N]
+ */
+
+#define NET_L5_FACTOR 629
+
+#define NET_L5_WEIGHT_LEN 320
+
+#define NET_L5_PARAMS_BIAS 0
+#define NET_L5_PARAMS_WEIGHT 1
+#define NET_L5_PARAMS_LEN 321
+
+extern RT_L2_DATA const int32_t net_l5_params[321];
+
+#endif//__NET_NET_H__
\ No newline at end of file
@@ -0,0 +1,302 @@
+/**
+ * @file pipeline.c
+ * @author Tibor Schneider
+ * @date 2020/06/14
+ * @brief This file contains the implementation of the pipelined layers 3, 4 and 5
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rt/rt_api.h"
+#include "pipeline.h"
+#include "net.h"
+#include "blob.h"
+#include "../func/functional.h"
+
+#ifdef PIPELINE
+
+#ifndef NUM_WORKERS
+#define NUM_WORKERS 8
+#endif
+
+#if NET_F2 != 2 * NUM_WORKERS
+#error "The pipeline requires two channels of layer 2 per core (NET_F2 == 2 * NUM_WORKERS)"
+#endif
+
+#if NUM_WORKERS > NET_QUEUE_MAX_PRODUCERS
+#error "The queue of the pipeline supports at most NET_QUEUE_MAX_PRODUCERS cores"
+#endif
+
+// length of the padded input of layer 3, which is needed for one block of 8 outputs
+#define _L3_BLOCK_LEN (8 + NET_L3_WEIGHT_LEN - 1)
+
+// size of the buffers on L1
+#define _L3_DATA_LEN (NET_F2 * NET_L3_PAD_INPUT_LEN_ALIGN)
+#define _L4_DATA_LEN (NET_T64 * 8 * NET_F2)
+#define _L3_WEIGHT_LEN (NET_F2 * NET_L3_WEIGHT_LEN)
+
+/**
+ * @brief Computes the blocks of layer 3 of the two channels of this core, for which the input is
+ * complete, and publishes them in the queue.
+ *
+ * @param p_pipeline Pipeline
+ * @param core_id Id of this core
+ * @param num_cols Number of columns of layer 2, which are pushed (NET_T8: all, the rest is padding)
+ */
+static void _net_pipeline_layer3(net_pipeline_t* p_pipeline, unsigned int core_id, unsigned int num_cols) {
+
+    // block j needs the padded input 8j to 8j + _L3_BLOCK_LEN - 1
+    int _num_blocks;
+    if (num_cols >= NET_T8) {
+        _num_blocks = NET_T64;
+    } else {
+        _num_blocks = ((int)num_cols + NET_L3_PAD_START - _L3_BLOCK_LEN + 8) / 8;
+        _num_blocks = __MIN(_num_blocks, NET_T64);
+    }
+
+    int _block = p_pipeline->queue.count[core_id];
+    if (_block >= _num_blocks) {
+        return;
+    }
+
+    int32_t _factor = net_params.l3_factor;
+    int32_t _tmp[2];
+    int8_t* _p_tmp = (int8_t*)_tmp;
+    int8_t* _p_result_iter;
+
+    for (; _block < _num_blocks; _block++) {
+        for (int _k = 2 * core_id; _k < 2 * core_id + 2; _k++) {
+
+            // compute 8 outputs of the channel
+            func_conv_scale(p_pipeline->p_l3_data + _k * NET_L3_PAD_INPUT_LEN_ALIGN + _block * 8, _L3_BLOCK_LEN,
+                            p_pipeline->p_l3_weight + _k * NET_L3_WEIGHT_LEN, NET_L3_WEIGHT_LEN,
+                            _factor, 0, _p_tmp);
+
+            // store them in the column of the channel
+            _p_result_iter = p_pipeline->p_l4_data + _block * 8 * NET_F2 + _k;
+            for (int _t = 0; _t < 8; _t++) {
+                *_p_result_iter = _p_tmp[_t];
+                _p_result_iter += NET_F2;
+            }
+        }
+    }
+
+    net_queue_push(&p_pipeline->queue, core_id, _num_blocks);
+}
+
+/**
+ * @brief Computes the rows 2 * core_id and 2 * core_id + 1 of layer 4 for the blocks up to
+ * num_blocks, and accumulates them into the partial sums of layer 5 of this core.
+ *
+ * @param p_pipeline Pipeline
+ * @param core_id Id of this core
+ * @param num_blocks Number of blocks of layer 3, which are complete (in all channels)
+ */
+static void _net_pipeline_layer4(net_pipeline_t* p_pipeline, unsigned int core_id, unsigned int num_blocks) {
+
+    const int32_t* _p_factor = p_pipeline->p_l4_params + NET_L4_PARAMS_FACTOR + 2 * core_id;
+    const int32_t* _p_offset = p_pipeline->p_l4_params + NET_L4_PARAMS_OFFSET + 2 * core_id;
+    const int8_t* _p_weight = (int8_t*)(p_pipeline->p_l4_params + NET_L4_PARAMS_WEIGHT) + 2 * core_id * NET_L4_WEIGHT_LEN;
+    const int8_t* _p_weight_l5 = (int8_t*)(p_pipeline->p_l5_params + NET_L5_PARAMS_WEIGHT) + 2 * core_id * NET_T64_ALIGN;
+    int32_t* _p_acc = p_pipeline->p_l5_acc + core_id * NET_N;
+
+    const int8_t* _p_data_iter;
+    int32_t _relu_threshold;
+    int32_t _factor;
+    int32_t _offset;
+    int32_t _elem; // stores the current element, for doing dot product and ReLU
+    int32_t _sum;  // stores the sum for the pooling
+
+    for (unsigned int _block = p_pipeline->l4_done[core_id]; _block < num_blocks; _block++) {
+        for (int _k = 0; _k < 2; _k++) {
+
+            _factor = _p_factor[_k];
+            _offset = _p_offset[_k];
+
+#ifdef REORDER_BN
+            _relu_threshold = -(_offset >> 3);
+#else//REORDER_BN
+            _factor = _factor >> 3;
+            _offset = _offset >> 3;
+#endif//REORDER_BN
+
+            _p_data_iter = p_pipeline->p_l4_data + _block * 8 * NET_F2;
+            _sum = 0;
+
+            for (int _t_pool = 0; _t_pool < 8; _t_pool++) {
+
+                // compute the dot product
+                _elem = func_dotp(_p_data_iter, _p_weight + _k * NET_L4_WEIGHT_LEN, NET_F2);
+
+#ifdef REORDER_BN
+                // do the ReLU
+                _elem = __MAX(_elem, _relu_threshold);
+#else//REORDER_BN
+                // do the BN
+                _elem = (_elem + _offset) / _factor;
+                // do the ReLU
+                _elem = __MAX(_elem, 0);
+#endif//REORDER_BN
+
+                _sum += _elem;
+                _p_data_iter += NET_F2;
+            }
+
+#ifdef REORDER_BN
+            // do the BN
+            _sum = _sum + _offset;
+            _sum = _sum / _factor;
+#else//REORDER_BN
+            // do the division for avg pooling
+            _sum = _sum >> 3;
+#endif//REORDER_BN
+            _sum = __CLIP_R(_sum, 127);
+
+            // layer 5: the output is element [2 * core_id + _k, _block] of the flattened input
+            for (int _n = 0; _n < NET_N; _n++) {
+                _p_acc[_n] += _sum * _p_weight_l5[_n * NET_L5_WEIGHT_LEN + _k * NET_T64_ALIGN + _block];
+            }
+        }
+    }
+
+    if (num_blocks > p_pipeline->l4_done[core_id]) {
+        p_pipeline->l4_done[core_id] = num_blocks;
+    }
+}
+
+int net_pipeline_init(net_pipeline_t* p_pipeline, int8_t* p_output) {
+
+    p_pipeline->p_output = p_output;
+    p_pipeline->p_l3_data = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _L3_DATA_LEN);
+    p_pipeline->p_l4_data = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _L4_DATA_LEN);
+    p_pipeline->p_l3_weight = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * _L3_WEIGHT_LEN);
+    p_pipeline->p_l4_params = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L4_PARAMS_LEN);
+    p_pipeline->p_l5_params = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NET_L5_PARAMS_LEN);
+    p_pipeline->p_l5_acc = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int32_t) * NUM_WORKERS * NET_N);
+
+    if (p_pipeline->p_l5_acc == NULL) {
+        return NET_PIPELINE_ERR_NOMEM;
+    }
+
+    // load all parameters of layer 3, 4 and 5
+    rt_dma_copy_t _copy;
+    rt_dma_memcpy((unsigned int)net_params.l3_weight,
+                  (unsigned int)p_pipeline->p_l3_weight,
+                  sizeof(int8_t) * _L3_WEIGHT_LEN,
+                  RT_DMA_DIR_EXT2LOC, 0, &_copy);
+    rt_dma_memcpy((unsigned int)net_params.l4_params,
+                  (unsigned int)p_pipeline->p_l4_params,
+                  sizeof(int32_t) * NET_L4_PARAMS_LEN,
+                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
+    rt_dma_memcpy((unsigned int)net_params.l5_params,
+                  (unsigned int)p_pipeline->p_l5_params,
+                  sizeof(int32_t) * NET_L5_PARAMS_LEN,
+                  RT_DMA_DIR_EXT2LOC, 1, &_copy);
+
+    // the input of layer 3 is zero padded, the columns of layer 2 are pushed in between
+    int32_t* _p_iter = (int32_t*)p_pipeline->p_l3_data;
+    for (int _i = 0; _i < _L3_DATA_LEN / 4; _i++) {
+        *(_p_iter++) = 0;
+    }
+
+    for (int _i = 0; _i < NUM_WORKERS * NET_N; _i++) {
+        p_pipeline->p_l5_acc[_i] = 0;
+    }
+
+    for (int _i = 0; _i < NUM_WORKERS; _i++) {
+        p_pipeline->l4_done[_i] = 0;
+    }
+
+    net_queue_init(&p_pipeline->queue, NUM_WORKERS);
+
+    rt_dma_wait(&_copy);
+
+    return NET_PIPELINE_OK;
+}
+
+void net_pipeline_push(net_pipeline_t* p_pipeline,
+                       const int8_t* p_data,
+                       unsigned int stride,
+                       unsigned int t_start,
+                       unsigned int num) {
+
+    unsigned int _core_id = rt_core_id();
+
+    // copy the columns into the padded input of layer 3
+    int8_t* _p_dst = p_pipeline->p_l3_data + 2 * _core_id * NET_L3_PAD_INPUT_LEN_ALIGN + NET_L3_PAD_START + t_start;
+    for (unsigned int _t = 0; _t < num; _t++) {
+        _p_dst[_t] = p_data[_t];
+        _p_dst[_t + NET_L3_PAD_INPUT_LEN_ALIGN] = p_data[_t + stride];
+    }
+
+    // layer 3 of the own channels only depends on this core
+    _net_pipeline_layer3(p_pipeline, _core_id, t_start + num);
+
+    // layer 4 and 5 of all blocks, which the other cores have already finished
+    _net_pipeline_layer4(p_pipeline, _core_id, net_queue_available(&p_pipeline->queue));
+}
+
+void net_pipeline_finish(net_pipeline_t* p_pipeline) {
+
+    unsigned int _core_id = rt_core_id();
+
+    // finish layer 3 (the last blocks contain the padding), and wait for all other cores
+    _net_pipeline_layer3(p_pipeline, _core_id, NET_T8);
+    _net_pipeline_layer4(p_pipeline, _core_id, net_queue_wait(&p_pipeline->queue, NET_T64));
+
+    // all partial sums of layer 5 must be complete
+    rt_team_barrier();
+
+    if (_core_id == 0) {
+
+        int32_t* _p_sum = p_pipeline->p_l5_acc;
+        const int8_t* _p_bias = (int8_t*)(p_pipeline->p_l5_params + NET_L5_PARAMS_BIAS);
+        int8_t _result[NET_N];
+
+        // add up the partial sums of all cores (in the partial sums of core 0)
+        for (int _n = 0; _n < NET_N; _n++) {
+            for (int _i = 1; _i < NUM_WORKERS; _i++) {
+                _p_sum[_n] += p_pipeline->p_l5_acc[_i * NET_N + _n];
+            }
+            _p_sum[_n] += _p_bias[_n];
+        }
+
+        // transform the vector
+        func_transform_32to8(_p_sum, NET_N, net_params.l5_factor, 1, _result);
+
+        // copy the data back (only NET_N elements, do not use DMA)
+        for (int _n = 0; _n < NET_N; _n++) {
+            p_pipeline->p_output[_n] = _result[_n];
+        }
+    }
+}
+
+void net_pipeline_free(net_pipeline_t* p_pipeline) {
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l3_data, sizeof(int8_t) * _L3_DATA_LEN);
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l4_data, sizeof(int8_t) * _L4_DATA_LEN);
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l3_weight, sizeof(int8_t) * _L3_WEIGHT_LEN);
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l4_params, sizeof(int32_t) * NET_L4_PARAMS_LEN);
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l5_params, sizeof(int32_t) * NET_L5_PARAMS_LEN);
+    rt_free(RT_ALLOC_CL_DATA, p_pipeline->p_l5_acc, sizeof(int32_t) * NUM_WORKERS * NET_N);
+}
+
+#endif//PIPELINE
@@ -0,0 +1,106 @@
+/**
+ * @file pipeline.h
+ * @author Tibor Schneider
+ * @date 2020/06/14
+ * @brief This file contains the definitions of the pipelined layers 3, 4 and 5
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_NET_PIPELINE_H__
+#define __CL_NET_PIPELINE_H__
+
+#include "rt/rt_api.h"
+#include "net.h"
+#include "queue.h"
+
+/**
+ * @brief State of the pipelined layers 3, 4 and 5 (PIPELINE), all buffers are on L1.
+ *
+ * The fused layer 1+2 pushes the pooled columns of layer 2 (chunk by chunk) into the pipeline, while
+ * it computes the next chunk. Core k owns the channels 2k and 2k + 1 of layer 2, 3 and 4:
+ *
+ * 1. Layer 3 is a depthwise convolution, core k computes it for its own channels as soon as the
+ *    columns of layer 2 are present, without waiting for the other cores. The output is computed in
+ *    blocks of 8 time steps (one output of layer 4), and stored flipped [NET_T64 * 8, NET_F2].
+ * 2. Layer 4 needs all channels of a block. Every finished block of layer 3 is published in a
+ *    queue, and core k computes its two rows of layer 4 for all blocks which are complete.
+ * 3. The output of layer 4 is immediately multiplied with the weights of layer 5, every core
+ *    accumulates its partial sums. At the end, core 0 adds them up.
+ */
+typedef struct {
+    int8_t* p_output;           // result of the network on L2 [NET_N]
+    int8_t* p_l3_data;          // padded input of layer 3 [NET_F2, NET_L3_PAD_INPUT_LEN_ALIGN]
+    int8_t* p_l4_data;          // input of layer 4 (flipped) [NET_T64 * 8, NET_F2]
+    int8_t* p_l3_weight;        // [NET_F2, NET_L3_WEIGHT_LEN]
+    int32_t* p_l4_params;       // [NET_L4_PARAMS_LEN]
+    int32_t* p_l5_params;       // [NET_L5_PARAMS_LEN]
+    int32_t* p_l5_acc;          // partial sums of layer 5 of every core [NET_F1, NET_N]
+    unsigned int l4_done[NET_F1]; // number of blocks of layer 4 computed by every core
+    net_queue_t queue;          // blocks of layer 3, one producer per core
+} net_pipeline_t;
+
+/**
+ * @brief Return values of net_pipeline_init
+ */
+#define NET_PIPELINE_OK 0
+#define NET_PIPELINE_ERR_NOMEM -1   // not enough space on L1 memory
+
+/**
+ * @brief Allocates the buffers on L1 and loads the parameters of layer 3, 4 and 5 (single core,
+ * before the team is forked)
+ *
+ * @param p_pipeline Pipeline to initialize, must be on L1
+ * @param p_output Pointer to the output of the network on L2 [NET_N]
+ *
+ * @returns NET_PIPELINE_OK on success, or a negative error code
+ */
+int net_pipeline_init(net_pipeline_t* p_pipeline, int8_t* p_output);
+
+/**
+ * @brief Pushes new columns of layer 2 of the two channels of this core, and computes all the work
+ * of this core which is ready (layer 3 for its channels, layer 4 and 5 for its rows). Never waits
+ * for the other cores. Called by every core of the team.
+ *
+ * @param p_pipeline Pipeline
+ * @param p_data Columns of the channels 2 * core_id and 2 * core_id + 1 of layer 2, on L1
+ * @param stride Distance between the two channels in p_data
+ * @param t_start First column (time step of layer 2)
+ * @param num Number of columns, all columns before t_start must already be pushed
+ */
+void net_pipeline_push(net_pipeline_t* p_pipeline,
+                       const int8_t* p_data,
+                       unsigned int stride,
+                       unsigned int t_start,
+                       unsigned int num);
+
+/**
+ * @brief Completes the pipeline after all NET_T8 columns are pushed, and stores the output of the
+ * network. Called by every core of the team.
+ */
+void net_pipeline_finish(net_pipeline_t* p_pipeline);
+
+/**
+ * @brief Frees all buffers of the pipeline (single core)
+ */
+void net_pipeline_free(net_pipeline_t* p_pipeline);
+
+#endif//__CL_NET_PIPELINE_H__
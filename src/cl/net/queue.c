@@ -0,0 +1,84 @@
+/**
+ * @file queue.c
+ * @author Tibor Schneider
+ * @date 2020/06/14
+ * @brief This file contains the implementation of the producer/consumer queue between the cores
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rt/rt_api.h"
+#include "queue.h"
+
+#ifdef HOST
+#include <sched.h>
+#endif//HOST
+
+void net_queue_init(net_queue_t* p_queue, unsigned int num_producers) {
+    p_queue->num_producers = num_producers;
+    for (unsigned int _i = 0; _i < NET_QUEUE_MAX_PRODUCERS; _i++) {
+        p_queue->count[_i] = 0;
+    }
+}
+
+void net_queue_push(net_queue_t* p_queue, unsigned int producer, unsigned int count) {
+
+#ifdef HOST
+    // the items must be visible to the other threads before the count
+    __sync_synchronize();
+    p_queue->count[producer] = count;
+#else//HOST
+    // the compiler must not move the stores of the items after the count
+    __asm__ __volatile__("" : : : "memory");
+    p_queue->count[producer] = count;
+    // wake up all cores of the team, which are waiting for the queue
+    eu_evt_trig(eu_evt_trig_addr(NET_QUEUE_EVENT), (1 << p_queue->num_producers) - 1);
+#endif//HOST
+
+}
+
+unsigned int net_queue_available(net_queue_t* p_queue) {
+    unsigned int _num = p_queue->count[0];
+    for (unsigned int _i = 1; _i < p_queue->num_producers; _i++) {
+        unsigned int _count = p_queue->count[_i];
+        _num = _count < _num ? _count : _num;
+    }
+#ifdef HOST
+    // the items must not be read before the count
+    __sync_synchronize();
+#endif//HOST
+    return _num;
+}
+
+unsigned int net_queue_wait(net_queue_t* p_queue, unsigned int num) {
+    unsigned int _num;
+    while ((_num = net_queue_available(p_queue)) < num) {
+#ifdef HOST
+        sched_yield();
+#else//HOST
+        // sleep until any producer pushes (a push since the check above is not lost, since the event
+        // stays pending in the event unit until it is cleared)
+        eu_evt_maskWaitAndClr(1 << NET_QUEUE_EVENT);
+#endif//HOST
+    }
+    return _num;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file queue.h
+ * @author Tibor Schneider
+ * @date 2020/06/14
+ * @brief This file contains the definitions of the producer/consumer queue between the cores
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_NET_QUEUE_H__
+#define __CL_NET_QUEUE_H__
+
+#include "rt/rt_api.h"
+
+/**
+ * @brief Maximal number of producers of a queue (one per core)
+ */
+#define NET_QUEUE_MAX_PRODUCERS 8
+
+/**
+ * @brief Software event of the event unit, which is triggered whenever a producer pushes. It is not
+ * used by the runtime.
+ */
+#define NET_QUEUE_EVENT 4
+
+/**
+ * @brief Queue on L1, in which every producer (core) fills its part of the items in order. The
+ * items themselves are stored by the user (e.g. item i in row i of a buffer on L1), the queue only
+ * contains the number of items each producer has completed. Item i is available as soon as every
+ * producer has completed it.
+ *
+ * The consumers do not remove items, and they never block the producers: every item has its own
+ * place in the buffer. Waiting consumers sleep on the event unit until a producer pushes.
+ */
+typedef struct {
+    unsigned int num_producers;
+    volatile unsigned int count[NET_QUEUE_MAX_PRODUCERS];
+} net_queue_t;
+
+/**
+ * @brief Initializes the queue, without any items (single core, before the team is forked)
+ *
+ * @param p_queue Queue, must be on L1
+ * @param num_producers Number of producers (cores 0 to num_producers - 1)
+ */
+void net_queue_init(net_queue_t* p_queue, unsigned int num_producers);
+
+/**
+ * @brief Publishes that the producer has completed its part of the first count items, and wakes up
+ * the waiting consumers. All stores of the items must be done before.
+ *
+ * @param p_queue Queue
+ * @param producer Producer (core id)
+ * @param count Number of completed items of this producer (never decreases)
+ */
+void net_queue_push(net_queue_t* p_queue, unsigned int producer, unsigned int count);
+
+/**
+ * @brief Returns the number of items, which all producers have completed (does not block)
+ */
+unsigned int net_queue_available(net_queue_t* p_queue);
+
+/**
+ * @brief Waits until at least num items are available.
+ *
+ * @returns Number of available items (at least num)
+ */
+unsigned int net_queue_wait(net_queue_t* p_queue, unsigned int num);
+
+#endif//__CL_NET_QUEUE_H__
@@ -0,0 +1,172 @@
+/**
+ * @file stream.c
+ * @author Tibor Schneider
+ * @date 2020/06/12
+ * @brief This file contains the Implementation for streaming tiles between L2 and L1 with the DMA
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rt/rt_api.h"
+#include "stream.h"
+
+/**
+ * @brief Returns the buffer of tile i on L1
+ */
+static inline int8_t* _net_stream_buffer(net_stream_t* p_stream, unsigned int i) {
+    return p_stream->p_ring + (i % p_stream->depth) * p_stream->buffer_len;
+}
+
+/**
+ * @brief Starts the transfer of the next tile (p_stream->issued)
+ */
+static void _net_stream_issue(net_stream_t* p_stream) {
+
+    net_stream_desc_t* _p_desc = &p_stream->desc;
+    unsigned int _i = p_stream->issued;
+
+    unsigned int _ext = (unsigned int)(_p_desc->p_ext
+                                       + (_i % _p_desc->num[0]) * _p_desc->stride[0]
+                                       + (_i / _p_desc->num[0]) * _p_desc->stride[1]);
+    unsigned int _loc = (unsigned int)(_net_stream_buffer(p_stream, _i) + _p_desc->loc_offset);
+    int _dir = p_stream->dir == NET_STREAM_IN ? RT_DMA_DIR_EXT2LOC : RT_DMA_DIR_LOC2EXT;
+    rt_dma_copy_t* _p_copy = &p_stream->copy[_i % p_stream->depth];
+
+    if (_p_desc->row_len == 0) {
+        rt_dma_memcpy(_ext, _loc, _p_desc->size, _dir, 0, _p_copy);
+    } else if (_p_desc->loc_row_stride != 0) {
+        // the rows are not contiguous on L1, copy them one by one
+        for (unsigned int _row = 0; _row < _p_desc->size / _p_desc->row_len; _row++) {
+            rt_dma_memcpy(_ext + _row * _p_desc->row_stride, _loc + _row * _p_desc->loc_row_stride,
+                          _p_desc->row_len, _dir, _row > 0, _p_copy);
+        }
+    } else {
+        rt_dma_memcpy_2d(_ext, _loc, _p_desc->size, _p_desc->row_stride, _p_desc->row_len,
+                         _dir, 0, _p_copy);
+    }
+
+    p_stream->issued++;
+}
+
+/**
+ * @brief Waits until the first num transfers are complete (in the order they were started)
+ */
+static void _net_stream_wait(net_stream_t* p_stream, unsigned int num) {
+    while (p_stream->waited < num) {
+        rt_dma_wait(&p_stream->copy[p_stream->waited % p_stream->depth]);
+        p_stream->waited++;
+    }
+}
+
+int net_stream_open(net_stream_t* p_stream, const net_stream_desc_t* p_desc, unsigned int depth, int dir) {
+
+    p_stream->desc = *p_desc;
+    if (p_stream->desc.num[0] == 0) {
+        p_stream->desc.num[0] = 1;
+    }
+    if (p_stream->desc.num[1] == 0) {
+        p_stream->desc.num[1] = 1;
+    }
+
+    p_stream->dir = dir;
+    p_stream->depth = depth;
+    p_stream->num_tiles = p_stream->desc.num[0] * p_stream->desc.num[1];
+    p_stream->buffer_len = p_desc->buffer_len;
+    if (p_stream->buffer_len == 0) {
+        p_stream->buffer_len = (p_desc->loc_offset + p_desc->size + 3) & ~3;
+    }
+    p_stream->next = 0;
+    p_stream->issued = 0;
+    p_stream->waited = 0;
+    p_stream->p_current = NULL;
+
+    p_stream->p_ring = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * depth * p_stream->buffer_len);
+    if (p_stream->p_ring == NULL) {
+        return NET_STREAM_ERR_NOMEM;
+    }
+
+    // clear the padding around the tiles (the buffers are aligned to 4 bytes)
+    if (p_stream->buffer_len != p_desc->size) {
+        int32_t* _p_iter = (int32_t*)p_stream->p_ring;
+        for (unsigned int _i = 0; _i < depth * p_stream->buffer_len / 4; _i++) {
+            *(_p_iter++) = 0;
+        }
+    }
+
+    // start loading the first tiles
+    if (dir == NET_STREAM_IN) {
+        while (p_stream->issued < depth - 1 && p_stream->issued < p_stream->num_tiles) {
+            _net_stream_issue(p_stream);
+        }
+    }
+
+    return NET_STREAM_OK;
+}
+
+int8_t* net_stream_next(net_stream_t* p_stream) {
+
+    unsigned int _i = p_stream->next++;
+
+    if (p_stream->dir == NET_STREAM_IN) {
+        // the buffer of the previous tile is free, fill it with tile _i + depth - 1
+        while (p_stream->issued < _i + p_stream->depth && p_stream->issued < p_stream->num_tiles) {
+            _net_stream_issue(p_stream);
+        }
+        _net_stream_wait(p_stream, _i + 1);
+    } else {
+        // store the previous tile, and wait until the buffer of the current one is free
+        if (_i > 0) {
+            _net_stream_issue(p_stream);
+        }
+        if (_i + 1 > p_stream->depth) {
+            _net_stream_wait(p_stream, _i + 1 - p_stream->depth);
+        }
+    }
+
+    return _net_stream_buffer(p_stream, _i);
+}
+
+int8_t* net_stream_team_next(net_stream_t* p_stream) {
+
+    // all cores must be done with the previous tile
+    rt_team_barrier();
+
+    if (rt_core_id() == 0) {
+        p_stream->p_current = net_stream_next(p_stream);
+    }
+
+    rt_team_barrier();
+
+    return p_stream->p_current;
+}
+
+void net_stream_close(net_stream_t* p_stream) {
+
+    // store the last tile
+    if (p_stream->dir == NET_STREAM_OUT && p_stream->issued < p_stream->next) {
+        _net_stream_issue(p_stream);
+    }
+
+    _net_stream_wait(p_stream, p_stream->issued);
+
+    rt_free(RT_ALLOC_CL_DATA, p_stream->p_ring, sizeof(int8_t) * p_stream->depth * p_stream->buffer_len);
+}
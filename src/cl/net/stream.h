@@ -0,0 +1,144 @@
+/**
+ * @file stream.h
+ * @author Tibor Schneider
+ * @date 2020/06/12
+ * @brief This file contains the definitions for streaming tiles between L2 and L1 with the DMA
+ */
+
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_NET_STREAM_H__
+#define __CL_NET_STREAM_H__
+
+#include "rt/rt_api.h"
+
+/**
+ * @brief Maximal number of buffers in the ring of a stream
+ */
+#define NET_STREAM_MAX_DEPTH 4
+
+/**
+ * @brief Number of buffers used by the layers. With DMA_STREAM, the next tile is loaded (and the
+ * previous one stored) while the current one is computed. Otherwise, every transfer is blocking.
+ *
+ * Layer 2, the sequential layer 1 and 3, the parallel layer 3 with LAYER3_TIME_BLOCKS and the
+ * parallel layer 4 use streams. The other parallel layer 1 and 3, layer 5 and the fused layer 1+2
+ * load their input with their own transfers (see README).
+ */
+#ifdef DMA_STREAM
+#define NET_STREAM_DEPTH 2
+#else//DMA_STREAM
+#define NET_STREAM_DEPTH 1
+#endif//DMA_STREAM
+
+/**
+ * @brief Direction of a stream
+ */
+#define NET_STREAM_IN 0   // L2 -> L1, the tiles are prefetched
+#define NET_STREAM_OUT 1  // L1 -> L2, the tiles are written back asynchronously
+
+/**
+ * @brief Describes how a tensor on L2 is split into tiles. The tiles are enumerated in row-major
+ * order over two dimensions: tile i is at p_ext + (i % num[0]) * stride[0] + (i / num[0]) * stride[1].
+ *
+ * A tile is either contiguous on L2 (row_len = 0), or consists of rows of row_len bytes, which are
+ * row_stride bytes apart on L2 (2D transfer). On L1, every tile is contiguous, and stored at byte
+ * loc_offset of its buffer. With loc_row_stride, the rows are instead loc_row_stride bytes apart on
+ * L1, and every row is copied with its own (merged) transfer. The remaining bytes of the buffer are
+ * set to zero when the stream is opened, and never touched by the DMA, such that they can be used
+ * as zero padding (also between the rows).
+ */
+typedef struct {
+    const int8_t* p_ext;        // first tile on L2
+    unsigned int size;          // size of a tile in bytes
+    unsigned int num[2];        // number of tiles in the inner and in the outer dimension (0 = 1)
+    unsigned int stride[2];     // distance of two tiles on L2 in the inner and outer dimension
+    unsigned int row_len;       // 2D tiles: bytes per row (0: the tile is contiguous on L2)
+    unsigned int row_stride;    // 2D tiles: distance of two rows on L2
+    unsigned int loc_row_stride; // 2D tiles: distance of two rows on L1 (0: row_len, single transfer)
+    unsigned int loc_offset;    // position of the tile inside its buffer on L1
+    unsigned int buffer_len;    // size of a buffer on L1 (0: loc_offset + size, aligned to 4 bytes)
+} net_stream_desc_t;
+
+/**
+ * @brief State of a stream. Tile i is stored in buffer i % depth of the ring. The tile returned by
+ * net_stream_next is valid until the following call of net_stream_next (or net_stream_close).
+ */
+typedef struct {
+    net_stream_desc_t desc;
+    int dir;
+    unsigned int depth;         // number of buffers in the ring
+    unsigned int num_tiles;
+    unsigned int buffer_len;
+    int8_t* p_ring;             // depth buffers on L1
+    unsigned int next;          // tile, which is returned by the next call of net_stream_next
+    unsigned int issued;        // number of started transfers
+    unsigned int waited;        // number of completed transfers
+    int8_t* volatile p_current; // tile of the last call of net_stream_team_next
+    rt_dma_copy_t copy[NET_STREAM_MAX_DEPTH];
+} net_stream_t;
+
+/**
+ * @brief Return values of net_stream_open
+ */
+#define NET_STREAM_OK 0
+#define NET_STREAM_ERR_NOMEM -1   // not enough space on L1 memory
+
+/**
+ * @brief Allocates the ring on L1 and, for an input stream, starts loading the first depth - 1
+ * tiles.
+ *
+ * @param p_stream Stream to initialize
+ * @param p_desc Tensor descriptor (copied)
+ * @param depth Number of buffers (1 <= depth <= NET_STREAM_MAX_DEPTH). With depth buffers, an input
+ *        stream loads up to depth - 1 tiles in advance, and an output stream has up to depth - 1
+ *        tiles in flight.
+ * @param dir NET_STREAM_IN or NET_STREAM_OUT
+ *
+ * @returns NET_STREAM_OK on success, or a negative error code
+ */
+int net_stream_open(net_stream_t* p_stream, const net_stream_desc_t* p_desc, unsigned int depth, int dir);
+
+/**
+ * @brief Hands out the next tile (single core).
+ *
+ * For an input stream, this releases the previous tile, starts loading the next tile into its
+ * buffer, and waits until the current one is present. For an output stream, this starts storing
+ * the previous tile, and returns the buffer, in which the result of the current tile must be
+ * written (after waiting until its previous content is stored).
+ *
+ * @returns Pointer to the buffer on L1, which contains the tile at loc_offset
+ */
+int8_t* net_stream_next(net_stream_t* p_stream);
+
+/**
+ * @brief Same as net_stream_next, but called by all cores of the team. The team waits until every
+ * core is done with the previous tile, then core 0 advances the stream, and all cores get the same
+ * tile.
+ */
+int8_t* net_stream_team_next(net_stream_t* p_stream);
+
+/**
+ * @brief Stores the last tile of an output stream, waits for all transfers and frees the ring.
+ */
+void net_stream_close(net_stream_t* p_stream);
+
+#endif//__CL_NET_STREAM_H__
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt/rt_api.h"
+#include "telemetry.h"
+
+RT_L2_DATA telemetry_record_t telemetry_staging;
+
+static unsigned int _telemetry_start;
+static unsigned int _telemetry_last;
+
+void telemetry_begin() {
+
+#ifdef HOST
+    // the host counts the cycles without any configuration, only start the counter (if it is not
+    // already running)
+    rt_perf_t _perf;
+    rt_perf_init(&_perf);
+    rt_perf_start(&_perf);
+#else//HOST
+    // Add the cycles to the events of the caller (PCER), and enable the counters (PCMR). rt_perf_conf
+    // and rt_perf_start would replace the events of the caller with the cycles only.
+    unsigned int _events;
+    asm volatile("csrr %0, 0xCC0" : "=r" (_events));
+    _events |= 1 << RT_PERF_CYCLES;
+    asm volatile("csrw 0xCC0, %0" : : "r" (_events));
+    cpu_perf_conf(PCMR_ACTIVE | PCMR_SATURATE);
+#endif//HOST
+
+    for (unsigned int _i = 0; _i < TELEMETRY_NUM_LAYERS; _i++) {
+        telemetry_staging.layer_cycles[_i] = 0;
+    }
+
+    _telemetry_start = rt_perf_read(RT_PERF_CYCLES);
+    _telemetry_last = _telemetry_start;
+}
+
+void telemetry_layer(unsigned int layer) {
+    unsigned int _now = rt_perf_read(RT_PERF_CYCLES);
+    telemetry_staging.layer_cycles[layer] = _now - _telemetry_last;
+    _telemetry_last = _now;
+}
+
+void telemetry_end() {
+    telemetry_staging.cycles = rt_perf_read(RT_PERF_CYCLES) - _telemetry_start;
+}
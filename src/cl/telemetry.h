@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CL_TELEMETRY_H__
+#define __CL_TELEMETRY_H__
+
+#include "rt/rt_api.h"
+
+/**
+ * @brief Number of layers, for which the cycles are recorded separately.
+ *
+ * With FUSE_LAYERS, the fused layer is accounted to layer 1 and layer 2 stays 0. The flip of layer
+ * 1 and 3 (FLIP_LAYERS) is accounted to the corresponding layer.
+ */
+#define TELEMETRY_NUM_LAYERS 5
+
+/**
+ * @brief Telemetry record of a single inference. All fields are 32bit words, such that the record
+ * can be dumped without any conversion (see src/fc/telemetry.h).
+ */
+typedef struct {
+    uint32_t seq;                                // sequence number, assigned by the FC
+    uint32_t timestamp;                          // start of the inference in us, assigned by the FC
+    uint32_t cycles;                             // total number of cluster cycles
+    uint32_t layer_cycles[TELEMETRY_NUM_LAYERS]; // cluster cycles of every layer
+} telemetry_record_t;
+
+/**
+ * @brief Record of the last inference, filled by the cluster and committed by the FC into the ring
+ * buffer (telemetry_commit)
+ */
+extern telemetry_record_t telemetry_staging;
+
+/**
+ * @brief Starts recording a new inference. Must be called by a single core (core 0).
+ *
+ * The cycles are added to the events which are already counted, and the counters are enabled.
+ * Neither the events of the caller are changed, nor are the counters reset, such that the
+ * measurements of the caller (e.g. RT_PERF_INSTR) are not disturbed.
+ */
+void telemetry_begin();
+
+/**
+ * @brief Stores the cycles since the last call of telemetry_layer or telemetry_begin.
+ *
+ * @param layer Index of the layer (0 to TELEMETRY_NUM_LAYERS - 1)
+ */
+void telemetry_layer(unsigned int layer);
+
+/**
+ * @brief Finishes the record, by storing the total number of cycles since telemetry_begin.
+ */
+void telemetry_end();
+
+#endif//__CL_TELEMETRY_H__
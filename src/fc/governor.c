@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt/rt_api.h"
+#include "governor.h"
+
+const governor_point_t governor_default_points[] = {
+    {800, 50},
+    {850, 100},
+    {850, 150},
+    {1000, 200},
+    {1100, 250}
+};
+
+const unsigned int governor_default_num_points = sizeof(governor_default_points) / sizeof(governor_point_t);
+
+/**
+ * @brief Computes the time (in us) needed to switch to the operating point and compute the inference
+ */
+static unsigned int _governor_total_time(const governor_t* p_gov,
+                                         unsigned int index,
+                                         unsigned int cycles) {
+    const governor_point_t* _p_point = p_gov->p_points + index;
+    unsigned int _time = cycles / _p_point->freq;
+    if (_p_point->voltage > p_gov->voltage) {
+        _time += GOVERNOR_SETTLE_US;
+    }
+    return _time;
+}
+
+void governor_init(governor_t* p_gov,
+                   const governor_point_t* p_points,
+                   unsigned int num_points) {
+
+    p_gov->p_points = p_points;
+    p_gov->num_points = num_points;
+    p_gov->num_history = 0;
+    p_gov->history_idx = 0;
+
+    // start at the fastest point, and wait until the voltage is settled
+    p_gov->current = num_points - 1;
+    p_gov->voltage = p_points[num_points - 1].voltage;
+    rt_freq_set(RT_FREQ_DOMAIN_CL, p_points[num_points - 1].freq * 1000000);
+    rt_voltage_force(RT_VOLTAGE_DOMAIN_MAIN, p_gov->voltage, NULL);
+    rt_time_wait_us(GOVERNOR_SETTLE_US);
+}
+
+unsigned int governor_estimate(const governor_t* p_gov) {
+    unsigned int _max = 0;
+    for (unsigned int _i = 0; _i < p_gov->num_history; _i++) {
+        if (p_gov->history[_i] > _max) {
+            _max = p_gov->history[_i];
+        }
+    }
+    return _max / 100 * (100 + GOVERNOR_MARGIN) + (_max % 100) * (100 + GOVERNOR_MARGIN) / 100;
+}
+
+unsigned int governor_select(const governor_t* p_gov,
+                             unsigned int deadline_us) {
+
+    // without any measurement, use the fastest point
+    if (p_gov->num_history == 0) {
+        return p_gov->num_points - 1;
+    }
+
+    unsigned int _cycles = governor_estimate(p_gov);
+
+    unsigned int _best = p_gov->num_points - 1;
+    unsigned int _best_time = 0xFFFFFFFF;
+
+    for (unsigned int _i = 0; _i < p_gov->num_points; _i++) {
+        unsigned int _time = _governor_total_time(p_gov, _i, _cycles);
+        if (_time <= deadline_us) {
+            // points are sorted by frequency, the first feasible point is the slowest one
+            return _i;
+        }
+        if (_time < _best_time) {
+            _best_time = _time;
+            _best = _i;
+        }
+    }
+
+    // no point meets the deadline, take the one with the shortest total time
+    return _best;
+}
+
+void governor_apply(governor_t* p_gov,
+                    unsigned int index) {
+
+    const governor_point_t* _p_point = p_gov->p_points + index;
+
+    if (_p_point->voltage > p_gov->voltage) {
+        // raise the voltage first, and wait until it is settled
+        rt_voltage_force(RT_VOLTAGE_DOMAIN_MAIN, _p_point->voltage, NULL);
+        rt_time_wait_us(GOVERNOR_SETTLE_US);
+        rt_freq_set(RT_FREQ_DOMAIN_CL, _p_point->freq * 1000000);
+    } else {
+        // lower the frequency first, the inference can start before the voltage is settled
+        if (index != p_gov->current) {
+            rt_freq_set(RT_FREQ_DOMAIN_CL, _p_point->freq * 1000000);
+        }
+        if (_p_point->voltage < p_gov->voltage) {
+            rt_voltage_force(RT_VOLTAGE_DOMAIN_MAIN, _p_point->voltage, NULL);
+        }
+    }
+
+    p_gov->voltage = _p_point->voltage;
+    p_gov->current = index;
+}
+
+void governor_update(governor_t* p_gov,
+                     unsigned int cycles) {
+    p_gov->history[p_gov->history_idx] = cycles;
+    p_gov->history_idx = (p_gov->history_idx + 1) % GOVERNOR_HISTORY;
+    if (p_gov->num_history < GOVERNOR_HISTORY) {
+        p_gov->num_history++;
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FC_GOVERNOR_H__
+#define __FC_GOVERNOR_H__
+
+#include "rt/rt_api.h"
+
+/**
+ * @brief Time to wait after changing the voltage, until it is settled (in us).
+ */
+#ifndef GOVERNOR_SETTLE_US
+#define GOVERNOR_SETTLE_US 90000
+#endif//GOVERNOR_SETTLE_US
+
+/**
+ * @brief Safety margin (in percent) added to the estimated number of cycles.
+ */
+#ifndef GOVERNOR_MARGIN
+#define GOVERNOR_MARGIN 10
+#endif//GOVERNOR_MARGIN
+
+/**
+ * @brief Number of past inferences used to estimate the number of cycles (the maximum is used).
+ */
+#ifndef GOVERNOR_HISTORY
+#define GOVERNOR_HISTORY 4
+#endif//GOVERNOR_HISTORY
+
+/**
+ * @brief Operating point of the cluster
+ */
+typedef struct {
+    unsigned int voltage; // voltage in mV
+    unsigned int freq;    // frequency in MHz
+} governor_point_t;
+
+/**
+ * @brief State of the DVFS governor
+ */
+typedef struct {
+    const governor_point_t* p_points;    // operating points, sorted by increasing frequency
+    unsigned int num_points;
+    unsigned int current;                // index of the currently active operating point
+    unsigned int voltage;                // currently forced voltage in mV
+    unsigned int history[GOVERNOR_HISTORY];
+    unsigned int num_history;            // number of valid entries in history
+    unsigned int history_idx;            // next entry in history to be overwritten
+} governor_t;
+
+/**
+ * @brief Operating points used by default (lowest voltage for each frequency, see POWER in main.c)
+ */
+extern const governor_point_t governor_default_points[];
+extern const unsigned int governor_default_num_points;
+
+/**
+ * @brief Initializes the governor and sets the fastest operating point (with waiting for the
+ * voltage to settle).
+ *
+ * @param p_gov Pointer to the governor state
+ * @param p_points Operating points, sorted by increasing frequency (and non-decreasing voltage)
+ * @param num_points Number of operating points
+ */
+void governor_init(governor_t* p_gov,
+                   const governor_point_t* p_points,
+                   unsigned int num_points);
+
+/**
+ * @brief Estimates the number of cycles of the next inference (maximum of the last
+ * GOVERNOR_HISTORY inferences, plus GOVERNOR_MARGIN percent)
+ *
+ * @param p_gov Pointer to the governor state
+ * @returns estimated cycles, or 0 if no inference was measured yet
+ */
+unsigned int governor_estimate(const governor_t* p_gov);
+
+/**
+ * @brief Selects the slowest operating point, which meets the deadline.
+ *
+ * The time to switch to the operating point is included: When the voltage must be raised, the
+ * inference can only start after GOVERNOR_SETTLE_US. Lowering the voltage does not delay the
+ * inference, because the frequency is lowered first. If no inference was measured yet, the
+ * fastest point is selected. If no point meets the deadline, the point with the lowest total time
+ * is selected.
+ *
+ * @param p_gov Pointer to the governor state
+ * @param deadline_us Time (in us) until the inference must be completed, starting now
+ * @returns index of the selected operating point
+ */
+unsigned int governor_select(const governor_t* p_gov,
+                             unsigned int deadline_us);
+
+/**
+ * @brief Switches to the operating point.
+ *
+ * When raising the voltage, the voltage is changed first, and the frequency is only changed after
+ * the voltage has settled. When lowering the voltage, the frequency is changed first.
+ *
+ * @param p_gov Pointer to the governor state
+ * @param index Index of the operating point
+ */
+void governor_apply(governor_t* p_gov,
+                    unsigned int index);
+
+/**
+ * @brief Stores the number of cycles of the last inference
+ *
+ * @param p_gov Pointer to the governor state
+ * @param cycles Number of cluster cycles used for the last inference
+ */
+void governor_update(governor_t* p_gov,
+                     unsigned int cycles);
+
+#endif//__FC_GOVERNOR_H__
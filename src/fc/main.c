@@ -23,12 +23,34 @@
 #include "stdio.h"
 #include "../cl/cluster.h"
 
+#ifdef GOVERNOR
+#include "governor.h"
+
+// time between two classifications (and deadline of each classification) in us
+#ifndef GOVERNOR_PERIOD_US
+#define GOVERNOR_PERIOD_US 100000
+#endif//GOVERNOR_PERIOD_US
+
+// number of classifications to compute
+#ifndef GOVERNOR_NUM_WINDOWS
+#define GOVERNOR_NUM_WINDOWS 16
+#endif//GOVERNOR_NUM_WINDOWS
+#endif//GOVERNOR
+
+#ifdef TELEMETRY
+#include "telemetry.h"
+#endif//TELEMETRY
+
 /** 
  * \brief Fabric main
  */
 int main(void)
 {
 
+#ifdef TELEMETRY
+    telemetry_init();
+#endif//TELEMETRY
+
 #ifdef POWER
 
     //SEQ
@@ -63,9 +85,17 @@ int main(void)
             // mount the cluster, and wait until the cluster is mounted
             rt_cluster_mount(1, 0, 0, NULL);
 
+#ifdef TELEMETRY
+            unsigned int timestamp = rt_time_get_us();
+#endif//TELEMETRY
+
             // call the cluster entry point, and wait unitl it is finished
             rt_cluster_call(NULL, 0, cluster_entry, NULL, NULL, 0, 0, 0, NULL);
 
+#ifdef TELEMETRY
+            telemetry_commit(timestamp);
+#endif//TELEMETRY
+
             // unmount the cluster
             rt_cluster_mount(0, 0, 0, NULL);
 
@@ -74,8 +104,61 @@ int main(void)
 
         }
 
+#ifdef TELEMETRY
+        // dump the telemetry after every sweep (outside of the measurement)
+        telemetry_dump();
+#endif//TELEMETRY
+
+    }
+
+#elif defined(GOVERNOR)
+
+    // The FC shares the voltage domain with the cluster, keep it at a frequency which is supported
+    // by the lowest voltage.
+    rt_freq_set(RT_FREQ_DOMAIN_FC, 50000000);
+
+    printf("fc::main::main (governor)\n");
+
+    governor_t gov;
+    governor_init(&gov, governor_default_points, governor_default_num_points);
+
+    // mount the cluster, and wait until the cluster is mounted
+    rt_cluster_mount(1, 0, 0, NULL);
+
+    for (unsigned int i = 0; i < GOVERNOR_NUM_WINDOWS; i++) {
+
+        unsigned int start = rt_time_get_us();
+
+        // select and switch to the slowest operating point which meets the deadline
+        unsigned int point = governor_select(&gov, GOVERNOR_PERIOD_US);
+        governor_apply(&gov, point);
+
+        // call the cluster entry point, and wait unitl it is finished
+        rt_cluster_call(NULL, 0, cluster_entry, NULL, NULL, 0, 0, 0, NULL);
+
+        governor_update(&gov, cluster_cycles);
+
+#ifdef TELEMETRY
+        telemetry_commit(start);
+#endif//TELEMETRY
+
+        unsigned int elapsed = rt_time_get_us() - start;
+        printf("window %d: %d mV, %d MHz, %d cycles, %d us\n", i, gov.p_points[point].voltage,
+               gov.p_points[point].freq, cluster_cycles, elapsed);
+
+        // wait for the next window
+        if (elapsed < GOVERNOR_PERIOD_US) {
+            rt_time_wait_us(GOVERNOR_PERIOD_US - elapsed);
+        }
     }
 
+    // unmount the cluster
+    rt_cluster_mount(0, 0, 0, NULL);
+
+#ifdef TELEMETRY
+    telemetry_dump();
+#endif//TELEMETRY
+
 #else//POWER
 
     // change the clock frequency
@@ -92,12 +175,24 @@ int main(void)
     // mount the cluster, and wait until the cluster is mounted
     rt_cluster_mount(1, 0, 0, NULL);
 
+#ifdef TELEMETRY
+    unsigned int timestamp = rt_time_get_us();
+#endif//TELEMETRY
+
     // call the cluster entry point, and wait unitl it is finished
     rt_cluster_call(NULL, 0, cluster_entry, NULL, NULL, 0, 0, 0, NULL);
 
+#ifdef TELEMETRY
+    telemetry_commit(timestamp);
+#endif//TELEMETRY
+
     // unmount the cluster
     rt_cluster_mount(0, 0, 0, NULL);
 
+#ifdef TELEMETRY
+    telemetry_dump();
+#endif//TELEMETRY
+
 #endif//POWER
 
 
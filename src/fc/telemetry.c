@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rt/rt_api.h"
+#include "stdio.h"
+#include "telemetry.h"
+
+RT_L2_DATA static telemetry_record_t _telemetry_ring[TELEMETRY_CAPACITY];
+static unsigned int _telemetry_count;
+
+static unsigned int _telemetry_line_len;
+static uint32_t _telemetry_checksum;
+
+/**
+ * @brief Writes a single word of the dump, and starts a new line if necessary
+ */
+static void _telemetry_write(uint32_t word) {
+    if (_telemetry_line_len == 0) {
+        printf("#TLM ");
+    }
+    printf("%08x", (unsigned int)word);
+    _telemetry_checksum += word;
+    _telemetry_line_len++;
+    if (_telemetry_line_len == TELEMETRY_LINE_WORDS) {
+        printf("\n");
+        _telemetry_line_len = 0;
+    }
+}
+
+void telemetry_init() {
+    _telemetry_count = 0;
+}
+
+void telemetry_commit(unsigned int timestamp) {
+    telemetry_record_t* _p_record = _telemetry_ring + (_telemetry_count % TELEMETRY_CAPACITY);
+    *_p_record = telemetry_staging;
+    _p_record->seq = _telemetry_count;
+    _p_record->timestamp = timestamp;
+    _telemetry_count++;
+}
+
+void telemetry_dump() {
+
+    unsigned int _num_records = _telemetry_count;
+    unsigned int _first = 0;
+    if (_num_records > TELEMETRY_CAPACITY) {
+        _first = _telemetry_count - TELEMETRY_CAPACITY;
+        _num_records = TELEMETRY_CAPACITY;
+    }
+
+    _telemetry_line_len = 0;
+    _telemetry_checksum = 0;
+
+    // header
+    _telemetry_write(TELEMETRY_MAGIC);
+    _telemetry_write((TELEMETRY_VERSION << 16) | (TELEMETRY_NUM_LAYERS << 8) | TELEMETRY_RECORD_WORDS);
+    _telemetry_write(_telemetry_count);
+    _telemetry_write(_num_records);
+
+    // records, oldest first
+    for (unsigned int _i = _first; _i < _first + _num_records; _i++) {
+        const uint32_t* _p_words = (const uint32_t*)(_telemetry_ring + (_i % TELEMETRY_CAPACITY));
+        for (unsigned int _k = 0; _k < TELEMETRY_RECORD_WORDS; _k++) {
+            _telemetry_write(_p_words[_k]);
+        }
+    }
+
+    // checksum (not part of the sum itself)
+    _telemetry_write(_telemetry_checksum);
+    if (_telemetry_line_len != 0) {
+        printf("\n");
+    }
+}
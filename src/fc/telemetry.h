@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FC_TELEMETRY_H__
+#define __FC_TELEMETRY_H__
+
+#include "rt/rt_api.h"
+#include "../cl/telemetry.h"
+
+/**
+ * @brief Number of records in the ring buffer (on L2). Every record takes
+ * 4 * (3 + TELEMETRY_NUM_LAYERS) bytes.
+ */
+#ifndef TELEMETRY_CAPACITY
+#define TELEMETRY_CAPACITY 64
+#endif//TELEMETRY_CAPACITY
+
+/**
+ * @brief Number of 32bit words printed in a single line of the dump.
+ */
+#ifndef TELEMETRY_LINE_WORDS
+#define TELEMETRY_LINE_WORDS 16
+#endif//TELEMETRY_LINE_WORDS
+
+#define TELEMETRY_MAGIC 0x54454c45
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_RECORD_WORDS (sizeof(telemetry_record_t) / sizeof(uint32_t))
+
+/**
+ * @brief Clears the ring buffer
+ */
+void telemetry_init();
+
+/**
+ * @brief Copies the record of the last inference (telemetry_staging, filled by the cluster) into
+ * the ring buffer, overwriting the oldest record if the buffer is full. Call this after the cluster
+ * has finished.
+ *
+ * @param timestamp Time in us, at which the inference was started (rt_time_get_us)
+ */
+void telemetry_commit(unsigned int timestamp);
+
+/**
+ * @brief Dumps all records of the ring buffer (oldest first) over UART (stdout). The records are
+ * not removed.
+ *
+ * The dump is a sequence of 32bit words:
+ *
+ * | word | content                                                   |
+ * |------|-----------------------------------------------------------|
+ * | 0    | TELEMETRY_MAGIC                                           |
+ * | 1    | version << 16 \| TELEMETRY_NUM_LAYERS << 8 \| record size |
+ * | 2    | total number of committed records                         |
+ * | 3    | number of records in this dump (n)                        |
+ * | 4... | n records (telemetry_record_t), each record size words    |
+ * | last | checksum: sum of all previous words (modulo 2^32)         |
+ *
+ * Since printf is line-based, the words are written in hex, TELEMETRY_LINE_WORDS words per line,
+ * and every line starts with "#TLM ". Use python_utils/telemetry.py to decode it.
+ *
+ * The dump is not triggered on demand (there is no command or GPIO handler): src/fc/main.c only
+ * dumps at fixed points, after every sweep over the operating points (POWER), and after the last
+ * inference. To get a dump at another time, call this function there.
+ */
+void telemetry_dump();
+
+#endif//__FC_TELEMETRY_H__
@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif//__AVX2__
+#include "engine.h"
+#include "pool.h"
+#include "../../cl/net/net.h"
+
+#if NET_L1_WEIGHT_LEN % 2 != 0 || NET_L3_WEIGHT_LEN % 2 != 0
+#error "The filters of layer 1 and 3 must have an even length"
+#endif
+
+// layer 2 applies the batch norm after the pooling (the fused layer always does this)
+#if defined(FUSE_LAYERS) || defined(REORDER_BN)
+#define _ENGINE_L2_REORDER_BN 1
+#else
+#define _ENGINE_L2_REORDER_BN 0
+#endif
+
+#ifdef REORDER_BN
+#define _ENGINE_L4_REORDER_BN 1
+#else
+#define _ENGINE_L4_REORDER_BN 0
+#endif
+
+// the result of layer 1 is not scaled (only possible in the fused layer)
+#if defined(FUSE_LAYERS) && defined(NO_INTERMEDIATE_SCALE)
+#define _ENGINE_NO_INTERMEDIATE_SCALE
+#endif
+
+// number of samples of layer 1 and 3, which are used by the pooling in layer 2 and 4
+#define _ENGINE_L1_OUT_LEN (NET_T8 * 8)
+#define _ENGINE_L3_POOL_LEN (NET_T64 * 8)
+
+// parameters inside the packed blocks of net.h
+#define _ENGINE_L1_FACTOR (net_l1_params + NET_L1_PARAMS_FACTOR)
+#define _ENGINE_L1_OFFSET (net_l1_params + NET_L1_PARAMS_OFFSET)
+#define _ENGINE_L1_WEIGHT ((const int8_t*)(net_l1_params + NET_L1_PARAMS_WEIGHT))
+#define _ENGINE_L2_FACTOR (net_l2_params + NET_L2_PARAMS_FACTOR)
+#define _ENGINE_L2_OFFSET (net_l2_params + NET_L2_PARAMS_OFFSET)
+#define _ENGINE_L2_WEIGHT ((const int8_t*)(net_l2_params + NET_L2_PARAMS_WEIGHT))
+#define _ENGINE_L4_FACTOR (net_l4_params + NET_L4_PARAMS_FACTOR)
+#define _ENGINE_L4_OFFSET (net_l4_params + NET_L4_PARAMS_OFFSET)
+#define _ENGINE_L4_WEIGHT ((const int8_t*)(net_l4_params + NET_L4_PARAMS_WEIGHT))
+#define _ENGINE_L5_BIAS ((const int8_t*)(net_l5_params + NET_L5_PARAMS_BIAS))
+#define _ENGINE_L5_WEIGHT ((const int8_t*)(net_l5_params + NET_L5_PARAMS_WEIGHT))
+
+struct engine_workspace_s {
+    int16_t l1_input[NET_C][NET_L1_PAD_INPUT_LEN];
+    int32_t l1_output[NET_C][_ENGINE_L1_OUT_LEN];
+    int32_t l2_conv[_ENGINE_L1_OUT_LEN];
+    int32_t l2_output[NET_F2][NET_T8];
+    int16_t l3_input[NET_L3_PAD_INPUT_LEN];
+    int32_t l3_conv[NET_T8];
+    int32_t l3_output[NET_F2][NET_T8];
+    int32_t l4_conv[_ENGINE_L3_POOL_LEN];
+    int32_t l4_output[NET_F2][NET_T64];
+};
+
+// weights of net.h, sign extended, such that all layers can be computed as cross correlations or
+// dot products
+static int16_t _engine_w1[NET_F1][NET_L1_WEIGHT_LEN];
+static int32_t _engine_w2[NET_F2][NET_C];
+static int16_t _engine_w3[NET_F2][NET_L3_WEIGHT_LEN];
+static int32_t _engine_w4[NET_F2][NET_F2];
+static pthread_once_t _engine_once = PTHREAD_ONCE_INIT;
+
+static void _engine_init_weights() {
+    for (int _k = 0; _k < NET_F1; _k++) {
+        for (int _j = 0; _j < NET_L1_WEIGHT_LEN; _j++) {
+            _engine_w1[_k][_j] = _ENGINE_L1_WEIGHT[_k * NET_L1_WEIGHT_LEN_ALIGN + _j];
+        }
+    }
+    for (int _k = 0; _k < NET_F2; _k++) {
+        // the weights of layer 2 are already stored in reverse order
+        for (int _ch = 0; _ch < NET_C; _ch++) {
+            _engine_w2[_k][_ch] = _ENGINE_L2_WEIGHT[_k * NET_L2_WEIGHT_LEN + _ch];
+        }
+        // layer 3 is a convolution, reverse the filter
+        for (int _j = 0; _j < NET_L3_WEIGHT_LEN; _j++) {
+            _engine_w3[_k][_j] = net_l3_weight[(_k + 1) * NET_L3_WEIGHT_LEN - 1 - _j];
+        }
+        for (int _i = 0; _i < NET_F2; _i++) {
+            _engine_w4[_k][_i] = _ENGINE_L4_WEIGHT[_k * NET_L4_WEIGHT_LEN + _i];
+        }
+    }
+}
+
+static inline int32_t _engine_clip(int32_t x) {
+    return x < -128 ? -128 : (x > 127 ? 127 : x);
+}
+
+/**
+ * @brief Cross correlation (valid): p_y[t] = offset + sum_j p_x[t + j] * p_w[j], for t in [0, len)
+ *
+ * @param p_x Input signal of length len + w_len - 1
+ * @param p_w Filter of length w_len, must be even
+ * @param w_len Length of the filter
+ * @param offset Initial value of every output
+ * @param len Number of outputs
+ * @param p_y Output of length len
+ */
+static void _engine_xcorr(const int16_t* p_x, const int16_t* p_w, unsigned int w_len,
+                          int32_t offset, unsigned int len, int32_t* p_y) {
+
+    unsigned int _t = 0;
+
+#ifdef __AVX2__
+    // compute 16 outputs at once. The pairs (x[t + j], x[t + j + 1]) are multiplied with the pair
+    // (w[j], w[j + 1]) and summed up with a single madd
+    for (; _t + 16 <= len; _t += 16) {
+        __m256i _acc_lo = _mm256_set1_epi32(offset);
+        __m256i _acc_hi = _acc_lo;
+        for (unsigned int _j = 0; _j < w_len; _j += 2) {
+            __m256i _x0 = _mm256_loadu_si256((const __m256i*)(p_x + _t + _j));
+            __m256i _x1 = _mm256_loadu_si256((const __m256i*)(p_x + _t + _j + 1));
+            __m256i _w = _mm256_set1_epi32((uint16_t)p_w[_j] | ((uint32_t)(uint16_t)p_w[_j + 1] << 16));
+            _acc_lo = _mm256_add_epi32(_acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(_x0, _x1), _w));
+            _acc_hi = _mm256_add_epi32(_acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(_x0, _x1), _w));
+        }
+        // _acc_lo contains the outputs 0..3 and 8..11, _acc_hi contains 4..7 and 12..15
+        _mm256_storeu_si256((__m256i*)(p_y + _t), _mm256_permute2x128_si256(_acc_lo, _acc_hi, 0x20));
+        _mm256_storeu_si256((__m256i*)(p_y + _t + 8), _mm256_permute2x128_si256(_acc_lo, _acc_hi, 0x31));
+    }
+#endif//__AVX2__
+
+    for (; _t < len; _t++) {
+        int32_t _acc = offset;
+        for (unsigned int _j = 0; _j < w_len; _j++) {
+            _acc += p_x[_t + _j] * p_w[_j];
+        }
+        p_y[_t] = _acc;
+    }
+}
+
+/**
+ * @brief Dot product over the channels: p_y[t] = sum_ch p_x[ch * stride + t] * p_w[ch]
+ *
+ * @param p_x Input of shape [num_ch, stride]
+ * @param stride Number of elements in a row of p_x
+ * @param num_ch Number of channels
+ * @param p_w Weight vector of length num_ch
+ * @param len Number of outputs (len <= stride)
+ * @param p_y Output of length len
+ */
+static void _engine_dotp_channels(const int32_t* p_x, unsigned int stride, unsigned int num_ch,
+                                  const int32_t* p_w, unsigned int len, int32_t* p_y) {
+
+    unsigned int _t = 0;
+
+#ifdef __AVX2__
+    for (; _t + 8 <= len; _t += 8) {
+        __m256i _acc = _mm256_setzero_si256();
+        for (unsigned int _ch = 0; _ch < num_ch; _ch++) {
+            __m256i _x = _mm256_loadu_si256((const __m256i*)(p_x + _ch * stride + _t));
+            _acc = _mm256_add_epi32(_acc, _mm256_mullo_epi32(_x, _mm256_set1_epi32(p_w[_ch])));
+        }
+        _mm256_storeu_si256((__m256i*)(p_y + _t), _acc);
+    }
+#endif//__AVX2__
+
+    for (; _t < len; _t++) {
+        int32_t _acc = 0;
+        for (unsigned int _ch = 0; _ch < num_ch; _ch++) {
+            _acc += p_x[_ch * stride + _t] * p_w[_ch];
+        }
+        p_y[_t] = _acc;
+    }
+}
+
+/**
+ * @brief ReLU, sum pooling over 8 samples and batch norm of a single channel, like layer 2 and 4
+ *
+ * @param p_x Input of length num_out * 8
+ * @param num_out Number of outputs
+ * @param factor Division factor of the batch norm (for the sum of 8 samples)
+ * @param offset Offset of the batch norm (for the sum of 8 samples)
+ * @param reorder_bn If 1, the batch norm is applied after pooling (REORDER_BN)
+ * @param p_y Output of length num_out
+ */
+static void _engine_relu_pool_bn(const int32_t* p_x, unsigned int num_out, int32_t factor,
+                                 int32_t offset, int reorder_bn, int32_t* p_y) {
+
+    int32_t _threshold = -(offset >> 3);
+    if (!reorder_bn) {
+        factor = factor >> 3;
+        offset = offset >> 3;
+    }
+
+    for (unsigned int _t_out = 0; _t_out < num_out; _t_out++) {
+        int32_t _sum = 0;
+        for (unsigned int _t_pool = 0; _t_pool < 8; _t_pool++) {
+            int32_t _elem = *(p_x++);
+            if (reorder_bn) {
+                _elem = _elem > _threshold ? _elem : _threshold;
+            } else {
+                _elem = (_elem + offset) / factor;
+                _elem = _elem > 0 ? _elem : 0;
+            }
+            _sum += _elem;
+        }
+        if (reorder_bn) {
+            _sum = (_sum + offset) / factor;
+        } else {
+            _sum = _sum >> 3;
+        }
+        p_y[_t_out] = _engine_clip(_sum);
+    }
+}
+
+/**
+ * @brief Layer 1 and 2: convolution in time, batch norm, convolution in space, ReLU, pooling and
+ * batch norm
+ */
+static void _engine_layer_1_2(const int8_t* p_data, engine_workspace_t* p_ws) {
+
+    // sign extend and pad the input
+    memset(p_ws->l1_input, 0, sizeof(p_ws->l1_input));
+    for (int _ch = 0; _ch < NET_C; _ch++) {
+        for (int _t = 0; _t < NET_T; _t++) {
+            p_ws->l1_input[_ch][NET_L1_PAD_START + _t] = p_data[_ch * NET_T + _t];
+        }
+    }
+
+    for (int _k = 0; _k < NET_F1; _k++) {
+
+        int32_t _factor_l1 = _ENGINE_L1_FACTOR[_k];
+        int32_t _offset_l1 = _ENGINE_L1_OFFSET[_k];
+
+        // layer 1 (only the samples which are used in layer 2)
+        for (int _ch = 0; _ch < NET_C; _ch++) {
+            _engine_xcorr(p_ws->l1_input[_ch], _engine_w1[_k], NET_L1_WEIGHT_LEN, _offset_l1,
+                          _ENGINE_L1_OUT_LEN, p_ws->l1_output[_ch]);
+#ifndef _ENGINE_NO_INTERMEDIATE_SCALE
+            for (int _t = 0; _t < _ENGINE_L1_OUT_LEN; _t++) {
+                p_ws->l1_output[_ch][_t] = _engine_clip(p_ws->l1_output[_ch][_t] / _factor_l1);
+            }
+#endif//_ENGINE_NO_INTERMEDIATE_SCALE
+        }
+
+        // layer 2, for all filters which use this spectral filter
+        for (int _d = 0; _d < NET_D; _d++) {
+            int _k2 = _k * NET_D + _d;
+#ifdef _ENGINE_NO_INTERMEDIATE_SCALE
+            int32_t _factor = _ENGINE_L2_FACTOR[_k2] * _factor_l1;
+            int32_t _offset = _ENGINE_L2_OFFSET[_k2] * _factor_l1;
+#else//_ENGINE_NO_INTERMEDIATE_SCALE
+            int32_t _factor = _ENGINE_L2_FACTOR[_k2];
+            int32_t _offset = _ENGINE_L2_OFFSET[_k2];
+#endif//_ENGINE_NO_INTERMEDIATE_SCALE
+            _engine_dotp_channels(&p_ws->l1_output[0][0], _ENGINE_L1_OUT_LEN, NET_C, _engine_w2[_k2],
+                                  _ENGINE_L1_OUT_LEN, p_ws->l2_conv);
+            _engine_relu_pool_bn(p_ws->l2_conv, NET_T8, _factor, _offset, _ENGINE_L2_REORDER_BN,
+                                 p_ws->l2_output[_k2]);
+        }
+    }
+}
+
+/**
+ * @brief Layer 3: depthwise convolution in time
+ */
+static void _engine_layer_3(engine_workspace_t* p_ws) {
+
+    memset(p_ws->l3_input, 0, sizeof(p_ws->l3_input));
+
+    for (int _k = 0; _k < NET_F2; _k++) {
+        for (int _t = 0; _t < NET_T8; _t++) {
+            p_ws->l3_input[NET_L3_PAD_START + _t] = p_ws->l2_output[_k][_t];
+        }
+        _engine_xcorr(p_ws->l3_input, _engine_w3[_k], NET_L3_WEIGHT_LEN, 0, NET_T8, p_ws->l3_conv);
+        for (int _t = 0; _t < NET_T8; _t++) {
+            p_ws->l3_output[_k][_t] = _engine_clip(p_ws->l3_conv[_t] / NET_L3_FACTOR);
+        }
+    }
+}
+
+/**
+ * @brief Layer 4: pointwise convolution, ReLU, pooling and batch norm
+ */
+static void _engine_layer_4(engine_workspace_t* p_ws) {
+    for (int _k = 0; _k < NET_F2; _k++) {
+        _engine_dotp_channels(&p_ws->l3_output[0][0], NET_T8, NET_F2, _engine_w4[_k],
+                              _ENGINE_L3_POOL_LEN, p_ws->l4_conv);
+        _engine_relu_pool_bn(p_ws->l4_conv, NET_T64, _ENGINE_L4_FACTOR[_k], _ENGINE_L4_OFFSET[_k],
+                             _ENGINE_L4_REORDER_BN, p_ws->l4_output[_k]);
+    }
+}
+
+/**
+ * @brief Layer 5: linear layer
+ */
+static void _engine_layer_5(engine_workspace_t* p_ws, int8_t* p_output) {
+    for (int _n = 0; _n < NET_N; _n++) {
+        const int8_t* _p_weight = _ENGINE_L5_WEIGHT + _n * NET_L5_WEIGHT_LEN;
+        int32_t _acc = 0;
+        for (int _k = 0; _k < NET_F2; _k++) {
+            for (int _t = 0; _t < NET_T64; _t++) {
+                _acc += p_ws->l4_output[_k][_t] * _p_weight[_k * NET_T64_ALIGN + _t];
+            }
+        }
+        _acc += _ENGINE_L5_BIAS[_n];
+        p_output[_n] = _engine_clip(_acc / NET_L5_FACTOR);
+    }
+}
+
+engine_workspace_t* engine_workspace_alloc() {
+    void* _p_ws = NULL;
+    if (posix_memalign(&_p_ws, 64, sizeof(engine_workspace_t)) != 0) {
+        return NULL;
+    }
+    return _p_ws;
+}
+
+void engine_workspace_free(engine_workspace_t* p_ws) {
+    free(p_ws);
+}
+
+void engine_compute(const int8_t* p_data, int8_t* p_output, engine_workspace_t* p_ws) {
+
+    pthread_once(&_engine_once, _engine_init_weights);
+
+    _engine_layer_1_2(p_data, p_ws);
+    _engine_layer_3(p_ws);
+    _engine_layer_4(p_ws);
+    _engine_layer_5(p_ws, p_output);
+}
+
+typedef struct {
+    const int8_t* p_data;
+    int8_t* p_output;
+    engine_workspace_t** p_ws;
+} _engine_batch_t;
+
+static void _engine_batch_task(void* arg, unsigned int thread_id, unsigned int index) {
+    _engine_batch_t* _p_batch = arg;
+    engine_compute(_p_batch->p_data + (size_t)index * NET_C * NET_T,
+                   _p_batch->p_output + (size_t)index * NET_N,
+                   _p_batch->p_ws[thread_id]);
+}
+
+int engine_compute_batch(const int8_t* p_data, unsigned int num_trials, int8_t* p_output,
+                         unsigned int num_threads) {
+
+    if (num_threads > num_trials) {
+        num_threads = num_trials;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    _engine_batch_t _batch;
+    _batch.p_data = p_data;
+    _batch.p_output = p_output;
+    _batch.p_ws = calloc(num_threads, sizeof(engine_workspace_t*));
+    if (_batch.p_ws == NULL) {
+        return -1;
+    }
+
+    int _status = 0;
+    for (unsigned int _i = 0; _i < num_threads; _i++) {
+        _batch.p_ws[_i] = engine_workspace_alloc();
+        if (_batch.p_ws[_i] == NULL) {
+            _status = -1;
+        }
+    }
+
+    if (_status == 0) {
+        _status = engine_pool_run(num_trials, num_threads, _engine_batch_task, &_batch);
+    }
+
+    for (unsigned int _i = 0; _i < num_threads; _i++) {
+        engine_workspace_free(_batch.p_ws[_i]);
+    }
+    free(_batch.p_ws);
+    return _status;
+}
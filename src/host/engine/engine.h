@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host inference engine: integer EEGNet for offline scoring of datasets on a server (x86_64).
+ *
+ * The engine computes exactly the same output as net_model_compute on the device, with the same
+ * configuration (FUSE_LAYERS, NO_INTERMEDIATE_SCALE and REORDER_BN change the arithmetic, all other
+ * options only change the speed on the device). It uses the weights and the scaling factors of
+ * src/cl/net/net.h, but it does not depend on the PULP runtime. The dot products are vectorized
+ * with AVX2, if the compiler targets it (-mavx2), and batches of trials are distributed on multiple
+ * threads (see pool.h). Build it with the Makefile in this directory.
+ */
+
+#ifndef __HOST_ENGINE_ENGINE_H__
+#define __HOST_ENGINE_ENGINE_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Trial file: header (engine_trial_header_t) followed by num_trials trials of type int8_t
+ * and shape [num_channels, num_samples], already quantized (see python_utils/trial_file.py).
+ */
+#define ENGINE_TRIAL_MAGIC 0x4c495254
+
+typedef struct {
+    uint32_t magic;
+    uint32_t num_trials;
+    uint32_t num_channels;
+    uint32_t num_samples;
+} engine_trial_header_t;
+
+/**
+ * @brief Intermediate featuremaps of a single trial. Every thread needs its own workspace.
+ */
+typedef struct engine_workspace_s engine_workspace_t;
+
+/**
+ * @brief Allocates a workspace
+ *
+ * @returns Pointer to the workspace, or NULL if there is not enough memory
+ */
+engine_workspace_t* engine_workspace_alloc();
+
+/**
+ * @brief Frees a workspace allocated with engine_workspace_alloc
+ */
+void engine_workspace_free(engine_workspace_t* p_ws);
+
+/**
+ * @brief Computes the output of the network for a single trial, bit-exact to net_model_compute
+ *
+ * @param p_data Pointer to the input data of shape [NET_C, NET_T] (neither aligned nor padded)
+ * @param p_output Pointer to the output data of shape [NET_N]
+ * @param p_ws Workspace, which is not used by any other thread at the same time
+ */
+void engine_compute(const int8_t* p_data, int8_t* p_output, engine_workspace_t* p_ws);
+
+/**
+ * @brief Computes the output of the network for a batch of trials on multiple threads
+ *
+ * @param p_data Pointer to the input data of shape [num_trials, NET_C, NET_T]
+ * @param num_trials Number of trials
+ * @param p_output Pointer to the output data of shape [num_trials, NET_N]
+ * @param num_threads Number of threads (at least 1)
+ *
+ * @returns 0 on success, -1 if there is not enough memory
+ */
+int engine_compute_batch(const int8_t* p_data, unsigned int num_trials, int8_t* p_output,
+                         unsigned int num_threads);
+
+#endif//__HOST_ENGINE_ENGINE_H__
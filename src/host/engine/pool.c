@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "pool.h"
+
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned int begin;
+    unsigned int end;
+} _engine_pool_range_t;
+
+typedef struct {
+    _engine_pool_range_t* p_ranges;
+    unsigned int num_threads;
+    engine_task_t task;
+    void* arg;
+} _engine_pool_t;
+
+typedef struct {
+    _engine_pool_t* p_pool;
+    unsigned int thread_id;
+} _engine_pool_worker_t;
+
+/**
+ * @brief Takes the first index of the range
+ *
+ * @returns 1 if an index was taken, 0 if the range is empty
+ */
+static int _engine_pool_pop(_engine_pool_range_t* p_range, unsigned int* p_index) {
+    int _found = 0;
+    pthread_mutex_lock(&p_range->lock);
+    if (p_range->begin < p_range->end) {
+        *p_index = p_range->begin++;
+        _found = 1;
+    }
+    pthread_mutex_unlock(&p_range->lock);
+    return _found;
+}
+
+/**
+ * @brief Moves the upper half of the remaining range of another thread into the (empty) range of
+ * this thread.
+ *
+ * @returns 1 if some work was stolen, 0 if all other ranges are empty
+ */
+static int _engine_pool_steal(_engine_pool_t* p_pool, unsigned int thread_id) {
+
+    _engine_pool_range_t* _p_own = p_pool->p_ranges + thread_id;
+
+    for (unsigned int _i = 1; _i < p_pool->num_threads; _i++) {
+        _engine_pool_range_t* _p_victim = p_pool->p_ranges + (thread_id + _i) % p_pool->num_threads;
+
+        pthread_mutex_lock(&_p_victim->lock);
+        if (_p_victim->begin < _p_victim->end) {
+            unsigned int _num = (_p_victim->end - _p_victim->begin + 1) / 2;
+            unsigned int _begin = _p_victim->end - _num;
+            _p_victim->end = _begin;
+            pthread_mutex_unlock(&_p_victim->lock);
+
+            pthread_mutex_lock(&_p_own->lock);
+            _p_own->begin = _begin;
+            _p_own->end = _begin + _num;
+            pthread_mutex_unlock(&_p_own->lock);
+            return 1;
+        }
+        pthread_mutex_unlock(&_p_victim->lock);
+    }
+    return 0;
+}
+
+static void* _engine_pool_worker(void* arg) {
+
+    _engine_pool_worker_t* _p_worker = arg;
+    _engine_pool_t* _p_pool = _p_worker->p_pool;
+    _engine_pool_range_t* _p_own = _p_pool->p_ranges + _p_worker->thread_id;
+    unsigned int _index;
+
+    do {
+        while (_engine_pool_pop(_p_own, &_index)) {
+            _p_pool->task(_p_pool->arg, _p_worker->thread_id, _index);
+        }
+    } while (_engine_pool_steal(_p_pool, _p_worker->thread_id));
+
+    return NULL;
+}
+
+int engine_pool_run(unsigned int num_tasks, unsigned int num_threads, engine_task_t task,
+                    void* arg) {
+
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    _engine_pool_t _pool;
+    _pool.num_threads = num_threads;
+    _pool.task = task;
+    _pool.arg = arg;
+    _pool.p_ranges = malloc(sizeof(_engine_pool_range_t) * num_threads);
+
+    _engine_pool_worker_t* _p_workers = malloc(sizeof(_engine_pool_worker_t) * num_threads);
+    pthread_t* _p_threads = malloc(sizeof(pthread_t) * num_threads);
+    int* _p_started = calloc(num_threads, sizeof(int));
+
+    if (_pool.p_ranges == NULL || _p_workers == NULL || _p_threads == NULL || _p_started == NULL) {
+        free(_pool.p_ranges);
+        free(_p_workers);
+        free(_p_threads);
+        free(_p_started);
+        return -1;
+    }
+
+    // split the tasks into contiguous ranges of (almost) equal size
+    for (unsigned int _t = 0; _t < num_threads; _t++) {
+        pthread_mutex_init(&_pool.p_ranges[_t].lock, NULL);
+        _pool.p_ranges[_t].begin = (unsigned int)(((unsigned long long)num_tasks * _t) / num_threads);
+        _pool.p_ranges[_t].end = (unsigned int)(((unsigned long long)num_tasks * (_t + 1)) / num_threads);
+        _p_workers[_t].p_pool = &_pool;
+        _p_workers[_t].thread_id = _t;
+    }
+
+    for (unsigned int _t = 1; _t < num_threads; _t++) {
+        _p_started[_t] = pthread_create(_p_threads + _t, NULL, _engine_pool_worker, _p_workers + _t) == 0;
+    }
+
+    // the calling thread is thread 0
+    _engine_pool_worker(_p_workers);
+
+    for (unsigned int _t = 1; _t < num_threads; _t++) {
+        if (_p_started[_t]) {
+            pthread_join(_p_threads[_t], NULL);
+        }
+    }
+
+    for (unsigned int _t = 0; _t < num_threads; _t++) {
+        pthread_mutex_destroy(&_pool.p_ranges[_t].lock);
+    }
+
+    free(_pool.p_ranges);
+    free(_p_workers);
+    free(_p_threads);
+    free(_p_started);
+    return 0;
+}
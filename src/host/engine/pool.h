@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HOST_ENGINE_POOL_H__
+#define __HOST_ENGINE_POOL_H__
+
+/**
+ * @brief Task executed by the pool
+ *
+ * @param arg Argument passed to engine_pool_run
+ * @param thread_id Index of the thread, in [0, num_threads)
+ * @param index Index of the task, in [0, num_tasks)
+ */
+typedef void (*engine_task_t)(void* arg, unsigned int thread_id, unsigned int index);
+
+/**
+ * @brief Executes the task for every index in [0, num_tasks) on num_threads threads, and returns
+ * when all tasks are finished. The calling thread is used as thread 0.
+ *
+ * Every thread starts with a contiguous range of indices, which it processes from the front. When
+ * its range is empty, it steals the upper half of the remaining range of another thread. Hence,
+ * the load is balanced even if some tasks take longer than others (or if some threads are
+ * preempted), while the threads rarely touch the same data.
+ *
+ * @param num_tasks Number of tasks
+ * @param num_threads Number of threads (at least 1)
+ * @param task Function to execute
+ * @param arg Argument passed to the task
+ *
+ * @returns 0 on success, -1 if there is not enough memory. If some threads cannot be created, their
+ *          tasks are stolen by the others.
+ */
+int engine_pool_run(unsigned int num_tasks, unsigned int num_threads, engine_task_t task,
+                    void* arg);
+
+#endif//__HOST_ENGINE_POOL_H__
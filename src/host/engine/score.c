@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Offline scoring of a trial file (see engine.h and python_utils/trial_file.py) with the host
+ * inference engine. The trial file is mapped into memory, all trials are classified on multiple
+ * threads, and the throughput is reported.
+ *
+ * Usage: eegnet_score [-j threads] [-r repetitions] [-o output.bin] trials.bin
+ *
+ * The output file contains the raw network output of type int8_t and shape [num_trials, NET_N].
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "engine.h"
+#include "../../cl/net/net.h"
+
+static void _score_usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-j threads] [-r repetitions] [-o output.bin] trials.bin\n", name);
+    fprintf(stderr, " -j <threads>     number of threads, default: number of online cpus\n");
+    fprintf(stderr, " -r <repetitions> classify all trials multiple times (for benchmarking)\n");
+    fprintf(stderr, " -o <file>        store the network output [num_trials, %d] as int8\n", NET_N);
+}
+
+static double _score_time() {
+    struct timespec _ts;
+    clock_gettime(CLOCK_MONOTONIC, &_ts);
+    return _ts.tv_sec + _ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+
+    long _num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    long _repetitions = 1;
+    const char* _output_filename = NULL;
+
+    int _opt;
+    while ((_opt = getopt(argc, argv, "j:r:o:h")) != -1) {
+        switch (_opt) {
+            case 'j': _num_threads = strtol(optarg, NULL, 10); break;
+            case 'r': _repetitions = strtol(optarg, NULL, 10); break;
+            case 'o': _output_filename = optarg; break;
+            case 'h': _score_usage(argv[0]); return 0;
+            default: _score_usage(argv[0]); return 2;
+        }
+    }
+    if (optind != argc - 1 || _num_threads < 1 || _repetitions < 1) {
+        _score_usage(argv[0]);
+        return 2;
+    }
+
+    // map the trial file
+    int _fd = open(argv[optind], O_RDONLY);
+    if (_fd < 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+    struct stat _st;
+    if (fstat(_fd, &_st) != 0 || (size_t)_st.st_size < sizeof(engine_trial_header_t)) {
+        fprintf(stderr, "%s: not a trial file\n", argv[optind]);
+        return 1;
+    }
+    const uint8_t* _p_file = mmap(NULL, _st.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    close(_fd);
+    if (_p_file == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    // check the header
+    const engine_trial_header_t* _p_header = (const engine_trial_header_t*)_p_file;
+    unsigned int _num_trials = _p_header->num_trials;
+    if (_p_header->magic != ENGINE_TRIAL_MAGIC) {
+        fprintf(stderr, "%s: not a trial file\n", argv[optind]);
+        return 1;
+    }
+    if (_p_header->num_channels != NET_C || _p_header->num_samples != NET_T) {
+        fprintf(stderr, "%s: trials have shape [%u, %u], the network expects [%d, %d]\n",
+                argv[optind], _p_header->num_channels, _p_header->num_samples, NET_C, NET_T);
+        return 1;
+    }
+    if ((size_t)_st.st_size < sizeof(engine_trial_header_t) + (size_t)_num_trials * NET_C * NET_T) {
+        fprintf(stderr, "%s: file is truncated\n", argv[optind]);
+        return 1;
+    }
+    const int8_t* _p_data = (const int8_t*)(_p_file + sizeof(engine_trial_header_t));
+
+    int8_t* _p_output = malloc((size_t)_num_trials * NET_N + 1);
+    if (_p_output == NULL) {
+        fprintf(stderr, "Not enough memory\n");
+        return 1;
+    }
+
+    // classify all trials
+    double _start = _score_time();
+    for (long _rep = 0; _rep < _repetitions; _rep++) {
+        if (engine_compute_batch(_p_data, _num_trials, _p_output, _num_threads) != 0) {
+            fprintf(stderr, "Not enough memory\n");
+            return 1;
+        }
+    }
+    double _elapsed = _score_time() - _start;
+
+    double _total = (double)_num_trials * _repetitions;
+    printf("%u trials, %ld threads: %.3f s, %.1f trials/s\n", _num_trials, _num_threads, _elapsed,
+           _elapsed > 0 ? _total / _elapsed : 0.0);
+
+    // store the output
+    if (_output_filename != NULL) {
+        FILE* _f = fopen(_output_filename, "wb");
+        if (_f == NULL || fwrite(_p_output, NET_N, _num_trials, _f) != _num_trials) {
+            perror(_output_filename);
+            return 1;
+        }
+        fclose(_f);
+    }
+
+    free(_p_output);
+    munmap((void*)_p_file, _st.st_size);
+    return 0;
+}
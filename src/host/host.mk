@@ -0,0 +1,47 @@
+# Copyright (C) 2020 ETH Zurich. All rights reserved.
+#
+# Author: Tibor Schneider, ETH Zurich
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the License); you may
+# not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Host build (x86_64 linux) of a PULP application, used instead of pulp_rt.mk with the platform
+# "host" (PULP_CURRENT_CONFIG_ARGS="platform=host"). It uses the same variables as pulp_rt.mk:
+# PULP_APP, PULP_APP_FC_SRCS, PULP_APP_CL_SRCS, PULP_CFLAGS and PULP_LDFLAGS. The FC and the
+# cluster code are linked into a single executable, see rt/rt_api.h.
+
+HOST_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
+HOST_CC ?= gcc
+HOST_BUILD_DIR ?= build/host
+HOST_BIN = $(HOST_BUILD_DIR)/$(PULP_APP)
+
+# the executable must not be position independent, such that all static data is below 4GB (the
+# addresses are casted to unsigned int for the DMA). Unused functions are removed (like in the PULP
+# build), since some tests do not link all dependencies of a source file.
+HOST_CFLAGS = -std=gnu99 -fno-pie -ffunction-sections -fdata-sections -fno-strict-aliasing -Wno-pointer-to-int-cast -pthread -DHOST -I$(HOST_DIR) $(PULP_CFLAGS)
+HOST_LDFLAGS = -no-pie -pthread -Wl,--gc-sections $(filter-out -lplpdsp,$(PULP_LDFLAGS))
+
+all: $(HOST_BIN)
+
+$(HOST_BIN): $(PULP_APP_FC_SRCS) $(PULP_APP_CL_SRCS) $(HOST_DIR)rt_host.c
+	mkdir -p $(HOST_BUILD_DIR)
+	$(HOST_CC) $(HOST_CFLAGS) $^ $(HOST_LDFLAGS) -o $@
+
+run: $(HOST_BIN)
+	./$(HOST_BIN)
+
+clean:
+	rm -rf $(HOST_BUILD_DIR)
+
+.PHONY: all run clean
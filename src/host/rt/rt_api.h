@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host implementation of the parts of the PULP runtime (rt_api.h) and of the PULP builtins, which
+ * are used by this project. It allows to compile the cluster code (src/cl) natively on a x86 linux
+ * machine, to check the results much faster than on GVSOC (see src/host/host.mk).
+ *
+ * - v4s, v2s: GCC vector extension (like on PULP), such that __builtin_shuffle works the same way
+ * - __SUMDOTP4, __CLIP_R, __PACK4, __MAC, ...: emulated with the same semantics as the builtins
+ * - rt_team_fork, rt_team_barrier: pthreads, one thread per core
+ * - rt_dma_*: memcpy, which is deferred until rt_dma_wait (the destination is poisoned until then)
+ * - rt_alloc: mmap below 4GB (MAP_32BIT), since addresses are passed as unsigned int to the DMA
+ * - rt_perf_*: only RT_PERF_CYCLES and RT_PERF_ACTIVE_CYCLES are counted, in ns (per core, but
+ *   the cores are never idle)
+ *
+ * The host build defines HOST, which is used in the source code to replace inline assembly.
+ */
+
+#ifndef __HOST_RT_API_H__
+#define __HOST_RT_API_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifndef __x86_64__
+#error "The host build of the PULP runtime only supports x86_64"
+#endif
+
+/*
+ * Memory sections (all data is in the same memory on the host)
+ */
+
+#define RT_L2_DATA
+#define RT_L1_DATA
+#define RT_CL_DATA
+#define RT_LOCAL_DATA
+#define RT_FC_DATA
+#define RT_FC_SHARED_DATA
+#define RT_FC_GLOBAL_DATA
+
+/*
+ * Vector types and builtins
+ */
+
+typedef signed char v4s __attribute__((vector_size(4)));
+typedef unsigned char v4u __attribute__((vector_size(4)));
+typedef short v2s __attribute__((vector_size(4)));
+typedef unsigned short v2u __attribute__((vector_size(4)));
+
+// the builtins are implemented as macros (statement expressions), such that they can be used in
+// non-static inline functions (like func_transform_32to8_elem)
+#define __host_sdotsp4(x, y, acc) ({                                                          \
+    v4s _hx = (x), _hy = (y);                                                                 \
+    (int32_t)(acc) + _hx[0] * _hy[0] + _hx[1] * _hy[1] + _hx[2] * _hy[2] + _hx[3] * _hy[3]; \
+})
+
+#define __host_sdotsp2(x, y, acc) ({                       \
+    v2s _hx = (x), _hy = (y);                              \
+    (int32_t)(acc) + _hx[0] * _hy[0] + _hx[1] * _hy[1];    \
+})
+
+#define __host_clip_r(x, bound) ({                                     \
+    int32_t _hv = (x), _hb = (bound);                                  \
+    _hv > _hb ? _hb : (_hv < -_hb - 1 ? -_hb - 1 : _hv);               \
+})
+
+#define __host_max(x, y) ({ int32_t _hx = (x), _hy = (y); _hx > _hy ? _hx : _hy; })
+#define __host_min(x, y) ({ int32_t _hx = (x), _hy = (y); _hx < _hy ? _hx : _hy; })
+
+#define __SUMDOTP4(x, y, z) __host_sdotsp4((v4s)(x), (v4s)(y), (z))
+#define __DOTP4(x, y) __host_sdotsp4((v4s)(x), (v4s)(y), 0)
+#define __SUMDOTP2(x, y, z) __host_sdotsp2((v2s)(x), (v2s)(y), (z))
+#define __DOTP2(x, y) __host_sdotsp2((v2s)(x), (v2s)(y), 0)
+#define __CLIP_R(x, bound) __host_clip_r((x), (bound))
+#define __PACK4(x, y, z, t) ((v4s){(signed char)(x), (signed char)(y), (signed char)(z), (signed char)(t)})
+#define __PACK2(x, y) ((v2s){(short)(x), (short)(y)})
+#define __MAC(acc, x, y) ((int32_t)(acc) + (int32_t)(x) * (int32_t)(y))
+#define __MSU(acc, x, y) ((int32_t)(acc) - (int32_t)(x) * (int32_t)(y))
+#define __MAX(x, y) __host_max((x), (y))
+#define __MIN(x, y) __host_min((x), (y))
+#define __ABS(x) ((x) < 0 ? -(x) : (x))
+#define __AND4(x, y) ((v4s)((v4s)(x) & (v4s)(y)))
+#define __OR4(x, y) ((v4s)((v4s)(x) | (v4s)(y)))
+#define __ADD4(x, y) ((v4s)((v4s)(x) + (v4s)(y)))
+#define __SUB4(x, y) ((v4s)((v4s)(x) - (v4s)(y)))
+
+/*
+ * Memory allocation
+ */
+
+typedef enum {
+    RT_ALLOC_FC_CODE,
+    RT_ALLOC_FC_DATA,
+    RT_ALLOC_FC_RET_DATA,
+    RT_ALLOC_CL_CODE,
+    RT_ALLOC_CL_DATA,
+    RT_ALLOC_L2_CL_DATA,
+    RT_ALLOC_PERIPH,
+    RT_ALLOC_NB_TYPES
+} rt_alloc_e;
+
+/**
+ * @brief Size of the L1 memory. rt_alloc(RT_ALLOC_CL_DATA, ...) fails if more memory is used.
+ */
+#ifndef HOST_L1_SIZE
+#define HOST_L1_SIZE 65536
+#endif//HOST_L1_SIZE
+
+void* rt_alloc(rt_alloc_e flags, int size);
+void rt_free(rt_alloc_e flags, void* chunk, int size);
+
+/**
+ * @brief Host only (not part of the PULP runtime): peak number of bytes allocated on L1
+ * (RT_ALLOC_CL_DATA) or on L2 (all other flags) since the start, or since rt_host_alloc_reset_peak.
+ */
+int rt_host_alloc_peak(rt_alloc_e flags);
+void rt_host_alloc_reset_peak();
+
+/*
+ * DMA
+ */
+
+typedef enum {
+    RT_DMA_DIR_LOC2EXT = 0,
+    RT_DMA_DIR_EXT2LOC = 1
+} rt_dma_dir_e;
+
+typedef struct {
+    int id;
+} rt_dma_copy_t;
+
+void rt_dma_memcpy(unsigned int ext, unsigned int loc, unsigned short size, rt_dma_dir_e dir,
+                   int merge, rt_dma_copy_t* copy);
+void rt_dma_memcpy_2d(unsigned int ext, unsigned int loc, unsigned short size,
+                      unsigned short stride, unsigned short length, rt_dma_dir_e dir, int merge,
+                      rt_dma_copy_t* copy);
+void rt_dma_wait(rt_dma_copy_t* copy);
+
+/**
+ * @brief Host only (not part of the PULP runtime): number of bytes transferred by the DMA in the
+ * direction dir since the start (RT_DMA_DIR_EXT2LOC: read from L2, RT_DMA_DIR_LOC2EXT: written to
+ * L2).
+ */
+unsigned int rt_host_dma_bytes(rt_dma_dir_e dir);
+
+/*
+ * Team (cluster cores)
+ */
+
+int rt_core_id();
+int rt_cluster_id();
+int rt_nb_pe();
+void rt_team_fork(int nb_cores, void (*entry)(void*), void* arg);
+void rt_team_barrier();
+void rt_team_critical_enter();
+void rt_team_critical_exit();
+
+/*
+ * Performance counters
+ */
+
+typedef enum {
+    RT_PERF_CYCLES,
+    RT_PERF_ACTIVE_CYCLES,
+    RT_PERF_INSTR,
+    RT_PERF_LD_STALL,
+    RT_PERF_JR_STALL,
+    RT_PERF_IMISS,
+    RT_PERF_LD,
+    RT_PERF_ST,
+    RT_PERF_JUMP,
+    RT_PERF_BRANCH,
+    RT_PERF_BTAKEN,
+    RT_PERF_RVC,
+    RT_PERF_LD_EXT,
+    RT_PERF_ST_EXT,
+    RT_PERF_LD_EXT_CYC,
+    RT_PERF_ST_EXT_CYC,
+    RT_PERF_TCDM_CONT,
+    RT_PERF_NB_EVENTS
+} rt_perf_event_e;
+
+typedef struct {
+    unsigned int events;
+    unsigned int values[RT_PERF_NB_EVENTS];
+} rt_perf_t;
+
+void rt_perf_init(rt_perf_t* perf);
+void rt_perf_conf(rt_perf_t* perf, unsigned int events);
+void rt_perf_reset(rt_perf_t* perf);
+void rt_perf_start(rt_perf_t* perf);
+void rt_perf_stop(rt_perf_t* perf);
+unsigned int rt_perf_read(int event);
+unsigned int rt_perf_get(rt_perf_t* perf, int event);
+
+/*
+ * Fabric controller: cluster, frequency, voltage and time
+ */
+
+typedef struct {
+    int id;
+} rt_event_t;
+
+typedef enum {
+    RT_FREQ_DOMAIN_FC = 0,
+    RT_FREQ_DOMAIN_CL = 1,
+    RT_FREQ_DOMAIN_PERIPH = 2
+} rt_freq_domain_e;
+
+typedef enum {
+    RT_VOLTAGE_DOMAIN_MAIN = 0
+} rt_voltage_domain_e;
+
+int rt_cluster_mount(int mount, int cid, int flags, rt_event_t* event);
+int rt_cluster_call(void* conf, int cid, void (*entry)(void*), void* arg, void* stacks,
+                    int master_stack_size, int slave_stack_size, int nb_pe, rt_event_t* event);
+int rt_freq_set(rt_freq_domain_e domain, unsigned int freq);
+unsigned int rt_freq_get(rt_freq_domain_e domain);
+int rt_voltage_force(rt_voltage_domain_e domain, unsigned int voltage, rt_event_t* event);
+unsigned long long rt_time_get_us();
+void rt_time_wait_us(int time_us);
+
+#endif//__HOST_RT_API_H__
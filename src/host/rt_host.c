@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host implementation of the PULP runtime, see rt/rt_api.h
+ */
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "rt/rt_api.h"
+
+/**
+ * @brief Number of cores in the cluster, used if rt_team_fork is called with 0 cores
+ */
+#ifndef HOST_NUM_CORES
+#define HOST_NUM_CORES 8
+#endif//HOST_NUM_CORES
+
+/**
+ * @brief Stack size of every (simulated) core
+ */
+#ifndef HOST_STACK_SIZE
+#define HOST_STACK_SIZE (1 << 20)
+#endif//HOST_STACK_SIZE
+
+/**
+ * @brief Value, with which the destination of a DMA transfer is overwritten until it is waited for
+ */
+#ifndef HOST_DMA_POISON
+#define HOST_DMA_POISON 0xa5
+#endif//HOST_DMA_POISON
+
+// size of the header in front of every allocated chunk (keeps the chunk aligned to 16 bytes)
+#define _HOST_CHUNK_HEADER 16
+
+// DMA transfer, which is executed at rt_dma_wait
+typedef struct {
+    int id;
+    unsigned int ext;
+    unsigned int loc;
+    unsigned short size;
+    rt_dma_dir_e dir;
+} _host_dma_transfer_t;
+
+static __thread int _host_core_id = 0;
+
+static pthread_mutex_t _host_critical = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t _host_alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_barrier_t _host_barrier;
+static int _host_team_size = 1;
+static void* _host_stacks[HOST_NUM_CORES];
+
+static int _host_l1_used = 0;
+static int _host_l1_peak = 0;
+static int _host_l2_used = 0;
+static int _host_l2_peak = 0;
+static unsigned int _host_freq[3] = {50000000, 50000000, 50000000};
+
+static pthread_mutex_t _host_dma_lock = PTHREAD_MUTEX_INITIALIZER;
+static _host_dma_transfer_t* _host_dma_pending = NULL;
+static int _host_dma_num_pending = 0;
+static int _host_dma_capacity = 0;
+static int _host_dma_next_id = 0;
+static unsigned int _host_dma_bytes[2] = {0, 0};
+
+// the performance counters of every core keep their state between team forks (like on PULP)
+static uint64_t _host_perf_start[HOST_NUM_CORES];
+static uint64_t _host_perf_acc[HOST_NUM_CORES];
+static int _host_perf_running[HOST_NUM_CORES];
+
+/**
+ * @brief Maps memory below 4GB, such that all addresses fit into an unsigned int
+ */
+static void* _host_map_low(size_t size) {
+    void* _p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (_p == MAP_FAILED) {
+        fprintf(stderr, "host: cannot map %lu bytes below 4GB\n", (unsigned long)size);
+        abort();
+    }
+    return _p;
+}
+
+static uint64_t _host_time_ns() {
+    struct timespec _ts;
+    clock_gettime(CLOCK_MONOTONIC, &_ts);
+    return (uint64_t)_ts.tv_sec * 1000000000ull + (uint64_t)_ts.tv_nsec;
+}
+
+/*
+ * Memory allocation
+ */
+
+void* rt_alloc(rt_alloc_e flags, int size) {
+
+    pthread_mutex_lock(&_host_alloc_lock);
+    if (flags == RT_ALLOC_CL_DATA) {
+        if (_host_l1_used + size > HOST_L1_SIZE) {
+            fprintf(stderr, "host: L1 overflow, %d bytes requested, %d bytes already used\n",
+                    size, _host_l1_used);
+            abort();
+        }
+        _host_l1_used += size;
+        _host_l1_peak = _host_l1_used > _host_l1_peak ? _host_l1_used : _host_l1_peak;
+    } else {
+        _host_l2_used += size;
+        _host_l2_peak = _host_l2_used > _host_l2_peak ? _host_l2_used : _host_l2_peak;
+    }
+    pthread_mutex_unlock(&_host_alloc_lock);
+
+    size_t _mapped = (size_t)size + _HOST_CHUNK_HEADER;
+    int8_t* _p_chunk = _host_map_low(_mapped);
+    ((int*)_p_chunk)[0] = size;
+    return _p_chunk + _HOST_CHUNK_HEADER;
+}
+
+void rt_free(rt_alloc_e flags, void* chunk, int size) {
+
+    int8_t* _p_chunk = (int8_t*)chunk - _HOST_CHUNK_HEADER;
+    int _size = ((int*)_p_chunk)[0];
+    if (_size != size) {
+        fprintf(stderr, "host: rt_free with size %d, but %d bytes were allocated\n", size, _size);
+    }
+
+    pthread_mutex_lock(&_host_alloc_lock);
+    if (flags == RT_ALLOC_CL_DATA) {
+        _host_l1_used -= _size;
+    } else {
+        _host_l2_used -= _size;
+    }
+    pthread_mutex_unlock(&_host_alloc_lock);
+
+    munmap(_p_chunk, (size_t)_size + _HOST_CHUNK_HEADER);
+}
+
+int rt_host_alloc_peak(rt_alloc_e flags) {
+    return flags == RT_ALLOC_CL_DATA ? _host_l1_peak : _host_l2_peak;
+}
+
+void rt_host_alloc_reset_peak() {
+    pthread_mutex_lock(&_host_alloc_lock);
+    _host_l1_peak = _host_l1_used;
+    _host_l2_peak = _host_l2_used;
+    pthread_mutex_unlock(&_host_alloc_lock);
+}
+
+/*
+ * DMA
+ */
+
+/*
+ * The transfers are not executed when they are started, but only at rt_dma_wait, and the
+ * destination is poisoned in the meantime. Thus, a missing wait, reading the destination before the
+ * wait, or reusing the source before the wait all change the result, like on PULP (where they only
+ * fail depending on the timing).
+ */
+
+void rt_dma_memcpy(unsigned int ext, unsigned int loc, unsigned short size, rt_dma_dir_e dir,
+                   int merge, rt_dma_copy_t* copy) {
+    pthread_mutex_lock(&_host_dma_lock);
+    if (!merge) {
+        copy->id = _host_dma_next_id++;
+    }
+    if (_host_dma_num_pending == _host_dma_capacity) {
+        _host_dma_capacity = _host_dma_capacity == 0 ? 64 : 2 * _host_dma_capacity;
+        _host_dma_pending = realloc(_host_dma_pending, _host_dma_capacity * sizeof(_host_dma_transfer_t));
+        if (_host_dma_pending == NULL) {
+            fprintf(stderr, "host: cannot queue the DMA transfer\n");
+            abort();
+        }
+    }
+    _host_dma_transfer_t* _p_transfer = _host_dma_pending + _host_dma_num_pending++;
+    _p_transfer->id = copy->id;
+    _p_transfer->ext = ext;
+    _p_transfer->loc = loc;
+    _p_transfer->size = size;
+    _p_transfer->dir = dir;
+    _host_dma_bytes[dir] += size;
+    if (dir == RT_DMA_DIR_EXT2LOC) {
+        memset((void*)(uintptr_t)loc, HOST_DMA_POISON, size);
+    } else {
+        memset((void*)(uintptr_t)ext, HOST_DMA_POISON, size);
+    }
+    pthread_mutex_unlock(&_host_dma_lock);
+}
+
+void rt_dma_memcpy_2d(unsigned int ext, unsigned int loc, unsigned short size,
+                      unsigned short stride, unsigned short length, rt_dma_dir_e dir, int merge,
+                      rt_dma_copy_t* copy) {
+    // the external memory is accessed in rows of length bytes, stride bytes apart
+    for (unsigned int _offset = 0; _offset < size; _offset += length) {
+        unsigned int _len = size - _offset < length ? size - _offset : length;
+        unsigned int _ext = ext + (_offset / length) * stride;
+        // all rows belong to the same transfer
+        rt_dma_memcpy(_ext, loc + _offset, _len, dir, merge || _offset > 0, copy);
+    }
+}
+
+void rt_dma_wait(rt_dma_copy_t* copy) {
+    pthread_mutex_lock(&_host_dma_lock);
+    // execute all transfers of this id in order, and remove them from the pending transfers
+    int _num = 0;
+    for (int _i = 0; _i < _host_dma_num_pending; _i++) {
+        _host_dma_transfer_t* _p_transfer = _host_dma_pending + _i;
+        if (_p_transfer->id != copy->id) {
+            _host_dma_pending[_num++] = *_p_transfer;
+        } else if (_p_transfer->dir == RT_DMA_DIR_EXT2LOC) {
+            memcpy((void*)(uintptr_t)_p_transfer->loc, (const void*)(uintptr_t)_p_transfer->ext,
+                   _p_transfer->size);
+        } else {
+            memcpy((void*)(uintptr_t)_p_transfer->ext, (const void*)(uintptr_t)_p_transfer->loc,
+                   _p_transfer->size);
+        }
+    }
+    _host_dma_num_pending = _num;
+    pthread_mutex_unlock(&_host_dma_lock);
+}
+
+unsigned int rt_host_dma_bytes(rt_dma_dir_e dir) {
+    return _host_dma_bytes[dir];
+}
+
+/*
+ * Team
+ */
+
+typedef struct {
+    int core_id;
+    void (*entry)(void*);
+    void* arg;
+} _host_core_args_t;
+
+static void* _host_core_main(void* args) {
+    _host_core_args_t* _p_args = (_host_core_args_t*)args;
+    _host_core_id = _p_args->core_id;
+    _p_args->entry(_p_args->arg);
+    return NULL;
+}
+
+/**
+ * @brief Starts a thread with the stack of the core (below 4GB)
+ */
+static void _host_start_core(pthread_t* thread, _host_core_args_t* args) {
+    if (_host_stacks[args->core_id] == NULL) {
+        _host_stacks[args->core_id] = _host_map_low(HOST_STACK_SIZE);
+    }
+    pthread_attr_t _attr;
+    pthread_attr_init(&_attr);
+    pthread_attr_setstack(&_attr, _host_stacks[args->core_id], HOST_STACK_SIZE);
+    if (pthread_create(thread, &_attr, _host_core_main, args) != 0) {
+        fprintf(stderr, "host: cannot start core %d\n", args->core_id);
+        abort();
+    }
+    pthread_attr_destroy(&_attr);
+}
+
+int rt_core_id() {
+    return _host_core_id;
+}
+
+int rt_cluster_id() {
+    return 0;
+}
+
+int rt_nb_pe() {
+    return HOST_NUM_CORES;
+}
+
+void rt_team_fork(int nb_cores, void (*entry)(void*), void* arg) {
+
+    if (nb_cores <= 0 || nb_cores > HOST_NUM_CORES) {
+        nb_cores = HOST_NUM_CORES;
+    }
+
+    pthread_t _threads[HOST_NUM_CORES];
+    _host_core_args_t _args[HOST_NUM_CORES];
+
+    _host_team_size = nb_cores;
+    pthread_barrier_init(&_host_barrier, NULL, nb_cores);
+
+    // the master (core 0) executes the entry as well, on its own stack
+    for (int _i = 1; _i < nb_cores; _i++) {
+        _args[_i].core_id = _i;
+        _args[_i].entry = entry;
+        _args[_i].arg = arg;
+        _host_start_core(_threads + _i, _args + _i);
+    }
+    entry(arg);
+
+    for (int _i = 1; _i < nb_cores; _i++) {
+        pthread_join(_threads[_i], NULL);
+    }
+
+    pthread_barrier_destroy(&_host_barrier);
+    _host_team_size = 1;
+}
+
+void rt_team_barrier() {
+    if (_host_team_size > 1) {
+        pthread_barrier_wait(&_host_barrier);
+    }
+}
+
+void rt_team_critical_enter() {
+    pthread_mutex_lock(&_host_critical);
+}
+
+void rt_team_critical_exit() {
+    pthread_mutex_unlock(&_host_critical);
+}
+
+/*
+ * Performance counters (per core, counting ns instead of cycles)
+ */
+
+void rt_perf_init(rt_perf_t* perf) {
+    memset(perf, 0, sizeof(rt_perf_t));
+}
+
+void rt_perf_conf(rt_perf_t* perf, unsigned int events) {
+    perf->events = events;
+}
+
+void rt_perf_reset(rt_perf_t* perf) {
+    _host_perf_acc[_host_core_id] = 0;
+    _host_perf_start[_host_core_id] = _host_time_ns();
+}
+
+void rt_perf_start(rt_perf_t* perf) {
+    if (!_host_perf_running[_host_core_id]) {
+        _host_perf_start[_host_core_id] = _host_time_ns();
+        _host_perf_running[_host_core_id] = 1;
+    }
+}
+
+void rt_perf_stop(rt_perf_t* perf) {
+    if (_host_perf_running[_host_core_id]) {
+        _host_perf_acc[_host_core_id] += _host_time_ns() - _host_perf_start[_host_core_id];
+        _host_perf_running[_host_core_id] = 0;
+    }
+    for (int _i = 0; _i < RT_PERF_NB_EVENTS; _i++) {
+        perf->values[_i] = rt_perf_read(_i);
+    }
+}
+
+unsigned int rt_perf_read(int event) {
+    if (event != RT_PERF_CYCLES && event != RT_PERF_ACTIVE_CYCLES) {
+        return 0;
+    }
+    uint64_t _value = _host_perf_acc[_host_core_id];
+    if (_host_perf_running[_host_core_id]) {
+        _value += _host_time_ns() - _host_perf_start[_host_core_id];
+    }
+    return (unsigned int)_value;
+}
+
+unsigned int rt_perf_get(rt_perf_t* perf, int event) {
+    return perf->values[event];
+}
+
+/*
+ * Fabric controller
+ */
+
+int rt_cluster_mount(int mount, int cid, int flags, rt_event_t* event) {
+    return 0;
+}
+
+int rt_cluster_call(void* conf, int cid, void (*entry)(void*), void* arg, void* stacks,
+                    int master_stack_size, int slave_stack_size, int nb_pe, rt_event_t* event) {
+    // execute the entry on core 0 of the cluster (with the stack below 4GB)
+    pthread_t _thread;
+    _host_core_args_t _args = {0, entry, arg};
+    _host_start_core(&_thread, &_args);
+    pthread_join(_thread, NULL);
+    return 0;
+}
+
+int rt_freq_set(rt_freq_domain_e domain, unsigned int freq) {
+    _host_freq[domain] = freq;
+    return 0;
+}
+
+unsigned int rt_freq_get(rt_freq_domain_e domain) {
+    return _host_freq[domain];
+}
+
+int rt_voltage_force(rt_voltage_domain_e domain, unsigned int voltage, rt_event_t* event) {
+    return 0;
+}
+
+unsigned long long rt_time_get_us() {
+    return _host_time_ns() / 1000;
+}
+
+void rt_time_wait_us(int time_us) {
+    usleep(time_us);
+}
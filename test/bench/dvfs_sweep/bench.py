@@ -0,0 +1,244 @@
+"""
+DVFS sweep: Executes the network on GVSOC at every cluster frequency of the operating points, reads
+the cycles and activity counters, and applies the energy model (python_utils/energy_model.py) to
+estimate the latency and the energy per classification at every operating point (voltage and
+frequency). Then, the operating point with the lowest energy that still meets the deadline is
+selected.
+
+GVSOC does not model the voltage, so the network is only simulated once per frequency, and the
+counters are reused for all voltages at this frequency. The activity is the sum of the active
+cycles of all 8 cores. The performance counters do not see the transfers of the DMA, which is why
+the bytes transferred between L2 and L1 are counted by executing the same configuration once with
+the host build (the transfers do not depend on the platform nor on the frequency).
+
+Before running this benchmark, the project must have been built once (./run.sh -n), such that the
+network header (src/cl/net/net.h) exists. The same configuration as in the main Makefile is used.
+
+Usage (from this directory, with python_utils in the PYTHONPATH):
+    python3 bench.py                              # all operating points of src/fc/main.c
+    python3 bench.py -d 20                        # select the best point with a deadline of 20ms
+    python3 bench.py -p 800:50 -p 1100:250        # only those points ([mV]:[MHz])
+    python3 bench.py -m model.json --csv out.csv  # custom energy model coefficients
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/20"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import csv
+import os
+import re
+import numpy as np
+
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderArray, align_array
+from makefile import Makefile
+from golden_model import GoldenModel
+from energy_model import EnergyModel, OPERATING_POINTS, min_energy_point
+import functional as F
+
+BENCHNAME = "bench::dvfs_sweep"
+RESULT_FILE = "result.out"
+
+INPUT_FILENAME = "../../../data/verification.npz"
+NET_FILENAME = "../../../data/net.npz"
+CONFIG_FILENAME = "../../../data/config.json"
+MAIN_MAKEFILE = "../../../Makefile"
+
+# the FC is kept at a fixed frequency (like in src/fc/main.c, POWER)
+FC_FREQ = 50
+
+
+def main_defines(filename=MAIN_MAKEFILE):
+    """ Returns all defines (name, value) which are enabled in the main Makefile (except POWER) """
+    defines = []
+    with open(filename, "r") as _f:
+        for line in _f.readlines():
+            match = re.match(r'^PULP_CFLAGS \+= "-D(\w+)(?:=(\w+))?"', line)
+            if match and match.group(1) != "POWER":
+                defines.append((match.group(1), match.group(2)))
+    return defines
+
+
+def gen_stimuli(defines):
+    """ generates the input and the expected output of the network, with the same configuration """
+    model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False,
+                        no_scale_between_l1_l2="NO_INTERMEDIATE_SCALE" in defines,
+                        reorder_bn="REORDER_BN" in defines)
+    x = np.load(INPUT_FILENAME)["input"][0, :, :]
+    x = F.quantize_to_int(x, model.input_scale)
+    y_exp = model(x)
+    if "DUPLICATE_FEATUREMAP" in defines:
+        C, T = x.shape
+        x_dev = np.zeros((C, T + 63), dtype=int)
+        x_dev[:, 31:31 + T] = x
+    else:
+        x_dev = align_array(x)
+    return x_dev, align_array(y_exp)
+
+
+def run_frequency(freq, defines, platform=None):
+    """
+    Run the network on GVSOC (or on the given platform) with the cluster frequency freq [MHz],
+    returns the parsed result
+    """
+    mkf = Makefile()
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    for source in ["model.c", "layer1.c", "layer2.c", "layer3.c", "layer4.c", "layer5.c",
+                   "fused_layer_1_2.c", "net.c", "blob.c", "stream.c", "queue.c", "pipeline.c"]:
+        mkf.add_cl_prog_source("net/{}".format(source))
+    for source in ["transform.c", "dotp.c", "conv.c", "flip.c", "xcorr.c", "ntt.c"]:
+        mkf.add_cl_prog_source("func/{}".format(source))
+    # needed if TELEMETRY is enabled in the main Makefile
+    mkf.add_cl_prog_source("telemetry.c")
+    for name, value in defines:
+        mkf.add_define(name, value)
+    mkf.add_define("FC_FREQ", FC_FREQ)
+    mkf.add_define("CL_FREQ", freq)
+    mkf.write()
+
+    env = "" if platform is None else "PULP_CURRENT_CONFIG_ARGS=platform={} ".format(platform)
+    os.system("{}make clean all run > {}".format(env, RESULT_FILE))
+    return parse_output(RESULT_FILE)
+
+
+def parse_point(text):
+    """ parses a string like 800:50 (voltage [mV]: frequency [MHz]) """
+    voltage, freq = text.split(":")
+    return int(voltage), int(freq)
+
+
+def bench(points, model, deadline=None, csv_file=None):
+    """
+    Execute the sweep
+
+    Parameters:
+    - points: list of (voltage [mV], frequency [MHz])
+    - model: EnergyModel
+    - deadline: float, latency deadline in s (or None)
+    - csv_file: filename to store the results, or None
+
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(BENCHNAME)
+
+    defines = main_defines()
+    x_dev, y_exp = gen_stimuli([name for name, _ in defines])
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderArray("x_vec", "int8_t", x_dev.ravel()))
+    header.add(HeaderArray("y_exp_vec", "int8_t", y_exp.ravel()))
+    header.write()
+
+    # simulate every frequency once
+    cycles, activity, ext_accesses = {}, {}, {}
+    dma_bytes = None
+    for freq in sorted(set(f for _, f in points)):
+        result = run_frequency(freq, defines)
+        logger.show_subcase_result("f_cl = {} MHz".format(freq), result)
+        if "1" not in result or "cycles" not in result["1"]:
+            continue
+        result = result["1"]
+        cycles[freq] = int(result["cycles"])
+        num_cores = model.params["num_cores"]
+        activity[freq] = min(1.0, int(result["active_total"]) / (num_cores * int(result["cycles"])))
+        ext_accesses[freq] = int(result["ld_ext"]) + int(result["st_ext"])
+        if "dma_rd" in result:
+            dma_bytes = int(result["dma_rd"]) + int(result["dma_wr"])
+
+    # count the DMA transfers with the host build
+    if cycles and dma_bytes is None:
+        result = run_frequency(FC_FREQ, defines, platform="host")
+        logger.show_subcase_result("DMA transfers (host)", result)
+        if "1" in result and "dma_rd" in result["1"]:
+            dma_bytes = int(result["1"]["dma_rd"]) + int(result["1"]["dma_wr"])
+    if dma_bytes is None:
+        print("Warning: DMA transfers could not be counted, the energy of L2 is underestimated")
+        dma_bytes = 0
+    else:
+        print("DMA transfers between L2 and L1: {} bytes".format(dma_bytes))
+
+    points = [p for p in points if p[1] in cycles]
+    if not points:
+        print("No results available")
+        return logger.summary()
+
+    evaluated = model.evaluate(points, cycles, activity, ext_accesses, dma_bytes)
+    best = min_energy_point(evaluated, deadline)
+
+    # print the table
+    print("\n{:>6} {:>6} {:>10} {:>10} {:>10} {:>10} {:>10}".format(
+        "V [mV]", "f[MHz]", "cycles", "t [ms]", "P [mW]", "E [uJ]", "leak [%]"))
+    for p in evaluated:
+        marker = ""
+        if deadline is not None and p["latency"] > deadline:
+            marker = " (misses deadline)"
+        if p is best:
+            marker = " <- best"
+        print("{:>6} {:>6} {:>10} {:>10.3f} {:>10.3f} {:>10.2f} {:>10.1f}{}".format(
+            p["voltage"], p["freq"], p["cycles"], p["latency"] * 1e3, p["power"] * 1e3,
+            p["energy"] * 1e6, 100 * p["energy_leak"] / p["energy"], marker))
+
+    deadline_str = "no deadline" if deadline is None else "deadline {:.2f} ms".format(deadline * 1e3)
+    if best is None:
+        print("\nNo operating point meets the {}".format(deadline_str))
+    else:
+        print("\nMinimum energy ({}): {} mV, {} MHz: {:.2f} uJ, {:.3f} ms".format(
+            deadline_str, best["voltage"], best["freq"], best["energy"] * 1e6,
+            best["latency"] * 1e3))
+
+    if csv_file is not None:
+        keys = ["voltage", "freq", "cycles", "latency", "power", "energy", "energy_dyn",
+                "energy_leak"]
+        with open(csv_file, "w") as _f:
+            writer = csv.DictWriter(_f, fieldnames=keys)
+            writer.writeheader()
+            writer.writerows(evaluated)
+
+    return logger.summary()
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("DVFS sweep with energy model")
+    parser.add_argument("-p", "--point", action="append", default=None,
+                        help="operating point [mV]:[MHz], e.g. 800:50 (can be used multiple times)")
+    parser.add_argument("-d", "--deadline", type=float, default=None,
+                        help="latency deadline in ms")
+    parser.add_argument("-m", "--model", default=None,
+                        help="json file with the energy model coefficients")
+    parser.add_argument("--csv", default=None, help="store the results in this csv file")
+    args = parser.parse_args()
+
+    if args.point is None:
+        sweep = OPERATING_POINTS
+    else:
+        sweep = [parse_point(p) for p in args.point]
+
+    energy_model = EnergyModel() if args.model is None else EnergyModel.from_file(args.model)
+    deadline_s = None if args.deadline is None else args.deadline * 1e-3
+
+    bench(sweep, energy_model, deadline_s, args.csv)
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+#include "../../../src/cl/net/net.h"
+#include "../../../src/cl/net/model.h"
+
+#define NUM_EVENTS 7
+#define NUM_CORES 8
+
+static const int events[NUM_EVENTS] = {
+    RT_PERF_CYCLES,
+    RT_PERF_ACTIVE_CYCLES,
+    RT_PERF_INSTR,
+    RT_PERF_LD_EXT,
+    RT_PERF_ST_EXT,
+    RT_PERF_TCDM_CONT,
+    RT_PERF_LD_STALL
+};
+
+static const char* event_names[NUM_EVENTS] = {
+    "cycles",
+    "active",
+    "instructions",
+    "ld_ext",
+    "st_ext",
+    "tcdm_cont",
+    "ld_stall"
+};
+
+// performance counters of the other cores (core 0 is measured by do_bench)
+static rt_perf_t core_perf[NUM_CORES];
+static int core_active[NUM_CORES];
+
+/**
+ * @brief Starts counting the active cycles on all cores except core 0. The counters of every core
+ * keep running between the team forks, and only count while the core is not clock gated.
+ */
+void perf_start_kernel(void* arg) {
+    int core_id = rt_core_id();
+    if (core_id != 0) {
+        rt_perf_init(core_perf + core_id);
+        rt_perf_conf(core_perf + core_id, 1 << RT_PERF_ACTIVE_CYCLES);
+        rt_perf_reset(core_perf + core_id);
+        rt_perf_start(core_perf + core_id);
+    }
+}
+
+/**
+ * @brief Stops and reads the active cycles on all cores except core 0
+ */
+void perf_stop_kernel(void* arg) {
+    int core_id = rt_core_id();
+    if (core_id != 0) {
+        rt_perf_stop(core_perf + core_id);
+        core_active[core_id] = rt_perf_read(RT_PERF_ACTIVE_CYCLES);
+    }
+}
+
+int do_bench(rt_perf_t* perf, int events) {
+
+    // allocate result memory
+    int8_t * p_output = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * NET_N);
+
+    //setup performance measurement
+    rt_perf_conf(perf, events);
+    
+    // start performance measurement
+    rt_perf_reset(perf);
+    rt_perf_start(perf);
+    
+    net_model_compute(x_vec, p_output);
+
+    rt_perf_stop(perf);
+
+    int num_err = 0;
+    for (int n = 0; n < NET_N; n++) {
+        if (p_output[n] != y_exp_vec[n]) {
+            num_err++;
+        }
+    }
+
+    // free memory
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_N);
+
+    return num_err;
+}
+
+void cluster_entry(void* arg) {
+
+    // setup performance measurement
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+
+    // GVSOC is able to count all events at the same time
+    int event_mask = 0;
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        event_mask |= 1 << events[i];
+    }
+
+    rt_team_fork(NUM_CORES, perf_start_kernel, NULL);
+    int result = do_bench(&perf, event_mask);
+    rt_team_fork(NUM_CORES, perf_stop_kernel, NULL);
+
+    // print the results
+    if (result == 0) {
+        printf("## 1: result: OK\n");
+    } else {
+        printf("## 1: result: FAIL\n");
+    }
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        printf("## 1: %s: %d\n", event_names[i], rt_perf_read(events[i]));
+    }
+
+    // active cycles summed over all cores
+    int active_total = rt_perf_read(RT_PERF_ACTIVE_CYCLES);
+    for (int i = 1; i < NUM_CORES; i++) {
+        active_total += core_active[i];
+    }
+    printf("## 1: active_total: %d\n", active_total);
+
+#ifdef HOST
+    // bytes transferred by the DMA between L2 and L1 (only counted by the host runtime)
+    printf("## 1: dma_rd: %d\n", rt_host_dma_bytes(RT_DMA_DIR_EXT2LOC));
+    printf("## 1: dma_wr: %d\n", rt_host_dma_bytes(RT_DMA_DIR_LOC2EXT));
+#endif//HOST
+}
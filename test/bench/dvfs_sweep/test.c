@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rt/rt_api.h"
+#include "cluster.h"
+
+#ifndef FC_FREQ
+#define FC_FREQ 100
+#endif//FC_FREQ
+
+#ifndef CL_FREQ
+#define CL_FREQ 100
+#endif//CL_FREQ
+
+int main() {
+    // set the operating point (frequency in MHz). GVSOC does not model the voltage.
+    rt_freq_set(RT_FREQ_DOMAIN_FC, FC_FREQ * 1000000);
+    rt_freq_set(RT_FREQ_DOMAIN_CL, CL_FREQ * 1000000);
+
+    // mount the cluster
+    rt_cluster_mount(1, 0, 0, NULL);
+
+    // call the cluster entry
+    rt_cluster_call(NULL, 0, cluster_entry, NULL, NULL, 0, 0, 0, NULL);
+
+    // unmount the cluster entry
+    rt_cluster_mount(0, 0, 0, NULL);
+}
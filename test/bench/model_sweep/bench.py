@@ -0,0 +1,317 @@
+"""
+Sweeps the network shape (C, T, F1, D, N) using synthetic networks, and reports for each shape the
+number of cycles, the memory footprint and if the result is bit-exact to the GoldenModel.
+
+For every shape, a random network is generated (python_utils/synthetic_net.py). The cluster sources
+are copied into a build directory (synth/src/cl), the net header is generated into this copy, and the
+entire model is compiled and executed. The source tree (src/cl/net/net.{c,h}) is not touched.
+
+The configurations of the main program are tried from the most to the least optimized, and the
+first one which supports the shape and fits into memory is reported. The memory usage is measured
+with the host build (peak of rt_alloc on L1 and on L2, see src/host/rt/rt_api.h), which is why the
+host build runs with an unlimited L1. On GVSOC, the memory is not measured, and a configuration
+which does not fit fails at runtime. Shapes which do not fit into memory are reported as SKIP.
+
+F2 is always F1 * D: layer 3 is a depthwise convolution on the F1 * D channels of layer 2, and layer
+4 is implemented as a square (F2 x F2) pointwise convolution, so an arbitrary F2 is not supported.
+
+Usage (from this directory, with python_utils in the PYTHONPATH):
+    python3 bench.py                          # default sweep
+    python3 bench.py -p C=64 -p T=2249,C=32   # custom points, unspecified dimensions are default
+    python3 bench.py --csv sweep.csv          # additionally store the results as csv
+    python3 bench.py -c fused+tiles -p C=22   # force a configuration (if it supports the shape)
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/05/18"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import csv
+import os
+import re
+import shutil
+import sys
+import numpy as np
+
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderArray, align_array, align_array_size
+from makefile import Makefile
+from golden_model import GoldenModel
+from synthetic_net import write_synthetic_net
+import functional as F
+
+BENCHNAME = "bench::model_sweep"
+RESULT_FILE = "result.out"
+SYNTH_DIR = "synth"
+
+PROJECT_ROOT = "../../.."
+CL_SRC_DIR = os.path.join(SYNTH_DIR, "src/cl")
+NET_HEADER = os.path.join(CL_SRC_DIR, "net/net.h")
+sys.path.append(os.path.join(PROJECT_ROOT, "data"))
+from gen_net_header import gen_net_header
+
+# Mr. Wolf: 64kB L1 (some of it is used for the stack), 512kB L2 (some of it is used for the code)
+L1_BUDGET = 60 * 1024
+L2_BUDGET = 400 * 1024
+
+NUM_WORKERS = 8
+
+DEFAULT_POINT = {"C": 22, "T": 1125, "F1": 8, "D": 2, "N": 4}
+
+DEFAULT_SWEEP = [
+    {},
+    {"C": 8},
+    {"C": 16},
+    {"C": 32},
+    {"C": 64},
+    {"C": 128},
+    {"T": 561},
+    {"T": 2249},
+    {"F1": 4},
+    {"F1": 16},
+    {"D": 1},
+    {"D": 4},
+    {"N": 2},
+    {"N": 8},
+]
+
+# configurations, ordered from the most to the least optimized
+BASE_FLAGS = ["INTRINSIC_SCALE", "FLIP_LAYERS", "LAYER3_TIME_BLOCKS", "PARALLEL", "DMA_STREAM",
+              "CROSS_CORRELATE", "REORDER_BN"]
+CONFIGS = [
+    ("fused+ring", BASE_FLAGS + ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "DUPLICATE_FEATUREMAP",
+                                 "DUPLICATE_IN_L1", "RING_BUFFER"]),
+    ("fused+pipeline", BASE_FLAGS + ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "DUPLICATE_FEATUREMAP",
+                                     "DUPLICATE_IN_L1", "RING_BUFFER", "PIPELINE"]),
+    ("fused+tiles", BASE_FLAGS + ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "DUPLICATE_FEATUREMAP",
+                                  "DUPLICATE_IN_L1", "RING_BUFFER", "CHANNEL_TILES"]),
+    ("fused+dup", BASE_FLAGS + ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "DUPLICATE_FEATUREMAP"]),
+    ("fused", BASE_FLAGS + ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE"]),
+    ("layer", BASE_FLAGS),
+]
+
+
+def _dims(p):
+    """ returns a dict with all derived dimensions used in net.h """
+    d = dict(p)
+    d["F2"] = p["F1"] * p["D"]
+    d["C_ALIGN"] = align_array_size(p["C"])
+    d["T_ALIGN"] = align_array_size(p["T"])
+    d["T8"] = p["T"] // 8
+    d["T8_ALIGN"] = align_array_size(d["T8"])
+    d["T64"] = d["T8"] // 8
+    d["T64_ALIGN"] = align_array_size(d["T64"])
+    d["PAD"] = p["T"] + 63
+    d["PAD_ALIGN"] = align_array_size(d["PAD"])
+    d["L3_PAD_ALIGN"] = align_array_size(d["T8"] + 15)
+    return d
+
+
+def l2_param_usage(header_filename):
+    """ Returns the size of all parameters declared in the net header file in bytes """
+    sizes = {"int8_t": 1, "int16_t": 2, "int32_t": 4}
+    total = 0
+    with open(header_filename, "r") as _f:
+        for dtype, length in re.findall(r"const (int\d+_t) \w+\[(\d+)\];", _f.read()):
+            total += sizes[dtype] * int(length)
+    return total
+
+
+def unsupported(name, d):
+    """ Returns the reason why the configuration does not support the shape, or None """
+    if name.startswith("fused"):
+        if d["F1"] != NUM_WORKERS:
+            return "{}: F1 != {}".format(name, NUM_WORKERS)
+        if d["D"] != 2:
+            return "{}: D != 2".format(name)
+        if d["PAD"] % 4 != 0 or d["T8"] != d["T8_ALIGN"]:
+            return "{}: T not supported".format(name)
+    if name == "fused+dup" and d["T"] != 1125:
+        return "{}: split is tuned for T=1125".format(name)
+    return None
+
+
+def copy_sources():
+    """ copies the cluster sources into the build directory (without the generated files) """
+    if os.path.exists(CL_SRC_DIR):
+        shutil.rmtree(CL_SRC_DIR)
+    shutil.copytree(os.path.join(PROJECT_ROOT, "src/cl"), CL_SRC_DIR,
+                    ignore=shutil.ignore_patterns("net.c", "net.h", "input.c", "input.h"))
+
+
+def gen_stimuli(model, x, pad_data):
+    """ computes the expected output, and prepares the input data for the device """
+    x = F.quantize_to_int(x, model.input_scale)
+    y_exp = model(x)
+    if pad_data:
+        C, T = x.shape
+        x_dev = np.zeros((C, T + 63), dtype=int)
+        x_dev[:, 31:31 + T] = x
+    else:
+        x_dev = align_array(x)
+    return x_dev, align_array(y_exp)
+
+
+def run_config(flags, net_file, config_file):
+    """ Builds and runs the model with the given flags, returns the parsed result """
+
+    # generate makefile
+    mkf = Makefile(cl_src_dir=CL_SRC_DIR)
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    for source in ["model.c", "layer1.c", "layer2.c", "layer3.c", "layer4.c", "layer5.c",
+                   "fused_layer_1_2.c", "net.c", "blob.c", "stream.c", "queue.c", "pipeline.c"]:
+        mkf.add_cl_prog_source("net/{}".format(source))
+    for source in ["transform.c", "dotp.c", "conv.c", "flip.c", "xcorr.c", "ntt.c"]:
+        mkf.add_cl_prog_source("func/{}".format(source))
+    for flag in flags:
+        mkf.add_define(flag)
+    # the memory usage is measured, and compared to the budget afterwards
+    mkf.add_define("HOST_L1_SIZE", 1 << 24)
+    mkf.write()
+
+    # generate the stimuli
+    no_div = "NO_INTERMEDIATE_SCALE" in flags
+    model = GoldenModel(config_file, net_file, clip_balanced=False, no_scale_between_l1_l2=no_div,
+                        reorder_bn="REORDER_BN" in flags)
+    x = np.load(os.path.join(SYNTH_DIR, "input.npz"))["input"][0]
+    x_dev, y_exp = gen_stimuli(model, x, "DUPLICATE_FEATUREMAP" in flags)
+
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderArray("x_vec", "int8_t", x_dev.ravel()))
+    header.add(HeaderArray("y_exp_vec", "int8_t", y_exp.ravel()))
+    header.write()
+
+    # compile and run
+    os.system("make clean all run > {}".format(RESULT_FILE))
+
+    # parse output
+    parsed = parse_output(RESULT_FILE)
+    if "1" in parsed:
+        return dict(parsed["1"])
+    return {"result": False, "rejected": "build or run failed"}
+
+
+def bench_point(point, seed=0, only=None):
+    """
+    Generate, build and run a single point of the sweep (with the configuration only, if it is set)
+
+    Returns: dict with the result, (cycles, ...) and memory usage
+    """
+    p = dict(DEFAULT_POINT)
+    p.update(point)
+    d = _dims(p)
+
+    net_file, config_file = write_synthetic_net(SYNTH_DIR, input_file="input.npz", seed=seed,
+                                                C=p["C"], T=p["T"], F1=p["F1"], D=p["D"],
+                                                N=p["N"])
+    gen_net_header(net_file, config_file, NET_HEADER)
+    l2_param = l2_param_usage(NET_HEADER)
+
+    reasons = []
+    for name, flags in CONFIGS:
+        if only is not None and name != only:
+            continue
+        reason = unsupported(name, d)
+        if reason is not None:
+            reasons.append(reason)
+            continue
+
+        result = run_config(flags, net_file, config_file)
+        result["config"] = name
+        result["l2_param"] = l2_param
+
+        # check the measured memory usage (only available with the host build)
+        if "l1" in result and int(result["l1"]) > L1_BUDGET:
+            reasons.append("{}: L1 overflow ({} bytes)".format(name, result["l1"]))
+            continue
+        if "l2_act" in result and l2_param + int(result["l2_act"]) + p["C"] * d["PAD_ALIGN"] > L2_BUDGET:
+            reasons.append("{}: L2 overflow".format(name))
+            continue
+
+        if reasons:
+            result["rejected"] = "; ".join(reasons)
+        return p, result
+
+    return p, {"result": None, "config": "-", "rejected": "; ".join(reasons)}
+
+
+def parse_point(text):
+    """ parses a string like "C=64,T=2249" """
+    point = {}
+    for item in text.split(","):
+        key, value = item.split("=")
+        key = key.strip()
+        assert key != "F2", "F2 is always F1 * D (see the description of this module)"
+        assert key in DEFAULT_POINT, "Unknown dimension: {}".format(key)
+        point[key] = int(value)
+    return point
+
+
+def bench(points, seed=0, csv_file=None, only=None):
+    """
+    Execute the sweep
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(BENCHNAME)
+    rows = []
+
+    copy_sources()
+    for point in points:
+        p, result = bench_point(point, seed, only)
+        subcase_name = "C={C} T={T} F1={F1} D={D} N={N}".format(**p)
+        logger.show_subcase_result(subcase_name, {"1": result})
+        rows.append({**p, **result})
+
+    if csv_file is not None:
+        keys = ["C", "T", "F1", "D", "N", "config", "result", "cycles", "instructions", "ipc", "ms",
+                "l1", "l2_param", "l2_act", "rejected"]
+        with open(csv_file, "w") as _f:
+            writer = csv.DictWriter(_f, fieldnames=keys, extrasaction="ignore")
+            writer.writeheader()
+            writer.writerows(rows)
+
+    return logger.summary()
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Sweeps the network shape with synthetic networks")
+    parser.add_argument("-p", "--point", action="append", default=None,
+                        help="point of the sweep, e.g. C=64,T=2249 (can be used multiple times)")
+    parser.add_argument("-s", "--seed", type=int, default=0, help="random seed of the networks")
+    parser.add_argument("--csv", default=None, help="store the results in this csv file")
+    parser.add_argument("-c", "--config", default=None, choices=[name for name, _ in CONFIGS],
+                        help="only use this configuration")
+    args = parser.parse_args()
+
+    if args.point is None:
+        sweep = DEFAULT_SWEEP
+    else:
+        sweep = [parse_point(p) for p in args.point]
+
+    n_total, n_success = bench(sweep, args.seed, args.csv, args.config)
+    print("\nbit-exact: {} / {}".format(n_success, n_total))
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+// from the build directory of the sweep (bench.py adds it to the include path)
+#include "net/net.h"
+#include "net/model.h"
+
+#ifdef HOST
+// memory allocated by net_model_compute
+int l1_usage;
+int l2_usage;
+#endif//HOST
+
+int do_bench(rt_perf_t* perf, int events) {
+
+    // allocate result memory
+    int8_t * p_output = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_N);
+
+    //setup performance measurement
+    rt_perf_conf(perf, events);
+    
+    // start performance measurement
+    rt_perf_reset(perf);
+#ifdef HOST
+    rt_host_alloc_reset_peak();
+    l1_usage = -rt_host_alloc_peak(RT_ALLOC_CL_DATA);
+    l2_usage = -rt_host_alloc_peak(RT_ALLOC_L2_CL_DATA);
+#endif//HOST
+    rt_perf_start(perf);
+    
+    net_model_compute(x_vec, p_output);
+
+    rt_perf_stop(perf);
+#ifdef HOST
+    l1_usage += rt_host_alloc_peak(RT_ALLOC_CL_DATA);
+    l2_usage += rt_host_alloc_peak(RT_ALLOC_L2_CL_DATA);
+#endif//HOST
+
+    int num_err = 0;
+    for (int n = 0; n < NET_N; n++) {
+        if (p_output[n] != y_exp_vec[n]) {
+            num_err++;
+        }
+    }
+
+    // free memory
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_N);
+
+    return num_err;
+}
+
+void cluster_entry(void* arg) {
+
+    // setup performance measurement
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+
+    int result;
+
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR));
+
+    // print the results
+    if (result == 0) {
+        printf("## 1: result: OK\n");
+    } else {
+        printf("## 1: result: FAIL\n");
+    }
+    printf("## 1: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 1: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+#ifdef HOST
+    printf("## 1: l1: %d\n", l1_usage);
+    printf("## 1: l2_act: %d\n", l2_usage);
+#endif//HOST
+}
@@ -0,0 +1,179 @@
+"""
+NTT crossover: Compares the convolution of layer 1 with the number theoretic transform (NTT_CONV,
+src/cl/func/ntt.c) against func_xcorr_scale and the fused layer 1+2, for different filter lengths.
+
+For every filter length K, the F1 filters are applied to a single channel of T samples on a single
+core (both methods are parallelized over channels in the same way). The NTT transforms every block
+once and shares it among all F1 filters. Both results are checked against numpy. The fused kernel
+only exists for K = 64, its cycles are estimated with the cycles of its inner loops (the same model
+as python_utils/sparsity.py), which scale linearly with K.
+
+On the platform host, the measured values are nanoseconds instead of cycles. Then, the crossover is
+only computed against func_xcorr_scale, since the estimate of the fused kernel is in cycles. On the
+host build, the NTT is about 2x slower than func_xcorr_scale for K = 64 (0.4x to 0.6x over several
+runs), and roughly on par at K = 128. The crossover on the cluster (GVSOC or the board) has not been
+measured.
+
+Usage (from this directory, with python_utils in the PYTHONPATH):
+    python3 bench.py                      # K = 16, 32, 48, 64, 96, 128
+    python3 bench.py -k 64 -k 256         # only those filter lengths
+    python3 bench.py --csv crossover.csv  # additionally store the results as csv
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/10"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import argparse
+import csv
+import os
+import numpy as np
+
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray
+from makefile import Makefile
+import ntt
+from sparsity import CYCLES_L1_CHANNEL, CYCLES_L1_GROUP
+
+BENCHNAME = "bench::ntt_crossover"
+RESULT_FILE = "result.out"
+
+DEFAULT_FILTER_LENGTHS = [16, 32, 48, 64, 96, 128]
+NUM_FILTERS = 8
+NUM_SAMPLES = 1125
+
+
+def fused_cycles(filter_len, num_filters=NUM_FILTERS, num_samples=NUM_SAMPLES):
+    """ Estimated cycles of the convolution in the fused layer 1+2 for a single channel """
+    num_calls = (num_samples + 3) // 4
+    return num_filters * num_calls * (CYCLES_L1_CHANNEL + CYCLES_L1_GROUP * ((filter_len + 3) // 4))
+
+
+def gen_stimuli(filter_len):
+    """ generates the input, the filters (reversed, like layer 1) and the expected output """
+    vec_a = np.random.randint(-128, 128, NUM_SAMPLES + filter_len - 1)
+    vec_b = np.random.randint(-127, 128, (NUM_FILTERS, filter_len))
+    div_factor = 128 * filter_len // 8
+    offset = 10 * div_factor
+    result = np.stack([np.correlate(vec_a, b, mode="valid") for b in vec_b])
+    result = np.clip(((result + offset) / div_factor).astype(int), -128, 127)
+    return vec_a, vec_b, div_factor, offset, result
+
+
+def run(filter_len):
+    """ Run both methods on the device, returns the parsed result """
+    length = ntt.ntt_len(filter_len)
+    vec_a, vec_b, div_factor, offset, vec_exp = gen_stimuli(filter_len)
+    twiddle = np.concatenate([ntt.twiddles(length), ntt.twiddles(length, inverse=True)])
+    spectrum = np.stack([ntt.filter_spectrum(b, length) for b in vec_b])
+
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderConstant("NUM_FILTERS", NUM_FILTERS))
+    header.add(HeaderConstant("LENGTH_A", len(vec_a)))
+    header.add(HeaderConstant("LENGTH_B", filter_len))
+    header.add(HeaderConstant("LENGTH_RES", NUM_SAMPLES))
+    header.add(HeaderConstant("LENGTH_NTT", length))
+    header.add(HeaderConstant("FACTOR", div_factor))
+    header.add(HeaderConstant("OFFSET", offset))
+    header.add(HeaderArray("vecA", "int8_t", vec_a))
+    header.add(HeaderArray("vecB", "int8_t", vec_b.ravel()))
+    header.add(HeaderArray("vecTwiddle", "uint32_t", twiddle))
+    header.add(HeaderArray("vecSpectrum", "uint32_t", spectrum.ravel()))
+    header.add(HeaderArray("vecExp", "int8_t", vec_exp.ravel()))
+    header.write()
+
+    mkf = Makefile()
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    mkf.add_cl_prog_source("func/xcorr.c")
+    mkf.add_cl_prog_source("func/ntt.c")
+    mkf.add_define("CONV_VERSION", 2)
+    mkf.write()
+
+    os.system("make clean all run > {}".format(RESULT_FILE))
+    return parse_output(RESULT_FILE)
+
+
+def bench(filter_lengths, csv_file=None):
+    """
+    Execute the benchmark
+
+    Parameters:
+    - filter_lengths: list of int, filter lengths K
+    - csv_file: filename to store the results, or None
+
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(BENCHNAME)
+
+    rows = []
+    for filter_len in filter_lengths:
+        result = run(filter_len)
+        logger.show_subcase_result("K = {}, xcorr".format(filter_len), {"1": result["1"]})
+        logger.show_subcase_result("K = {}, ntt".format(filter_len), {"2": result["2"]})
+        rows.append({"K": filter_len,
+                     "N": ntt.ntt_len(filter_len),
+                     "xcorr": int(result["1"]["cycles"]),
+                     "ntt": int(result["2"]["cycles"]),
+                     "fused": fused_cycles(filter_len)})
+
+    # print the table
+    print("\n{:>5} {:>5} {:>12} {:>12} {:>14} {:>10}".format(
+        "K", "N", "xcorr", "ntt", "fused (est.)", "ntt gain"))
+    on_host = "platform=host" in os.environ.get("PULP_CURRENT_CONFIG_ARGS", "")
+    crossover = None
+    for row in rows:
+        best = row["xcorr"] if on_host else min(row["xcorr"], row["fused"])
+        if crossover is None and row["ntt"] < best:
+            crossover = row["K"]
+        print("{:>5} {:>5} {:>12} {:>12} {:>14} {:>9.2f}x".format(
+            row["K"], row["N"], row["xcorr"], row["ntt"], row["fused"], best / row["ntt"]))
+    print("({} for {} filters on one channel of {} samples, single core{})".format(
+        "ns" if on_host else "cycles", NUM_FILTERS, NUM_SAMPLES,
+        ", the gain is only against xcorr" if on_host else ""))
+
+    if crossover is None:
+        print("\nThe NTT is slower for all filter lengths")
+    else:
+        print("\nThe NTT is faster for K >= {} (first length in the sweep)".format(crossover))
+
+    if csv_file is not None:
+        with open(csv_file, "w") as _f:
+            writer = csv.DictWriter(_f, fieldnames=["K", "N", "xcorr", "ntt", "fused"])
+            writer.writeheader()
+            writer.writerows(rows)
+
+    return logger.summary()
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser("Crossover of the NTT convolution")
+    parser.add_argument("-k", "--filter-len", type=int, action="append", default=None,
+                        help="filter length (can be used multiple times)")
+    parser.add_argument("--csv", default=None, help="store the results in this csv file")
+    args = parser.parse_args()
+
+    bench(DEFAULT_FILTER_LENGTHS if args.filter_len is None else args.filter_len, args.csv)
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+#include "../../../src/cl/func/functional.h"
+
+/*
+ * Computes NUM_FILTERS filters of length LENGTH_B on one channel (LENGTH_A samples) on a single
+ * core, once with func_xcorr_scale, and once with the NTT (overlap-save), where the forward
+ * transform of every block is shared by all filters (like layer 1 with NTT_CONV).
+ */
+
+RT_CL_DATA static int8_t* pA_l1;
+RT_CL_DATA static int8_t* pB_l1;
+RT_CL_DATA static uint32_t* pTwiddle_l1;
+RT_CL_DATA static uint32_t* pSpectrum_l1;
+RT_CL_DATA static uint32_t* pBuffer_l1;
+RT_CL_DATA static int8_t* pRes_l1;
+
+int check_result() {
+    int num_err = 0;
+    for (int i = 0; i < NUM_FILTERS * LENGTH_RES; i++) {
+        if (pRes_l1[i] != vecExp[i]) {
+            num_err++;
+        }
+    }
+    return num_err;
+}
+
+void compute_xcorr() {
+    for (int k = 0; k < NUM_FILTERS; k++) {
+        func_xcorr_scale(pA_l1, LENGTH_A, pB_l1 + k * LENGTH_B, LENGTH_B,
+                         FACTOR, OFFSET, pRes_l1 + k * LENGTH_RES);
+    }
+}
+
+void compute_ntt() {
+    uint32_t* pInput = pBuffer_l1;
+    uint32_t* pProduct = pBuffer_l1 + LENGTH_NTT;
+    unsigned int step = LENGTH_NTT - LENGTH_B + 1;
+    for (unsigned int start = 0; start < LENGTH_RES; start += step) {
+        unsigned int in_len = LENGTH_A - start < LENGTH_NTT ? LENGTH_A - start : LENGTH_NTT;
+        unsigned int num = LENGTH_RES - start < step ? LENGTH_RES - start : step;
+        func_ntt_load(pA_l1 + start, in_len, LENGTH_NTT, pInput);
+        func_ntt_forward(pInput, LENGTH_NTT, pTwiddle_l1);
+        for (int k = 0; k < NUM_FILTERS; k++) {
+            func_ntt_pointwise(pInput, pSpectrum_l1 + k * LENGTH_NTT, LENGTH_NTT, pProduct);
+            func_ntt_inverse(pProduct, LENGTH_NTT, pTwiddle_l1 + LENGTH_NTT / 2);
+            func_ntt_transform_8bit(pProduct + LENGTH_B - 1, num, FACTOR, OFFSET,
+                                    pRes_l1 + k * LENGTH_RES + start);
+        }
+    }
+}
+
+int do_bench(rt_perf_t* perf, int events, void (*compute)()) {
+
+    for (int i = 0; i < NUM_FILTERS * LENGTH_RES; i++) {
+        pRes_l1[i] = 0;
+    }
+
+    //setup performance measurement
+    rt_perf_conf(perf, events);
+    
+    // start performance measurement
+    rt_perf_reset(perf);
+    rt_perf_start(perf);
+    
+    compute();
+
+    rt_perf_stop(perf);
+
+    return check_result();
+}
+
+void cluster_entry(void* arg) {
+
+    // allocate memory
+    pA_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(vecA));
+    pB_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(vecB));
+    pTwiddle_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(vecTwiddle));
+    pSpectrum_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(vecSpectrum));
+    pBuffer_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(uint32_t) * 2 * LENGTH_NTT);
+    pRes_l1 = rt_alloc(RT_ALLOC_CL_DATA, sizeof(vecExp));
+
+    // copy memory
+    rt_dma_copy_t copy;
+    rt_dma_memcpy((unsigned int)vecA, (unsigned int)pA_l1, sizeof(vecA), RT_DMA_DIR_EXT2LOC, 0, &copy);
+    rt_dma_memcpy((unsigned int)vecB, (unsigned int)pB_l1, sizeof(vecB), RT_DMA_DIR_EXT2LOC, 1, &copy);
+    rt_dma_memcpy((unsigned int)vecTwiddle, (unsigned int)pTwiddle_l1, sizeof(vecTwiddle), RT_DMA_DIR_EXT2LOC, 1, &copy);
+    rt_dma_memcpy((unsigned int)vecSpectrum, (unsigned int)pSpectrum_l1, sizeof(vecSpectrum), RT_DMA_DIR_EXT2LOC, 1, &copy);
+    rt_dma_wait(&copy);
+
+    // setup performance measurement
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+
+    int result;
+
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR), compute_xcorr);
+    printf("## 1: result: %s\n", result == 0 ? "OK" : "FAIL");
+    printf("## 1: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 1: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR), compute_ntt);
+    printf("## 2: result: %s\n", result == 0 ? "OK" : "FAIL");
+    printf("## 2: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 2: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+#include "../../../../src/cl/net/net.h"
+#include "../../../../src/cl/net/blob.h"
+#include "../../../../src/cl/net/model.h"
+
+/**
+ * @brief Computes the model and returns the number of wrong outputs
+ */
+int check_model(const int8_t* p_exp) {
+
+    int8_t * p_output = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * NET_N);
+
+    net_model_compute(x_vec, p_output);
+
+    int num_err = 0;
+    for (int n = 0; n < NET_N; n++) {
+        if (p_output[n] != p_exp[n]) {
+            num_err++;
+        }
+    }
+
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*)p_output, sizeof(int8_t) * NET_N);
+    return num_err;
+}
+
+void print_result(int id, int status, int num_err) {
+    printf("## %d: result: %s\n", id, num_err == 0 ? "OK" : "FAIL");
+    printf("## %d: status: %d\n", id, status);
+}
+
+/**
+ * @brief Loads the blob and measures the number of cycles
+ */
+int load_blob(rt_perf_t* perf, const uint8_t* p_blob, unsigned int size, int id) {
+    rt_perf_reset(perf);
+    rt_perf_start(perf);
+    int status = net_blob_load(p_blob, size);
+    rt_perf_stop(perf);
+    printf("## %d: cycles: %d\n", id, rt_perf_read(RT_PERF_CYCLES));
+    return status;
+}
+
+void cluster_entry(void* arg) {
+
+    int status;
+
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+    rt_perf_conf(&perf, (1<<RT_PERF_CYCLES));
+
+    // compiled model
+    print_result(1, 0, check_model(y_exp_vec));
+
+    // load the retrained model
+    status = load_blob(&perf, blob_vec, BLOB_SIZE, 2);
+    print_result(2, status, (status != NET_BLOB_OK) + check_model(y_blob_exp_vec));
+
+    // corrupted blob must be rejected, and the loaded model must stay active
+    status = net_blob_load(blob_crc_vec, BLOB_SIZE);
+    print_result(3, status, (status != NET_BLOB_ERR_CRC) + check_model(y_blob_exp_vec));
+
+    // blob of a network with different dimensions
+    status = net_blob_load(blob_shape_vec, BLOB_SIZE);
+    print_result(4, status, (status != NET_BLOB_ERR_SHAPE) + check_model(y_blob_exp_vec));
+
+    // truncated blob
+    status = net_blob_load(blob_vec, BLOB_SIZE - 4);
+    print_result(5, status, (status != NET_BLOB_ERR_FORMAT) + check_model(y_blob_exp_vec));
+
+    // back to the compiled model
+    net_blob_unload();
+    print_result(6, 0, check_model(y_exp_vec));
+
+    // load the retrained model with compressed weights
+    status = load_blob(&perf, blob_z_vec, BLOB_Z_SIZE, 7);
+    print_result(7, status, (status != NET_BLOB_OK) + check_model(y_blob_exp_vec));
+    net_blob_unload();
+
+    // blob of a network with pool sums of layer 2, which do not fit into the compiled fused layer
+    status = net_blob_load(blob_bits_vec, BLOB_SIZE);
+    print_result(8, status, (status != NET_BLOB_ERR_SHAPE) + check_model(y_exp_vec));
+}
@@ -0,0 +1,176 @@
+"""
+This file will test loading the model blob at runtime (src/cl/net/blob.c)
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import os
+import zlib
+import numpy as np
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray
+from makefile import Makefile
+from golden_model import GoldenModel
+import functional as F
+import net_blob
+
+TESTNAME = "cl::net::blob"
+RESULT_FILE = "result.out"
+
+INPUT_FILENAME = "../../../../data/verification.npz"
+NET_FILENAME = "../../../../data/net.npz"
+CONFIG_FILENAME = "../../../../data/config.json"
+GENERATOR_DIR = "../../../../data"
+RETRAINED_NET_FILENAME = "net_retrained.npz"
+BLOB_FILENAME = "net_retrained.bin"
+COMPRESSED_BLOB_FILENAME = "net_retrained_z.bin"
+
+DEFINES = ["INTRINSIC_SCALE", "FLIP_LAYERS", "PARALLEL", "DMA_STREAM", "CROSS_CORRELATE",
+           "FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "REORDER_BN", "DUPLICATE_FEATUREMAP"]
+
+CASES = ["compiled model", "load", "corrupted", "wrong shape", "truncated", "unload",
+         "load compressed", "wrong bits"]
+
+
+def gen_blob(net_filename, blob_filename, compress=False):
+    """ Generates the model blob of the network with data/gen_net_header.py """
+    cwd = os.getcwd()
+    os.system("cd {} && python3 gen_net_header.py -n {} -c config.json -o {} -b {} {}".format(
+        GENERATOR_DIR, os.path.join(cwd, net_filename), os.path.join(cwd, "net_tmp.h"),
+        os.path.join(cwd, blob_filename), "-z" if compress else ""))
+    os.remove("net_tmp.h")
+    os.remove("net_tmp.c")
+
+
+def patch_header(blob, word, value):
+    """ Changes a word of the header, and fixes the checksum of the header """
+    words = np.frombuffer(blob, dtype="<u4").copy()
+    words[word] = value
+    words[2] = 0
+    table_len = net_blob.HEADER_WORDS + net_blob.SECTION_WORDS * len(net_blob.SECTIONS)
+    words[2] = zlib.crc32(words[:table_len].tobytes())
+    return words.tobytes()
+
+
+def gen_stimuli():
+    """
+    This function generates the stimuli (input and output) for the test
+    """
+
+    # retrained network with the same dimensions. Negating the weights keeps them on the
+    # quantization grid.
+    net = dict(np.load(NET_FILENAME))
+    for key in ["conv1.weightFrozen", "fc.weightFrozen", "fc.bias"]:
+        net[key] = -net[key]
+    np.savez(RETRAINED_NET_FILENAME, **net)
+
+    gen_blob(RETRAINED_NET_FILENAME, BLOB_FILENAME)
+    with open(BLOB_FILENAME, "rb") as _f:
+        blob = _f.read()
+    gen_blob(RETRAINED_NET_FILENAME, COMPRESSED_BLOB_FILENAME, compress=True)
+    with open(COMPRESSED_BLOB_FILENAME, "rb") as _f:
+        blob_z = _f.read()
+
+    model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False,
+                        no_scale_between_l1_l2=True, reorder_bn=True)
+    retrained_model = GoldenModel(CONFIG_FILENAME, RETRAINED_NET_FILENAME, clip_balanced=False,
+                                  no_scale_between_l1_l2=True, reorder_bn=True)
+    os.remove(RETRAINED_NET_FILENAME)
+    os.remove(BLOB_FILENAME)
+    os.remove(COMPRESSED_BLOB_FILENAME)
+
+    # flip a single bit in the weights of layer 5
+    blob_crc = bytearray(blob)
+    blob_crc[-1] ^= 0x10
+
+    # change the number of samples T
+    blob_shape = patch_header(blob, 9, np.frombuffer(blob, dtype="<u4")[9] + 8)
+
+    # pool sums of layer 2 with 33 bits (the compiled network needs 31 bits, without L2_RELU_CAP)
+    _, scalars, _ = net_blob.decode(blob)
+    blob_bits = patch_header(blob, net_blob.BITS_WORD, scalars["l1_result_bits"] | 33 << 16)
+
+    x = np.load(INPUT_FILENAME)["input"][0, :, :]
+    x = F.quantize_to_int(x, model.input_scale)
+    C, T = x.shape
+    x_pad = np.zeros((C, T + 63), dtype=int)
+    x_pad[:, 31:31 + T] = x
+
+    return (x_pad, model(x), retrained_model(x), blob, bytes(blob_crc), blob_shape, blob_z,
+            blob_bits)
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME)
+
+    # generate makefile
+    mkf = Makefile()
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    for source in ["model.c", "layer1.c", "layer2.c", "layer3.c", "layer4.c", "layer5.c",
+                   "fused_layer_1_2.c", "net.c", "blob.c", "stream.c"]:
+        mkf.add_cl_prog_source("net/{}".format(source))
+    for source in ["transform.c", "dotp.c", "conv.c", "flip.c", "xcorr.c"]:
+        mkf.add_cl_prog_source("func/{}".format(source))
+    for define in DEFINES:
+        mkf.add_define(define)
+    mkf.write()
+
+    # generate the stimuli
+    x, y_exp, y_blob_exp, blob, blob_crc, blob_shape, blob_z, blob_bits = gen_stimuli()
+
+    # prepare header file
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderConstant("BLOB_SIZE", len(blob)))
+    header.add(HeaderConstant("BLOB_Z_SIZE", len(blob_z)))
+    header.add(HeaderArray("x_vec", "int8_t", x.ravel()))
+    header.add(HeaderArray("y_exp_vec", "int8_t", y_exp.ravel()))
+    header.add(HeaderArray("y_blob_exp_vec", "int8_t", y_blob_exp.ravel()))
+    header.add(HeaderArray("blob_vec", "uint8_t", list(blob)))
+    header.add(HeaderArray("blob_crc_vec", "uint8_t", list(blob_crc)))
+    header.add(HeaderArray("blob_shape_vec", "uint8_t", list(blob_shape)))
+    header.add(HeaderArray("blob_z_vec", "uint8_t", list(blob_z)))
+    header.add(HeaderArray("blob_bits_vec", "uint8_t", list(blob_bits)))
+    header.write()
+
+    # compile and run
+    os.system("make clean all run > {}".format(RESULT_FILE))
+
+    # parse output
+    result = parse_output(RESULT_FILE)
+    for i, case in enumerate(CASES):
+        result.setdefault(str(i + 1), {"result": False})["case"] = case
+
+    # log the result
+    logger.show_subcase_result("blob", result)
+
+    # return summary
+    return logger.summary()
@@ -26,10 +26,19 @@
 #include "../../../../src/cl/net/net.h"
 #include "../../../../src/cl/net/layers.h"
 
+// the window test uses a window of arbitrary length, with an unaligned output
+#ifdef WINDOW_LEN
+#define OUT_T8 (WINDOW_LEN / 8)
+#define OUT_T8_ALIGN (WINDOW_LEN / 8)
+#else//WINDOW_LEN
+#define OUT_T8 NET_T8
+#define OUT_T8_ALIGN NET_T8_ALIGN
+#endif//WINDOW_LEN
+
 int do_bench(rt_perf_t* perf, int events) {
 
     // allocate result memory
-    int8_t * p_output = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    int8_t * p_output = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_F2 * OUT_T8_ALIGN);
     
     //setup performance measurement
     rt_perf_conf(perf, events);
@@ -38,22 +47,26 @@ int do_bench(rt_perf_t* perf, int events) {
     rt_perf_reset(perf);
     rt_perf_start(perf);
     
+#ifdef WINDOW_LEN
+    net_fused_layer_1_2_window(x_vec, p_output, WINDOW_LEN);
+#else//WINDOW_LEN
     net_fused_layer_1_2(x_vec, p_output);
+#endif//WINDOW_LEN
 
     rt_perf_stop(perf);
 
     int num_err = 0;
     for (int k = 0; k < NET_F2; k++) {
-        for (int t = 0; t < NET_T8; t++) {
-            if (p_output[k * NET_T8_ALIGN + t] != y_exp_vec[k * NET_T8_ALIGN + t]) {
+        for (int t = 0; t < OUT_T8; t++) {
+            if (p_output[k * OUT_T8_ALIGN + t] != y_exp_vec[k * OUT_T8_ALIGN + t]) {
                 num_err++;
-                printf("error at: k=%d, t=%d, acq=%d, exp=%d\n", k, t, p_output[k * NET_T8_ALIGN + t], y_exp_vec[k * NET_T8_ALIGN + t]);
+                printf("error at: k=%d, t=%d, acq=%d, exp=%d\n", k, t, p_output[k * OUT_T8_ALIGN + t], y_exp_vec[k * OUT_T8_ALIGN + t]);
             }
         }
     }
 
     // free memory
-    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F2 * OUT_T8_ALIGN);
 
     return num_err;
 }
@@ -29,12 +29,14 @@ __copyright__ = """
 
 import random
 import os
+import json
 import numpy as np
 from test_utils import parse_output, TestLogger
 from header_file import HeaderFile, HeaderConstant, HeaderArray, align_array
 from makefile import Makefile
-from golden_model import GoldenModel
+from golden_model import GoldenModel, FusedLayer12
 import functional as F
+import value_range
 
 TESTNAME = "cl::net::Fused Layer 1 and 2"
 RESULT_FILE = "result.out"
@@ -44,14 +46,39 @@ NET_FILENAME = "../../../../data/net.npz"
 CONFIG_FILENAME = "../../../../data/config.json"
 
 
-def gen_stimuli(random_input, no_div=False, pad_data=False):
+def int16_input_bound():
     """
-    This function generates the stimuli (input and output) for the test
+    Returns the largest bound r, such that the results of layer 1 fit into 16 bits for every input in
+    [-r, r] (python_utils/value_range.py). Used to test the 16bit kernel (L1_RESULT_INT16) with the
+    trained network, where the results of layer 1 do not fit into 16 bits for every input.
+    """
+    with open(CONFIG_FILENAME, "r") as _f:
+        net_params = json.load(_f)["indiv"]["net"]["params"]
+    net = np.load(NET_FILENAME)
+    bound = 1
+    while value_range.l1_result_bits(value_range.analyze(net, net_params, (-bound - 1, bound + 1))) <= 16:
+        bound += 1
+    return bound
+
+
+def gen_stimuli(random_input, no_div=False, pad_data=False, interleave_data=False, t_len=None,
+                input_bound=None):
+    """
+    This function generates the stimuli (input and output) for the test. If t_len is set, a random
+    window of this length is generated, and the output is not aligned. If input_bound is set, a
+    random input in [-input_bound, input_bound] is generated.
     """
     if no_div:
         model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False, no_scale_between_l1_l2=True)
         layer = model.layers[0]
-        if random_input:
+        if t_len is not None:
+            # same layer, but for a window of a different length
+            layer = FusedLayer12(np.load(NET_FILENAME), model.C, t_len, model.F1, model.F2,
+                                 clip_balanced=False)
+            x = np.random.randint(-60, 60, (model.C, t_len))
+        elif input_bound is not None:
+            x = np.random.randint(-input_bound, input_bound + 1, (model.C, model.T))
+        elif random_input:
             x = np.random.randint(-60, 60, (model.C, model.T))
         else:
             x = np.load(INPUT_FILENAME)["input"][0, :, :]
@@ -68,12 +95,15 @@ def gen_stimuli(random_input, no_div=False, pad_data=False):
             x = F.quantize_to_int(x, layer1.input_scale)
         y_exp = layer2(layer1(x))
 
-    y_exp_align = align_array(y_exp)
+    y_exp_align = align_array(y_exp) if t_len is None else y_exp
 
-    if pad_data:
+    if interleave_data:
+        # samples of all channels are interleaved, not padded
+        return x, x.T, y_exp, y_exp_align
+    elif pad_data:
         C, T = x.shape
         T_pad = T + 63
-        assert T_pad % 4 == 0
+        assert T_pad % 4 == 0 or t_len is not None
         x_pad = np.zeros((C, T_pad), dtype=np.int)
         x_pad[:, 31:31 + T] = x
         return x, x_pad, y_exp, y_exp_align
@@ -90,9 +120,27 @@ def test():
 
     logger = TestLogger(TESTNAME)
 
-    for no_intermediate_scale, duplicate_featuremap in [(False, False),
-                                                        (True, False),
-                                                        (True, True)]:
+    for no_intermediate_scale, duplicate_featuremap, interleaved_input, dup_in_l1, \
+            ring_buffer, channel_tiles, t_len, int16 in [
+            (False, False, False, False, False, False, None, False),
+            (True, False, False, False, False, False, None, False),
+            (True, True, False, False, False, False, None, False),
+            (True, True, True, False, False, False, None, False),
+            (True, True, False, True, False, False, None, False),
+            (True, True, True, True, False, False, None, False),
+            (True, True, False, True, True, False, None, False),
+            (True, True, True, True, True, False, None, False),
+            (True, True, False, True, True, False, 100, False),
+            (True, True, False, True, True, False, 3001, False),
+            (True, True, True, True, True, False, 9000, False),
+            (True, True, False, True, True, True, None, False),
+            (True, True, True, True, True, True, None, False),
+            (True, True, False, True, True, True, 3001, False),
+            (True, True, False, False, False, False, None, True),
+            (True, True, False, True, False, False, None, True),
+            (True, True, False, True, True, False, None, True),
+            (True, True, True, True, True, False, None, True),
+            (True, True, False, True, True, True, None, True)]:
 
         # generate makefile
         # mkf = Makefile(opt_level=2 if duplicate_featuremap else 3)
@@ -101,6 +149,7 @@ def test():
         mkf.add_cl_test_source("cluster.c")
         mkf.add_cl_prog_source("net/fused_layer_1_2.c")
         mkf.add_cl_prog_source("net/net.c")
+        mkf.add_cl_prog_source("net/blob.c")
         mkf.add_cl_prog_source("func/conv.c")
         mkf.add_cl_prog_source("func/xcorr.c")
         mkf.add_cl_prog_source("func/dotp.c")
@@ -118,16 +167,34 @@ def test():
         if duplicate_featuremap:
             mkf.add_define("DUPLICATE_FEATUREMAP")
 
+        if interleaved_input:
+            mkf.add_define("INTERLEAVED_INPUT")
+
+        if dup_in_l1:
+            mkf.add_define("DUPLICATE_IN_L1")
+
+        if ring_buffer:
+            mkf.add_define("RING_BUFFER")
+
+        if channel_tiles:
+            mkf.add_define("CHANNEL_TILES")
+
+        if int16:
+            mkf.add_define("L1_RESULT_INT16")
+
         mkf.write()
 
         random_input = False
 
         # generate the stimuli
         _, x_align, _, y_exp_align = gen_stimuli(random_input, no_intermediate_scale,
-                                                 duplicate_featuremap)
+                                                 duplicate_featuremap, interleaved_input, t_len,
+                                                 int16_input_bound() if int16 else None)
 
         # prepare header file
         header = HeaderFile("test_stimuli.h")
+        if t_len is not None:
+            header.add(HeaderConstant("WINDOW_LEN", t_len))
         header.add(HeaderArray("x_vec", "int8_t", x_align.ravel()))
         header.add(HeaderArray("y_exp_vec", "int8_t", y_exp_align.ravel()))
         header.write()
@@ -144,6 +211,18 @@ def test():
             options.append("no scale")
         if duplicate_featuremap:
             options.append("dup inp")
+        if interleaved_input:
+            options.append("interleaved")
+        if dup_in_l1:
+            options.append("dup in L1")
+        if ring_buffer:
+            options.append("ring")
+        if channel_tiles:
+            options.append("tiles")
+        if t_len is not None:
+            options.append("T={}".format(t_len))
+        if int16:
+            options.append("int16")
 
         subcase_name = "Fused Layer 1+2 "
         if options:
@@ -0,0 +1,164 @@
+"""
+This file will test the input stage (quantization of the raw ADC samples, src/cl/net/input_stage.c)
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import os
+import re
+import numpy as np
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderArray, align_array_size
+from makefile import Makefile
+import convert_torch_format as convert
+import functional as F
+
+TESTNAME = "cl::net::input_stage"
+RESULT_FILE = "result.out"
+
+INPUT_FILENAME = "../../../../data/verification.npz"
+NET_FILENAME = "../../../../data/net.npz"
+NET_HEADER = "../../../../src/cl/net/net.h"
+
+# same as the default in data/gen_net_header.py
+ADC_LSB = 2 ** -12
+
+
+def read_constant(name, filename=NET_HEADER):
+    """ Reads the value of a constant, defined in the header file """
+    with open(filename, "r") as _f:
+        match = re.search(r"#define {} (-?\d+)".format(name), _f.read())
+    assert match, "{} is not defined in {}".format(name, filename)
+    return int(match.group(1))
+
+
+def adc_codes(x, adc_bits, adc_lsb=ADC_LSB):
+    """ Converts the input into raw ADC codes (same as data/gen_input_header.py) """
+    code_max = 2 ** (adc_bits - 1) - 1
+    return np.clip(np.round(x / adc_lsb), -code_max - 1, code_max).astype(np.int)
+
+
+def gen_stimuli(random_input, duplicate_featuremap, interleaved, adc_bits, factor, shift):
+    """
+    This function generates the stimuli (input and output) for the test. If interleaved is set, the
+    samples are of shape [T, C], and the result is not padded.
+    """
+    if random_input:
+        # uses the full range of the ADC, such that a large part of the samples saturates
+        shape = (read_constant("NET_C"), read_constant("NET_T"))
+        x = np.random.randint(-2 ** (adc_bits - 1), 2 ** (adc_bits - 1), shape)
+    else:
+        x = adc_codes(np.load(INPUT_FILENAME)["input"][0, :, :], adc_bits)
+    y = F.quantize_adc(x, factor, shift)
+
+    C, T = x.shape
+    if interleaved:
+        return x.T, y.T
+    if duplicate_featuremap:
+        y_exp = np.zeros((C, T + 63), dtype=np.int)
+        y_exp[:, 31:31 + T] = y
+    else:
+        y_exp = np.zeros((C, align_array_size(T)), dtype=np.int)
+        y_exp[:, :T] = y
+    return x, y_exp
+
+
+def python_deviation():
+    """
+    Compares the fixed-point quantization to the floating point quantization of the golden model
+    Returns: dictionary: {"result": bool, "max error": int}
+    """
+    net = np.load(NET_FILENAME)
+    input_scale = convert.ste_quant(net, "quant1")
+    shift = read_constant("NET_INPUT_SHIFT")
+    factor = convert.adc_factor(input_scale, ADC_LSB, shift)
+    x = adc_codes(np.load(INPUT_FILENAME)["input"], 16)
+    # also check the values around the quantization boundaries
+    x = np.concatenate([x.ravel(), np.arange(-2 ** 15, 2 ** 15)])
+    y = F.quantize_adc(x, factor, shift)
+    y_ref = F.quantize_to_int(x * ADC_LSB, input_scale)
+    max_err = int(np.abs(y - y_ref).max())
+    return {"result": max_err <= 1, "max error": max_err}
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME, show_title=False)
+
+    adc_bits = read_constant("NET_INPUT_ADC_BITS")
+    factor = read_constant("NET_INPUT_FACTOR")
+    shift = read_constant("NET_INPUT_SHIFT")
+
+    for duplicate_featuremap, interleaved in [(False, False), (True, False), (True, True)]:
+        for random_input in [False, True]:
+
+            # generate makefile
+            mkf = Makefile()
+            mkf.add_fc_test_source("test.c")
+            mkf.add_cl_test_source("cluster.c")
+            mkf.add_cl_prog_source("net/input_stage.c")
+            mkf.add_cl_prog_source("net/net.c")
+            mkf.add_cl_prog_source("net/blob.c")
+            if duplicate_featuremap:
+                mkf.add_define("DUPLICATE_FEATUREMAP")
+            if interleaved:
+                mkf.add_define("INTERLEAVED_INPUT")
+            mkf.write()
+
+            # generate the stimuli
+            x, y_exp = gen_stimuli(random_input, duplicate_featuremap, interleaved, adc_bits, factor,
+                                   shift)
+
+            # prepare header file
+            header = HeaderFile("test_stimuli.h")
+            header.add(HeaderArray("x_vec", "int16_t" if adc_bits <= 16 else "int32_t",
+                                   x.ravel()))
+            header.add(HeaderArray("y_exp_vec", "int8_t", y_exp.ravel()))
+            header.write()
+
+            # compile and run
+            os.system("make clean all run > {}".format(RESULT_FILE))
+
+            # parse output
+            result = parse_output(RESULT_FILE)
+
+            # log the result
+            subcase_name = "Input Stage "
+            subcase_name += "random" if random_input else "real"
+            if duplicate_featuremap:
+                subcase_name += " + dup inp"
+            if interleaved:
+                subcase_name += " + interleaved"
+            logger.show_subcase_result(subcase_name, result)
+
+    logger.show_subcase_result("Deviation to golden model", {"1": python_deviation()})
+
+    # return summary
+    return logger.summary()
@@ -25,6 +25,7 @@
 #include "../../../../src/cl/func/functional.h"
 #include "../../../../src/cl/net/net.h"
 #include "../../../../src/cl/net/layers.h"
+#include "../../../../src/cl/net/blob.h"
 
 int do_bench(rt_perf_t* perf, int events) {
 
@@ -50,9 +51,16 @@ int do_bench(rt_perf_t* perf, int events) {
             p_output_tmp = p_output + (k * NET_C_ALIGN + ch) * NET_T_ALIGN;
             p_exp_tmp = y_exp_vec + (k * NET_C + ch) * NET_T_ALIGN;
             for (int t = 0; t < NET_T; t++) {
+#ifdef DMA_FLIP
+                // the output is transposed, of shape [NET_F1, NET_T_ALIGN, NET_C_ALIGN]
+                if (p_output[(k * NET_T_ALIGN + t) * NET_C_ALIGN + ch] != *(p_exp_tmp)) {
+                    num_err += 1;
+                }
+#else//DMA_FLIP
                 if (*(p_output_tmp) != *(p_exp_tmp)) {
                     num_err += 1;
                 }
+#endif//DMA_FLIP
                 p_output_tmp++;
                 p_exp_tmp++;
             }
@@ -60,7 +68,7 @@ int do_bench(rt_perf_t* perf, int events) {
     }
 
     // free memory
-    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F1 * NET_C * NET_T_ALIGN);
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F1 * NET_C_ALIGN * NET_T_ALIGN);
 
     return num_err;
 }
@@ -83,4 +91,19 @@ void cluster_entry(void* arg) {
     }
     printf("## 1: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
     printf("## 1: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+
+#ifdef NTT_CONV
+    // compute the spectra of the filters on the device (like with a model blob)
+    net_params.l1_ntt_spectrum = NULL;
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR));
+    net_params.l1_ntt_spectrum = net_l1_ntt_spectrum;
+
+    if (result == 0) {
+        printf("## 2: result: OK\n");
+    } else {
+        printf("## 2: result: FAIL\n");
+    }
+    printf("## 2: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 2: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+#endif//NTT_CONV
 }
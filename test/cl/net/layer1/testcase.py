@@ -69,77 +69,107 @@ def test():
     for intrinsic_conv_scale in [False, True]:
         for simd in [False, True]:
             for parallel in [False, True]:
-                for cross_correlate in [False, True]:
-
-                    if not simd and (parallel or cross_correlate):
-                        continue
-
-                    # parallel requires intrinsic conv scale
-                    if parallel and not intrinsic_conv_scale:
-                        continue
-
-                    # not implemented
-                    if cross_correlate and not parallel:
-                        continue
-
-                    # generate makefile
-                    mkf = Makefile()
-                    mkf.add_fc_test_source("test.c")
-                    mkf.add_cl_test_source("cluster.c")
-                    mkf.add_cl_prog_source("net/layer1.c")
-                    mkf.add_cl_prog_source("net/net.c")
-                    mkf.add_cl_prog_source("func/conv.c")
-                    mkf.add_cl_prog_source("func/xcorr.c")
-                    mkf.add_cl_prog_source("func/transform.c")
-
-                    if parallel:
-                        mkf.add_define("PARALLEL")
-                    if intrinsic_conv_scale:
-                        mkf.add_define("INTRINSIC_SCALE")
-                    if cross_correlate:
-                        mkf.add_define("CROSS_CORRELATE")
-                    if not simd:
-                        mkf.add_define("NO_SIMD")
-
-                    mkf.write()
-
-                    random_input = False
-
-                    # generate the stimuli
-                    x, y_exp = gen_stimuli(random_input)
-                    x_align = align_array(x)
-                    y_exp_align = align_array(y_exp)
-
-                    # prepare header file
-                    header = HeaderFile("test_stimuli.h")
-                    header.add(HeaderArray("x_vec", "int8_t", x_align.ravel()))
-                    header.add(HeaderArray("y_exp_vec", "int8_t", y_exp_align.ravel()))
-                    header.write()
-
-                    # compile and run
-                    os.system("make clean all run > {}".format(RESULT_FILE))
-
-                    # parse output
-                    result = parse_output(RESULT_FILE)
-
-                    # log the result
-                    options = []
-                    if simd:
-                        options.append("simd")
-                    if parallel:
-                        options.append("par")
-                    if intrinsic_conv_scale:
-                        options.append("intr.s.")
-                    if cross_correlate:
-                        options.append("xcorr")
-
-                    subcase_name = "Layer 1 "
-                    if options:
-                        subcase_name += "; ".join(options)
-                    else:
-                        subcase_name += "naive"
-
-                    logger.show_subcase_result(subcase_name, result)
+                for cross_correlate, ntt_conv in [(False, False), (True, False), (False, True)]:
+                    for dma_flip in [False, True]:
+                        for dma_stream in [False, True]:
+
+                            if not simd and (parallel or cross_correlate):
+                                continue
+
+                            # the NTT is only implemented for the parallel layer
+                            if ntt_conv and not parallel:
+                                continue
+
+                            # parallel requires intrinsic conv scale
+                            if parallel and not intrinsic_conv_scale:
+                                continue
+
+                            # not implemented
+                            if cross_correlate and not parallel:
+                                continue
+
+                            # the transposed output is only tested for the SIMD implementation
+                            if dma_flip and not (simd and intrinsic_conv_scale):
+                                continue
+
+                            # the parallel layer keeps the entire input on L1, streaming is only
+                            # tested for the SIMD implementation
+                            if dma_stream and (parallel or not (simd and intrinsic_conv_scale)):
+                                continue
+
+                            # generate makefile
+                            mkf = Makefile()
+                            mkf.add_fc_test_source("test.c")
+                            mkf.add_cl_test_source("cluster.c")
+                            mkf.add_cl_prog_source("net/layer1.c")
+                            mkf.add_cl_prog_source("net/stream.c")
+                            mkf.add_cl_prog_source("net/net.c")
+                            mkf.add_cl_prog_source("net/blob.c")
+                            mkf.add_cl_prog_source("func/conv.c")
+                            mkf.add_cl_prog_source("func/xcorr.c")
+                            mkf.add_cl_prog_source("func/transform.c")
+                            mkf.add_cl_prog_source("func/ntt.c")
+
+                            if parallel:
+                                mkf.add_define("PARALLEL")
+                            if intrinsic_conv_scale:
+                                mkf.add_define("INTRINSIC_SCALE")
+                            if cross_correlate:
+                                mkf.add_define("CROSS_CORRELATE")
+                            if ntt_conv:
+                                mkf.add_define("NTT_CONV")
+                            if not simd:
+                                mkf.add_define("NO_SIMD")
+                            if dma_flip:
+                                mkf.add_define("DMA_FLIP")
+                            if dma_stream:
+                                mkf.add_define("DMA_STREAM")
+
+                            mkf.write()
+
+                            random_input = False
+
+                            # generate the stimuli
+                            x, y_exp = gen_stimuli(random_input)
+                            x_align = align_array(x)
+                            y_exp_align = align_array(y_exp)
+
+                            # prepare header file
+                            header = HeaderFile("test_stimuli.h")
+                            header.add(HeaderArray("x_vec", "int8_t", x_align.ravel()))
+                            header.add(HeaderArray("y_exp_vec", "int8_t", y_exp_align.ravel()))
+                            header.write()
+
+                            # compile and run
+                            os.system("make clean all run > {}".format(RESULT_FILE))
+
+                            # parse output
+                            result = parse_output(RESULT_FILE)
+
+                            # log the result
+                            options = []
+                            if simd:
+                                options.append("simd")
+                            if parallel:
+                                options.append("par")
+                            if intrinsic_conv_scale:
+                                options.append("intr.s.")
+                            if cross_correlate:
+                                options.append("xcorr")
+                            if ntt_conv:
+                                options.append("ntt")
+                            if dma_flip:
+                                options.append("dma flip")
+                            if dma_stream:
+                                options.append("stream")
+
+                            subcase_name = "Layer 1 "
+                            if options:
+                                subcase_name += "; ".join(options)
+                            else:
+                                subcase_name += "naive"
+
+                            logger.show_subcase_result(subcase_name, result)
 
     # return summary
     return logger.summary()
@@ -87,16 +87,14 @@ def test():
                             # not implemented
                             continue
 
-                        if not parallel and dma_stream:
-                            # not implemented
-                            continue
-
                         # generate makefile
                         mkf = Makefile()
                         mkf.add_fc_test_source("test.c")
                         mkf.add_cl_test_source("cluster.c")
                         mkf.add_cl_prog_source("net/layer2.c")
+                        mkf.add_cl_prog_source("net/stream.c")
                         mkf.add_cl_prog_source("net/net.c")
+                        mkf.add_cl_prog_source("net/blob.c")
                         mkf.add_cl_prog_source("func/transform.c")
                         mkf.add_cl_prog_source("func/dotp.c")
 
@@ -44,9 +44,16 @@ int do_bench(rt_perf_t* perf, int events) {
     int num_err = 0;
     for (int k = 0; k < NET_F2; k++) {
         for (int t = 0; t < NET_T8; t++) {
+#if defined(DMA_FLIP) || defined(LAYER3_TIME_BLOCKS)
+            // the output is transposed, of shape [NET_T8_ALIGN, NET_F2]
+            if (p_output[t * NET_F2 + k] != y_exp_vec[k * NET_T8_ALIGN + t]) {
+                num_err++;
+            }
+#else//DMA_FLIP, LAYER3_TIME_BLOCKS
             if (p_output[k * NET_T8_ALIGN + t] != y_exp_vec[k * NET_T8_ALIGN + t]) {
                 num_err++;
             }
+#endif//DMA_FLIP, LAYER3_TIME_BLOCKS
         }
     }
 
@@ -69,14 +69,26 @@ def test():
 
     logger = TestLogger(TESTNAME, show_title=False)
 
-    for simd, parallel in [(False, False), (True, False), (True, True)]:
+    for simd, parallel, dma_flip, time_blocks, random_input, dma_stream in [
+            (False, False, False, False, False, False),
+            (True, False, False, False, False, False),
+            (True, True, False, False, False, False),
+            (True, False, True, False, False, False),
+            (True, True, True, False, False, False),
+            (True, True, False, True, False, False),
+            (True, True, False, True, True, False),
+            (True, True, False, True, True, True),
+            (True, False, False, False, False, True),
+            (True, False, True, False, False, True)]:
 
         # generate makefile
         mkf = Makefile()
         mkf.add_fc_test_source("test.c")
         mkf.add_cl_test_source("cluster.c")
         mkf.add_cl_prog_source("net/layer3.c")
+        mkf.add_cl_prog_source("net/stream.c")
         mkf.add_cl_prog_source("net/net.c")
+        mkf.add_cl_prog_source("net/blob.c")
         mkf.add_cl_prog_source("func/transform.c")
         mkf.add_cl_prog_source("func/conv.c")
 
@@ -86,9 +98,16 @@ def test():
         if parallel:
             mkf.add_define("PARALLEL")
 
-        mkf.write()
+        if dma_flip:
+            mkf.add_define("DMA_FLIP")
+
+        if time_blocks:
+            mkf.add_define("LAYER3_TIME_BLOCKS")
 
-        random_input = False
+        if dma_stream:
+            mkf.add_define("DMA_STREAM")
+
+        mkf.write()
 
         # generate the stimuli
         _, x_align, _, y_exp_align = gen_stimuli(random_input)
@@ -111,6 +130,14 @@ def test():
             options.append("simd")
         if parallel:
             options.append("parallel")
+        if dma_flip:
+            options.append("dma flip")
+        if time_blocks:
+            options.append("time blocks")
+        if random_input:
+            options.append("random input")
+        if dma_stream:
+            options.append("stream")
 
         subcase_name = "layer 3 "
         if options:
@@ -70,7 +70,9 @@ def test():
     mkf.add_fc_test_source("test.c")
     mkf.add_cl_test_source("cluster.c")
     mkf.add_cl_prog_source("net/layer3.c")
+    mkf.add_cl_prog_source("net/stream.c")
     mkf.add_cl_prog_source("net/net.c")
+    mkf.add_cl_prog_source("net/blob.c")
     mkf.add_cl_prog_source("func/flip.c")
     mkf.write()
 
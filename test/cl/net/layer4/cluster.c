@@ -51,7 +51,7 @@ int do_bench(rt_perf_t* perf, int events) {
     }
 
     // free memory
-    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F2 * NET_T8_ALIGN);
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * NET_F2 * NET_T64_ALIGN);
 
     return num_err;
 }
@@ -77,20 +77,25 @@ def test():
     for simd in [False, True]:
         for flip_layers in [False, True]:
             for parallel in [False, True]:
-                for reorder in [False, True]:
+                for reorder, dma_stream in [(False, False), (True, False), (True, True)]:
 
                     if not simd and (flip_layers or parallel or reorder):
                         continue
                     if parallel and not flip_layers:
                         # not implemented
                         continue
+                    if dma_stream and not parallel:
+                        # only the parallel implementation uses a stream
+                        continue
 
                     # generate makefile
                     mkf = Makefile()
                     mkf.add_fc_test_source("test.c")
                     mkf.add_cl_test_source("cluster.c")
                     mkf.add_cl_prog_source("net/layer4.c")
+                    mkf.add_cl_prog_source("net/stream.c")
                     mkf.add_cl_prog_source("net/net.c")
+                    mkf.add_cl_prog_source("net/blob.c")
                     mkf.add_cl_prog_source("func/transform.c")
                     mkf.add_cl_prog_source("func/dotp.c")
 
@@ -106,6 +111,9 @@ def test():
                     if reorder:
                         mkf.add_define("REORDER_BN")
 
+                    if dma_stream:
+                        mkf.add_define("DMA_STREAM")
+
                     mkf.write()
 
                     random_input = False
@@ -135,6 +143,8 @@ def test():
                         options.append("par")
                     if reorder:
                         options.append("reorder")
+                    if dma_stream:
+                        options.append("stream")
 
                     subcase_name = "Layer 4 "
                     if options:
@@ -77,6 +77,7 @@ def test():
         mkf.add_cl_test_source("cluster.c")
         mkf.add_cl_prog_source("net/layer5.c")
         mkf.add_cl_prog_source("net/net.c")
+        mkf.add_cl_prog_source("net/blob.c")
         mkf.add_cl_prog_source("func/transform.c")
         mkf.add_cl_prog_source("func/dotp.c")
         mkf.write()
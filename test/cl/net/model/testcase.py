@@ -77,18 +77,24 @@ def test():
 
     logger = TestLogger(TESTNAME)
 
-    for intrinsic, simd, flip_layers, parallel, stream, xcorr, fuse, no_div, reorder, dup_inp in [
-            (False, False, False, False, False, False, False, False, False, False),
-            (True, False, False, False, False, False, False, False, False, False),
-            (True, True, False, False, False, False, False, False, False, False),
-            (True, True, True, False, False, False, False, False, False, False),
-            (True, True, True, True, False, False, False, False, False, False),
-            (True, True, True, True, True, False, False, False, False, False),
-            (True, True, True, True, True, True, False, False, False, False),
-            (True, True, True, True, True, True, True, False, False, False),
-            (True, True, True, True, True, True, True, True, False, False),
-            (True, True, True, True, True, True, True, True, True, False),
-            (True, True, True, True, True, True, True, True, True, True)
+    for intrinsic, simd, flip_layers, parallel, stream, xcorr, fuse, no_div, reorder, dup_inp, dup_l1, ring, \
+            dma_flip, time_blocks, pipeline in [
+            (False, False, False, False, False, False, False, False, False, False, False, False, False, False, False),
+            (True, False, False, False, False, False, False, False, False, False, False, False, False, False, False),
+            (True, True, False, False, False, False, False, False, False, False, False, False, False, False, False),
+            (True, True, True, False, False, False, False, False, False, False, False, False, False, False, False),
+            (True, True, True, True, False, False, False, False, False, False, False, False, False, False, False),
+            (True, True, True, True, True, False, False, False, False, False, False, False, False, False, False),
+            (True, True, True, True, True, True, False, False, False, False, False, False, False, False, False),
+            (True, True, True, True, True, True, True, False, False, False, False, False, False, False, False),
+            (True, True, True, True, True, True, True, True, False, False, False, False, False, False, False),
+            (True, True, True, True, True, True, True, True, True, False, False, False, False, False, False),
+            (True, True, True, True, True, True, True, True, True, True, False, False, False, False, False),
+            (True, True, True, True, True, True, True, True, True, True, True, False, False, False, False),
+            (True, True, True, True, True, True, True, True, True, True, True, True, False, False, False),
+            (True, True, True, True, True, True, True, True, True, True, True, True, True, False, False),
+            (True, True, True, True, True, True, True, True, True, True, True, True, True, True, False),
+            (True, True, True, True, True, True, True, True, True, True, True, True, True, True, True)
     ]:
 
         # generate makefile
@@ -99,10 +105,14 @@ def test():
         mkf.add_cl_prog_source("net/layer1.c")
         mkf.add_cl_prog_source("net/layer2.c")
         mkf.add_cl_prog_source("net/layer3.c")
+        mkf.add_cl_prog_source("net/stream.c")
+        mkf.add_cl_prog_source("net/queue.c")
+        mkf.add_cl_prog_source("net/pipeline.c")
         mkf.add_cl_prog_source("net/layer4.c")
         mkf.add_cl_prog_source("net/layer5.c")
         mkf.add_cl_prog_source("net/fused_layer_1_2.c")
         mkf.add_cl_prog_source("net/net.c")
+        mkf.add_cl_prog_source("net/blob.c")
         mkf.add_cl_prog_source("func/transform.c")
         mkf.add_cl_prog_source("func/dotp.c")
         mkf.add_cl_prog_source("func/conv.c")
@@ -129,6 +139,16 @@ def test():
             mkf.add_define("DUPLICATE_FEATUREMAP")
         if reorder:
             mkf.add_define("REORDER_BN")
+        if dup_l1:
+            mkf.add_define("DUPLICATE_IN_L1")
+        if ring:
+            mkf.add_define("RING_BUFFER")
+        if dma_flip:
+            mkf.add_define("DMA_FLIP")
+        if time_blocks:
+            mkf.add_define("LAYER3_TIME_BLOCKS")
+        if pipeline:
+            mkf.add_define("PIPELINE")
 
         mkf.write()
 
@@ -173,6 +193,16 @@ def test():
             subcase_name = "+ reorder BN"
         if dup_inp:
             subcase_name = "+ duplicate featuremap"
+        if dup_l1:
+            subcase_name = "+ duplicate in L1"
+        if ring:
+            subcase_name = "+ ring buffer"
+        if dma_flip:
+            subcase_name = "+ DMA flip"
+        if time_blocks:
+            subcase_name = "+ layer 3 time blocks"
+        if pipeline:
+            subcase_name = "+ pipeline"
 
         # log the result
         logger.show_subcase_result(subcase_name, result)
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "cluster.h"
+#include "test_stimuli.h"
+#include "../../../../src/cl/net/queue.h"
+
+#ifndef NUM_WORKERS
+#define NUM_WORKERS 8
+#endif
+
+typedef struct {
+    net_queue_t* p_queue;
+    int8_t* p_items;
+    int num_err;
+} _test_kernel_t;
+
+/**
+ * @brief Checks the items from start to end (all parts of the cores), returns the number of errors
+ */
+static int _consume(const int8_t* p_items, unsigned int start, unsigned int end) {
+    int num_err = 0;
+    for (unsigned int i = start * NUM_WORKERS; i < end * NUM_WORKERS; i++) {
+        if (p_items[i] != x_vec[i]) {
+            num_err++;
+        }
+    }
+    return num_err;
+}
+
+/**
+ * @brief Every core produces its part of all items (after a random delay), and consumes the items
+ * which are available. The items are pushed in batches of BATCH items.
+ */
+void _test_kernel(void* args) {
+
+    _test_kernel_t* _args = args;
+    unsigned int _core_id = rt_core_id();
+    unsigned int _consumed = 0;
+    unsigned int _available;
+    int _num_err = 0;
+
+    for (unsigned int _i = 0; _i < NUM_ITEMS; _i++) {
+
+        // delay the core, such that the cores are out of sync
+        for (volatile int _d = 0; _d < delay_vec[_i * NUM_WORKERS + _core_id]; _d++);
+
+        // produce the part of this core
+        _args->p_items[_i * NUM_WORKERS + _core_id] = x_vec[_i * NUM_WORKERS + _core_id];
+
+        if ((_i + 1) % BATCH == 0) {
+            net_queue_push(_args->p_queue, _core_id, _i + 1);
+        }
+
+#ifdef WAIT
+        // wait for the batch of this item
+        if ((_i + 1) % BATCH == 0) {
+            _available = net_queue_wait(_args->p_queue, _i + 1);
+            if (_available < _i + 1) {
+                _num_err++;
+            }
+            _num_err += _consume(_args->p_items, _consumed, _available);
+            _consumed = _available;
+        }
+#else//WAIT
+        // consume the items which are available, without waiting
+        _available = net_queue_available(_args->p_queue);
+        _num_err += _consume(_args->p_items, _consumed, _available);
+        _consumed = _available;
+#endif//WAIT
+    }
+
+    // push the last (incomplete) batch, and consume all remaining items
+    net_queue_push(_args->p_queue, _core_id, NUM_ITEMS);
+    _available = net_queue_wait(_args->p_queue, NUM_ITEMS);
+    if (_available != NUM_ITEMS) {
+        _num_err++;
+    }
+    _num_err += _consume(_args->p_items, _consumed, _available);
+
+    rt_team_critical_enter();
+    _args->num_err += _num_err;
+    rt_team_critical_exit();
+
+    rt_team_barrier();
+}
+
+int do_bench(rt_perf_t* perf, int events) {
+
+    // the items and the queue on L1 (filled with garbage)
+    int8_t* p_items = rt_alloc(RT_ALLOC_CL_DATA, sizeof(int8_t) * NUM_ITEMS * NUM_WORKERS);
+    net_queue_t* p_queue = rt_alloc(RT_ALLOC_CL_DATA, sizeof(net_queue_t));
+    for (int i = 0; i < NUM_ITEMS * NUM_WORKERS; i++) {
+        p_items[i] = 0x55;
+    }
+
+    //setup performance measurement
+    rt_perf_conf(perf, events);
+
+    // start performance measurement
+    rt_perf_reset(perf);
+    rt_perf_start(perf);
+
+    net_queue_init(p_queue, NUM_WORKERS);
+
+    _test_kernel_t args;
+    args.p_queue = p_queue;
+    args.p_items = p_items;
+    args.num_err = 0;
+    rt_team_fork(NUM_WORKERS, _test_kernel, &args);
+
+    rt_perf_stop(perf);
+
+    // free memory
+    rt_free(RT_ALLOC_CL_DATA, (void*) p_items, sizeof(int8_t) * NUM_ITEMS * NUM_WORKERS);
+    rt_free(RT_ALLOC_CL_DATA, (void*) p_queue, sizeof(net_queue_t));
+
+    return args.num_err;
+}
+
+void cluster_entry(void* arg) {
+
+    // setup performance measurement
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+
+    int result;
+
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR));
+
+    // print the results
+    if (result == 0) {
+        printf("## 1: result: OK\n");
+    } else {
+        printf("## 1: result: FAIL\n");
+    }
+    printf("## 1: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 1: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+}
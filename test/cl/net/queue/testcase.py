@@ -0,0 +1,96 @@
+"""
+This file will test the producer/consumer queue between the cores (src/cl/net/queue.c)
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+import os
+import numpy as np
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray
+from makefile import Makefile
+
+TESTNAME = "cl::net::queue"
+RESULT_FILE = "result.out"
+
+NUM_WORKERS = 8
+NUM_ITEMS = 23
+
+
+def gen_stimuli():
+    """
+    This function generates the stimuli (the part of every core of every item, and the delay of
+    every core before producing an item)
+    """
+    x = np.random.randint(-128, 128, (NUM_ITEMS, NUM_WORKERS))
+    delay = np.random.randint(0, 200, (NUM_ITEMS, NUM_WORKERS))
+    return x, delay
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME, show_title=False)
+
+    for batch in [1, 4]:
+        for wait in [False, True]:
+
+            # generate makefile
+            mkf = Makefile()
+            mkf.add_fc_test_source("test.c")
+            mkf.add_cl_test_source("cluster.c")
+            mkf.add_cl_prog_source("net/queue.c")
+            mkf.add_define("BATCH", batch)
+            if wait:
+                mkf.add_define("WAIT")
+            mkf.write()
+
+            # generate the stimuli
+            x, delay = gen_stimuli()
+
+            # prepare header file
+            header = HeaderFile("test_stimuli.h")
+            header.add(HeaderConstant("NUM_ITEMS", NUM_ITEMS))
+            header.add(HeaderArray("x_vec", "int8_t", x.ravel()))
+            header.add(HeaderArray("delay_vec", "int32_t", delay.ravel()))
+            header.write()
+
+            # compile and run
+            os.system("make clean all run > {}".format(RESULT_FILE))
+
+            # parse output
+            result = parse_output(RESULT_FILE)
+
+            # log the result
+            subcase_name = "Queue batch {}".format(batch)
+            if wait:
+                subcase_name += " + wait"
+            logger.show_subcase_result(subcase_name, result)
+
+    # return summary
+    return logger.summary()
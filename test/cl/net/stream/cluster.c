@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+#include "../../../../src/cl/net/stream.h"
+
+#ifndef NUM_WORKERS
+#define NUM_WORKERS 8
+#endif
+
+#define _NUM_TILES (NUM_INNER * NUM_OUTER)
+
+// size of a padded row on L1
+#define _LOC_ROW_LEN (2 * PAD + LEN_ALIGN)
+
+#ifdef PADDED_ROWS
+// every input tile contains the NUM_INNER rows of an outer index, each with its own padding
+#define _NUM_IN_TILES NUM_OUTER
+#define _ROWS_PER_TILE NUM_INNER
+#else//PADDED_ROWS
+#define _NUM_IN_TILES _NUM_TILES
+#define _ROWS_PER_TILE 1
+#endif//PADDED_ROWS
+
+typedef struct {
+    net_stream_t* p_input;
+    net_stream_t* p_output;
+    int num_err;
+} _test_kernel_t;
+
+/**
+ * @brief Copies one tile, and counts the padding bytes which are not zero
+ */
+static int _copy_tile(const int8_t* p_in, int8_t* p_out, int start, int step) {
+    int num_err = 0;
+    for (int i = start; i < PAD; i += step) {
+        if (p_in[i] != 0 || p_in[PAD + LEN + i] != 0) {
+            num_err++;
+        }
+    }
+    for (int i = start; i < LEN; i += step) {
+        p_out[i] = p_in[PAD + i];
+    }
+    return num_err;
+}
+
+/**
+ * @brief Every core copies a part of each tile, the streams are advanced together
+ */
+void _test_kernel(void* args) {
+
+    _test_kernel_t* _args = args;
+    int8_t* _p_in;
+    int8_t* _p_out;
+    int _num_err = 0;
+
+    for (int _i = 0; _i < _NUM_IN_TILES; _i++) {
+        _p_in = net_stream_team_next(_args->p_input);
+        for (int _r = 0; _r < _ROWS_PER_TILE; _r++) {
+            _p_out = net_stream_team_next(_args->p_output);
+            _num_err += _copy_tile(_p_in + _r * _LOC_ROW_LEN, _p_out, rt_core_id(), NUM_WORKERS);
+        }
+    }
+
+    rt_team_critical_enter();
+    _args->num_err += _num_err;
+    rt_team_critical_exit();
+
+    rt_team_barrier();
+}
+
+int do_bench(rt_perf_t* perf, int events) {
+
+    // allocate result memory (and fill it with garbage)
+    int8_t * p_output = rt_alloc(RT_ALLOC_L2_CL_DATA, sizeof(int8_t) * _NUM_TILES * LEN);
+    for (int i = 0; i < _NUM_TILES * LEN; i++) {
+        p_output[i] = 0x55;
+    }
+
+    // tiles of the input [NUM_OUTER, NUM_INNER, LEN], aligned to [NUM_OUTER, NUM_INNER, LEN_ALIGN]
+#ifdef PADDED_ROWS
+    net_stream_desc_t input_desc = {
+        .p_ext = x_vec,
+        .size = sizeof(int8_t) * NUM_INNER * LEN,
+        .num = {NUM_OUTER, 1},
+        .stride = {sizeof(int8_t) * NUM_INNER * LEN_ALIGN, 0},
+        .row_len = sizeof(int8_t) * LEN,
+        .row_stride = sizeof(int8_t) * LEN_ALIGN,
+        .loc_row_stride = sizeof(int8_t) * _LOC_ROW_LEN,
+        .loc_offset = PAD,
+        .buffer_len = sizeof(int8_t) * NUM_INNER * _LOC_ROW_LEN,
+    };
+#else//PADDED_ROWS
+    net_stream_desc_t input_desc = {
+        .p_ext = x_vec,
+        .size = sizeof(int8_t) * LEN,
+        .num = {NUM_INNER, NUM_OUTER},
+        .stride = {sizeof(int8_t) * LEN_ALIGN, sizeof(int8_t) * NUM_INNER * LEN_ALIGN},
+        .loc_offset = PAD,
+        .buffer_len = sizeof(int8_t) * _LOC_ROW_LEN,
+    };
+#endif//PADDED_ROWS
+#ifdef TRANSPOSE
+    // every tile is a column of the output [NUM_OUTER, LEN, NUM_INNER]
+    net_stream_desc_t output_desc = {
+        .p_ext = p_output,
+        .size = sizeof(int8_t) * LEN,
+        .num = {NUM_INNER, NUM_OUTER},
+        .stride = {sizeof(int8_t), sizeof(int8_t) * LEN * NUM_INNER},
+        .row_len = sizeof(int8_t),
+        .row_stride = sizeof(int8_t) * NUM_INNER,
+    };
+#else//TRANSPOSE
+    // every tile is a row of the output [NUM_OUTER, NUM_INNER, LEN]
+    net_stream_desc_t output_desc = {
+        .p_ext = p_output,
+        .size = sizeof(int8_t) * LEN,
+        .num = {NUM_INNER, NUM_OUTER},
+        .stride = {sizeof(int8_t) * LEN, sizeof(int8_t) * NUM_INNER * LEN},
+    };
+#endif//TRANSPOSE
+
+    net_stream_t input;
+    net_stream_t output;
+    int num_err = 0;
+
+    //setup performance measurement
+    rt_perf_conf(perf, events);
+
+    // start performance measurement
+    rt_perf_reset(perf);
+    rt_perf_start(perf);
+
+    net_stream_open(&input, &input_desc, DEPTH, NET_STREAM_IN);
+    net_stream_open(&output, &output_desc, DEPTH, NET_STREAM_OUT);
+
+#ifdef TEAM
+    _test_kernel_t args;
+    args.p_input = &input;
+    args.p_output = &output;
+    args.num_err = 0;
+    rt_team_fork(NUM_WORKERS, _test_kernel, &args);
+    num_err += args.num_err;
+#else//TEAM
+    for (int i = 0; i < _NUM_IN_TILES; i++) {
+        int8_t* p_in = net_stream_next(&input);
+        for (int r = 0; r < _ROWS_PER_TILE; r++) {
+            int8_t* p_out = net_stream_next(&output);
+            num_err += _copy_tile(p_in + r * _LOC_ROW_LEN, p_out, 0, 1);
+        }
+    }
+#endif//TEAM
+
+    net_stream_close(&output);
+    net_stream_close(&input);
+
+    rt_perf_stop(perf);
+
+    for (int i = 0; i < _NUM_TILES * LEN; i++) {
+        if (p_output[i] != y_exp_vec[i]) {
+            num_err++;
+        }
+    }
+
+    // free memory
+    rt_free(RT_ALLOC_L2_CL_DATA, (void*) p_output, sizeof(int8_t) * _NUM_TILES * LEN);
+
+    return num_err;
+}
+
+void cluster_entry(void* arg) {
+
+    // setup performance measurement
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+
+    int result;
+
+    result = do_bench(&perf, (1<<RT_PERF_CYCLES | 1<<RT_PERF_INSTR));
+
+    // print the results
+    if (result == 0) {
+        printf("## 1: result: OK\n");
+    } else {
+        printf("## 1: result: FAIL\n");
+    }
+    printf("## 1: cycles: %d\n", rt_perf_read(RT_PERF_CYCLES));
+    printf("## 1: instructions: %d\n", rt_perf_read(RT_PERF_INSTR));
+}
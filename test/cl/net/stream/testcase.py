@@ -0,0 +1,114 @@
+"""
+This file will test the DMA streams (src/cl/net/stream.c)
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import os
+import numpy as np
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray, align_array_size
+from makefile import Makefile
+
+TESTNAME = "cl::net::stream"
+RESULT_FILE = "result.out"
+
+NUM_INNER = 5
+NUM_OUTER = 3
+LEN = 37
+PAD = 8
+
+
+def gen_stimuli(transpose):
+    """
+    This function generates the stimuli (input and output) for the test
+    """
+    x = np.random.randint(-128, 128, (NUM_OUTER, NUM_INNER, LEN))
+    x_align = np.zeros((NUM_OUTER, NUM_INNER, align_array_size(LEN)), dtype=int)
+    x_align[:, :, :LEN] = x
+    y_exp = np.transpose(x, (0, 2, 1)) if transpose else x
+    return x_align, y_exp
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME, show_title=False)
+
+    for depth in [1, 2, 4]:
+        for transpose, team, padded_rows in [(False, False, False), (True, False, False),
+                                             (False, True, False), (True, True, False),
+                                             (False, False, True), (True, True, True)]:
+
+            # generate makefile
+            mkf = Makefile()
+            mkf.add_fc_test_source("test.c")
+            mkf.add_cl_test_source("cluster.c")
+            mkf.add_cl_prog_source("net/stream.c")
+            mkf.add_define("DEPTH", depth)
+            if transpose:
+                mkf.add_define("TRANSPOSE")
+            if team:
+                mkf.add_define("TEAM")
+            if padded_rows:
+                mkf.add_define("PADDED_ROWS")
+            mkf.write()
+
+            # generate the stimuli
+            x_align, y_exp = gen_stimuli(transpose)
+
+            # prepare header file
+            header = HeaderFile("test_stimuli.h")
+            header.add(HeaderConstant("NUM_INNER", NUM_INNER))
+            header.add(HeaderConstant("NUM_OUTER", NUM_OUTER))
+            header.add(HeaderConstant("LEN", LEN))
+            header.add(HeaderConstant("LEN_ALIGN", align_array_size(LEN)))
+            header.add(HeaderConstant("PAD", PAD))
+            header.add(HeaderArray("x_vec", "int8_t", x_align.ravel()))
+            header.add(HeaderArray("y_exp_vec", "int8_t", y_exp.ravel()))
+            header.write()
+
+            # compile and run
+            os.system("make clean all run > {}".format(RESULT_FILE))
+
+            # parse output
+            result = parse_output(RESULT_FILE)
+
+            # log the result
+            subcase_name = "Stream depth {}".format(depth)
+            if transpose:
+                subcase_name += " + 2d"
+            if team:
+                subcase_name += " + team"
+            if padded_rows:
+                subcase_name += " + padded rows"
+            logger.show_subcase_result(subcase_name, result)
+
+    # return summary
+    return logger.summary()
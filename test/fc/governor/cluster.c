@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "cluster.h"
+
+unsigned int cluster_cycles = 0;
+
+/**
+ * @brief Simulated inference, which takes (roughly) a given number of cycles
+ *
+ * @param arg Pointer to the number of cycles
+ */
+void cluster_entry(void* arg) {
+
+    unsigned int num_cycles = *((unsigned int*)arg);
+
+    rt_perf_t perf;
+    rt_perf_init(&perf);
+    rt_perf_conf(&perf, 1 << RT_PERF_CYCLES);
+    rt_perf_reset(&perf);
+    rt_perf_start(&perf);
+
+    while (rt_perf_read(RT_PERF_CYCLES) < num_cycles) {
+        asm volatile("nop");
+    }
+
+    rt_perf_stop(&perf);
+    cluster_cycles = rt_perf_read(RT_PERF_CYCLES);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "cluster.h"
+#include "test_stimuli.h"
+#include "../../../src/fc/governor.h"
+
+int main() {
+
+    // the FC shares the voltage domain with the cluster
+    rt_freq_set(RT_FREQ_DOMAIN_FC, 50000000);
+
+    governor_t gov;
+    governor_init(&gov, governor_default_points, governor_default_num_points);
+
+    // mount the cluster
+    rt_cluster_mount(1, 0, 0, NULL);
+
+    for (unsigned int i = 0; i < NUM_WINDOWS; i++) {
+
+        unsigned int start = rt_time_get_us();
+
+        unsigned int point = governor_select(&gov, deadline_us[i]);
+        governor_apply(&gov, point);
+
+        // call the cluster entry with the simulated workload
+        unsigned int num_cycles = workload[i];
+        rt_cluster_call(NULL, 0, cluster_entry, (void*)(&num_cycles), NULL, 0, 0, 0, NULL);
+
+        governor_update(&gov, cluster_cycles);
+
+        unsigned int elapsed = rt_time_get_us() - start;
+
+        printf("## %d: voltage: %d\n", i, gov.p_points[point].voltage);
+        printf("## %d: freq: %d\n", i, gov.p_points[point].freq);
+        printf("## %d: cycles: %d\n", i, cluster_cycles);
+        printf("## %d: elapsed: %d\n", i, elapsed);
+    }
+
+    // unmount the cluster entry
+    rt_cluster_mount(0, 0, 0, NULL);
+}
@@ -0,0 +1,136 @@
+"""
+This file will test the DVFS governor
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+
+import os
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray
+from makefile import Makefile
+
+TESTNAME = "fc::governor"
+RESULT_FILE = "result.out"
+
+# must be equal to the definitions in src/fc/governor.{c,h}
+POINTS = [(800, 50), (850, 100), (850, 150), (1000, 200), (1100, 250)]
+SETTLE_US = 90000
+MARGIN = 10
+HISTORY = 4
+
+# simulated schedule: (deadline in us, cycles of the simulated inference)
+SMALL = 500000
+LARGE = 6000000
+SCHEDULE = [
+    (100000, SMALL),  # no measurement yet: fastest point
+    (100000, SMALL),  # lower the voltage: slowest point
+    (15000, SMALL),   # still feasible at the slowest point
+    (8000, SMALL),    # raising the voltage takes too long: best effort (stay)
+    (150000, LARGE),  # the inference takes longer than expected, but still meets the deadline
+    (120000, LARGE),  # raise the voltage (and wait until it is settled)
+    (30000, LARGE),   # keep the fastest point
+    (100000, SMALL),  # lower the voltage, without waiting
+    (3000, SMALL),    # infeasible: best effort
+]
+
+
+def replay(cycles, deadlines):
+    """
+    Reference implementation of the governor. Computes, which operating point should be selected in
+    every window, based on the cycles measured in the previous windows.
+    Returns: list of tuples (point index, feasible)
+    """
+    history = []
+    voltage = POINTS[-1][0]
+    expected = []
+    for n_cycles, deadline in zip(cycles, deadlines):
+        if not history:
+            selected, feasible = len(POINTS) - 1, True
+        else:
+            max_cycles = max(history[-HISTORY:])
+            estimate = max_cycles // 100 * (100 + MARGIN) + (max_cycles % 100) * (100 + MARGIN) // 100
+            times = [estimate // f + (SETTLE_US if v > voltage else 0) for v, f in POINTS]
+            feasible_points = [i for i, t in enumerate(times) if t <= deadline]
+            if feasible_points:
+                selected, feasible = feasible_points[0], True
+            else:
+                selected, feasible = times.index(min(times)), False
+        expected.append((selected, feasible))
+        voltage = POINTS[selected][0]
+        history.append(n_cycles)
+    return expected
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME)
+
+    # generate makefile
+    mkf = Makefile()
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    mkf.add_fc_prog_source("governor.c")
+    mkf.write()
+
+    # prepare header file
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderConstant("NUM_WINDOWS", len(SCHEDULE)))
+    header.add(HeaderArray("deadline_us", "unsigned int", [d for d, _ in SCHEDULE]))
+    header.add(HeaderArray("workload", "unsigned int", [w for _, w in SCHEDULE]))
+    header.write()
+
+    # compile and run
+    os.system("make clean all run > {}".format(RESULT_FILE))
+
+    # parse output
+    result = parse_output(RESULT_FILE)
+
+    # replay the governor with the measured cycles
+    windows = sorted(result, key=int)
+    cycles = [int(result[k]["cycles"]) for k in windows]
+    deadlines = [SCHEDULE[int(k)][0] for k in windows]
+    expected = replay(cycles, deadlines)
+
+    for k, (selected, feasible), deadline in zip(windows, expected, deadlines):
+        voltage, freq = POINTS[selected]
+        case = result[k]
+        ok = int(case["voltage"]) == voltage and int(case["freq"]) == freq
+        # the deadline must be met, if a feasible point exists
+        if feasible:
+            ok = ok and int(case["elapsed"]) <= deadline
+        case["result"] = ok
+        case["deadline"] = deadline
+
+    # log the result
+    logger.show_subcase_result("window", result)
+
+    # return summary
+    return logger.summary()
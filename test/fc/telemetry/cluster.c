@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "cluster.h"
+#include "../../../src/cl/telemetry.h"
+
+/**
+ * @brief Returns the minimal number of cycles between two consecutive reads of the cycle counter
+ */
+static unsigned int read_cost() {
+    unsigned int cost = (unsigned int)-1;
+    for (unsigned int i = 0; i < 16; i++) {
+        unsigned int start = rt_perf_read(RT_PERF_CYCLES);
+        unsigned int diff = rt_perf_read(RT_PERF_CYCLES) - start;
+        cost = diff < cost ? diff : cost;
+    }
+    return cost;
+}
+
+/**
+ * @brief Simulated inference, where every layer takes (roughly) a given number of cycles
+ *
+ * @param arg Pointer to the number of cycles of every layer
+ */
+void cluster_entry(void* arg) {
+
+    const unsigned int* workload = (const unsigned int*)arg;
+
+    telemetry_begin();
+
+    for (unsigned int i = 0; i < TELEMETRY_NUM_LAYERS; i++) {
+        unsigned int start = rt_perf_read(RT_PERF_CYCLES);
+        while (rt_perf_read(RT_PERF_CYCLES) - start < workload[i]) {
+            asm volatile("nop");
+        }
+        telemetry_layer(i);
+    }
+
+    telemetry_end();
+
+    // every layer reads the counter about three times (start, end of the loop and telemetry)
+    printf("## read_cost: %d\n", read_cost());
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "cluster.h"
+#include "test_stimuli.h"
+#include "../../../src/fc/telemetry.h"
+
+int main() {
+
+    telemetry_init();
+
+    // mount the cluster
+    rt_cluster_mount(1, 0, 0, NULL);
+
+    for (unsigned int i = 0; i < NUM_INFERENCES; i++) {
+
+        unsigned int timestamp = rt_time_get_us();
+
+        rt_cluster_call(NULL, 0, cluster_entry, (void*)workload, NULL, 0, 0, 0, NULL);
+
+        telemetry_commit(timestamp);
+
+        // dump before the ring buffer is full
+        if (i + 1 == PARTIAL_DUMP) {
+            telemetry_dump();
+        }
+    }
+
+    // unmount the cluster entry
+    rt_cluster_mount(0, 0, 0, NULL);
+
+    // dump after the ring buffer has wrapped around
+    telemetry_dump();
+}
@@ -0,0 +1,123 @@
+"""
+This file will test the telemetry ring buffer and the dump of the FC
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+
+import os
+import re
+from test_utils import TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray
+from makefile import Makefile
+import telemetry as tm
+
+TESTNAME = "fc::telemetry"
+RESULT_FILE = "result.out"
+
+CAPACITY = 4
+NUM_INFERENCES = 10
+# the first dump is done after this number of inferences
+PARTIAL_DUMP = 2
+# simulated number of cycles for every layer
+WORKLOAD = [20000, 0, 5000, 3000, 1000]
+# maximal overhead (cycles) of the measurement, in addition to the cost of reading the counter
+OVERHEAD = 200
+# number of counter reads of the measurement of a single layer (and of the loop in cluster.c)
+NUM_READS = 4
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME)
+
+    # generate makefile
+    mkf = Makefile()
+    mkf.add_fc_test_source("test.c")
+    mkf.add_cl_test_source("cluster.c")
+    mkf.add_fc_prog_source("telemetry.c")
+    mkf.add_cl_prog_source("telemetry.c")
+    mkf.add_define("TELEMETRY")
+    mkf.add_define("TELEMETRY_CAPACITY", CAPACITY)
+    mkf.write()
+
+    # prepare header file
+    header = HeaderFile("test_stimuli.h")
+    header.add(HeaderConstant("NUM_INFERENCES", NUM_INFERENCES))
+    header.add(HeaderConstant("PARTIAL_DUMP", PARTIAL_DUMP))
+    header.add(HeaderArray("workload", "unsigned int", WORKLOAD))
+    header.write()
+
+    # compile and run
+    os.system("make clean all run > {}".format(RESULT_FILE))
+
+    # cost of reading the cycle counter (the host counts ns, and reading the clock is expensive)
+    with open(RESULT_FILE, "r") as _f:
+        costs = [int(c) for c in re.findall(r"^## read_cost: (\d+)$", _f.read(), re.MULTILINE)]
+    overhead = OVERHEAD + NUM_READS * max(costs, default=0)
+
+    # decode the dumps
+    try:
+        with open(RESULT_FILE, "r") as _f:
+            dumps = tm.decode(_f)
+    except tm.TelemetryError:
+        dumps = []
+
+    result = {}
+    if len(dumps) != 2:
+        result["1"] = {"result": False, "dumps": len(dumps)}
+        logger.show_subcase_result("dump", result)
+        return logger.summary()
+
+    partial, wrapped = dumps
+    seqs = [r["seq"] for r in partial["records"]]
+    result["1"] = {"result": partial["total"] == PARTIAL_DUMP and seqs == list(range(PARTIAL_DUMP)),
+                   "case": "partial"}
+    seqs = [r["seq"] for r in wrapped["records"]]
+    result["2"] = {"result": (wrapped["total"] == NUM_INFERENCES and
+                              seqs == list(range(NUM_INFERENCES - CAPACITY, NUM_INFERENCES))),
+                   "case": "wrapped"}
+
+    # check the measured cycles
+    success = True
+    for record in partial["records"] + wrapped["records"]:
+        layer_cycles = record["layer_cycles"]
+        for cycles, expected in zip(layer_cycles, WORKLOAD):
+            success = success and expected <= cycles <= expected + overhead
+        success = success and sum(layer_cycles) <= record["cycles"] <= sum(layer_cycles) + overhead
+    timestamps = [r["timestamp"] for r in wrapped["records"]]
+    success = success and timestamps == sorted(timestamps)
+    result["3"] = {"result": success, "case": "cycles"}
+
+    # log the result
+    logger.show_subcase_result("dump", result)
+
+    # return summary
+    return logger.summary()
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 ETH Zurich. All rights reserved.
+ *
+ * Author: Tibor Schneider, ETH Zurich
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "stdio.h"
+#include "rt/rt_api.h"
+#include "test_stimuli.h"
+#include "../../../src/cl/net/net.h"
+#include "../../../src/cl/net/model.h"
+#include "../../../src/host/engine/engine.h"
+
+#define NUM_THREADS 3
+
+void cluster_entry(void* arg) {
+
+    int8_t * p_output = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_N);
+    int8_t * p_exp = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_N * NUM_TRIALS);
+    int8_t * p_batch = rt_alloc(RT_ALLOC_FC_DATA, sizeof(int8_t) * NET_N * NUM_TRIALS);
+    engine_workspace_t* p_ws = engine_workspace_alloc();
+
+    // compare every trial with the device implementation
+    int num_err = 0;
+    for (int i = 0; i < NUM_TRIALS; i++) {
+        net_model_compute(x_vec + i * DEV_INPUT_LEN, p_exp + i * NET_N);
+        engine_compute(x_raw_vec + i * NET_C * NET_T, p_output, p_ws);
+        for (int n = 0; n < NET_N; n++) {
+            if (p_output[n] != p_exp[i * NET_N + n]) {
+                num_err++;
+            }
+        }
+    }
+
+    printf("## 1: result: %s\n", num_err == 0 ? "OK" : "FAIL");
+
+    // compute all trials on multiple threads
+    num_err = engine_compute_batch(x_raw_vec, NUM_TRIALS, p_batch, NUM_THREADS) != 0;
+    for (int i = 0; i < NUM_TRIALS * NET_N; i++) {
+        if (p_batch[i] != p_exp[i]) {
+            num_err++;
+        }
+    }
+
+    printf("## 2: result: %s\n", num_err == 0 ? "OK" : "FAIL");
+
+    engine_workspace_free(p_ws);
+    rt_free(RT_ALLOC_FC_DATA, (void*)p_output, sizeof(int8_t) * NET_N);
+    rt_free(RT_ALLOC_FC_DATA, (void*)p_exp, sizeof(int8_t) * NET_N * NUM_TRIALS);
+    rt_free(RT_ALLOC_FC_DATA, (void*)p_batch, sizeof(int8_t) * NET_N * NUM_TRIALS);
+}
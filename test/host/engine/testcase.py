@@ -0,0 +1,164 @@
+"""
+This file will test the host inference engine (src/host/engine) against the device implementation
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+
+import os
+import subprocess
+import numpy as np
+from test_utils import parse_output, TestLogger
+from header_file import HeaderFile, HeaderConstant, HeaderArray, align_array
+from makefile import Makefile
+from golden_model import GoldenModel
+import functional as F
+import trial_file
+
+TESTNAME = "host::engine"
+RESULT_FILE = "result.out"
+
+INPUT_FILENAME = "../../../data/verification.npz"
+NET_FILENAME = "../../../data/net.npz"
+CONFIG_FILENAME = "../../../data/config.json"
+ENGINE_DIR = "../../../src/host/engine"
+TRIAL_FILENAME = "trials.bin"
+OUTPUT_FILENAME = "output.bin"
+
+NUM_RANDOM = 2
+NUM_REAL = 2
+
+# all options which change the arithmetic of the network (all other options only change the speed)
+CONFIGS = [
+    ("default", ["FUSE_LAYERS", "NO_INTERMEDIATE_SCALE", "REORDER_BN", "DUPLICATE_FEATUREMAP"]),
+    ("fused, intermediate scale", ["FUSE_LAYERS", "REORDER_BN"]),
+    ("unfused", ["REORDER_BN"]),
+    ("unfused, no reorder BN", []),
+]
+
+# options of the device implementation which are the same for all configurations
+DEVICE_DEFINES = ["INTRINSIC_SCALE", "FLIP_LAYERS", "PARALLEL", "DMA_STREAM", "CROSS_CORRELATE"]
+
+
+def gen_stimuli(C, T, scale):
+    """ returns random and real trials, np.array(shape: [N, C, T]) """
+    x_rand = np.random.randint(-60, 60, (NUM_RANDOM, C, T))
+    x_real = np.load(INPUT_FILENAME)["input"][:NUM_REAL]
+    x_real = F.quantize_to_int(np.reshape(x_real, (-1, C, T)), scale)
+    return np.concatenate([x_rand, x_real], axis=0)
+
+
+def device_input(x, pad_data):
+    """ returns the input of net_model_compute for every trial, np.array(shape: [N, -1]) """
+    N, C, T = x.shape
+    if pad_data:
+        x_dev = np.zeros((N, C, T + 63), dtype=int)
+        x_dev[:, :, 31:31 + T] = x
+    else:
+        x_dev = np.stack([align_array(x[i]) for i in range(N)])
+    return np.reshape(x_dev, (N, -1))
+
+
+def test_device(logger, x):
+    """ compares engine_compute and engine_compute_batch with net_model_compute """
+    for name, defines in CONFIGS:
+        mkf = Makefile()
+        mkf.add_fc_test_source("test.c")
+        mkf.add_cl_test_source("cluster.c")
+        for source in ["model.c", "layer1.c", "layer2.c", "layer3.c", "layer4.c", "layer5.c",
+                       "fused_layer_1_2.c", "net.c", "blob.c", "stream.c"]:
+            mkf.add_cl_prog_source("net/{}".format(source))
+        for source in ["transform.c", "dotp.c", "conv.c", "flip.c", "xcorr.c"]:
+            mkf.add_cl_prog_source("func/{}".format(source))
+        mkf.add_host_prog_source("engine/engine.c")
+        mkf.add_host_prog_source("engine/pool.c")
+        for define in DEVICE_DEFINES + defines:
+            mkf.add_define(define)
+        mkf.write()
+
+        x_dev = device_input(x, "DUPLICATE_FEATUREMAP" in defines)
+        header = HeaderFile("test_stimuli.h")
+        header.add(HeaderConstant("NUM_TRIALS", x.shape[0]))
+        header.add(HeaderConstant("DEV_INPUT_LEN", x_dev.shape[1]))
+        header.add(HeaderArray("x_vec", "int8_t", x_dev.ravel()))
+        header.add(HeaderArray("x_raw_vec", "int8_t", x.ravel()))
+        header.write()
+
+        os.system("make clean all run > {}".format(RESULT_FILE))
+        result = parse_output(RESULT_FILE)
+        for case_id, case in [("1", "single"), ("2", "batch")]:
+            result.setdefault(case_id, {"result": False})["case"] = case
+        logger.show_subcase_result(name, result)
+
+
+def test_cli(logger, model, x):
+    """ compares eegnet_score (AVX2 if available, multiple threads) with the golden model """
+    build_dir = os.path.abspath("build/engine")
+    defines = " ".join(CONFIGS[0][1])
+    ret = os.system("make -s -C {} BUILD_DIR={} ENGINE_DEFINES=\"{}\" > {} 2>&1".format(
+        ENGINE_DIR, build_dir, defines, RESULT_FILE))
+
+    success = False
+    throughput = None
+    if ret == 0:
+        trial_file.write_trials(TRIAL_FILENAME, x)
+        out = subprocess.run([os.path.join(build_dir, "eegnet_score"), "-j", "3", "-o",
+                              OUTPUT_FILENAME, TRIAL_FILENAME], stdout=subprocess.PIPE)
+        if out.returncode == 0:
+            y = trial_file.read_output(OUTPUT_FILENAME, model.N)
+            success = np.array_equal(y, model(x))
+            throughput = out.stdout.decode().strip().split(", ")[-1]
+    result = {"1": {"result": success}}
+    if throughput is not None:
+        result["1"]["throughput"] = throughput
+    logger.show_subcase_result("eegnet_score", result)
+
+    for filename in [TRIAL_FILENAME, OUTPUT_FILENAME]:
+        if os.path.exists(filename):
+            os.remove(filename)
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+
+    logger = TestLogger(TESTNAME)
+
+    # the engine only runs natively
+    if "platform=host" not in os.environ.get("PULP_CURRENT_CONFIG_ARGS", ""):
+        logger.show_subcase_result("engine", {"1": {"result": None, "reason": "host only"}})
+        return logger.summary()
+
+    model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False,
+                        no_scale_between_l1_l2=True, reorder_bn=True)
+    x = gen_stimuli(model.C, model.T, model.input_scale)
+
+    test_device(logger, x)
+    test_cli(logger, model, x)
+
+    return logger.summary()
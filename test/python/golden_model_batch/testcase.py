@@ -0,0 +1,101 @@
+"""
+Test the batched golden model: every layer and function must produce exactly the same result for a
+batch of trials as for every trial separately.
+"""
+
+
+import numpy as np
+from test_utils import TestLogger
+from golden_model import GoldenModel
+from batch_eval import run
+import functional as F
+
+TESTNAME = "python::GoldenModel batched"
+NET_FILENAME = "../../../data/net.npz"
+DATA_FILENAME = "../../../data/verification.npz"
+CONFIG_FILENAME = "../../../data/config.json"
+
+BATCH_SIZE = 4
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(TESTNAME)
+
+    data = dict(np.load(DATA_FILENAME))
+    x = data["input"][:BATCH_SIZE]
+
+    logger.show_subcase_result("Functional", test_functional())
+
+    configs = [("Model", False, True), ("Model no reorder", False, False),
+               ("Model fused", True, True)]
+    for name, fused, reorder_bn in configs:
+        model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False,
+                            no_scale_between_l1_l2=fused, reorder_bn=reorder_bn)
+        x_q = F.quantize_to_int(x, model.input_scale)
+        logger.show_subcase_result(name, test_model(model, x_q))
+
+    model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False)
+    x_q = F.quantize_to_int(data["input"], model.input_scale)
+    y, _ = run(model, x_q, batch_size=3, num_workers=2)
+    success = all(np.array_equal(model(x_q[i]), y[i]) for i in range(x_q.shape[0]))
+    logger.show_subcase_result("Multiprocessing", {"1": {"result": success}})
+
+    # return summary
+    return logger.summary()
+
+
+def test_model(model, x):
+    """
+    Executes the model layer by layer on the batch, and compares it to every trial separately
+    """
+    result = {}
+    y_batch = x
+    y_single = list(x)
+    for i, layer in enumerate(model.layers):
+        y_batch = layer(y_batch)
+        y_single = [layer(y) for y in y_single]
+        success = y_batch.shape == (x.shape[0], ) + tuple(layer.output_shape)
+        success = success and all(np.array_equal(a, b) for a, b in zip(y_batch, y_single))
+        result[str(i + 1)] = {"result": success}
+    return result
+
+
+def test_functional():
+    """
+    Executes every function on a random batch, and compares it to every sample separately
+    """
+    rng = np.random.RandomState(0)
+    x3 = rng.randint(-128, 128, (BATCH_SIZE, 4, 6, 32))
+    x2 = x3[:, :, 0, :]
+    scale = rng.randint(-8, 8, 4)
+    cases = [
+        ("batch_norm", x3, lambda x, axis: F.batch_norm(x, scale, scale, axis=axis)),
+        ("apply_factor_offset", x3,
+         lambda x, axis: F.apply_factor_offset(x, np.arange(1, 5) * 50, scale, axis=axis)),
+        ("relu", x3, lambda x, axis: F.relu(x, scale * 10, axis=axis)),
+        ("pool", x2, lambda x, axis: F.pool(x, (1, 8))),
+        ("conv_time", x2, lambda x, axis: F.conv_time(x, rng.randint(-128, 128, (3, 16)))),
+        ("depthwise_conv_space", x3,
+         lambda x, axis: F.depthwise_conv_space(x, rng.randint(-128, 128, (8, 6)))),
+        ("depthwise_conv_time", x2,
+         lambda x, axis: F.depthwise_conv_time(x, rng.randint(-128, 128, (4, 16)))),
+        ("pointwise_conv", x2, lambda x, axis: F.pointwise_conv(x, rng.randint(-128, 128, (4, 4)))),
+        ("linear", x2[:, 0, :],
+         lambda x, axis: F.linear(x, rng.randint(-128, 128, (3, 32)), scale[:3])),
+    ]
+    result = {}
+    for i, (name, x, func) in enumerate(cases):
+        # use the same random weights for the batch and for the single samples
+        state = rng.get_state()
+        y_batch = func(x, 1)
+        y_single = []
+        for sample in x:
+            rng.set_state(state)
+            y_single.append(func(sample, 0))
+        success = np.array_equal(y_batch, np.stack(y_single))
+        result[str(i + 1)] = {"result": success, "function": name}
+    return result
@@ -0,0 +1,128 @@
+"""
+This file will test the conversion of GVSOC traces into timelines and flame graphs
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+
+from test_utils import TestLogger
+import gvsoc_trace as gt
+
+TESTNAME = "python::gvsoc_trace"
+
+NM_OUTPUT = """
+1c008000 00000020 T main
+1c008020 00000040 T kernel
+1c008060 00000010 t helper
+1c009000 00000004 D data
+"""
+
+# core pe0: main -> kernel -> helper -> kernel (sleep) -> main
+# core pe1: kernel only
+TRACE = """
+this line is ignored
+100000: 10: [/sys/board/chip/cluster/pe0/insn] M 1c008000 addi sp, sp, -16
+110000: 11: [/sys/board/chip/cluster/pe0/insn] M 1c008004 jal ra, 1c008020
+120000: 12: [/sys/board/chip/cluster/pe0/insn] M 1c008020 addi a0, a0, 1
+130000: 13: [/sys/board/chip/cluster/pe0/insn] M 1c008024 jal ra, 1c008060
+140000: 14: [/sys/board/chip/cluster/pe0/insn] M 1c008060 addi a0, a0, 1
+150000: 15: [/sys/board/chip/cluster/pe0/insn] M 1c008064 ret
+160000: 16: [/sys/board/chip/cluster/pe0/insn] M 1c008028 p.elw t0, 0(t1)
+200000: 20: [/sys/board/chip/cluster/pe0/insn] M 1c00802c ret
+210000: 21: [/sys/board/chip/cluster/pe0/insn] M 1c008008 addi sp, sp, 16
+220000: 22: [/sys/board/chip/cluster/pe0/insn] M 1c00800c ret
+120000: 12: [/sys/board/chip/cluster/pe1/insn] M 1c008020 addi a0, a0, 1
+130000: 13: [/sys/board/chip/cluster/pe1/insn] M 1c008024 addi a0, a0, 1
+140000: 14: [/sys/board/chip/cluster/pe1/insn] M 1c008028 addi a0, a0, 1
+"""
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(TESTNAME)
+
+    symbols = gt.SymbolTable.from_nm_output(NM_OUTPUT)
+    trace = gt.parse_trace(TRACE.splitlines())
+    segments, collapsed = gt.build_profile(trace, symbols)
+    events = gt.chrome_trace(segments)["traceEvents"]
+
+    logger.show_subcase_result("symbols", test_symbols(symbols))
+    logger.show_subcase_result("parse", test_parse(trace))
+    logger.show_subcase_result("flame graph", test_collapsed(collapsed))
+    logger.show_subcase_result("timeline", test_timeline(events))
+
+    # return summary
+    return logger.summary()
+
+
+def test_symbols(symbols):
+    success = symbols.lookup(0x1c008000) == ("main", 0x1c008000)
+    success = success and symbols.lookup(0x1c008068) == ("helper", 0x1c008060)
+    success = success and symbols.lookup(0x1c008070)[0] == gt.UNKNOWN
+    success = success and symbols.lookup(0x1c000000)[0] == gt.UNKNOWN
+    return {"1": {"result": success}}
+
+
+def test_parse(trace):
+    success = sorted(trace) == ["pe0", "pe1"]
+    success = success and len(trace["pe0"]) == 10 and len(trace["pe1"]) == 3
+    success = success and trace["pe0"][6] == (160000, 16, 0x1c008028, "p.elw")
+    return {"1": {"result": success}}
+
+
+def test_collapsed(collapsed):
+    expected = {
+        ("pe0", "main"): 4,
+        ("pe0", "main", "kernel"): 3,
+        ("pe0", "main", "kernel", "helper"): 2,
+        ("pe0", "main", "kernel", "[wait]"): 4,
+        ("pe1", "kernel"): 3,
+    }
+    success = collapsed == expected
+    lines = gt.collapsed_stacks(collapsed).splitlines()
+    success = success and "pe0;main;kernel;[wait] 4" in lines
+    return {"1": {"result": success, "stacks": len(lines)}}
+
+
+def test_timeline(events):
+    frames = [(e["tid"], e["name"], e["ts"], e["dur"]) for e in events if e["ph"] == "X"]
+    expected = [
+        (0, "main", 0.1, 0.13),
+        (0, "kernel", 0.12, 0.09),
+        (0, "helper", 0.14, 0.02),
+        (0, "[wait]", 0.16, 0.04),
+        (1, "kernel", 0.12, 0.03),
+    ]
+    success = len(frames) == len(expected)
+    for exp in expected:
+        success = success and any(f[:2] == exp[:2] and abs(f[2] - exp[2]) < 1e-9 and
+                                  abs(f[3] - exp[3]) < 1e-9 for f in frames)
+    names = [e["args"]["name"] for e in events if e["ph"] == "M"]
+    success = success and names == ["pe0", "pe1"]
+    return {"1": {"result": success, "events": len(frames)}}
@@ -0,0 +1,112 @@
+"""
+Test folding the linear preprocessing into layer 1 and 2 (python_utils/preprocessing.py): the
+folded model on the raw input is compared to the unfolded pipeline (preprocessing in floating point,
+then quantizing the input).
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "0.0.1"
+__date__ = "2020/06/04"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+import numpy as np
+from test_utils import TestLogger
+from golden_model import GoldenModel
+from batch_eval import run, compare_preprocessing
+import preprocessing
+import functional as F
+
+TESTNAME = "python::preprocessing"
+NET_FILENAME = "../../../data/net.npz"
+DATA_FILENAME = "../../../data/verification.npz"
+CONFIG_FILENAME = "../../../data/config.json"
+
+# maximal error of the output (in quantization steps), if the preprocessing is folded
+TOLERANCE = 8
+
+
+def gen_specs(C):
+    """ returns a list of (name, spec) """
+    rng = np.random.RandomState(0)
+    gain = list(rng.uniform(0.9, 1.1, C))
+    return [
+        ("identity", {"steps": []}),
+        ("CAR", {"steps": [{"type": "car"}]}),
+        ("CAR + gain", {"steps": [{"type": "car"}, {"type": "gain", "gain": gain}]}),
+        ("CAR + gain + FIR", {"steps": [{"type": "car"}, {"type": "gain", "gain": gain},
+                                        {"type": "fir", "taps": [0.25, 0.5, 0.25]}]}),
+    ]
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(TESTNAME)
+
+    x = np.load(DATA_FILENAME)["input"]
+    reference = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False)
+
+    logger.show_subcase_result("Linearity", test_linearity(x[0]))
+
+    for name, spec in gen_specs(reference.C):
+        model = GoldenModel(CONFIG_FILENAME, NET_FILENAME, clip_balanced=False,
+                            preprocessing_spec=spec)
+        y, _ = run(model, F.quantize_to_int(x, model.input_scale))
+        _, stats = compare_preprocessing(model, reference, x, y)
+        if name == "identity":
+            success = stats["max_error"] == 0
+        else:
+            success = stats["max_error"] <= TOLERANCE and stats["agreement"] == 1
+        logger.show_subcase_result(name, {"1": {"result": success,
+                                                "max error": stats["max_error"],
+                                                "same class": stats["agreement"]}})
+
+    # return summary
+    return logger.summary()
+
+
+def test_linearity(x):
+    """
+    Checks the folded weights in floating point: layer 1 on the raw input, followed by the spatial
+    matrix, must be equal to layer 1 on the preprocessed input (up to the truncation of the filter
+    and the border of the window)
+    """
+    net = dict(np.load(NET_FILENAME))
+    C = x.shape[0]
+    result = {}
+    for i, (name, spec) in enumerate(gen_specs(C)):
+        folded, dropped = preprocessing.fold(net, spec)
+        w1 = net["conv1.weightFrozen"][:, 0, 0, :]
+        w1_folded = folded["conv1.weightFrozen"][:, 0, 0, :]
+        y_exp = F.conv_time(preprocessing.apply(spec, x), w1[:, ::-1])
+        y = F.conv_time(x, w1_folded[:, ::-1])
+        y = np.einsum("dc,kct->kdt", preprocessing.spatial_matrix(spec, C), y)
+        # ignore the border, where the filter is applied on the padding
+        error = np.abs(y - y_exp)[:, :, 64:-64].max() / np.abs(y_exp).max()
+        # the weights are quantized with 255 levels, and the filter may be truncated
+        success = error < 0.02 + 2 * np.sqrt(dropped)
+        result[str(i + 1)] = {"result": success, "spec": name, "error": error}
+    return result
@@ -0,0 +1,123 @@
+"""
+This file will test the decoding of the telemetry dump and the latency statistics
+"""
+
+__author__ = "Tibor Schneider"
+__email__ = "sctibor@student.ethz.ch"
+__version__ = "1.0"
+__license__ = "Apache 2.0"
+__copyright__ = """
+    Copyright (C) 2020 ETH Zurich. All rights reserved.
+
+    Author: Tibor Schneider, ETH Zurich
+
+    SPDX-License-Identifier: Apache-2.0
+
+    Licensed under the Apache License, Version 2.0 (the License); you may
+    not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+    www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an AS IS BASIS, WITHOUT
+    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+"""
+
+
+
+from test_utils import TestLogger
+from test_utils import TestLogger
+import telemetry as tm
+
+TESTNAME = "python::telemetry"
+
+NUM_LAYERS = 5
+
+
+def gen_records(seqs, period=1000):
+    """ generates records with a known pattern: cycles = 1000 + 10 * seq, layer k = seq + k """
+    records = []
+    for seq in seqs:
+        layer_cycles = [seq + k for k in range(NUM_LAYERS)]
+        records.append({"seq": seq, "timestamp": (seq * period) & tm.MASK,
+                        "cycles": 1000 + 10 * seq, "layer_cycles": layer_cycles})
+    return records
+
+
+def test():
+    """
+    Execute the tests
+    Returns: (n_total, n_success)
+    """
+    logger = TestLogger(TESTNAME)
+
+    logger.show_subcase_result("roundtrip", test_roundtrip())
+    logger.show_subcase_result("corrupted", test_corrupted())
+    logger.show_subcase_result("statistics", test_statistics())
+
+    # return summary
+    return logger.summary()
+
+
+def test_roundtrip():
+    result = {}
+    cases = [
+        ("empty", []),
+        ("single", gen_records([0])),
+        ("ring", gen_records(range(36, 100))),
+    ]
+    for i, (name, records) in enumerate(cases):
+        # embed the dump inside other output, with a second dump afterwards
+        lines = ["fc::main::main", "Result:"] + tm.encode_dump(records, total=100) + ["Class 1: 0"]
+        lines += tm.encode_dump(gen_records([7]), line_words=3)
+        dumps = tm.decode(lines)
+        success = len(dumps) == 2 and dumps[0]["records"] == records
+        success = success and dumps[0]["total"] == 100 and dumps[0]["num_layers"] == NUM_LAYERS
+        success = success and dumps[1]["records"] == gen_records([7])
+        result[str(i + 1)] = {"result": success, "case": name}
+    return result
+
+
+def test_corrupted():
+    result = {}
+    lines = tm.encode_dump(gen_records(range(4)))
+
+    def _expect_error(lines):
+        try:
+            tm.decode(lines)
+        except tm.TelemetryError:
+            return True
+        return False
+
+    # flip a single bit in the payload
+    corrupted = list(lines)
+    corrupted[1] = corrupted[1][:-1] + "{:x}".format(int(corrupted[1][-1], 16) ^ 1)
+    result["1"] = {"result": _expect_error(corrupted), "case": "checksum"}
+
+    # remove the last line
+    result["2"] = {"result": _expect_error(lines[:-1]), "case": "truncated"}
+    return result
+
+
+def test_statistics():
+    # sequence number 50 is missing
+    records = gen_records(list(range(40, 50)) + list(range(51, 60)))
+    stats = tm.statistics(records)
+    cycles = [r["cycles"] for r in records]
+
+    success = stats["lost"] == 1
+    success = success and stats["cycles"]["min"] == 1400 and stats["cycles"]["max"] == 1590
+    success = success and stats["cycles"]["jitter"] == 190
+    success = success and abs(stats["cycles"]["mean"] - sum(cycles) / len(cycles)) < 1e-9
+    success = success and [s["min"] for s in stats["layers"]] == [40, 41, 42, 43, 44]
+    # period of consecutive records only
+    success = success and stats["period"]["n"] == 17 and stats["period"]["jitter"] == 0
+    success = success and stats["period"]["mean"] == 1000
+
+    hist = tm.histogram(cycles, bins=4)
+    success = success and sum(c for _, _, c in hist) == len(records)
+    success = success and hist[0][0] == 1400 and hist[-1][1] == 1590
+    return {"1": {"result": success}}
@@ -29,6 +29,7 @@ __copyright__ = """
 
 
 import os
+import re
 import sys
 import importlib.util
 
@@ -47,7 +48,9 @@ def test_main(root_folder):
     # go a directory up and build the project, without running it
     os.chdir("..")
     print("Building the project...")
-    os.system("./run.sh -n > /dev/null")
+    platform = re.search(r"platform=(\w+)", os.environ.get("PULP_CURRENT_CONFIG_ARGS", ""))
+    platform_arg = "" if platform is None else " -p {}".format(platform.group(1))
+    os.system("./run.sh -n{} > /dev/null".format(platform_arg))
     # go back to the test directory
     os.chdir(old_cwd)
 